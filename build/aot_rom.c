@@ -0,0 +1,177 @@
+/*
+ * Generated by chip8-aot from smc.ch8. Do not edit.
+ */
+
+#include <stdint.h>
+#include "chip8.h"
+#include "opcode_table.h"
+#include "instructions.h"
+#include "aot.h"
+
+#define V chip8_memory.registers
+#define I chip8_memory.index
+#define PC chip8_memory.program_counter
+
+#define AOT_BLOCK_COUNT 2
+#define AOT_CODE_START 0x200
+#define AOT_CODE_END 0x212
+
+const char aot_rom_name[] = "smc.ch8";
+
+static uint8_t aot_dirty[AOT_BLOCK_COUNT];
+
+static const uint16_t aot_block_start[AOT_BLOCK_COUNT] = {
+    0x200, 0x20C
+};
+
+static const uint16_t aot_block_end[AOT_BLOCK_COUNT] = {
+    0x20A, 0x212
+};
+
+void aot_invalidate(uint16_t address, uint16_t length)
+{
+    unsigned end = (unsigned)address + length;
+
+    if (end <= AOT_CODE_START || address >= AOT_CODE_END)
+        return;
+
+    for (int b = 0; b < AOT_BLOCK_COUNT; b++)
+    {
+        if (address < aot_block_end[b] && end > aot_block_start[b])
+            aot_dirty[b] = 1;
+    }
+}
+
+int aot_run(int budget)
+{
+    int cycles = 0;
+    uint16_t sum;
+
+    (void)sum;
+
+dispatch:
+    switch (PC)
+    {
+    case 0x200:
+        goto B_200;
+    case 0x202:
+        if (aot_dirty[0])
+            return cycles;
+        goto I_202;
+    case 0x204:
+        if (aot_dirty[0])
+            return cycles;
+        goto I_204;
+    case 0x206:
+        if (aot_dirty[0])
+            return cycles;
+        goto I_206;
+    case 0x208:
+        if (aot_dirty[0])
+            return cycles;
+        goto I_208;
+    case 0x20C:
+        goto B_20C;
+    case 0x20E:
+        if (aot_dirty[1])
+            return cycles;
+        goto I_20E;
+    case 0x210:
+        if (aot_dirty[1])
+            return cycles;
+        goto I_210;
+    default:
+        return cycles;
+    }
+
+B_200:
+    if (aot_dirty[0])
+        return cycles;
+    /* 200: 6072 */
+    if (cycles == budget)
+    {
+        PC = 0x200;
+        return cycles;
+    }
+    cycles++;
+    V[0x0] = 0x72;
+    /* 202: 6105 */
+I_202:
+    if (cycles == budget)
+    {
+        PC = 0x202;
+        return cycles;
+    }
+    cycles++;
+    V[0x1] = 0x05;
+    /* 204: A20C */
+I_204:
+    if (cycles == budget)
+    {
+        PC = 0x204;
+        return cycles;
+    }
+    cycles++;
+    I = 0x20C;
+    /* 206: F155 */
+I_206:
+    if (cycles == budget)
+    {
+        PC = 0x206;
+        return cycles;
+    }
+    cycles++;
+    PC = 0x208;
+    opcode = 0xF155;
+    OP_Fx55();
+    if (chip8_memory.fault)
+        return cycles;
+    aot_invalidate(I, 2);
+    if (aot_dirty[0])
+    {
+        PC = 0x208;
+        return cycles;
+    }
+    /* 208: 120C */
+I_208:
+    if (cycles == budget)
+    {
+        PC = 0x208;
+        return cycles;
+    }
+    cycles++;
+    PC = 0x20C;
+    goto B_20C;
+
+B_20C:
+    if (aot_dirty[1])
+        return cycles;
+    /* 20C: 7201 */
+    if (cycles == budget)
+    {
+        PC = 0x20C;
+        return cycles;
+    }
+    cycles++;
+    V[0x2] += 0x01;
+    /* 20E: 6000 */
+I_20E:
+    if (cycles == budget)
+    {
+        PC = 0x20E;
+        return cycles;
+    }
+    cycles++;
+    V[0x0] = 0x00;
+    /* 210: B214 */
+I_210:
+    if (cycles == budget)
+    {
+        PC = 0x210;
+        return cycles;
+    }
+    cycles++;
+    opcode = 0xB214;
+    OP_Bnnn();
+    goto dispatch;
+}
@@ -0,0 +1,66 @@
+/*
+ * AHEAD-OF-TIME TRANSLATION INTERFACE
+ *
+ * chip8-aot (tools/chip8_aot.c) statically recompiles a ROM into a C
+ * translation unit. It disassembles the ROM by following every reachable
+ * path from START_ADDRESS (jumps, calls, return sites and both successors
+ * of every skip), which separates code from data, splits the code into
+ * basic blocks and emits each block as straight-line C that operates
+ * directly on chip8_memory. Blocks are chained with direct gotos where the
+ * successor is known statically.
+ *
+ * The generated file implements the functions declared below and is linked
+ * against the regular core. Anything it cannot execute natively is left to
+ * the interpreter:
+ *
+ *   - Targets of indirect jumps (Bnnn) and any other address that was not
+ *     discovered statically
+ *   - Blocks whose bytes were overwritten at run time (self-modifying code)
+ *   - Invalid opcodes
+ *
+ * In each of these cases aot_run() returns with program_counter pointing
+ * at the instruction the interpreter must execute next, so a driver simply
+ * alternates between aot_run() and processor_cycle().
+ *
+ * A handler that raises a fault (see Chip8Fault) ends aot_run() at once,
+ * with chip8_memory.fault set exactly as the interpreter would leave it.
+ */
+
+#ifndef AOT_H
+#define AOT_H
+
+#include <stdint.h>
+
+/*
+ * aot_rom_name
+ *
+ * File name of the ROM the translation unit was generated from.
+ */
+extern const char aot_rom_name[];
+
+/*
+ * aot_run(budget)
+ *
+ * Executes translated blocks starting at chip8_memory.program_counter
+ * until `budget` instructions have run or control reaches an address that
+ * must be interpreted. The budget is checked per instruction, so blocks
+ * may be left part-way through at a frame boundary; every translated
+ * instruction is also an entry point, so the next call resumes there.
+ *
+ * Return Value:
+ *   Number of CHIP-8 instructions executed (0 when the current address
+ *   must be handled by the interpreter).
+ */
+int aot_run(int budget);
+
+/*
+ * aot_invalidate(address, length)
+ *
+ * Marks every translated block overlapping [address, address + length)
+ * as modified, so it is interpreted from then on. Translated code calls
+ * this after its own memory stores; drivers must call it after any
+ * interpreted instruction that writes RAM (Fx33, Fx55).
+ */
+void aot_invalidate(uint16_t address, uint16_t length);
+
+#endif
@@ -0,0 +1,118 @@
+/*
+ * AUDIO SUBSYSTEM — INTERFACE DESCRIPTION
+ *
+ * CHIP-8 has a single sound source: a beeper that sounds while the sound
+ * timer is non-zero. This module produces that tone through SDL audio.
+ *
+ * The emulation thread and the SDL audio callback never share a lock.
+ * Instead, for every executed instruction the emulator appends the beeper
+ * state (on/off) for the exact number of output samples that instruction
+ * spans into a lock-free single-producer/single-consumer ring buffer
+ * (see ring_buffer.h). The audio callback drains the ring one sample at a
+ * time and turns the on/off states into a square wave, so tone edges land
+ * on the sample that corresponds to the Fx18 write or timer expiry.
+ *
+ * The amount of queued audio determines output latency. It is bounded by
+ * AudioConfig.latency_ms: in free-running mode excess samples are dropped,
+ * and in audio-synchronized mode the frontend only emulates a new frame
+ * when the queue has fallen below that target, so emulation speed follows
+ * the audio device clock instead of drifting against it.
+ *
+ * Any SDL audio driver can be selected, including "dummy" and "disk",
+ * which makes the audio path testable on machines without sound hardware.
+ */
+
+#ifndef AUDIO_MANAGER_H
+#define AUDIO_MANAGER_H
+
+#include <stdint.h>
+#include <stdatomic.h>
+#include <SDL2/SDL.h>
+#include "ring_buffer.h"
+#include "frontend.h"
+
+/*
+ * AudioManager
+ *
+ *   device           — Opened SDL audio device, 0 when audio is disabled.
+ *   spec             — Format actually obtained from the device.
+ *   config           — Copy of the configuration passed at initialization
+ *                      (AudioConfig, see frontend.h).
+ *   tone             — SPSC queue of per-sample states: silent, beeper
+ *                      tone, or a fixed low or high level.
+ *   latency_samples  — latency_ms converted to samples.
+ *   sample_remainder — Fractional-sample accumulator for per-cycle pushes.
+ *   phase            — Square-wave phase accumulator (callback-owned).
+ *   polarity         — Current square-wave half (callback-owned).
+ *   underruns        — Number of callbacks that ran out of queued samples.
+ */
+typedef struct
+{
+    SDL_AudioDeviceID device;
+    SDL_AudioSpec spec;
+    AudioConfig config;
+    RingBuffer tone;
+    size_t latency_samples;
+    uint32_t sample_remainder;
+    uint32_t phase;
+    int polarity;
+    _Atomic unsigned long underruns;
+} AudioManager;
+
+/*
+ * g_audioManager
+ *
+ * Global instance of the audio subsystem, mirroring g_displayManager.
+ */
+extern AudioManager g_audioManager;
+
+/*
+ * AudioManager_Init(config)
+ *
+ * Initializes the SDL audio subsystem with the requested driver, opens a
+ * mono 16-bit output device and starts playback.
+ *
+ * Return Value:
+ *   1 — Audio is running
+ *   0 — Audio could not be initialized; the emulator may continue silently
+ */
+int AudioManager_Init(const AudioConfig *config);
+
+/*
+ * AudioManager_Destroy()
+ *
+ * Stops playback, closes the device and shuts down the audio subsystem.
+ * Safe to call when initialization failed.
+ */
+void AudioManager_Destroy();
+
+/*
+ * AudioManager_QueueCycle(tone_on)
+ *
+ * Called by the emulation thread after every executed instruction. Queues
+ * the beeper state for the samples covered by one instruction
+ * (sample_rate / (CHIP8_FRAME_RATE × CHIP8_CYCLES_PER_FRAME), with the
+ * fractional part carried over to the next call).
+ */
+void AudioManager_QueueCycle(int tone_on);
+
+/*
+ * AudioManager_QueueSamples(levels, count)
+ *
+ * Queues `count` output samples directly: +1 and -1 play at full
+ * amplitude, 0 is silence. Used for XO-CHIP audio patterns, which are
+ * generated at the device sample rate (xochip_audio()) instead of per
+ * instruction.
+ */
+void AudioManager_QueueSamples(const int8_t *levels, size_t count);
+
+/*
+ * AudioManager_FrameDue()
+ *
+ * Returns 1 when the queued audio has dropped below the latency target and
+ * another frame should be emulated, 0 otherwise. Only meaningful when
+ * sync_to_audio is enabled.
+ */
+int AudioManager_FrameDue();
+
+#endif
@@ -0,0 +1,110 @@
+/*
+ * HEADLESS VIDEO CAPTURE
+ *
+ * This module runs the CHIP-8 machine without a window and as fast as the
+ * host allows, writing every emulated 60 Hz frame to a file or to stdout.
+ * It is intended for producing gameplay videos for QA and regression review
+ * without screen-recording an SDL window in real time.
+ *
+ * Two output formats are supported:
+ *
+ *   - Y4M  — YUV4MPEG2 stream (4:2:0, full-size luma plane, neutral chroma)
+ *            that can be piped directly into ffmpeg or other encoders.
+ *   - RGBA — Headerless raw frames, 4 bytes per pixel, row-major.
+ *
+ * Every output pixel is a CHIP-8 pixel scaled by an integer factor.
+ *
+ * Emulation and encoding run as a two-stage pipeline: the calling thread
+ * emulates frame N+1 while a dedicated encoder thread scales and writes
+ * frame N. Frames are handed over through a small ring of 64×32 monochrome
+ * slots, so only 2 KB per frame crosses between the stages.
+ */
+
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include <stdint.h>
+#include "memory.h"
+
+/*
+ * CaptureFormat
+ *
+ * Output container/pixel format written by capture_run().
+ */
+typedef enum
+{
+    CAPTURE_FORMAT_Y4M,
+    CAPTURE_FORMAT_RGBA
+} CaptureFormat;
+
+/*
+ * CaptureConfig
+ *
+ *   output_path — Destination file, or "-" to write to stdout.
+ *   format      — Y4M or raw RGBA.
+ *   scale       — Integer scale factor applied to each CHIP-8 pixel (>= 1).
+ *   frames      — Number of 60 Hz frames to emulate and write.
+ */
+typedef struct
+{
+    const char *output_path;
+    CaptureFormat format;
+    int scale;
+    unsigned long frames;
+} CaptureConfig;
+
+/*
+ * capture_run(config)
+ *
+ * Emulates config->frames frames of the ROM currently loaded into
+ * chip8_memory and writes each of them to the configured output.
+ *
+ * A short summary (frames written, wall time and speed relative to real
+ * time) is printed to stderr once the capture completes.
+ *
+ * Return Value:
+ *    0 — All frames were written
+ *   -1 — The output could not be opened or written, or the encoder
+ *        thread could not be started
+ */
+int capture_run(const CaptureConfig *config);
+
+/*
+ * CaptureWriter
+ *
+ * The encoder behind capture_run(), for frontends that write frames as
+ * they are shown (see frontend.h). Frames are encoded and written on the
+ * calling thread.
+ */
+typedef struct CaptureWriter CaptureWriter;
+
+/*
+ * capture_writer_open(config)
+ *
+ * Opens config->output_path and writes the stream header. config->frames
+ * is ignored.
+ *
+ * Returns the writer, or NULL on failure (a message is printed).
+ */
+CaptureWriter *capture_writer_open(const CaptureConfig *config);
+
+/*
+ * capture_writer_frame(writer, pixels)
+ *
+ * Encodes and writes one 64×32 frame; a non-zero pixel is lit.
+ *
+ * Returns 0 on success, or -1 if the output could not be written.
+ */
+int capture_writer_frame(CaptureWriter *writer, const uint8_t pixels[CHIP8_HEIGHT][CHIP8_WIDTH]);
+
+/*
+ * capture_writer_close(writer)
+ *
+ * Flushes and closes the output (stdout is only flushed) and frees the
+ * writer. Accepts NULL.
+ *
+ * Returns 0 on success, or -1 if the final flush failed.
+ */
+int capture_writer_close(CaptureWriter *writer);
+
+#endif
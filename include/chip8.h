@@ -13,19 +13,25 @@
 #define CHIP8_H
 
 #include <stdint.h>
+#include <stddef.h>
 #include "memory.h"
 
 /*
- * chip8_memory
+ * chip8_vm / chip8_memory
  *
- * Global instance representing the entire CHIP-8 machine state.
+ * chip8_memory is the CHIP-8 machine state the core operates on.
  * This includes RAM, registers, stack, timers, index register,
  * keypad mapping, and the display buffer. The MEMORY struct
  * defined in memory.h
  *
  * All instructions and processing routines interact with this object.
+ * It is an alias for *chip8_vm, a per-thread pointer that starts out at
+ * a built-in machine. Code that runs many machines (see vec_env.h)
+ * points chip8_vm at each MEMORY in turn; every thread can do so
+ * independently.
  */
-extern MEMORY chip8_memory;
+extern _Thread_local MEMORY *chip8_vm;
+#define chip8_memory (*chip8_vm)
 
 /*
  * chip8_init()
@@ -33,7 +39,7 @@ extern MEMORY chip8_memory;
  * Initializes the CHIP-8 virtual machine.
  *
  * This function:
- *   - Seeds the RNG for random-number instructions (Cxkk)
+ *   - Seeds the RNG for random-number instructions (Cxkk) from the clock
  *   - Loads the built-in font sprites into memory starting at 0x50
  *   - Resets the program counter to 0x200 (standard start address)
  *   - Initializes opcode dispatch tables
@@ -42,6 +48,13 @@ extern MEMORY chip8_memory;
  */
 void chip8_init();
 
+/*
+ * chip8_seed(seed)
+ *
+ * Reseeds the random-number generator, for reproducible runs.
+ */
+void chip8_seed(uint32_t seed);
+
 /*
  * chip8_generate_random_number()
  *
@@ -49,7 +62,8 @@ void chip8_init();
  *
  * Used primarily by the Cxkk (RND Vx, byte) instruction. The value is
  * masked by the instruction handler to apply the correct bit-filtering
- * semantics defined by the CHIP-8 specification.
+ * semantics defined by the CHIP-8 specification. The generator is a
+ * xorshift whose state lives in chip8_memory.rng_state.
  */
 uint8_t chip8_generate_random_number();
 
@@ -68,4 +82,98 @@ uint8_t chip8_generate_random_number();
  */
 int chip8_load_ROM(const char *filename);
 
+/*
+ * chip8_load_ROM_buffer(data, size)
+ *
+ * Same as chip8_load_ROM() for a ROM image that is already in memory.
+ * Returns 0 on success, or -1 if the image does not fit.
+ */
+int chip8_load_ROM_buffer(const uint8_t *data, size_t size);
+
+/*
+ * chip8_set_key(key, pressed)
+ *
+ * Updates the state of keypad key `key` (0–F).
+ *
+ * All input sources must go through this function rather than writing
+ * chip8_memory.keypad directly: when the CPU is blocked in Fx0A, a press
+ * completes the pending key wait by storing the key into the waiting
+ * register and unblocking execution.
+ */
+void chip8_set_key(uint8_t key, uint8_t pressed);
+
+/*
+ * chip8_hash_mix(x)
+ *
+ * 64-bit finalizer (splitmix64) used to derive the Zobrist keys below.
+ */
+static inline uint64_t chip8_hash_mix(uint64_t x)
+{
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+/*
+ * chip8_ram_key(address, value) / chip8_pixel_key(row, col)
+ *
+ * Zobrist keys. ram_hash is the XOR of chip8_ram_key() over every RAM
+ * byte, so writing a byte XORs out the key of the old value and XORs in
+ * the key of the new one. display_hash is the XOR of chip8_pixel_key()
+ * over the pixels that are on, so it changes by one key per toggle.
+ */
+static inline uint64_t chip8_ram_key(uint16_t address, uint8_t value)
+{
+    return chip8_hash_mix(((uint64_t)address << 8) | value);
+}
+
+static inline uint64_t chip8_pixel_key(unsigned row, unsigned col)
+{
+    return chip8_hash_mix(0x100000u + row * CHIP8_WIDTH + col);
+}
+
+/*
+ * chip8_write_ram(address, value)
+ *
+ * Stores one byte of RAM and updates ram_hash.
+ */
+void chip8_write_ram(uint16_t address, uint8_t value);
+
+/*
+ * chip8_rehash()
+ *
+ * Recomputes ram_hash and display_hash from scratch, after RAM or the
+ * display were written directly. Loading fonts and ROMs does this.
+ */
+void chip8_rehash(void);
+
+/*
+ * chip8_state_hash()
+ *
+ * Returns a 64-bit hash of the complete machine state. RAM and display,
+ * which make up almost all of the 12 KB, enter through their incremental
+ * hashes; only the small remainder (registers, I, PC, stack, timers,
+ * keypad, key wait, fault, frame position, RNG) is hashed here, so the
+ * cost does not depend on the size of the machine. Hashes are meant for
+ * deduplication within one process.
+ */
+uint64_t chip8_state_hash(void);
+
+/*
+ * chip8_fault(fault)
+ *
+ * Called by instruction handlers that detect a program error. Records
+ * the Chip8Fault, which halts the CPU, and moves the program counter
+ * back to the faulting instruction.
+ */
+void chip8_fault(uint8_t fault);
+
+/*
+ * chip8_fault_name(fault)
+ *
+ * Returns a short human-readable description of a Chip8Fault.
+ */
+const char *chip8_fault_name(uint8_t fault);
+
 #endif
@@ -0,0 +1,120 @@
+/*
+ * DEBUGGER — GDB REMOTE SERIAL PROTOCOL STUB
+ *
+ * Exposes the CHIP-8 machine to a GDB-compatible client over a local Unix
+ * socket or a TCP port bound to the loopback interface. Supported:
+ *
+ *   - Register and RAM inspection / modification (g, G, p, P, m, M)
+ *   - PC breakpoints (Z0 / Z1)
+ *   - RAM watchpoints on write, read and access (Z2 / Z3 / Z4), triggered
+ *     by the instructions that touch RAM through I: Fx55 and Fx33 write,
+ *     Fx65 and Dxyn read
+ *   - Continue, single-step and interrupt (c, s, Ctrl-C)
+ *   - Faults (see Chip8Fault) stop the machine with SIGILL for invalid
+ *     opcodes and SIGSEGV for everything else
+ *
+ * Register numbering, as advertised in the target description:
+ *
+ *   0–15  V0–VF     (8 bit)
+ *   16    I         (16 bit)
+ *   17    PC        (16 bit)
+ *   18    SP        (8 bit)
+ *   19    DT        (8 bit)
+ *   20    ST        (8 bit)
+ *
+ * ZERO COST WHEN NOT STOPPING
+ *
+ * Frontends check debugger_active once per frame. Only while it is set do
+ * they run instructions through debugger_cycle(), which checks the stop
+ * conditions before each instruction; otherwise the regular, uninstrumented
+ * processor path runs unchanged. It is set only while the machine is
+ * halted or stepping, or has breakpoints or watchpoints: a machine
+ * continued without any, or left by its client, runs at full speed, and
+ * blocks in Fx0A as usual.
+ *
+ * The socket is serviced without blocking from debugger_poll(), as long as
+ * debugger_enabled is set, so the window stays responsive while the
+ * machine is halted and a client can attach or interrupt at any time.
+ */
+
+#ifndef DEBUGGER_H
+#define DEBUGGER_H
+
+/*
+ * DEBUGGER_POLL_MS
+ *
+ * Longest a frontend may sleep on input, e.g. blocked in Fx0A, without
+ * calling debugger_poll() while debugger_enabled is set.
+ */
+#define DEBUGGER_POLL_MS 50
+
+/*
+ * debugger_enabled
+ *
+ * Non-zero once debugger_init() succeeded: debugger_poll() must be called
+ * every frame.
+ */
+extern int debugger_enabled;
+
+/*
+ * debugger_active
+ *
+ * Non-zero while something can stop the machine: it is halted (from
+ * debugger_init() until a client continues it) or stepping, or has
+ * breakpoints or watchpoints. Selects the instrumented execution path.
+ * Updated by debugger_poll().
+ */
+extern int debugger_active;
+
+/*
+ * debugger_init(endpoint)
+ *
+ * Starts listening for a client. A purely numeric `endpoint` is a TCP port
+ * on 127.0.0.1; anything else is the path of a Unix socket to create.
+ * The machine starts halted at its first instruction, so a client can set
+ * breakpoints before anything runs.
+ *
+ * Returns 0 on success, -1 on failure.
+ */
+int debugger_init(const char *endpoint);
+
+/*
+ * debugger_poll()
+ *
+ * Accepts a pending connection and handles every complete packet that
+ * has arrived, without blocking, then updates debugger_active. Call once
+ * per frame while debugger_enabled is set.
+ */
+void debugger_poll(void);
+
+/*
+ * debugger_cycle()
+ *
+ * Instrumented replacement for processor_cycle(). Checks breakpoints and
+ * watchpoints for the instruction at PC, then executes it. A PC past the
+ * end of RAM raises CHIP8_FAULT_PC_RANGE before anything is fetched.
+ *
+ * Return Value:
+ *   1 if an instruction was executed (or the CPU is blocked in Fx0A),
+ *   0 if the machine is halted and the rest of the frame must be skipped.
+ */
+int debugger_cycle(void);
+
+/*
+ * debugger_frame()
+ *
+ * Instrumented replacement for processor_frame(); processor_frame()
+ * polls the debugger and forwards here while debugger_active is set.
+ * Idle-loop fast-forward is disabled so every instruction is visible to
+ * the stop checks.
+ */
+void debugger_frame(void);
+
+/*
+ * debugger_shutdown()
+ *
+ * Closes the connection and the listening socket.
+ */
+void debugger_shutdown(void);
+
+#endif
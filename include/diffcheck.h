@@ -0,0 +1,161 @@
+/*
+ * DIFFERENTIAL CHECKER
+ *
+ * Proves that the optimized engines execute exactly what instructions.c
+ * specifies, by running each one beside a reference and comparing the
+ * complete machine state.
+ *
+ * REFERENCE
+ *
+ * The reference interpreter is processor_cycle(): fetch, one table walk
+ * (opcode_table.h) and the handler in instructions.c, one instruction at
+ * a time, with the timers ticking after every CHIP8_CYCLES_PER_FRAME
+ * cycle slots. It has no caches and no fast paths, and must
+ * stay that way.
+ *
+ * CANDIDATE ENGINES
+ *
+ *   run      — processor_run(): the batched interpreter with PC and I in
+ *              locals and the common instructions inline.
+ *   frame    — processor_frame() and processor_frames(): idle-loop
+ *              fast-forward, within and across frames, whole frames only.
+ *   lockstep — lockstep_frame(): the SIMD interpreter, whole frames only.
+ *
+ * LOCKSTEP MODE
+ *
+ * diffcheck_run() runs a machine on an engine and on the reference side
+ * by side and compares them (every field except frame_cycle, which is
+ * engine bookkeeping) after every step:
+ *
+ *   DIFFCHECK_INSTRUCTION — after every instruction (step engines only).
+ *   DIFFCHECK_BLOCK       — after every step the engine takes on its own:
+ *                           a processor_run() batch up to its next event.
+ *   DIFFCHECK_FRAME       — after every frame, or every run of frames
+ *                           for engines that run several at once.
+ *
+ * When a block or frame diverges, both machines are rewound to its start
+ * and, if the engine can step, replayed one instruction at a time to find
+ * the first diverging instruction. The report shows that instruction and
+ * both states.
+ *
+ * EXHAUSTIVE MODE
+ *
+ * diffcheck_opcodes() executes every one of the 65536 opcodes on
+ * randomized machines: random registers, I, PC, stack, timers, keypad,
+ * RAM and display, with the opcode placed at PC. Step engines run one
+ * block starting with the opcode; frame engines run one frame, with all
+ * the states of an opcode in the lanes of one lockstep group. Opcodes are
+ * spread over threads.
+ */
+
+#ifndef DIFFCHECK_H
+#define DIFFCHECK_H
+
+#include <stdio.h>
+#include "memory.h"
+
+/*
+ * DiffEngine
+ *
+ *   name    — Name used on the command line.
+ *   step    — Advances `vm` by at most `budget` cycle slots without
+ *             crossing the end of the current frame (vm->frame_cycle counts
+ *             the slots used), ticking the timers when the frame ends.
+ *             Returns the slots advanced (at least 1). NULL for engines
+ *             that only run whole frames.
+ *   frame   — Runs one frame, timers included, on `count` machines that
+ *             start at a frame boundary. Returns 0, or -1 on failure (a
+ *             message is printed). NULL to run frames with step.
+ *   frames  — Runs up to `frames` frames on one machine that starts at a
+ *             frame boundary, stopping where processor_frames() does, and
+ *             returns the number run. Used instead of frame when comparing
+ *             by frame, up to each key change; NULL for one at a time.
+ *   release — Frees what the engine keeps for the calling thread, or NULL.
+ */
+typedef struct
+{
+    const char *name;
+    unsigned int (*step)(MEMORY *vm, unsigned int budget);
+    int (*frame)(MEMORY *vms, int count);
+    unsigned int (*frames)(MEMORY *vm, unsigned int frames);
+    void (*release)(void);
+} DiffEngine;
+
+/*
+ * DiffcheckMode
+ *
+ * How often diffcheck_run() compares; see LOCKSTEP MODE above.
+ */
+typedef enum
+{
+    DIFFCHECK_INSTRUCTION,
+    DIFFCHECK_BLOCK,
+    DIFFCHECK_FRAME
+} DiffcheckMode;
+
+/*
+ * diffcheck_find_engine(name)
+ *
+ * Returns the engine called `name`, or NULL.
+ */
+const DiffEngine *diffcheck_find_engine(const char *name);
+
+/*
+ * diffcheck_engine_names()
+ *
+ * Returns the engine names separated by '|', for usage messages.
+ */
+const char *diffcheck_engine_names(void);
+
+/*
+ * diffcheck_reference_step(vm)
+ *
+ * Runs one cycle slot of `vm` on the reference interpreter: one
+ * instruction unless blocked or halted, then the timers if the slot
+ * ended the frame.
+ */
+void diffcheck_reference_step(MEMORY *vm);
+
+/*
+ * diffcheck_compare(a, b)
+ *
+ * Returns the name of the first field in which two machines differ
+ * (frame_cycle excepted), or NULL if they are identical.
+ */
+const char *diffcheck_compare(const MEMORY *a, const MEMORY *b);
+
+/*
+ * diffcheck_report(out, reference, candidate)
+ *
+ * Prints both machine states side by side, marking the fields that
+ * differ, with the first differing RAM bytes and display rows.
+ */
+void diffcheck_report(FILE *out, const MEMORY *reference, const MEMORY *candidate);
+
+/*
+ * diffcheck_run(initial, engine, mode, frames, out)
+ *
+ * Runs `initial` for `frames` frames on `engine` and on the reference in
+ * lockstep, pressing one keypad key at a time (a different one every 16
+ * frames) on both. Stops at the first divergence and reports it to `out`.
+ *
+ * Returns 0 if the machines never diverged, 1 if they did, or -1 if the
+ * mode needs single steps the engine cannot take (a message is printed).
+ */
+int diffcheck_run(const MEMORY *initial, const DiffEngine *engine, DiffcheckMode mode,
+                  unsigned long frames, FILE *out);
+
+/*
+ * diffcheck_opcodes(engine, states, threads, seed, out)
+ *
+ * Runs the exhaustive check: `states` random machines (1 to
+ * LOCKSTEP_MAX_LANES) for each of the 65536 opcodes, on `threads`
+ * threads. The first mismatches are reported to `out` in full, then a
+ * count.
+ *
+ * Returns the number of opcodes with a mismatch (0 if all match), or -1
+ * on failure (a message is printed).
+ */
+long diffcheck_opcodes(const DiffEngine *engine, int states, int threads, uint32_t seed, FILE *out);
+
+#endif
@@ -22,24 +22,8 @@
 
 #include <stdint.h>
 #include <SDL2/SDL.h>
-
-/*
- * CHIP8_WIDTH / CHIP8_HEIGHT
- *
- * Native logical dimensions of the CHIP-8 framebuffer.
- * All rendering is performed at these base dimensions before being
- * scaled to the window.
- */
-#define CHIP8_WIDTH 64
-#define CHIP8_HEIGHT 32
-
-/*
- * CHIP8_PIXEL_SCALE
- *
- * The integer scale factor applied to each CHIP-8 pixel when producing
- * the window output. A scale of 10 yields a 640×320 final render area.
- */
-#define CHIP8_PIXEL_SCALE 10
+#include "memory.h"
+#include "frontend.h"
 
 /*
  * DisplayManager
@@ -49,8 +33,9 @@
  *   window   — The top-level SDL window used for display output.
  *   renderer — SDL renderer responsible for clearing, drawing, and presenting.
  *   texture  — Streaming texture updated each frame with the current
- *               CHIP-8 pixel buffer. The texture is always created at
- *               64×32 resolution, matching the CHIP-8 display.
+ *               CHIP-8 pixel buffer. The texture is created at 64×32
+ *               resolution, matching the CHIP-8 display, and recreated
+ *               by DisplayManager_UpdateRGBA() for other sizes.
  *
  * All fields are owned and freed by DisplayManager_* routines.
  */
@@ -70,21 +55,22 @@ typedef struct
 extern DisplayManager g_displayManager;
 
 /*
- * DisplayManager_Init(title)
+ * DisplayManager_Init(title, vsync)
  *
  * Initializes the SDL video subsystem and allocates all rendering objects.
  *
  * Responsibilities:
  *   - Initializes SDL2 (video module)
  *   - Creates a window sized to CHIP-8 resolution × scale factor
- *   - Creates a renderer capable of accelerated texture operations
+ *   - Creates a renderer capable of accelerated texture operations,
+ *     synchronized to the display refresh when vsync is non-zero
  *   - Creates a streaming texture matching the logical framebuffer size
  *
  * Return Value:
  *   1 — Initialization successful
  *   0 — Error occurred (SDL failure, resource allocation error)
  */
-int DisplayManager_Init(const char *title);
+int DisplayManager_Init(const char *title, int vsync);
 
 /*
  * DisplayManager_Destroy()
@@ -109,10 +95,30 @@ void DisplayManager_Destroy();
  *   - Present the rendered frame to the screen
  *
  * This routine must be executed once per emulation cycle to synchronize
- * visual output with CPU execution.
+ * visual output with CPU execution. Time spent here and in
+ * SDL_RenderPresent() is added to metrics_frontend (see metrics.h).
  */
 void DisplayManager_Update();
 
+/*
+ * DisplayManager_UpdateRGBA(pixels, width, height)
+ *
+ * Like DisplayManager_Update(), but shows width × height RGBA8888 pixels
+ * (row-major) scaled to the window. The texture is recreated whenever the
+ * size differs from the previous frame's. Used for XO-CHIP (xochip.h).
+ */
+void DisplayManager_UpdateRGBA(const uint32_t *pixels, int width, int height);
+
+/*
+ * DisplayManager_SetOverlay(text)
+ *
+ * Sets text drawn over the top-left corner of every following frame, in
+ * a small built-in font (letters, digits and . / % : -), with '\n'
+ * starting a new line. NULL or "" removes the overlay. Used for the
+ * metrics HUD.
+ */
+void DisplayManager_SetOverlay(const char *text);
+
 /*
  * DisplayManager_ProcessInput()
  *
@@ -122,14 +128,33 @@ void DisplayManager_Update();
  *   - SDL_QUIT     → Signals emulator termination
  *   - KEYDOWN/UP   → Maps host keyboard keys to CHIP-8 keypad indices
  *
+ * Every event handled is counted in metrics_frontend.input_events.
+ *
  * Return Value:
  *   1 — Quit requested
  *   0 — Continue running
  *
  * Key Mapping:
  *   CHIP-8 expects a hexadecimal keypad (0–F). SDL keyboard keys are mapped
- *   to these indices based on widely used emulator conventions.
+ *   to these indices through the keymap lookup table (see keymap.h).
+ *   Unmapped keys may be speed hotkeys (see speed_control.h).
  */
 int DisplayManager_ProcessInput();
 
+/*
+ * DisplayManager_WaitInput(timeout_ms)
+ *
+ * Sleeps in SDL_WaitEventTimeout() until an input event arrives or the
+ * timeout expires, then processes all pending events exactly like
+ * DisplayManager_ProcessInput(). A negative timeout waits indefinitely.
+ *
+ * Used while the CPU is blocked on a key wait (Fx0A), so that the
+ * emulator consumes no CPU time between key presses and timer ticks.
+ *
+ * Return Value:
+ *   1 — Quit requested
+ *   0 — Continue running
+ */
+int DisplayManager_WaitInput(int timeout_ms);
+
 #endif
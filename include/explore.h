@@ -0,0 +1,172 @@
+/*
+ * STATE-SPACE EXPLORATION
+ *
+ * Searches the input sequences of a ROM. Starting from a root machine,
+ * every expanded state is branched once per action: the action's keypad
+ * state is held for `frames_per_step` frames (K) and the result becomes a
+ * child state. Children whose machine state has been seen before are
+ * dropped, so the search only ever expands unique states.
+ *
+ * SEARCH ORDER
+ *
+ *   - EXPLORE_BREADTH_FIRST expands states in the order they were found,
+ *     one depth level after the other.
+ *   - EXPLORE_BEST_FIRST always expands the states with the highest
+ *     score, as returned by the caller's score function.
+ *
+ * Either way, states are taken in batches and the batch is expanded by
+ * all worker threads at once. Results are merged by the calling thread in
+ * a fixed order, so a search gives the same answer for any thread count.
+ *
+ * STATE IDENTITY
+ *
+ * States are identified by chip8_state_hash(), which is maintained
+ * incrementally as RAM and display are written, and deduplicated in an
+ * open-addressing set of 64-bit hashes. Two different states colliding on
+ * all 64 bits would merge; at the state counts a search can reach, this
+ * is vanishingly unlikely.
+ *
+ * SNAPSHOTS
+ *
+ * States waiting to be expanded are stored compactly: the small machine
+ * state verbatim, the display as one bit per pixel, and only those
+ * 64-byte lines of RAM that differ from the root machine. A typical
+ * snapshot is a few hundred bytes instead of a 12 KB MEMORY. Snapshots
+ * are freed as soon as their state has been expanded; only the parent
+ * link and action of each state are kept, to rebuild input sequences.
+ */
+
+#ifndef EXPLORE_H
+#define EXPLORE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "memory.h"
+
+typedef enum
+{
+    EXPLORE_BREADTH_FIRST,
+    EXPLORE_BEST_FIRST
+} ExploreStrategy;
+
+/*
+ * ExploreScoreFn / ExploreGoalFn
+ *
+ * Called from worker threads for every new child state; they must be
+ * thread-safe and must not modify the machine.
+ *
+ *   score — Priority for EXPLORE_BEST_FIRST; higher is expanded first.
+ *   goal  — Non-zero ends the search with this state as the result.
+ */
+typedef double (*ExploreScoreFn)(const MEMORY *vm, void *user);
+typedef int (*ExploreGoalFn)(const MEMORY *vm, void *user);
+
+/*
+ * ExploreConfig
+ *
+ *   strategy        — Search order.
+ *   frames_per_step — Frames each action is held for (K; 0 means 1).
+ *   max_depth       — Steps below the root before a state is no longer
+ *                     expanded; 0 for no limit.
+ *   max_states      — Stop after this many unique states; 0 for no limit.
+ *   num_threads     — Worker threads including the caller; 0 uses one per
+ *                     online CPU.
+ *   actions         — Keypad bitmasks to branch on (bit k = key k held);
+ *                     NULL for the 16 states with a single key held.
+ *   action_count    — Number of entries in actions.
+ *   score, goal     — Optional callbacks; see above.
+ *   user            — Passed to the callbacks.
+ */
+typedef struct
+{
+    ExploreStrategy strategy;
+    int frames_per_step;
+    int max_depth;
+    unsigned long max_states;
+    int num_threads;
+    const uint16_t *actions;
+    int action_count;
+    ExploreScoreFn score;
+    ExploreGoalFn goal;
+    void *user;
+} ExploreConfig;
+
+/*
+ * ExploreStats
+ *
+ *   expanded            — States whose children were generated.
+ *   generated           — Child states run (expanded × actions).
+ *   unique              — Distinct states found, including the root.
+ *   duplicates          — Children dropped because their state was known.
+ *   faults              — New states that ended in a CPU fault; they are
+ *                         counted as unique but never expanded.
+ *   max_depth           — Deepest state found.
+ *   snapshot_bytes      — Current size of all stored snapshots.
+ *   peak_snapshot_bytes — Largest value snapshot_bytes reached.
+ *   seconds             — Time spent in explore_run().
+ */
+typedef struct
+{
+    unsigned long long expanded;
+    unsigned long long generated;
+    unsigned long long unique;
+    unsigned long long duplicates;
+    unsigned long long faults;
+    int max_depth;
+    size_t snapshot_bytes;
+    size_t peak_snapshot_bytes;
+    double seconds;
+} ExploreStats;
+
+typedef struct Explorer Explorer;
+
+/*
+ * explore_create(root, config)
+ *
+ * Creates a search starting from a copy of `root`, which should have a
+ * ROM loaded, and starts the worker threads. Returns NULL on failure (a
+ * message is printed).
+ */
+Explorer *explore_create(const MEMORY *root, const ExploreConfig *config);
+
+/*
+ * explore_run(explorer)
+ *
+ * Searches until a goal state is found, the state limit is reached, or no
+ * states within the depth limit are left to expand.
+ *
+ * Returns 1 if a goal state was found, 0 otherwise, -1 if out of memory.
+ */
+int explore_run(Explorer *explorer);
+
+/*
+ * explore_goal_path(explorer, actions, capacity)
+ *
+ * Writes the actions leading from the root to the goal state, in order,
+ * to `actions` (at most `capacity` entries). Returns the path length, or
+ * -1 if no goal was found or the path does not fit.
+ */
+int explore_goal_path(const Explorer *explorer, uint16_t *actions, int capacity);
+
+/*
+ * explore_get_stats(explorer)
+ *
+ * Returns the search counters.
+ */
+const ExploreStats *explore_get_stats(const Explorer *explorer);
+
+/*
+ * explore_report_stats(explorer, out)
+ *
+ * Prints a one-line summary including states/sec and unique states.
+ */
+void explore_report_stats(const Explorer *explorer, FILE *out);
+
+/*
+ * explore_destroy(explorer)
+ *
+ * Stops the worker threads and frees the search.
+ */
+void explore_destroy(Explorer *explorer);
+
+#endif
@@ -0,0 +1,166 @@
+/*
+ * PERSISTENT FLEET STATE
+ *
+ * Keeps the state of every session of a multi-session host (the wall,
+ * see wall_display.h) in a memory-mapped file, so that a restarted host
+ * resumes all of them where they were. Restoring a session is one copy
+ * of a MEMORY out of the mapping; nothing is serialized or parsed.
+ *
+ * LAYOUT
+ *
+ *   offset 0                    FleetStoreHeader, padded to
+ *                               FLEET_STORE_ALIGN bytes
+ *   FLEET_STORE_ALIGN + i×stride slot i: two FleetStoreCopy records, the
+ *                               stride rounded up to FLEET_STORE_ALIGN
+ *
+ * Every slot sits on its own pages, so writing back one session never
+ * touches another's. The file is only meant to be read back by a build
+ * with the same MEMORY layout and byte order; the header records enough
+ * to refuse anything else.
+ *
+ * CRASH CONSISTENCY
+ *
+ * A checkpoint of a session writes the older of its slot's two copies:
+ * first the generation number in `begin`, then the state and a checksum,
+ * then the generation in `end`. The newer copy is left intact until the
+ * next checkpoint of the session. fleet_store_sync() flushes the mapping
+ * with msync() between checkpoints.
+ *
+ * A copy counts only if `begin` and `end` match and the checksum is
+ * right: a process killed mid-copy leaves `end` behind, and a system
+ * crash during writeback can leave any mix of pages, which the checksum
+ * catches. When a slot's newest copy is torn, the session rolls back to
+ * the other one, one checkpoint older.
+ *
+ * Only the state at checkpoints is persistent: a crash loses the frames
+ * run since the last one.
+ */
+
+#ifndef FLEET_STORE_H
+#define FLEET_STORE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "memory.h"
+
+/*
+ * FLEET_STORE_MAGIC / FLEET_STORE_VERSION
+ *
+ * Identify the file layout; fleet_store_open() refuses files that differ.
+ */
+#define FLEET_STORE_MAGIC 0x544C4643u /* "CFLT" */
+#define FLEET_STORE_VERSION 1
+
+/*
+ * FLEET_STORE_ALIGN
+ *
+ * Alignment of the header size and of the slot stride: a page on common
+ * hosts, so slots are written back independently.
+ */
+#define FLEET_STORE_ALIGN 4096
+
+/*
+ * FleetStoreHeader
+ *
+ *   magic       — FLEET_STORE_MAGIC, written last when the file is created.
+ *   version     — FLEET_STORE_VERSION.
+ *   slots       — Number of sessions.
+ *   stride      — Bytes from one slot to the next.
+ *   memory_size — sizeof(MEMORY) of the build that created the file.
+ *   rom_hash    — Hash of the ROM every session runs.
+ */
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t slots;
+    uint32_t stride;
+    uint32_t memory_size;
+    uint32_t reserved;
+    uint64_t rom_hash;
+} FleetStoreHeader;
+
+/*
+ * FleetStoreCopy
+ *
+ *   begin    — Generation being written, stored first.
+ *   end      — Generation completely written, stored last. 0 for a copy
+ *              never written.
+ *   checksum — Hash of generation, frames and state.
+ *   frames   — Frames the session had run, instructions being
+ *              CHIP8_CYCLES_PER_FRAME per frame.
+ *   vm       — The session's machine state: registers, RAM, display,
+ *              timers, PRNG state and the position within the frame.
+ */
+typedef struct
+{
+    uint64_t begin;
+    uint64_t end;
+    uint64_t checksum;
+    uint64_t frames;
+    MEMORY vm;
+} FleetStoreCopy;
+
+/*
+ * FleetSlotStatus
+ *
+ * What fleet_store_load() found in a slot.
+ *
+ *   FLEET_SLOT_EMPTY       — No complete copy: never saved, or both copies
+ *                            torn. The session starts afresh.
+ *   FLEET_SLOT_LATEST      — The last checkpoint.
+ *   FLEET_SLOT_ROLLED_BACK — The last checkpoint was torn; the one before.
+ */
+typedef enum
+{
+    FLEET_SLOT_EMPTY,
+    FLEET_SLOT_LATEST,
+    FLEET_SLOT_ROLLED_BACK
+} FleetSlotStatus;
+
+typedef struct FleetStore FleetStore;
+
+/*
+ * fleet_store_open(path, slots, rom, rom_size)
+ *
+ * Maps the fleet file at `path`, creating it with `slots` empty slots if
+ * it does not exist. An existing file must have been created for the
+ * same number of sessions of the same ROM by a compatible build.
+ *
+ * Returns NULL on failure (a message is printed).
+ */
+FleetStore *fleet_store_open(const char *path, int slots, const uint8_t *rom, size_t rom_size);
+
+/*
+ * fleet_store_load(store, slot, vm, frames)
+ *
+ * Copies the newest complete copy of a slot into `vm` and `frames`. Both
+ * are left alone for FLEET_SLOT_EMPTY.
+ */
+FleetSlotStatus fleet_store_load(FleetStore *store, int slot, MEMORY *vm, uint64_t *frames);
+
+/*
+ * fleet_store_save(store, slot, vm, frames)
+ *
+ * Checkpoints a session into the older copy of its slot.
+ */
+void fleet_store_save(FleetStore *store, int slot, const MEMORY *vm, uint64_t frames);
+
+/*
+ * fleet_store_sync(store)
+ *
+ * Writes the checkpoints made so far back to the file, waiting until
+ * they are on disk.
+ *
+ * Returns 0 on success, or -1 on failure (a message is printed).
+ */
+int fleet_store_sync(FleetStore *store);
+
+/*
+ * fleet_store_close(store)
+ *
+ * Syncs and unmaps the file. NULL is ignored.
+ */
+void fleet_store_close(FleetStore *store);
+
+#endif
@@ -0,0 +1,155 @@
+/*
+ * FRAME PACER
+ *
+ * Schedules frames against exact deadlines on CLOCK_MONOTONIC and records
+ * how well those deadlines were met.
+ *
+ * Deadlines are absolute: frame N is due at start + N × period, so
+ * oversleeping one frame does not push every later frame back. Waiting is
+ * hybrid: the pacer sleeps with clock_nanosleep() until shortly before the
+ * deadline (kernel timers routinely wake late by hundreds of microseconds)
+ * and then spins on the clock for the remaining fraction of a millisecond.
+ *
+ * When presentation is already synchronized to the display (vsync), the
+ * pacer can be told not to wait at all and merely measure frame times.
+ *
+ * Statistics kept per pacer:
+ *   - Frame time of the most recent FRAME_PACER_HISTORY frames, from which
+ *     p50/p99 percentiles are computed on demand
+ *   - Maximum frame time over the whole run
+ *   - Number of missed deadlines (frames that started later than their
+ *     deadline by more than FRAME_PACER_MISS_TOLERANCE_NS)
+ */
+
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+/*
+ * FRAME_PACER_HISTORY
+ *
+ * Number of recent frame times kept for percentile computation.
+ */
+#define FRAME_PACER_HISTORY 4096
+
+/*
+ * FRAME_PACER_SPIN_NS
+ *
+ * Portion of each wait, in nanoseconds, spent spinning instead of sleeping.
+ */
+#define FRAME_PACER_SPIN_NS 500000
+
+/*
+ * FRAME_PACER_MISS_TOLERANCE_NS
+ *
+ * Lateness after which a frame is counted as a missed deadline.
+ */
+#define FRAME_PACER_MISS_TOLERANCE_NS 1000000
+
+/*
+ * FramePacer
+ *
+ *   period_ns     — Target frame period.
+ *   deadline_ns   — Absolute CLOCK_MONOTONIC time the next frame is due.
+ *   last_mark_ns  — Time of the previous frame_pacer_mark() call.
+ *   vsync         — When non-zero, frame_pacer_wait() does not sleep.
+ *   history       — Ring of recent frame times (ns).
+ *   history_next  — Next slot to overwrite in history.
+ *   frames        — Number of frame times recorded.
+ *   missed        — Number of missed deadlines.
+ *   max_ns        — Longest frame time recorded.
+ */
+typedef struct
+{
+    int64_t period_ns;
+    int64_t deadline_ns;
+    int64_t last_mark_ns;
+    int vsync;
+    uint32_t history[FRAME_PACER_HISTORY];
+    unsigned int history_next;
+    unsigned long frames;
+    unsigned long missed;
+    int64_t max_ns;
+} FramePacer;
+
+/*
+ * FramePacerStats
+ *
+ * Summary produced by frame_pacer_get_stats(). Times are in nanoseconds.
+ */
+typedef struct
+{
+    unsigned long frames;
+    unsigned long missed;
+    int64_t p50_ns;
+    int64_t p99_ns;
+    int64_t max_ns;
+} FramePacerStats;
+
+/*
+ * frame_pacer_now_ns()
+ *
+ * Current CLOCK_MONOTONIC time in nanoseconds.
+ */
+int64_t frame_pacer_now_ns(void);
+
+/*
+ * frame_pacer_sleep_ns(ns)
+ *
+ * Sleeps for approximately `ns` nanoseconds (no spinning).
+ */
+void frame_pacer_sleep_ns(int64_t ns);
+
+/*
+ * frame_pacer_init(pacer, rate_hz, vsync)
+ *
+ * Resets all statistics and schedules the first deadline one period from
+ * now. With vsync set, frame_pacer_wait() only measures.
+ */
+void frame_pacer_init(FramePacer *pacer, int rate_hz, int vsync);
+
+/*
+ * frame_pacer_wait(pacer)
+ *
+ * Blocks until the current deadline (sleep, then spin), records the frame
+ * time and advances the deadline by one period. When the deadline has
+ * already passed by more than a whole period, the schedule is re-anchored
+ * to the present instead of trying to catch up with a burst of frames.
+ */
+void frame_pacer_wait(FramePacer *pacer);
+
+/*
+ * frame_pacer_mark(pacer)
+ *
+ * Records the time since the previous mark as one frame time without
+ * waiting. Used when something other than the pacer (vsync, the audio
+ * clock) decides when frames happen.
+ */
+void frame_pacer_mark(FramePacer *pacer);
+
+/*
+ * frame_pacer_resume(pacer)
+ *
+ * Re-anchors the schedule one period from now without recording a frame
+ * or a missed deadline. Called after the frontend deliberately slept
+ * outside the pacer (e.g. while blocked on a key wait).
+ */
+void frame_pacer_resume(FramePacer *pacer);
+
+/*
+ * frame_pacer_get_stats(pacer, stats)
+ *
+ * Computes percentiles over the recorded history.
+ */
+void frame_pacer_get_stats(const FramePacer *pacer, FramePacerStats *stats);
+
+/*
+ * frame_pacer_report(pacer, out)
+ *
+ * Prints a one-line summary of the frame-time statistics.
+ */
+void frame_pacer_report(const FramePacer *pacer, FILE *out);
+
+#endif
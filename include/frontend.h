@@ -0,0 +1,158 @@
+/*
+ * FRONTEND BACKENDS
+ *
+ * The interactive emulator (main.c) shows the display, reads input and
+ * plays the beeper through a FrontendBackend: a table of functions chosen
+ * by name at startup with --frontend. The core never calls a backend; it
+ * only exposes chip8_memory.display, chip8_set_key() and the sound timer.
+ *
+ *   sdl      — SDL2 window and audio (display_manager.h, audio_manager.h).
+ *   terminal — Half-block characters on the terminal (terminal_display.h).
+ *   braille  — Braille characters on the terminal.
+ *   null     — Nothing shown, no input; for servers that only publish
+ *              state through --shm, --metrics or --gdb. wait_input never
+ *              sleeps longer than a frame, since no input can arrive.
+ *   record   — Every frame written to a Y4M or RGBA file in real time
+ *              (see capture.h), no input.
+ *
+ * Only the sdl backend and the multi-session wall (wall_display.h) need
+ * SDL. Building with CHIP8_NO_SDL (make SDL=0) leaves both out, and
+ * nothing else includes an SDL header.
+ */
+
+#ifndef FRONTEND_H
+#define FRONTEND_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "capture.h"
+
+/*
+ * CHIP8_PIXEL_SCALE
+ *
+ * The integer scale factor applied to each CHIP-8 pixel when producing
+ * the window output. A scale of 10 yields a 640×320 final render area.
+ * Also the default scale of captures and recordings.
+ */
+#define CHIP8_PIXEL_SCALE 10
+
+/*
+ * AudioConfig
+ *
+ *   driver         — SDL audio driver name (e.g. "dummy", "disk"), or NULL
+ *                    to let SDL choose.
+ *   sample_rate    — Output sample rate in Hz.
+ *   buffer_samples — SDL device buffer size in samples (power of two).
+ *   latency_ms     — Target amount of queued audio, in milliseconds.
+ *   tone_hz        — Frequency of the beeper square wave.
+ *   sync_to_audio  — When non-zero, the frontend paces emulation by the
+ *                    audio device clock (see audio_frame_due).
+ */
+typedef struct
+{
+    const char *driver;
+    int sample_rate;
+    int buffer_samples;
+    int latency_ms;
+    int tone_hz;
+    int sync_to_audio;
+} AudioConfig;
+
+/*
+ * FrontendConfig
+ *
+ *   title         — Window title.
+ *   vsync         — Present in sync with the display refresh.
+ *   audio_enabled — Play the beeper, if the backend can.
+ *   audio         — Audio settings.
+ *   record        — Output path, format and scale of the record backend
+ *                   (frames is ignored).
+ */
+typedef struct
+{
+    const char *title;
+    int vsync;
+    int audio_enabled;
+    AudioConfig audio;
+    CaptureConfig record;
+} FrontendConfig;
+
+/*
+ * Frontend flags
+ *
+ *   FRONTEND_EVERY_FRAME — present() wants every frame, including those in
+ *                          which the display cannot have changed (blocked
+ *                          in Fx0A), so recordings keep real-time pacing.
+ *   FRONTEND_TERMINAL    — The backend draws on the terminal; messages for
+ *                          the user go to set_overlay() instead of stderr.
+ */
+#define FRONTEND_EVERY_FRAME 0x1
+#define FRONTEND_TERMINAL 0x2
+
+/*
+ * FrontendBackend
+ *
+ *   name            — Name given to --frontend.
+ *   flags           — FRONTEND_* bits.
+ *   init            — Opens the output (and audio); 0 on success, -1 on
+ *                     failure with a message printed.
+ *   present         — Shows chip8_memory.display.
+ *   set_overlay     — Sets a line of text shown with the display (the
+ *                     metrics HUD); NULL or "" clears it.
+ *   poll_input      — Handles pending input without blocking; 1 if quit
+ *                     was requested, 0 otherwise.
+ *   wait_input      — Sleeps until input or the timeout (negative waits
+ *                     indefinitely), then handles it like poll_input.
+ *   queue_audio     — Queues the beeper state for one instruction slot.
+ *   audio_frame_due — 1 when another frame should be emulated to keep the
+ *                     audio queue filled, 0 if not yet, -1 when no audio
+ *                     is playing.
+ *   destroy         — Closes everything init opened and prints a summary.
+ *
+ * Backends that can run XO-CHIP programs (xochip.h) also provide
+ *
+ *   present_rgba      — Shows width × height RGBA8888 pixels instead of
+ *                       chip8_memory.display.
+ *   audio_sample_rate — The output sample rate, 0 when no audio is playing.
+ *   queue_wave        — Queues output samples of +1, -1 or 0 (silence).
+ *
+ * and leave them NULL otherwise.
+ */
+typedef struct
+{
+    const char *name;
+    int flags;
+    int (*init)(const FrontendConfig *config);
+    void (*present)(void);
+    void (*set_overlay)(const char *text);
+    int (*poll_input)(void);
+    int (*wait_input)(int timeout_ms);
+    void (*queue_audio)(int tone_on);
+    int (*audio_frame_due)(void);
+    void (*destroy)(void);
+    void (*present_rgba)(const uint32_t *pixels, int width, int height);
+    int (*audio_sample_rate)(void);
+    void (*queue_wave)(const int8_t *levels, size_t count);
+} FrontendBackend;
+
+#ifndef CHIP8_NO_SDL
+extern const FrontendBackend frontend_sdl;
+#endif
+
+/*
+ * frontend_find(name)
+ *
+ * Returns the backend called `name`, or the default backend for NULL
+ * (sdl, or terminal without SDL). Returns NULL for an unknown name.
+ */
+const FrontendBackend *frontend_find(const char *name);
+
+/*
+ * frontend_names()
+ *
+ * Returns the names of the available backends, separated by '|', for
+ * usage messages.
+ */
+const char *frontend_names(void);
+
+#endif
@@ -41,6 +41,8 @@ void OP_00E0();
  * subroutine call. We pop this address from the stack and
  * restore it into the program counter. This replaces the
  * preemptive `pc += 2` increment performed earlier.
+ *
+ * Raises CHIP8_FAULT_STACK_UNDERFLOW if the stack is empty.
  */
 void OP_00EE();
 
@@ -68,6 +70,8 @@ void OP_1nnn();
  * following this CALL. Returning to the CALL itself would cause
  * an infinite loop of CALLs and RETs, so preserving the
  * incremented PC is essential for proper control flow.
+ *
+ * Raises CHIP8_FAULT_STACK_OVERFLOW if all 16 stack slots are in use.
  */
 void OP_2nnn();
 
@@ -295,6 +299,8 @@ void OP_Cxkk();
  * cleared to 0 when no such collisions occur. The screen pixels are
  * updated using XOR drawing semantics, typically by XORing with
  * 0xFFFFFFFF for "on" pixels in a 32-bit video buffer.
+ *
+ * Raises CHIP8_FAULT_MEMORY_RANGE if the sprite extends past the end of RAM.
  */
 void OP_Dxyn();
 
@@ -308,6 +314,8 @@ void OP_Dxyn();
  * in processor_cycle(), skipping the next instruction is done by adding an
  * additional 2 to the PC when the key is detected as pressed.
  * This allows conditional flow control based on user input.
+ *
+ * Raises CHIP8_FAULT_KEY_RANGE if Vx is not a valid key (0–F).
  */
 void OP_Ex9E();
 
@@ -321,6 +329,8 @@ void OP_Ex9E();
  * processor_cycle(), skipping the next instruction is accomplished by adding
  * an additional 2 to the PC when the key is not pressed. This enables
  * conditional branching based on the absence of user input.
+ *
+ * Raises CHIP8_FAULT_KEY_RANGE if Vx is not a valid key (0–F).
  */
 void OP_ExA1();
 
@@ -341,11 +351,11 @@ void OP_Fx07();
  * Waits for a key press and stores the value of the pressed key into Vx.
  *
  * This is a blocking instruction: execution should pause until the user
- * presses a key. The typical implementation achieves this by repeating
- * the same opcode until a key is detected—done by subtracting 2 from the
- * program counter when no key is pressed, causing the instruction to run
- * again on the next cycle. Once a key is pressed, its value is stored in Vx,
- * and execution continues normally.
+ * presses a key. If a key is already held, its value is stored in Vx
+ * immediately. Otherwise, rather than re-executing the opcode every cycle,
+ * the CPU enters a blocked state (waiting_for_key) and fetches nothing
+ * until chip8_set_key() reports a press, which stores the key in Vx and
+ * lets execution continue with the following instruction.
  */
 void OP_Fx0A();
 
@@ -410,6 +420,8 @@ void OP_Fx29();
  * the remainder modulo 10 to extract the right-most digit, then dividing
  * by 10 to shift the number right. Only integer values are stored, and
  * the original value of Vx is not modified.
+ *
+ * Raises CHIP8_FAULT_MEMORY_RANGE if I + 2 is past the end of RAM.
  */
 void OP_Fx33();
 
@@ -423,6 +435,8 @@ void OP_Fx33();
  * V2 to I+2, and so on until Vx is stored. The index register I may or
  * may not be incremented after the transfer depending on the interpreter
  * variant, but in the original CHIP-8 specification, I remains unchanged.
+ *
+ * Raises CHIP8_FAULT_MEMORY_RANGE if I + x is past the end of RAM.
  */
 void OP_Fx55();
 
@@ -437,6 +451,8 @@ void OP_Fx55();
  * As with Fx55, the original CHIP-8 specification leaves the index
  * register I unchanged after the transfer, though some later variants
  * increment it.
+ *
+ * Raises CHIP8_FAULT_MEMORY_RANGE if I + x is past the end of RAM.
  */
 void OP_Fx65();
 
@@ -0,0 +1,48 @@
+/*
+ * KEYMAP
+ *
+ * Maps host keys to the 16 keys of the CHIP-8 keypad for every frontend
+ * (SDL window, terminal). A layout is a string of 16 characters, the host
+ * key for each keypad key 0–F in order. The default is the widely used
+ * left-hand block:
+ *
+ *     1 2 3 4        1 2 3 C
+ *     Q W E R   →    4 5 6 D
+ *     A S D F        7 8 9 E
+ *     Z X C V        A 0 B F
+ *
+ * Lookups go through a 256-entry table indexed by the host key code, so
+ * a key event costs one load. Host key codes are characters: SDL keycodes
+ * for letters and digits are their lowercase ASCII codes, and terminals
+ * send the characters themselves. Letters match in either case.
+ */
+
+#ifndef KEYMAP_H
+#define KEYMAP_H
+
+/*
+ * KEYMAP_DEFAULT
+ *
+ * Host keys for keypad keys 0–F in the default layout.
+ */
+#define KEYMAP_DEFAULT "x123qweasdzc4rfv"
+
+/*
+ * keymap_set(keys)
+ *
+ * Switches to a layout of 16 distinct printable characters.
+ *
+ * Returns 0 on success, or -1 if the layout is invalid (a message is
+ * printed and the current layout is kept).
+ */
+int keymap_set(const char *keys);
+
+/*
+ * keymap_lookup(host_key)
+ *
+ * Returns the keypad key (0–15) mapped to a host key code, or -1 if the
+ * key is not mapped.
+ */
+int keymap_lookup(int host_key);
+
+#endif
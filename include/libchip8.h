@@ -0,0 +1,141 @@
+/*
+ * LIBCHIP8 EMBEDDING API
+ *
+ * Entry point for programs that link the core as a library (libchip8.a or
+ * libchip8.so, see `make lib`) instead of running the chip8 executable.
+ * The library contains no SDL code, and neither this header nor anything
+ * it includes pulls in SDL.
+ *
+ * Each Chip8Machine owns a complete MEMORY. Every call points the calling
+ * thread's chip8_vm at that machine for its duration and restores it on
+ * return, so any number of machines can be driven from any number of
+ * threads, as long as one machine is used by one thread at a time.
+ *
+ * ROMs are loaded from memory; the library never touches the file system.
+ *
+ * TIMING
+ *
+ * The core runs CHIP8_CYCLES_PER_FRAME cycles per 60 Hz frame, and the
+ * delay and sound timers tick once per frame. libchip8_run_cycles() keeps
+ * track of where it stopped inside a frame, so running 3 + 7 cycles is the
+ * same as running one frame. A blocked (Fx0A) or faulted CPU still uses
+ * up its cycles: time passes and the timers keep running.
+ */
+
+#ifndef LIBCHIP8_H
+#define LIBCHIP8_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "memory.h"
+
+typedef struct Chip8Machine Chip8Machine;
+
+/*
+ * LIBCHIP8_STOPPED
+ *
+ * Returned by libchip8_run_cycles() instead of a Chip8Fault when an
+ * attached debugger (debugger.h) stopped the machine.
+ */
+#define LIBCHIP8_STOPPED (-1)
+
+/*
+ * libchip8_create(seed)
+ *
+ * Allocates and initializes a machine whose random-number generator
+ * starts from `seed`. The machine holds no program until a ROM is loaded.
+ * Returns NULL if out of memory.
+ */
+Chip8Machine *libchip8_create(uint32_t seed);
+
+/*
+ * libchip8_destroy(machine)
+ *
+ * Frees the machine. NULL is ignored.
+ */
+void libchip8_destroy(Chip8Machine *machine);
+
+/*
+ * libchip8_load_rom(machine, data, size)
+ *
+ * Resets the machine and loads the `size`-byte ROM image at `data` to
+ * 0x200. The image is copied, so `data` may be freed afterwards.
+ * Returns 0 on success, or -1 if the image does not fit in memory.
+ */
+int libchip8_load_rom(Chip8Machine *machine, const uint8_t *data, size_t size);
+
+/*
+ * libchip8_reset(machine)
+ *
+ * Restores the state right after the last libchip8_load_rom(), including
+ * the random-number generator, so a reset machine replays identically.
+ */
+void libchip8_reset(Chip8Machine *machine);
+
+/*
+ * libchip8_run_cycles(machine, cycles)
+ *
+ * Runs `cycles` CPU cycles, ticking the timers at every frame boundary.
+ * Returns the machine's Chip8Fault (CHIP8_FAULT_NONE while running), or
+ * LIBCHIP8_STOPPED if the debugger stopped the machine first; the cycles
+ * not run are dropped.
+ */
+int libchip8_run_cycles(Chip8Machine *machine, unsigned long cycles);
+
+/*
+ * libchip8_run_frames(machine, frames)
+ *
+ * Runs `frames` whole 60 Hz frames (after completing a frame left
+ * partially run by libchip8_run_cycles()). Returns the machine's
+ * Chip8Fault.
+ */
+int libchip8_run_frames(Chip8Machine *machine, unsigned long frames);
+
+/*
+ * libchip8_set_key(machine, key, pressed)
+ *
+ * Presses or releases keypad key `key` (0–F). See chip8_set_key().
+ */
+void libchip8_set_key(Chip8Machine *machine, uint8_t key, uint8_t pressed);
+
+/*
+ * libchip8_set_keypad(machine, keys)
+ *
+ * Sets all 16 keys at once; bit k of `keys` is key k.
+ */
+void libchip8_set_keypad(Chip8Machine *machine, uint16_t keys);
+
+/*
+ * libchip8_framebuffer(machine)
+ *
+ * Returns the CHIP8_HEIGHT × CHIP8_WIDTH display, row-major, one uint32_t
+ * per pixel (zero when off). The pointer stays valid until the machine is
+ * destroyed and always shows the current frame.
+ */
+const uint32_t *libchip8_framebuffer(const Chip8Machine *machine);
+
+/*
+ * libchip8_sound_active(machine)
+ *
+ * Returns non-zero while the sound timer is running (the beep is on).
+ */
+int libchip8_sound_active(const Chip8Machine *machine);
+
+/*
+ * libchip8_hash(machine)
+ *
+ * Returns a 64-bit FNV-1a hash of the complete machine state: registers,
+ * RAM, stack, timers, keypad, key wait, fault, RNG and display, plus the
+ * position inside the current frame. Equal machines hash equally on every
+ * platform, so hashes can be compared across processes.
+ */
+uint64_t libchip8_hash(const Chip8Machine *machine);
+
+/*
+ * libchip8_state(machine)
+ *
+ * Returns the machine's MEMORY for direct inspection or modification.
+ */
+MEMORY *libchip8_state(Chip8Machine *machine);
+
+#endif
@@ -0,0 +1,143 @@
+/*
+ * LOCKSTEP SIMD INTERPRETER
+ *
+ * Runs up to LOCKSTEP_MAX_LANES machines of the same ROM together, one
+ * machine per vector lane. The hot state (V0–VF, I, PC, the stack and
+ * its pointer, timers) is kept in structure-of-arrays form, one vector
+ * per register, while RAM, the keypad and the display stay in a MEMORY
+ * per lane.
+ *
+ * EXECUTION
+ *
+ * Each step picks the lowest PC among the lanes that still have cycles
+ * left in the current frame and executes that one decoded opcode for
+ * every lane sitting at the same PC, under a lane mask:
+ *
+ *   - Register, immediate, skip, jump, call, return and timer
+ *     instructions (00EE, 1nnn–9xy0, Annn, Bnnn, 8xy?,
+ *     Fx07/15/18/1E/29) are vector operations.
+ *   - Ex9E/ExA1 and Fx33/55/65 run per lane straight from the register
+ *     vectors, as keypad reads and RAM loads and stores.
+ *   - Everything else that touches per-lane state (CLS, RND, DRW, Fx0A)
+ *     runs the regular handler once per active lane, copying only the
+ *     registers that handler uses in and out of the lane's MEMORY.
+ *
+ * While every lane that can run sits at the same PC, and the opcodes
+ * executed keep it that way (no skip or key test taken by only some
+ * lanes, no Bnnn), the next PC is read from one lane instead of being
+ * searched for.
+ *
+ * Lanes whose PCs diverge simply wait while another group executes;
+ * always running the lowest PC first lets the leading lanes be caught up
+ * at the next common address, where they merge again. Each lane
+ * executes exactly CHIP8_CYCLES_PER_FRAME instructions per frame, so
+ * its final state is the same as running it alone with processor_cycle()
+ * (idle-loop fast-forward is not needed: it never changes the result).
+ *
+ * Lanes are assumed to run the same code. Lanes loaded with differing
+ * RAM, and any RAM written at run time by Fx33/Fx55, mark 64-byte lines
+ * as possibly different; opcodes fetched from such lines are compared
+ * lane by lane before they are shared.
+ *
+ * The vector code uses GCC vector extensions, with the vectors sized 8,
+ * 16 or 32 lanes to the smallest that holds the group. On x86-64 Linux
+ * the frame function is built for AVX2 and for baseline SSE2, and the
+ * best version is selected at load time.
+ */
+
+#ifndef LOCKSTEP_H
+#define LOCKSTEP_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "memory.h"
+
+/*
+ * LOCKSTEP_MAX_LANES
+ *
+ * Largest group size. Groups of up to 8 or 16 machines run on 8- or
+ * 16-lane vectors; lanes beyond the group's size stay disabled.
+ */
+#define LOCKSTEP_MAX_LANES 32
+
+/*
+ * LockstepStats
+ *
+ *   frames            — Frames run.
+ *   steps             — Opcodes issued (each across one or more lanes).
+ *   lane_instructions — Instructions executed, summed over lanes.
+ *   scalar_calls      — Per-lane handler calls for non-vector opcodes.
+ *   divergent_fetches — Steps whose opcode had to be compared per lane.
+ *
+ * Lane utilisation is lane_instructions / (steps × lanes).
+ */
+typedef struct
+{
+    unsigned long long frames;
+    unsigned long long steps;
+    unsigned long long lane_instructions;
+    unsigned long long scalar_calls;
+    unsigned long long divergent_fetches;
+} LockstepStats;
+
+typedef struct LockstepGroup LockstepGroup;
+
+/*
+ * lockstep_create(lanes)
+ *
+ * Allocates a group of `lanes` (1–LOCKSTEP_MAX_LANES) machines. Every
+ * lane starts zeroed and halted until loaded. Returns NULL on failure.
+ */
+LockstepGroup *lockstep_create(int lanes);
+
+/*
+ * lockstep_load(group, lane, vm)
+ *
+ * Copies the machine state `vm` into `lane`.
+ */
+void lockstep_load(LockstepGroup *group, int lane, const MEMORY *vm);
+
+/*
+ * lockstep_store(group, lane, vm)
+ *
+ * Copies the current machine state of `lane` out to `vm`.
+ */
+void lockstep_store(const LockstepGroup *group, int lane, MEMORY *vm);
+
+/*
+ * lockstep_set_key(group, lane, key, pressed)
+ *
+ * chip8_set_key() for one lane.
+ */
+void lockstep_set_key(LockstepGroup *group, int lane, uint8_t key, uint8_t pressed);
+
+/*
+ * lockstep_frame(group)
+ *
+ * Runs one 60 Hz frame on every lane: CHIP8_CYCLES_PER_FRAME cycles
+ * followed by a timer update, as processor_frame() does for one machine.
+ */
+void lockstep_frame(LockstepGroup *group);
+
+/*
+ * lockstep_get_stats(group)
+ *
+ * Returns the group's counters.
+ */
+const LockstepStats *lockstep_get_stats(const LockstepGroup *group);
+
+/*
+ * lockstep_report_stats(group, out)
+ *
+ * Prints a one-line summary including lane utilisation.
+ */
+void lockstep_report_stats(const LockstepGroup *group, FILE *out);
+
+/*
+ * lockstep_destroy(group)
+ *
+ * Frees the group.
+ */
+void lockstep_destroy(LockstepGroup *group);
+
+#endif
@@ -49,6 +49,43 @@
  */
 #define START_ADDRESS 0x200
 
+/*
+ * CHIP8_WIDTH / CHIP8_HEIGHT
+ *
+ * Native logical dimensions of the CHIP-8 framebuffer.
+ * All rendering is performed at these base dimensions before being
+ * scaled to the output (window, video capture, ...).
+ */
+#define CHIP8_WIDTH 64
+#define CHIP8_HEIGHT 32
+
+/*
+ * Chip8Fault
+ *
+ * Reasons the CPU can stop on a program error. Every access the program
+ * could steer out of bounds is checked and turned into one of these
+ * instead of touching memory outside the machine:
+ *
+ *   CHIP8_FAULT_STACK_OVERFLOW  — 2nnn with all 16 stack slots in use.
+ *   CHIP8_FAULT_STACK_UNDERFLOW — 00EE with an empty stack.
+ *   CHIP8_FAULT_MEMORY_RANGE    — Dxyn, Fx33, Fx55 or Fx65 accessing RAM
+ *                                 past 0xFFF through I.
+ *   CHIP8_FAULT_PC_RANGE        — Instruction fetch past 0xFFF.
+ *   CHIP8_FAULT_KEY_RANGE       — Ex9E / ExA1 with Vx greater than 0xF.
+ *   CHIP8_FAULT_INVALID_OPCODE  — Opcode without a handler.
+ */
+typedef enum
+{
+    CHIP8_FAULT_NONE = 0,
+    CHIP8_FAULT_STACK_OVERFLOW,
+    CHIP8_FAULT_STACK_UNDERFLOW,
+    CHIP8_FAULT_MEMORY_RANGE,
+    CHIP8_FAULT_PC_RANGE,
+    CHIP8_FAULT_KEY_RANGE,
+    CHIP8_FAULT_INVALID_OPCODE,
+    CHIP8_FAULT_COUNT
+} Chip8Fault;
+
 /*
  * MEMORY
  *
@@ -79,6 +116,31 @@
  *   - Logical state of the 16 hexadecimal keypad keys.
  *   - Keys map to: 0–F.
  *
+ * waiting_for_key / key_register
+ *   - Set by Fx0A when no key is held. While waiting_for_key is non-zero
+ *     the CPU is blocked: no instructions are fetched, only the timers
+ *     keep running. The next key press (see chip8_set_key()) stores the
+ *     key index into V[key_register] and unblocks the CPU.
+ *
+ * fault
+ *   - A Chip8Fault. Once non-zero the CPU is halted for good; the program
+ *     counter points at the faulting instruction.
+ *
+ * frame_cycle
+ *   - Cycle slots of the current 60 Hz frame already used by
+ *     processor_run(); 0 at every frame boundary. processor_frame() runs
+ *     whole frames and leaves it alone.
+ *
+ * rng_state
+ *   - State of the generator behind Cxkk. Kept with the machine so that
+ *     a copied snapshot replays the same random numbers.
+ *
+ * ram_hash / display_hash
+ *   - Zobrist hashes of ram and display, kept up to date by every
+ *     instruction that writes them (see chip8_state_hash()). Code that
+ *     writes ram or display directly must call chip8_rehash() before
+ *     relying on them.
+ *
  * display[32][64]
  *   - 64×32 monochrome display buffer.
  *   - Each pixel is represented as a 32-bit value (ARGB/RGBA depending on renderer).
@@ -94,7 +156,14 @@ typedef struct
     uint8_t delay_timer;
     uint8_t sound_timer;
     uint8_t keypad[16];
-    uint32_t display[32][64];
+    uint8_t waiting_for_key;
+    uint8_t key_register;
+    uint8_t fault;
+    uint8_t frame_cycle;
+    uint32_t rng_state;
+    uint64_t ram_hash;
+    uint64_t display_hash;
+    uint32_t display[CHIP8_HEIGHT][CHIP8_WIDTH];
 } MEMORY;
 
 #endif
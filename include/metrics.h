@@ -0,0 +1,172 @@
+/*
+ * RUNTIME METRICS
+ *
+ * Live numbers for the interactive frontend, built from counters that are
+ * always maintained and cost a few additions per frame:
+ *
+ *   - processor_stats (processor.h): frames, instructions executed,
+ *     Dxyn calls and pixels drawn
+ *   - metrics_frontend (below): time spent in DisplayManager_Update() and
+ *     in SDL_RenderPresent(), and input events handled
+ *
+ * Once per second metrics_frame() turns the change in those counters into
+ * a MetricsSample (rates and per-frame averages). The sample can be
+ * exported three ways, each optional:
+ *
+ *   - Prometheus text exposition on a loopback TCP port or a Unix socket,
+ *     answering any HTTP request with the current counters and the last
+ *     sample's gauges
+ *   - a stats line on stderr after every sample
+ *   - an on-screen HUD, formatted by metrics_format_hud() for
+ *     DisplayManager_SetOverlay()
+ *
+ * A frontend that sleeps on input instead of running frames, e.g. blocked
+ * in Fx0A, bounds its sleep with metrics_wait_ms() and calls
+ * metrics_poll() after each wake, so requests are still answered and
+ * samples still taken while the machine is idle.
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * METRICS_INTERVAL_NS
+ *
+ * Time between two samples.
+ */
+#define METRICS_INTERVAL_NS 1000000000LL
+
+/*
+ * METRICS_POLL_MS
+ *
+ * Longest a Prometheus request waits while the frontend sleeps on input.
+ */
+#define METRICS_POLL_MS 50
+
+/*
+ * FrontendCounters
+ *
+ *   display_updates   — Calls to DisplayManager_Update().
+ *   display_update_ns — Total time spent in DisplayManager_Update().
+ *   present_ns        — Part of that spent in SDL_RenderPresent().
+ *   input_events      — Input events handled by the display manager.
+ */
+typedef struct
+{
+    unsigned long long display_updates;
+    int64_t display_update_ns;
+    int64_t present_ns;
+    unsigned long long input_events;
+} FrontendCounters;
+
+/*
+ * metrics_frontend
+ *
+ * Counters updated by the display manager.
+ */
+extern FrontendCounters metrics_frontend;
+
+/*
+ * MetricsConfig
+ *
+ *   endpoint — Loopback TCP port number or Unix socket path to serve
+ *              Prometheus text on; NULL for none.
+ *   log      — Print a stats line to stderr after every sample.
+ *   hud      — The frontend shows every sample with metrics_format_hud().
+ */
+typedef struct
+{
+    const char *endpoint;
+    int log;
+    int hud;
+} MetricsConfig;
+
+/*
+ * MetricsSample
+ *
+ * Rates over the last interval:
+ *
+ *   seconds                — Length of the interval.
+ *   fps                    — Frames emulated per second.
+ *   speed                  — Achieved speed multiplier (fps relative to
+ *                            CHIP8_FRAME_RATE); see speed_control.h.
+ *   ips                    — Instructions executed per second.
+ *   target_ips             — Instructions per second at full speed.
+ *   instructions_per_frame — Average instructions per frame.
+ *   draw_calls_per_frame   — Average Dxyn calls per frame.
+ *   pixels_per_frame       — Average pixels drawn per frame.
+ *   update_ms              — Average DisplayManager_Update() time.
+ *   present_ms             — Average SDL_RenderPresent() time.
+ *   input_events_per_sec   — Input events handled per second.
+ */
+typedef struct
+{
+    double seconds;
+    double fps;
+    double speed;
+    double ips;
+    double target_ips;
+    double instructions_per_frame;
+    double draw_calls_per_frame;
+    double pixels_per_frame;
+    double update_ms;
+    double present_ms;
+    double input_events_per_sec;
+} MetricsSample;
+
+/*
+ * metrics_init(config)
+ *
+ * Starts the sampling interval and, if requested, the Prometheus
+ * endpoint. Returns 0 on success, or -1 if the socket could not be opened.
+ */
+int metrics_init(const MetricsConfig *config);
+
+/*
+ * metrics_frame()
+ *
+ * Call once per frame. Answers pending Prometheus requests without
+ * blocking and takes a sample when the interval has elapsed.
+ *
+ * Returns the new sample, or NULL if none was taken this frame.
+ */
+const MetricsSample *metrics_frame(void);
+
+/*
+ * metrics_wait_ms(idle)
+ *
+ * Longest the frontend may sleep on input before metrics need it again:
+ * METRICS_POLL_MS while the Prometheus endpoint is open, and, when `idle`
+ * (no frame will run until input arrives), the time left until the next
+ * sample is due, 0 if it already is. Samples only count when something
+ * consumes them: the endpoint, the stats line or the HUD.
+ *
+ * Returns -1 when there is no limit.
+ */
+int metrics_wait_ms(int idle);
+
+/*
+ * metrics_poll()
+ *
+ * Answers pending Prometheus requests without blocking or sampling.
+ */
+void metrics_poll(void);
+
+/*
+ * metrics_format_hud(sample, text, size)
+ *
+ * Formats a sample as a few short lines of text for the on-screen HUD.
+ */
+void metrics_format_hud(const MetricsSample *sample, char *text, size_t size);
+
+/*
+ * metrics_shutdown()
+ *
+ * Closes the Prometheus endpoint and its connections.
+ */
+void metrics_shutdown(void);
+
+#endif
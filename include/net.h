@@ -0,0 +1,47 @@
+/*
+ * LISTENING SOCKETS
+ *
+ * The debugger (debugger.h), the frame stream (stream.h) and the metrics
+ * endpoint (metrics.h) all serve on an endpoint given on the command
+ * line: a decimal port number listens on loopback TCP, anything else is
+ * the path of a Unix domain socket. This module opens and closes those
+ * listeners; each server accepts and talks to its own clients.
+ *
+ * Not supported on Windows: net_listen() prints an error and fails.
+ */
+
+#ifndef NET_H
+#define NET_H
+
+/*
+ * NET_PATH_SIZE
+ *
+ * Size of the buffer receiving a Unix socket path; at least as large as
+ * sun_path on every supported host.
+ */
+#define NET_PATH_SIZE 108
+
+/*
+ * net_listen(endpoint, name, backlog, unix_path)
+ *
+ * Opens a non-blocking listening socket on `endpoint`, on 127.0.0.1 for
+ * a port number. A socket left behind at a Unix path by a previous run is
+ * removed first; any other file there makes the call fail. The path is
+ * copied to `unix_path` so net_close() can remove it; for TCP the buffer
+ * is set to an empty string. `name` ("debugger", "stream", ...) only
+ * appears in error messages.
+ *
+ * Returns the listening descriptor, or -1 on failure (a message is
+ * printed).
+ */
+int net_listen(const char *endpoint, const char *name, int backlog, char unix_path[NET_PATH_SIZE]);
+
+/*
+ * net_close(fd, unix_path)
+ *
+ * Closes a listener opened by net_listen() and removes its Unix socket,
+ * if any, clearing `unix_path`. A negative `fd` is ignored.
+ */
+void net_close(int fd, char unix_path[NET_PATH_SIZE]);
+
+#endif
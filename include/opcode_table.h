@@ -11,7 +11,7 @@
  *
  * STRUCTURE:
  *   - mainTable[16]     — Dispatches based on the highest nibble (0xF000 >> 12)
- *   - table0[16]        — Handles 0x0*** opcodes differentiated by lowest nibble
+ *   - table0[16]        — Handles 00E0 / 00EE; any other 0nnn is an invalid opcode
  *   - table8[16]        — Handles 0x8xy? opcodes (bitwise/arithmetic instructions)
  *   - tableE[16]        — Handles Ex9E / ExA1 opcodes based on lowest nibble
  *   - tableF[0x100]     — Handles all Fx** opcodes (full low byte indexing)
@@ -29,7 +29,7 @@
  * opcode
  *
  * Holds the 16-bit instruction currently being executed.
- * This global variable is assigned during the fetch phase inside processor_cycle().
+ * This per-thread variable is assigned during the fetch phase inside processor_cycle().
  *
  * Access Patterns:
  *   - Instruction handlers read fields directly by masking/shifting
@@ -39,7 +39,7 @@
  *   High nibble → (opcode & 0xF000) >> 12
  *   Low byte    → (opcode & 0x00FF)
  */
-extern uint16_t opcode;
+extern _Thread_local uint16_t opcode;
 
 /*
  * ot_init()
@@ -47,7 +47,8 @@ extern uint16_t opcode;
  * Initializes the opcode dispatch system.
  *
  * Responsibilities:
- *   - Clears all dispatch tables and sets unimplemented entries to OP_NULL
+ *   - Clears all dispatch tables and sets unimplemented entries to OP_NULL,
+ *     which raises CHIP8_FAULT_INVALID_OPCODE
  *   - Assigns opcode groups (0, 8, E, F) to appropriate sub-tables
  *   - Populates each table based on the CHIP-8 specification
  *   - Ensures every valid opcode has an associated function pointer
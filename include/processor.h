@@ -1,17 +1,113 @@
 /*
  * CHIP-8 Processor Interface
  *
- * This header declares the CPU execution entry point for the CHIP-8 emulator.
- * It exposes a single function, processor_cycle(), responsible for performing
- * one full fetch–decode–execute step and updating system timers. All CPU state
- * (registers, memory, stack, timers) resides in chip8_memory.
+ * This header declares the CPU execution entry points for the CHIP-8 emulator.
+ * processor_cycle() performs one full fetch–decode–execute step, while
+ * processor_update_timers() advances the 60 Hz delay and sound timers and
+ * processor_frame() combines both into one emulated 60 Hz frame. All CPU
+ * state (registers, memory, stack, timers) resides in chip8_memory.
+ *
+ * IDLE-LOOP FAST-FORWARD
+ *
+ * Many programs busy-wait on the delay timer or the keypad with short
+ * loops such as:
+ *
+ *     L: Fx07        ; Vx = DT
+ *        3x00        ; skip next if Vx == 0
+ *        1nnn (L)    ; jump back to L
+ *
+ * Within one frame, neither the timers nor the keypad change, so once such
+ * a loop has completed one iteration without side effects and returned to
+ * its start with identical registers and I, every further iteration in the
+ * same frame is guaranteed to repeat it exactly. processor_run() detects
+ * this at backward 1nnn jumps and skips the whole iterations that would
+ * fit in the rest of the frame (or of the budget), jumping straight to the
+ * next timer tick (or input poll). Only whole iterations are skipped, so
+ * the machine state at the end of the frame is identical to executing
+ * every instruction.
+ *
+ * processor_frames() also skips across frame ends. An iteration of the
+ * loop is replayed to see what it does with the timers:
+ *
+ *   - A loop that never reads DT (e.g. polling the keypad with Ex9E)
+ *     repeats until the keypad changes.
+ *   - A loop whose only use of DT is loading it with Fx07 into registers
+ *     that 3xkk/4xkk compare, as above, repeats unchanged until DT comes
+ *     down to the first value a test reacts to: 30 frames at DT = 30 and
+ *     3x00. The registers are left holding what the last skipped Fx07
+ *     read.
+ *
+ * The frame ends skipped over only tick the timers, in bulk, stopping
+ * short of the one where the sound timer runs out. A CPU blocked in Fx0A
+ * (or faulted) is skipped the same way, frames at a time, until the
+ * keypad changes. A batch runner waiting out a 30-frame delay then
+ * executes a few instructions instead of one or two iterations per frame.
+ *
+ * BATCHED EXECUTION
+ *
+ * processor_run() executes up to a budget of cycles in one tight loop,
+ * with PC and I held in locals, and only returns early when something a
+ * frontend has to react to happens (see ProcessorEvent). Frontends and
+ * batch runners can hand it a whole frame, or more, at once.
  */
 
 #ifndef PROCESSOR_H
 #define PROCESSOR_H
 
+#include <limits.h>
+#include <stdio.h>
 #include "chip8.h"
 
+/*
+ * CHIP8_CYCLES_PER_FRAME
+ *
+ * Number of instructions executed per emulated 60 Hz frame. Ten
+ * instructions per frame yields 600 instructions per second, which is
+ * within the range most classic CHIP-8 programs were written for.
+ */
+#define CHIP8_CYCLES_PER_FRAME 10
+
+/*
+ * CHIP8_FRAME_RATE
+ *
+ * Rate, in Hz, at which the delay and sound timers count down and at
+ * which frames are produced.
+ */
+#define CHIP8_FRAME_RATE 60
+
+/*
+ * ProcessorStats
+ *
+ * Counters maintained by processor_run() and processor_frames() (and by
+ * frontends that run their own frame loop) and, for drawing, by Dxyn itself:
+ *
+ *   frames              — Frames emulated.
+ *   frames_skipped      — Frames of those in which only the timers were
+ *                         ticked, in bulk, by processor_frames().
+ *   cycles_executed     — Instructions actually fetched and executed.
+ *   idle_loops_detected — Times an idle loop was recognized.
+ *   idle_cycles_skipped — Instructions not executed thanks to fast-forward.
+ *   draw_calls          — Dxyn instructions executed.
+ *   pixels_drawn        — Pixels toggled by Dxyn.
+ */
+typedef struct
+{
+    unsigned long long frames;
+    unsigned long long frames_skipped;
+    unsigned long long cycles_executed;
+    unsigned long long idle_loops_detected;
+    unsigned long long idle_cycles_skipped;
+    unsigned long long draw_calls;
+    unsigned long long pixels_drawn;
+} ProcessorStats;
+
+/*
+ * processor_stats
+ *
+ * Statistics for the machines run by the current thread.
+ */
+extern _Thread_local ProcessorStats processor_stats;
+
 /*
  * processor_cycle()
  *
@@ -19,10 +115,122 @@
  *   - Fetches the next opcode from memory
  *   - Advances the program counter
  *   - Dispatches and executes the instruction
- *   - Updates delay and sound timers
  *
- * This function must be called repeatedly from the main emulation loop.
+ * Timers are not touched here; see processor_update_timers(). While the
+ * CPU is blocked waiting for a key (Fx0A) or halted by a fault, the call
+ * does nothing. Fetching past the end of RAM raises CHIP8_FAULT_PC_RANGE.
  */
 void processor_cycle();
 
+/*
+ * processor_update_timers()
+ *
+ * Decrements the delay and sound timers by one if they are non-zero.
+ * Must be called at CHIP8_FRAME_RATE to give the timers their intended
+ * real-time meaning.
+ */
+void processor_update_timers();
+
+/*
+ * processor_frame()
+ *
+ * Emulates one 60 Hz frame: CHIP8_CYCLES_PER_FRAME instruction cycles
+ * followed by a single timer update. Used by frontends that drive the
+ * machine frame-by-frame rather than instruction-by-instruction; the same
+ * as processor_frames(1, ...).
+ */
+void processor_frame();
+
+/*
+ * ProcessorEvent
+ *
+ * Reasons for processor_run() to return, as a bit mask:
+ *
+ *   PROCESSOR_EVENT_FRAME      — A frame ended: its cycles were used up and
+ *                                the timers ticked.
+ *   PROCESSOR_EVENT_DISPLAY    — 00E0 or Dxyn changed the display.
+ *   PROCESSOR_EVENT_SOUND      — The beeper turned on or off (Fx18, or the
+ *                                sound timer running out).
+ *   PROCESSOR_EVENT_KEY_WAIT   — The CPU is blocked in Fx0A.
+ *   PROCESSOR_EVENT_FAULT      — The CPU is halted by a fault, including
+ *                                invalid opcodes; see chip8_memory.fault.
+ *   PROCESSOR_EVENT_BREAKPOINT — The attached debugger stopped the machine
+ *                                (breakpoint, watchpoint or single step).
+ *
+ * 0 means the budget ran out without any event.
+ */
+typedef enum
+{
+    PROCESSOR_EVENT_FRAME = 1 << 0,
+    PROCESSOR_EVENT_DISPLAY = 1 << 1,
+    PROCESSOR_EVENT_SOUND = 1 << 2,
+    PROCESSOR_EVENT_KEY_WAIT = 1 << 3,
+    PROCESSOR_EVENT_FAULT = 1 << 4,
+    PROCESSOR_EVENT_BREAKPOINT = 1 << 5
+} ProcessorEvent;
+
+/*
+ * processor_run(budget, used)
+ *
+ * Runs up to `budget` cycle slots, ticking the timers at every frame
+ * boundary (every CHIP8_CYCLES_PER_FRAME slots, counted in
+ * chip8_memory.frame_cycle across calls). Stops right after the
+ * instruction or frame end that caused an event and returns the
+ * ProcessorEvent bits that occurred, or 0 if the budget was used up first.
+ * Stores the number of slots used in *used.
+ *
+ * Events of an instruction are never reported together with FRAME: when
+ * the instruction used the last slot of a frame, the timers tick at the
+ * start of the next call, which returns FRAME without using any slots.
+ * So the state on return is always the state after the last slot used,
+ * e.g. for the beeper.
+ *
+ * A blocked (Fx0A) or faulted CPU still uses up its slots, as time passes
+ * for the timers: the call skips straight to the end of the frame and
+ * reports KEY_WAIT or FAULT, together with FRAME if it got there. While a
+ * debugger is attached, instructions run through debugger_cycle(); when it
+ * stops the machine, BREAKPOINT is returned and the slot is not used.
+ */
+int processor_run(unsigned int budget, unsigned int *used);
+
+/*
+ * PROCESSOR_IDLE_FOREVER
+ *
+ * Frame count from processor_frames() for a machine that stays idle until
+ * its keypad changes.
+ */
+#define PROCESSOR_IDLE_FOREVER UINT_MAX
+
+/*
+ * processor_frames(frames, ran, idle)
+ *
+ * Emulates up to `frames` whole frames, from a frame boundary, and stores
+ * the number emulated in *ran. Returns the ProcessorEvent bits of the last
+ * one, FRAME included. The run stops early after a frame that changed the
+ * display or the beeper, or in which the CPU blocked or faulted, so only
+ * the last frame ever has something to show. Idle loops and a blocked CPU
+ * are skipped across frame ends as described above. The frame position,
+ * chip8_memory.frame_cycle, is ignored and left as it was.
+ *
+ * If `idle` is not NULL, it receives the number of frames after the last
+ * one known to have no events and to change nothing but the timers and
+ * the registers an idle loop loads from DT, as long as the keypad does not
+ * change: PROCESSOR_IDLE_FOREVER, for a loop or key wait that does not
+ * depend on the timers, or a count below 255. A caller may put off
+ * running them, e.g. the scheduler parks such machines, but must run them,
+ * with the old keypad, before looking at the machine.
+ *
+ * While a debugger is attached (see debugger.h), it is polled and a single
+ * frame is run, by debugger_frame() if it is active.
+ */
+int processor_frames(unsigned int frames, unsigned int *ran, unsigned int *idle);
+
+/*
+ * processor_report_stats(out)
+ *
+ * Prints a one-line summary of processor_stats, including the frames and
+ * the share of cycles skipped by idle-loop fast-forward.
+ */
+void processor_report_stats(FILE *out);
+
 #endif
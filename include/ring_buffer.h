@@ -0,0 +1,80 @@
+/*
+ * LOCK-FREE SINGLE-PRODUCER / SINGLE-CONSUMER RING BUFFER
+ *
+ * A fixed-capacity byte queue that one thread writes and exactly one other
+ * thread reads, without locks. It is used to hand the beeper's tone state
+ * from the emulation thread to the audio callback, which must never block.
+ *
+ * The capacity is rounded up to a power of two so that positions can be
+ * wrapped with a mask. head and tail are free-running counters: the
+ * producer only advances head, the consumer only advances tail, and each
+ * side publishes its counter with release semantics after touching the
+ * data, so the other side observes fully written (or fully consumed) bytes.
+ */
+
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+/*
+ * RingBuffer
+ *
+ *   data     — Backing storage of `capacity` bytes.
+ *   capacity — Power-of-two size of the buffer.
+ *   mask     — capacity - 1, used to wrap positions.
+ *   head     — Total number of bytes ever written (producer-owned).
+ *   tail     — Total number of bytes ever read (consumer-owned).
+ */
+typedef struct
+{
+    uint8_t *data;
+    size_t capacity;
+    size_t mask;
+    _Atomic size_t head;
+    _Atomic size_t tail;
+} RingBuffer;
+
+/*
+ * ring_buffer_init(rb, capacity)
+ *
+ * Allocates storage for at least `capacity` bytes.
+ * Returns 0 on success, -1 on allocation failure.
+ */
+int ring_buffer_init(RingBuffer *rb, size_t capacity);
+
+/*
+ * ring_buffer_free(rb)
+ *
+ * Releases the storage owned by the ring buffer.
+ */
+void ring_buffer_free(RingBuffer *rb);
+
+/*
+ * ring_buffer_size(rb)
+ *
+ * Number of bytes currently queued. Safe to call from either side; the
+ * result is a snapshot that may already be stale when it is used.
+ */
+size_t ring_buffer_size(RingBuffer *rb);
+
+/*
+ * ring_buffer_fill(rb, value, count)
+ *
+ * Producer side. Appends up to `count` copies of `value` and returns the
+ * number of bytes actually written, which is smaller than `count` when the
+ * buffer is full.
+ */
+size_t ring_buffer_fill(RingBuffer *rb, uint8_t value, size_t count);
+
+/*
+ * ring_buffer_read(rb, out, count)
+ *
+ * Consumer side. Removes up to `count` bytes into `out` and returns the
+ * number of bytes actually read.
+ */
+size_t ring_buffer_read(RingBuffer *rb, uint8_t *out, size_t count);
+
+#endif
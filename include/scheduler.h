@@ -0,0 +1,188 @@
+/*
+ * COOPERATIVE SESSION SCHEDULER
+ *
+ * Hosts many libchip8 machines ("sessions") on one thread. Time advances
+ * in 60 Hz ticks; at every tick each runnable session runs one frame
+ * through processor_frames() and is then put back into a timer wheel for the
+ * next tick, so nothing spins between frames. Run one scheduler per core
+ * to spread sessions over several threads.
+ *
+ * PARKING
+ *
+ * A session whose CPU blocks in Fx0A (or faults) cannot do anything
+ * observable except count its timers down, so it is parked instead of
+ * being run every frame:
+ *
+ *   - With both timers at zero it leaves the wheel entirely and only a
+ *     key press (scheduler_set_key()) or scheduler_wake() brings it back.
+ *   - Otherwise it is scheduled for the frame in which the last timer
+ *     runs out, where the beeper turns off, and parked again after it.
+ *
+ * A session spinning in an idle loop (see IDLE-LOOP FAST-FORWARD in
+ * processor.h), e.g. polling the keypad or waiting for the delay timer to
+ * run out, is parked the same way for the frames processor_frames() finds
+ * it will spend unchanged: until a key press, or until the frame in which
+ * the timer reaches the value the loop waits for.
+ *
+ * The frames a blocked session sleeps through are not emulated; the only
+ * state they would have changed, the timers, is brought up to date when
+ * the session is next touched. An idle session catches up by running its
+ * frames then, with the keypad as it was, which the fast-forward makes
+ * cheap. The end result is identical to running every session every frame.
+ *
+ * TIMER WHEEL
+ *
+ * SCHEDULER_WHEEL_SLOTS lists, one per tick modulo the wheel size. Timers
+ * are 8 bits wide, so no deadline, for a key wait or an idle loop, is ever
+ * more than 255 ticks away and every entry fires on the first revolution. Insertion, removal and the
+ * per-tick work are O(1) per session involved; parked sessions cost
+ * nothing.
+ *
+ * STALLS
+ *
+ * A call that finds more than SCHEDULER_MAX_CATCH_UP ticks due (after a
+ * suspend, a slow start or an overloaded host) runs only that many and
+ * drops the rest, re-anchoring the schedule to the present as the frame
+ * pacer does. The sessions fall behind wall-clock time instead of trying
+ * to catch up with a burst they may never finish.
+ */
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdint.h>
+#include "libchip8.h"
+
+/*
+ * SCHEDULER_WHEEL_SLOTS
+ *
+ * Number of ticks covered by one revolution of the timer wheel.
+ */
+#define SCHEDULER_WHEEL_SLOTS 256
+
+/*
+ * SCHEDULER_MAX_CATCH_UP
+ *
+ * Most ticks one scheduler_run() call runs; later ones due are dropped.
+ */
+#define SCHEDULER_MAX_CATCH_UP 4
+
+/*
+ * SchedulerStats
+ *
+ *   sessions       — Sessions currently added.
+ *   parked         — Sessions currently parked.
+ *   frames_run     — Frames emulated.
+ *   frames_skipped — Frames parked sessions slept through.
+ *   key_wakeups    — Parked sessions woken by input or scheduler_wake().
+ *   timer_wakeups  — Parked sessions run for a timer running out, or
+ *                    reaching the value an idle loop waits for.
+ *   ticks_dropped  — Ticks no session ran because of a stall (see STALLS).
+ */
+typedef struct
+{
+    int sessions;
+    int parked;
+    unsigned long long frames_run;
+    unsigned long long frames_skipped;
+    unsigned long long key_wakeups;
+    unsigned long long timer_wakeups;
+    unsigned long long ticks_dropped;
+} SchedulerStats;
+
+/*
+ * SchedulerFrameFunc
+ *
+ * Called after every frame a session runs, with the ProcessorEvent bits
+ * (processor.h) that occurred during it, e.g. to send the display when
+ * PROCESSOR_EVENT_DISPLAY is set.
+ */
+typedef void (*SchedulerFrameFunc)(int session, int events, void *context);
+
+typedef struct Scheduler Scheduler;
+
+/*
+ * scheduler_create(start_ns, on_frame, context)
+ *
+ * Creates an empty scheduler whose tick 0 is at `start_ns`
+ * (CLOCK_MONOTONIC, see frame_pacer_now_ns()). `on_frame` may be NULL.
+ * Returns NULL if out of memory.
+ */
+Scheduler *scheduler_create(int64_t start_ns, SchedulerFrameFunc on_frame, void *context);
+
+/*
+ * scheduler_destroy(scheduler)
+ *
+ * Frees the scheduler. The machines are not destroyed.
+ */
+void scheduler_destroy(Scheduler *scheduler);
+
+/*
+ * scheduler_add(scheduler, machine)
+ *
+ * Adds a session that runs `machine`, starting at the next tick. The
+ * machine is not copied and must stay alive until it is removed.
+ * Returns the session number, or -1 if out of memory.
+ */
+int scheduler_add(Scheduler *scheduler, Chip8Machine *machine);
+
+/*
+ * scheduler_remove(scheduler, session)
+ *
+ * Removes a session and returns its machine, brought up to date.
+ * The session number may be reused by a later scheduler_add().
+ */
+Chip8Machine *scheduler_remove(Scheduler *scheduler, int session);
+
+/*
+ * scheduler_machine(scheduler, session)
+ *
+ * Returns the session's machine, brought up to date if it was parked, for
+ * inspection (framebuffer, beeper) between ticks.
+ */
+Chip8Machine *scheduler_machine(Scheduler *scheduler, int session);
+
+/*
+ * scheduler_set_key(scheduler, session, key, pressed)
+ *
+ * Presses or releases a key (see chip8_set_key()). A press that completes
+ * a parked session's key wait, or any change to the keys of a session
+ * parked in an idle loop, makes it runnable from the next tick.
+ */
+void scheduler_set_key(Scheduler *scheduler, int session, uint8_t key, uint8_t pressed);
+
+/*
+ * scheduler_wake(scheduler, session)
+ *
+ * Makes a session runnable from the next tick. Call after changing a
+ * machine directly, e.g. libchip8_reset() on a faulted session, having
+ * fetched it with scheduler_machine() so it was up to date.
+ */
+void scheduler_wake(Scheduler *scheduler, int session);
+
+/*
+ * scheduler_run(scheduler, now_ns)
+ *
+ * Runs every tick due by `now_ns`, in order, including ticks missed by
+ * calling late, up to SCHEDULER_MAX_CATCH_UP of them (see STALLS).
+ * Returns the number of frames emulated.
+ */
+unsigned long scheduler_run(Scheduler *scheduler, int64_t now_ns);
+
+/*
+ * scheduler_next_deadline(scheduler)
+ *
+ * Returns the time of the next tick with a session to run, for the caller
+ * to sleep until, or INT64_MAX if every session is parked without a
+ * deadline.
+ */
+int64_t scheduler_next_deadline(const Scheduler *scheduler);
+
+/*
+ * scheduler_stats(scheduler)
+ *
+ * Returns the scheduler's counters.
+ */
+const SchedulerStats *scheduler_stats(const Scheduler *scheduler);
+
+#endif
@@ -0,0 +1,168 @@
+/*
+ * SHARED-MEMORY STATE EXPORT
+ *
+ * Publishes the display, and optionally the CPU state and RAM, of the
+ * running machine into a POSIX shared-memory segment once per frame.
+ * Recorders, overlays and other local processes map the segment
+ * read-only and read frames in place: no copies through the emulator,
+ * no sockets, and no system calls once the segment is mapped.
+ *
+ * SEQLOCK
+ *
+ * The segment holds a single frame, guarded by a sequence counter. The
+ * writer makes the counter odd, writes the frame and makes it even again.
+ * A reader samples the counter with shm_export_read_begin(), reads what
+ * it needs directly from the mapping, and then asks
+ * shm_export_read_retry() whether the counter moved in the meantime; if
+ * it did, the data may be torn and the reader starts over. The writer
+ * never waits for readers, so a slow or stuck reader cannot stall the
+ * emulator.
+ *
+ *     uint64_t sequence;
+ *     do
+ *     {
+ *         sequence = shm_export_read_begin(segment);
+ *         ... read segment->display, segment->frame, ...
+ *     } while (shm_export_read_retry(segment, sequence));
+ *
+ * Anything read inside the loop must not be trusted (e.g. used as an
+ * array index) before the retry check has passed.
+ *
+ * The display is only copied into the segment when its incremental hash
+ * (MEMORY.display_hash) changed, so a static screen costs a few stores
+ * per frame.
+ */
+
+#ifndef SHM_EXPORT_H
+#define SHM_EXPORT_H
+
+#include <stdint.h>
+#include <stdatomic.h>
+#include "memory.h"
+
+/*
+ * SHM_EXPORT_MAGIC / SHM_EXPORT_VERSION
+ *
+ * Identify the segment layout; readers refuse segments that differ.
+ */
+#define SHM_EXPORT_MAGIC 0x38504843u /* "CHP8" */
+#define SHM_EXPORT_VERSION 1
+
+/*
+ * SHM_EXPORT_STATE
+ *
+ * Flag: registers, timers, stack and RAM are exported along with the
+ * display. Without it those fields stay zero.
+ */
+#define SHM_EXPORT_STATE 0x01u
+
+/*
+ * ShmExportSegment
+ *
+ * Layout of the shared segment. The first block is written once at
+ * creation; everything after `sequence` is guarded by it.
+ *
+ *   magic, version — SHM_EXPORT_MAGIC and SHM_EXPORT_VERSION.
+ *   size           — sizeof(ShmExportSegment).
+ *   flags          — SHM_EXPORT_STATE if the CPU state is exported.
+ *   sequence       — Seqlock counter; odd while a frame is being written.
+ *   frame          — Frames emulated since the export was created.
+ *   published_ns   — CLOCK_MONOTONIC time the frame was published.
+ *   display_hash   — MEMORY.display_hash of the exported display.
+ *   display        — Pixels as in MEMORY.display (0 is off).
+ */
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t size;
+    uint32_t flags;
+
+    _Atomic uint64_t sequence;
+    uint64_t frame;
+    int64_t published_ns;
+    uint64_t display_hash;
+    uint32_t display[CHIP8_HEIGHT][CHIP8_WIDTH];
+
+    uint8_t registers[16];
+    uint16_t index;
+    uint16_t program_counter;
+    uint16_t stack[16];
+    uint8_t stack_pointer;
+    uint8_t delay_timer;
+    uint8_t sound_timer;
+    uint8_t fault;
+    uint8_t ram[4096];
+} ShmExportSegment;
+
+typedef struct ShmExport ShmExport;
+
+/*
+ * shm_export_create(name, flags)
+ *
+ * Creates (or takes over) the shared-memory object `name`, e.g. "/chip8",
+ * accessible to the current user only. A missing leading '/' is added.
+ * Returns NULL on failure (a message is printed).
+ */
+ShmExport *shm_export_create(const char *name, uint32_t flags);
+
+/*
+ * shm_export_publish(exporter, vm, frame)
+ *
+ * Writes the state of `vm` as frame number `frame`. Call after every
+ * frame, or run of frames (processor_frames()), with its timer update;
+ * `frame` then advances by more than one.
+ */
+void shm_export_publish(ShmExport *exporter, const MEMORY *vm, uint64_t frame);
+
+/*
+ * shm_export_destroy(exporter)
+ *
+ * Unmaps and removes the shared-memory object. Readers that still have it
+ * mapped keep the last frame.
+ */
+void shm_export_destroy(ShmExport *exporter);
+
+/*
+ * shm_export_open(name)
+ *
+ * Maps an existing segment read-only for a reader. Returns NULL if it does
+ * not exist or has a different layout (a message is printed).
+ */
+const ShmExportSegment *shm_export_open(const char *name);
+
+/*
+ * shm_export_close(segment)
+ *
+ * Unmaps a segment returned by shm_export_open().
+ */
+void shm_export_close(const ShmExportSegment *segment);
+
+/*
+ * shm_export_read_begin(segment)
+ *
+ * Waits until no frame is being written and returns the sequence counter.
+ */
+static inline uint64_t shm_export_read_begin(const ShmExportSegment *segment)
+{
+    uint64_t sequence;
+
+    while ((sequence = atomic_load_explicit(&segment->sequence, memory_order_acquire)) & 1u)
+        ;
+
+    return sequence;
+}
+
+/*
+ * shm_export_read_retry(segment, sequence)
+ *
+ * Returns non-zero if a frame was written since shm_export_read_begin()
+ * returned `sequence`, i.e. the data just read may be inconsistent.
+ */
+static inline int shm_export_read_retry(const ShmExportSegment *segment, uint64_t sequence)
+{
+    atomic_thread_fence(memory_order_acquire);
+    return atomic_load_explicit(&segment->sequence, memory_order_relaxed) != sequence;
+}
+
+#endif
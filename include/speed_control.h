@@ -0,0 +1,128 @@
+/*
+ * SPEED CONTROL
+ *
+ * Emulation speed as a multiple of real time, switched at runtime with
+ * hotkeys that every frontend forwards:
+ *
+ *   Tab — Fast-forward while held. Terminals report no key releases, so
+ *         there Tab toggles fast-forward instead.
+ *   =   — Toggle fast-forward.
+ *   -   — Toggle slow motion.
+ *
+ * Keys mapped to the keypad (keymap.h) take precedence over hotkeys.
+ *
+ * The display still refreshes at CHIP8_FRAME_RATE. Each display period
+ * emulates as many frames as the speed calls for, and only the last one
+ * is presented. At speeds below 1 some periods emulate no frame and
+ * present nothing. When the core cannot emulate all the frames before
+ * the next display deadline, the rest are dropped instead of carried
+ * over. Uncapped speed therefore emulates frames until the deadline,
+ * presents once, and is limited only by the core.
+ */
+
+#ifndef SPEED_CONTROL_H
+#define SPEED_CONTROL_H
+
+#include <stdint.h>
+
+/*
+ * SPEED_UNCAPPED
+ *
+ * Multiplier meaning "as fast as the core can go".
+ */
+#define SPEED_UNCAPPED 0.0
+
+/*
+ * SPEED_PRESENT_MARGIN_NS
+ *
+ * Time left free before each display deadline when frames are being
+ * dropped, for presenting and for the rest of the loop. It also absorbs
+ * an OS scheduler tick, so that an uncapped core still meets the
+ * display deadlines.
+ */
+#define SPEED_PRESENT_MARGIN_NS 4000000
+
+/*
+ * Hotkeys, as host key codes (the SDL keycodes of these keys are their
+ * ASCII codes, and terminals send the characters).
+ */
+#define SPEED_KEY_HOLD '\t'
+#define SPEED_KEY_FAST_FORWARD '='
+#define SPEED_KEY_SLOW_MOTION '-'
+
+/*
+ * SpeedControl
+ *
+ *   normal       — Multiplier without fast-forward or slow motion (--speed).
+ *   fast_forward — Fast-forward multiplier (--ff-speed).
+ *   slow_motion  — Slow-motion multiplier (--slow-speed).
+ *   held         — Fast-forward key held.
+ *   toggled      — Fast-forward toggled on.
+ *   slow         — Slow motion toggled on.
+ *   credit       — Frames owed to the current display period.
+ */
+typedef struct
+{
+    double normal;
+    double fast_forward;
+    double slow_motion;
+    int held;
+    int toggled;
+    int slow;
+    double credit;
+} SpeedControl;
+
+/*
+ * speed_control
+ *
+ * The emulator's speed state. Defaults: normal 1, fast-forward 4, slow
+ * motion 0.25.
+ */
+extern SpeedControl speed_control;
+
+/*
+ * speed_control_parse(text, multiplier)
+ *
+ * Parses a multiplier: a number above 0 and at most 1000, or "max" for
+ * SPEED_UNCAPPED.
+ *
+ * Returns 0 on success, or -1 if invalid (a message is printed).
+ */
+int speed_control_parse(const char *text, double *multiplier);
+
+/*
+ * speed_control_key(host_key, pressed, releases)
+ *
+ * Handles a hotkey press or release. `releases` is zero for frontends
+ * that never report releases, which turns the hold key into a toggle.
+ *
+ * Returns 1 if the key is a hotkey, 0 otherwise.
+ */
+int speed_control_key(int host_key, int pressed, int releases);
+
+/*
+ * speed_control_multiplier()
+ *
+ * Returns the current multiplier, or SPEED_UNCAPPED.
+ */
+double speed_control_multiplier(void);
+
+/*
+ * speed_control_begin_period()
+ *
+ * Starts a display period, adding the frames the current speed owes it.
+ */
+void speed_control_begin_period(void);
+
+/*
+ * speed_control_frame_due(frames_run, deadline_ns)
+ *
+ * Returns 1 if another frame should be emulated in this display period,
+ * `frames_run` frames in, with the period ending at `deadline_ns`
+ * (CLOCK_MONOTONIC). The first owed frame always runs; after that, frames
+ * owed later than SPEED_PRESENT_MARGIN_NS before the deadline are
+ * dropped.
+ */
+int speed_control_frame_due(unsigned int frames_run, int64_t deadline_ns);
+
+#endif
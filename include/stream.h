@@ -0,0 +1,135 @@
+/*
+ * FRAME STREAMING SERVER
+ *
+ * Runs the loaded ROM headless at 60 Hz and serves its display over a
+ * Unix domain socket or a loopback TCP port, so remote viewers and test
+ * drivers can watch and control a session without an SDL window. Up to
+ * STREAM_MAX_CLIENTS clients can be connected at once; all of them see
+ * the same machine and all of them may press keys.
+ *
+ * PROTOCOL
+ *
+ * All integers are little-endian.
+ *
+ * Server → client, one message per changed frame:
+ *
+ *   offset  size  field
+ *   0       1     'F'
+ *   1       1     flags — bit 0: key frame (delta against a blank screen)
+ *   2       2     payload length in bytes
+ *   4       4     frame number (frames emulated since the server started)
+ *   8       8     produced_ns — CLOCK_MONOTONIC time the frame was finished
+ *   16      8     input_ns — timestamp of the newest key event from this
+ *                 client applied before the frame, or 0
+ *   24      …     payload
+ *
+ * The payload encodes the display as a bitmap of STREAM_BITMAP_BYTES
+ * bytes (row-major, most significant bit first), XORed with the bitmap
+ * last sent to the same client and then run-length encoded (see
+ * stream_encode_delta()). A frame is only sent when Dxyn or 00E0 changed
+ * the display since the client's previous frame, which the server learns
+ * from the display's incremental hash without comparing pixels. The first
+ * frame to every client is a key frame.
+ *
+ * Client → server, key events:
+ *
+ *   0       1     'K'
+ *   1       1     bit 7: pressed, bits 0–3: key
+ *   2       8     client timestamp (CLOCK_MONOTONIC ns), echoed as input_ns
+ *
+ * Both ends share the host clock, so a client measures frame delivery
+ * latency as now − produced_ns and end-to-end input latency (key sent to
+ * the first frame delivered after it was applied) as now − input_ns.
+ *
+ * A client that does not read fast enough has frames skipped rather than
+ * queued without limit; its next frame is a delta against the last frame
+ * it was actually sent.
+ */
+
+#ifndef STREAM_H
+#define STREAM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "memory.h"
+
+/*
+ * STREAM_MAX_CLIENTS
+ *
+ * Maximum number of simultaneously connected clients.
+ */
+#define STREAM_MAX_CLIENTS 8
+
+/*
+ * STREAM_BITMAP_BYTES / STREAM_HEADER_SIZE / STREAM_KEY_EVENT_SIZE
+ *
+ * Size of a packed display, of a frame message header and of a key
+ * event message.
+ */
+#define STREAM_BITMAP_BYTES (CHIP8_WIDTH * CHIP8_HEIGHT / 8)
+#define STREAM_HEADER_SIZE 24
+#define STREAM_KEY_EVENT_SIZE 10
+
+/*
+ * STREAM_MAX_PAYLOAD
+ *
+ * Worst-case size of an encoded delta (no runs at all).
+ */
+#define STREAM_MAX_PAYLOAD (STREAM_BITMAP_BYTES + STREAM_BITMAP_BYTES / 128 + 1)
+
+/*
+ * StreamConfig
+ *
+ *   endpoint — Loopback TCP port number, or the path of a Unix socket.
+ *   frames   — Frames to run before exiting; 0 runs until interrupted.
+ *   unpaced  — Run as fast as possible instead of at 60 Hz.
+ */
+typedef struct
+{
+    const char *endpoint;
+    unsigned long frames;
+    int unpaced;
+} StreamConfig;
+
+/*
+ * stream_run(config)
+ *
+ * Serves the ROM currently loaded into chip8_memory until config->frames
+ * frames have run or SIGINT/SIGTERM arrives, then prints the number of
+ * frames, frames sent, bytes per frame and key events to stderr.
+ *
+ * Returns 0 on success, or -1 if the socket could not be opened.
+ */
+int stream_run(const StreamConfig *config);
+
+/*
+ * stream_pack_display(vm, bitmap)
+ *
+ * Packs vm->display into STREAM_BITMAP_BYTES bytes, one bit per pixel.
+ */
+void stream_pack_display(const MEMORY *vm, uint8_t *bitmap);
+
+/*
+ * stream_encode_delta(previous, current, out)
+ *
+ * XORs two packed displays and run-length encodes the result into `out`
+ * (at least STREAM_MAX_PAYLOAD bytes). The encoding is a sequence of
+ * control bytes c, each followed by data:
+ *
+ *   c < 0x80  — c + 1 literal bytes follow.
+ *   c ≥ 0x80  — one byte follows, repeated c − 0x80 + 3 times.
+ *
+ * Unchanged areas XOR to long runs of zero bytes, so small changes cost a
+ * few bytes. Returns the encoded length.
+ */
+size_t stream_encode_delta(const uint8_t *previous, const uint8_t *current, uint8_t *out);
+
+/*
+ * stream_decode_delta(payload, length, bitmap)
+ *
+ * Applies an encoded delta to `bitmap` in place. Returns 0 on success, or
+ * -1 if the payload is malformed or does not cover exactly one bitmap.
+ */
+int stream_decode_delta(const uint8_t *payload, size_t length, uint8_t *bitmap);
+
+#endif
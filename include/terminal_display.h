@@ -0,0 +1,134 @@
+/*
+ * TERMINAL DISPLAY
+ *
+ * Shows the CHIP-8 display in a text terminal, for hosts without a window
+ * system (SSH sessions, servers). No SDL is involved; output is plain
+ * UTF-8 with ANSI escape sequences on stdout, input comes from stdin in
+ * raw mode.
+ *
+ * CELLS
+ *
+ * Each character cell shows several pixels:
+ *
+ *   TERMINAL_CELLS_HALF_BLOCKS — 1×2 pixels per cell with ' ', '▀', '▄'
+ *                                and '█': 64×16 cells.
+ *   TERMINAL_CELLS_BRAILLE     — 2×4 pixels per cell with the Braille
+ *                                patterns U+2800–U+28FF: 32×8 cells.
+ *
+ * CHANGED-CELL OUTPUT
+ *
+ * A shadow buffer holds the cell last written at every position. An
+ * update compares the display against it and only writes the cells that
+ * changed, with cursor-addressing sequences to jump between them. Short
+ * runs of unchanged cells between two changes are simply rewritten when
+ * that takes fewer bytes than moving the cursor past them. A frame with
+ * no changes writes nothing, and a moving sprite typically costs a few
+ * dozen bytes, so the display stays smooth over slow links. Ctrl-L
+ * redraws the whole screen.
+ *
+ * INPUT
+ *
+ * The keypad uses the same keymap as the SDL window (see keymap.h).
+ * Terminals report key presses but not releases, so a press holds its
+ * keypad key for TERMINAL_KEY_HOLD_FRAMES frames; the terminal's key
+ * repeat keeps a held key down. Esc or Ctrl-C quits. Speed hotkeys
+ * (speed_control.h) toggle, since a held key cannot be told apart.
+ */
+
+#ifndef TERMINAL_DISPLAY_H
+#define TERMINAL_DISPLAY_H
+
+#include <stddef.h>
+
+/*
+ * TERMINAL_KEY_HOLD_FRAMES
+ *
+ * Frames a keypad key stays pressed after its last key press: long
+ * enough to bridge the gaps between a held key's repeats, short enough
+ * that a tap is not taken for a long press.
+ */
+#define TERMINAL_KEY_HOLD_FRAMES 6
+
+typedef enum
+{
+    TERMINAL_CELLS_HALF_BLOCKS,
+    TERMINAL_CELLS_BRAILLE
+} TerminalCells;
+
+/*
+ * TerminalStats
+ *
+ *   updates       — Calls to terminal_display_update().
+ *   bytes_written — Bytes written to the terminal, escape sequences
+ *                   included.
+ *   cells_written — Cells redrawn.
+ */
+typedef struct
+{
+    unsigned long long updates;
+    unsigned long long bytes_written;
+    unsigned long long cells_written;
+} TerminalStats;
+
+/*
+ * terminal_display_init(cells)
+ *
+ * Puts stdin in raw mode, switches to the alternate screen and hides the
+ * cursor. stdin and stdout must be a terminal.
+ *
+ * Returns 0 on success, or -1 on failure (a message is printed).
+ */
+int terminal_display_init(TerminalCells cells);
+
+/*
+ * terminal_display_update()
+ *
+ * Writes the cells of chip8_memory.display that changed since the last
+ * update, and the status line if it changed. Time spent is added to
+ * metrics_frontend like DisplayManager_Update(), with the final write()
+ * counted as presenting.
+ */
+void terminal_display_update(void);
+
+/*
+ * terminal_display_set_status(text)
+ *
+ * Sets a line of text shown below the display, e.g. the metrics HUD
+ * ('\n' is shown as a gap). NULL or "" clears it.
+ */
+void terminal_display_set_status(const char *text);
+
+/*
+ * terminal_display_process_input()
+ *
+ * Reads pending input without blocking, presses the keypad keys it maps
+ * to and releases keys whose hold time ran out. Call once per frame.
+ *
+ * Returns 1 if quit was requested, 0 otherwise.
+ */
+int terminal_display_process_input(void);
+
+/*
+ * terminal_display_wait_input(timeout_ms)
+ *
+ * Sleeps until input arrives or the timeout expires (negative waits
+ * indefinitely), then processes it like terminal_display_process_input().
+ */
+int terminal_display_wait_input(int timeout_ms);
+
+/*
+ * terminal_display_destroy()
+ *
+ * Restores the terminal: cursor, main screen and input mode. Also runs at
+ * exit if the program ends without calling it.
+ */
+void terminal_display_destroy(void);
+
+/*
+ * terminal_display_stats()
+ *
+ * Returns the output counters.
+ */
+const TerminalStats *terminal_display_stats(void);
+
+#endif
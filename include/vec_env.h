@@ -0,0 +1,144 @@
+/*
+ * VECTORIZED ENVIRONMENT API
+ *
+ * Runs N independent copies of one ROM side by side for reinforcement-
+ * learning workloads. A single vec_env_step() call applies one keypad
+ * action per environment, advances every environment by `frame_skip`
+ * frames, and returns per-environment rewards, episode-end flags and all
+ * framebuffers packed into one contiguous uint8 tensor of shape
+ * N × CHIP8_HEIGHT × CHIP8_WIDTH (row-major, one byte per pixel, 0 or 1).
+ *
+ * Each environment is a plain MEMORY. Environments are split into
+ * contiguous slices, one per worker thread, and each worker points its
+ * thread's chip8_vm at the environment it is stepping, so no machine
+ * state is copied during a step. Resets copy a pristine snapshot taken
+ * right after the ROM was loaded, then reseed the random-number
+ * generator per environment and episode, so runs are reproducible.
+ *
+ * REWARDS
+ *
+ * A reward source names a counter in RAM, typically the score. Its
+ * value is `bytes` bytes wide (1 to 4, big-endian) or, with `bcd` set,
+ * `bytes` BCD digits (1 to 9) stored one per byte as written by Fx33. The
+ * counter must lie within RAM; vec_env_create() refuses it otherwise.
+ * The reward of a step is the sum over all sources of scale × (value
+ * after the step − value before it).
+ *
+ * EPISODE END
+ *
+ * An episode ends when the CPU faults or after max_episode_frames frames
+ * (if non-zero). Ended environments are reset automatically; the
+ * observation returned for them is the first frame of the new episode.
+ */
+
+#ifndef VEC_ENV_H
+#define VEC_ENV_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "memory.h"
+
+/*
+ * VEC_ENV_MAX_REWARDS
+ *
+ * Maximum number of reward sources per VecEnv.
+ */
+#define VEC_ENV_MAX_REWARDS 16
+
+/*
+ * VecEnvRewardSource
+ *
+ *   address — RAM address of the counter's most significant byte/digit.
+ *   bytes   — Width in bytes (binary, 1–4) or in digits (BCD, 1–9).
+ *   bcd     — Non-zero if the counter holds one decimal digit per byte.
+ *   scale   — Multiplier applied to the counter's change.
+ */
+typedef struct
+{
+    uint16_t address;
+    uint8_t bytes;
+    uint8_t bcd;
+    float scale;
+} VecEnvRewardSource;
+
+/*
+ * VecEnvConfig
+ *
+ *   num_envs           — Number of environments (N).
+ *   num_threads        — Worker threads, including the caller; 0 uses one
+ *                        per online CPU (never more than num_envs).
+ *   frame_skip         — Frames emulated per step; the action is held for
+ *                        all of them (0 is treated as 1).
+ *   max_episode_frames — Episode length limit in frames; 0 for none.
+ *   seed               — Base seed for the random-number generators.
+ *   rewards            — Array of reward_count (at most
+ *                        VEC_ENV_MAX_REWARDS) reward sources.
+ */
+typedef struct
+{
+    int num_envs;
+    int num_threads;
+    int frame_skip;
+    unsigned long max_episode_frames;
+    uint32_t seed;
+    const VecEnvRewardSource *rewards;
+    int reward_count;
+} VecEnvConfig;
+
+typedef struct VecEnv VecEnv;
+
+/*
+ * vec_env_create(rom_path, config)
+ *
+ * Loads the ROM once, takes the pristine snapshot, allocates the
+ * environments and starts the worker threads. chip8_init() is called
+ * here; the environments do not depend on the caller's chip8_vm.
+ *
+ * Returns the new VecEnv, or NULL on failure (a message is printed).
+ */
+VecEnv *vec_env_create(const char *rom_path, const VecEnvConfig *config);
+
+/*
+ * vec_env_reset(env, observations)
+ *
+ * Resets every environment to the start of a new episode and writes the
+ * initial framebuffers to `observations` (N × 32 × 64 bytes) if non-NULL.
+ */
+void vec_env_reset(VecEnv *env, uint8_t *observations);
+
+/*
+ * vec_env_step(env, actions, rewards, dones, observations)
+ *
+ * Advances every environment by one step.
+ *
+ *   actions      — N keypad bitmasks; bit k set means key k is held.
+ *   rewards      — N rewards (may be NULL).
+ *   dones        — N flags, 1 if the episode ended during this step (may
+ *                  be NULL).
+ *   observations — N × 32 × 64 framebuffer bytes (may be NULL).
+ */
+void vec_env_step(VecEnv *env, const uint16_t *actions, float *rewards,
+                  uint8_t *dones, uint8_t *observations);
+
+/*
+ * vec_env_num_envs(env)
+ *
+ * Returns N.
+ */
+int vec_env_num_envs(const VecEnv *env);
+
+/*
+ * vec_env_get(env, i)
+ *
+ * Returns the machine state of environment i, for inspection.
+ */
+MEMORY *vec_env_get(VecEnv *env, int i);
+
+/*
+ * vec_env_destroy(env)
+ *
+ * Stops the worker threads and frees all environments.
+ */
+void vec_env_destroy(VecEnv *env);
+
+#endif
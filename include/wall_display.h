@@ -0,0 +1,131 @@
+/*
+ * WALL DISPLAY
+ *
+ * Shows the displays of many sessions (scheduler.h) side by side in one
+ * SDL window, for monitoring walls and training dashboards: a grid of
+ * 64×32 tiles, one per session, as close to square as the session count
+ * allows, scaled up to fill WALL_WINDOW_WIDTH.
+ *
+ * ATLAS
+ *
+ * All tiles live in one streaming texture, the atlas, mirrored by a copy
+ * in host memory. wall_display_update() converts a session's display into
+ * its tile of the host copy and marks the tile dirty. Once per frame,
+ * wall_display_present() uploads only the dirty tiles, merging runs of
+ * them side by side in a grid row into one SDL_UpdateTexture() each,
+ * draws the atlas with a single SDL_RenderCopy(), then the grid and the
+ * focus outline, and presents. A frame in which no tile changed uploads
+ * and presents nothing.
+ *
+ * FOCUS
+ *
+ * Clicking a tile focuses its session: the keyboard (keymap.h) then
+ * drives that session's keypad, through the WallKeyFunc given to
+ * wall_display_init(). Keys still held on the session losing focus are
+ * released. The focused tile is outlined and its number shown in the
+ * window title. Esc or closing the window quits.
+ */
+
+#ifndef WALL_DISPLAY_H
+#define WALL_DISPLAY_H
+
+#include <stdint.h>
+#include "memory.h"
+
+/*
+ * WALL_MAX_SESSIONS
+ *
+ * Most tiles a wall can show: a 32×32 grid, a 2048×1024 atlas.
+ */
+#define WALL_MAX_SESSIONS 1024
+
+/*
+ * WALL_WINDOW_WIDTH
+ *
+ * Window width the tiles are scaled up towards, by whole factors. Walls
+ * of more than 20 columns are shown at 1:1 and are wider.
+ */
+#define WALL_WINDOW_WIDTH 1280
+
+/*
+ * WallKeyFunc
+ *
+ * Called for every keypad key pressed or released on the focused
+ * session, e.g. to forward it with scheduler_set_key().
+ */
+typedef void (*WallKeyFunc)(int session, uint8_t key, uint8_t pressed, void *context);
+
+/*
+ * WallStats
+ *
+ *   presents       — Frames presented.
+ *   tile_updates   — Tiles converted by wall_display_update().
+ *   uploads        — SDL_UpdateTexture() calls, one per run of dirty tiles.
+ *   bytes_uploaded — Atlas bytes uploaded to the texture.
+ */
+typedef struct
+{
+    unsigned long long presents;
+    unsigned long long tile_updates;
+    unsigned long long uploads;
+    unsigned long long bytes_uploaded;
+} WallStats;
+
+/*
+ * wall_display_init(title, vsync, sessions, on_key, context)
+ *
+ * Opens the window with a tile for each of `sessions` sessions (1 to
+ * WALL_MAX_SESSIONS), all blank, and focuses session 0.
+ *
+ * Returns 0 on success, or -1 on failure (a message is printed).
+ */
+int wall_display_init(const char *title, int vsync, int sessions, WallKeyFunc on_key, void *context);
+
+/*
+ * wall_display_update(session, display)
+ *
+ * Copies a session's display into its tile, to be uploaded by the next
+ * wall_display_present().
+ */
+void wall_display_update(int session, const uint32_t display[CHIP8_HEIGHT][CHIP8_WIDTH]);
+
+/*
+ * wall_display_present()
+ *
+ * Uploads the changed tiles and presents the wall, if anything changed
+ * since the last present.
+ */
+void wall_display_present(void);
+
+/*
+ * wall_display_wait_input(timeout_ms)
+ *
+ * Handles pending input, first sleeping until input arrives or the
+ * timeout expires (0 does not sleep, negative waits indefinitely).
+ *
+ * Returns 1 if quit was requested, 0 otherwise.
+ */
+int wall_display_wait_input(int timeout_ms);
+
+/*
+ * wall_display_focus()
+ *
+ * Returns the focused session.
+ */
+int wall_display_focus(void);
+
+/*
+ * wall_display_destroy()
+ *
+ * Closes the window and prints a summary to stderr.
+ */
+void wall_display_destroy(void);
+
+/*
+ * wall_display_stats()
+ *
+ * Returns the output counters.
+ */
+const WallStats *wall_display_stats(void);
+
+#endif
@@ -0,0 +1,222 @@
+/*
+ * XO-CHIP MACHINE
+ *
+ * XO-CHIP extends CHIP-8 (and SUPER-CHIP) with a 64 KB address space,
+ * two display bitplanes for four colours, and programmable audio. Its
+ * machine state does not fit the fixed-size MEMORY that the rest of the
+ * core copies, hashes and runs in vector lanes, so XO-CHIP programs run
+ * on a separate XoChip machine with its own interpreter.
+ *
+ * INSTRUCTIONS
+ *
+ * Everything CHIP-8 has, with the XO-CHIP conventions of Octo:
+ *
+ *   - 8xy6/8xyE shift Vy into Vx; Fx55/Fx65 advance I past the last
+ *     register; Bnnn adds V0; VF is written after the result.
+ *   - Sprites wrap around the display edges.
+ *
+ * plus the SUPER-CHIP instructions
+ *
+ *   00Cn / 00Dn  Scroll down / up by n pixels.
+ *   00FB / 00FC  Scroll right / left by 4 pixels.
+ *   00FD         Exit: the machine stops (exited is set).
+ *   00FE / 00FF  Low (64×32) / high (128×64) resolution; clears.
+ *   Dxy0         16×16 sprite, 32 bytes per plane.
+ *   Fx30         I = big (8×10) font digit Vx.
+ *   Fx75 / Fx85  Save / load V0–Vx to / from the flag registers.
+ *
+ * and the XO-CHIP ones
+ *
+ *   5xy2 / 5xy3  Save / load Vx–Vy to / from I, in either order; I is
+ *                unchanged.
+ *   F000 nnnn    I = nnnn (a 4-byte instruction; skips step over it).
+ *   Fn01         Select the planes (bit 0, bit 1) that 00E0, Dxyn and
+ *                the scrolls work on.
+ *   F002         Load the 16-byte audio pattern from I.
+ *   Fx3A         Pitch: the pattern plays at 4000 × 2^((Vx − 64) / 48)
+ *                bits per second.
+ *
+ * MEMORY
+ *
+ * RAM is XOCHIP_PAGES pages of XOCHIP_PAGE_SIZE bytes, allocated when
+ * first written; pages never written read as zero. A machine costs
+ * sizeof(XoChip) plus the pages its ROM and its writes touch, so a
+ * 3 KB ROM still fits in one page instead of 64 KB.
+ *
+ * DISPLAY
+ *
+ * Each plane is a packed bitmap, one bit per pixel, with the leftmost
+ * pixel in the most significant bit: one 64-bit word per row in low
+ * resolution, two in high resolution. A sprite row is shifted into
+ * position and XORed into the row a word at a time, with collisions
+ * found by ANDing before the XOR. Scrolls move whole words (rows) or
+ * shift them (4 pixels sideways).
+ */
+
+#ifndef XOCHIP_H
+#define XOCHIP_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * XOCHIP_PAGE_SIZE / XOCHIP_PAGES
+ *
+ * Size of a RAM page and number of pages in the 64 KB address space.
+ */
+#define XOCHIP_PAGE_SIZE 4096
+#define XOCHIP_PAGES (65536 / XOCHIP_PAGE_SIZE)
+
+/*
+ * XOCHIP_WIDTH / XOCHIP_HEIGHT
+ *
+ * High-resolution display size; xochip_render() always produces it,
+ * doubling pixels in low resolution.
+ */
+#define XOCHIP_WIDTH 128
+#define XOCHIP_HEIGHT 64
+
+/*
+ * XOCHIP_CYCLES_PER_FRAME
+ *
+ * Default instructions per 60 Hz frame. XO-CHIP programs are written for
+ * much faster interpreters than the 10 per frame of CHIP-8.
+ */
+#define XOCHIP_CYCLES_PER_FRAME 1000
+
+/*
+ * XoChip
+ *
+ *   registers, flags  — V0–VF and the 16 SUPER-CHIP flag registers.
+ *   index, pc         — I and the program counter (16 bits each).
+ *   stack, sp         — Return addresses.
+ *   delay/sound_timer — 60 Hz timers; the pattern plays while sound_timer
+ *                       is non-zero.
+ *   keypad            — Keys 0–F held.
+ *   waiting_for_key   — Blocked in Fx0A; key_register receives the key.
+ *   fault             — A Chip8Fault (memory.h); the machine is halted.
+ *   exited            — 00FD was executed; the machine is halted.
+ *   hires             — High resolution.
+ *   planes            — Plane mask selected with Fn01 (1 after reset).
+ *   pitch             — Fx3A pitch (64 after reset: 4000 bits/s).
+ *   pattern           — Audio pattern, 128 bits, first bit in bit 7 of
+ *                       pattern[0].
+ *   audio_phase       — Position in the pattern, 16.16 fixed point bits.
+ *   rng_state         — State of the Cxkk generator.
+ *   plane             — The bitplanes, [plane][row][word].
+ *   pages             — RAM pages; NULL pages read as zero.
+ */
+typedef struct
+{
+    uint8_t registers[16];
+    uint8_t flags[16];
+    uint16_t index;
+    uint16_t pc;
+    uint16_t stack[16];
+    uint8_t sp;
+    uint8_t delay_timer;
+    uint8_t sound_timer;
+    uint8_t keypad[16];
+    uint8_t waiting_for_key;
+    uint8_t key_register;
+    uint8_t fault;
+    uint8_t exited;
+    uint8_t hires;
+    uint8_t planes;
+    uint8_t pitch;
+    uint8_t pattern[16];
+    uint32_t audio_phase;
+    uint32_t rng_state;
+    uint64_t plane[2][XOCHIP_HEIGHT][XOCHIP_WIDTH / 64];
+    uint8_t *pages[XOCHIP_PAGES];
+} XoChip;
+
+/*
+ * xochip_create(seed)
+ *
+ * Creates a machine in the reset state, with the fonts in the first page
+ * and Cxkk seeded with `seed`. Returns NULL if out of memory.
+ */
+XoChip *xochip_create(uint32_t seed);
+
+/*
+ * xochip_destroy(machine)
+ *
+ * Frees the machine and its pages. Accepts NULL.
+ */
+void xochip_destroy(XoChip *machine);
+
+/*
+ * xochip_load_rom(machine, data, size)
+ *
+ * Copies a ROM of up to 65536 − 0x200 bytes to 0x200.
+ *
+ * Returns 0 on success, or -1 if the ROM is too large or out of memory
+ * (a message is printed).
+ */
+int xochip_load_rom(XoChip *machine, const uint8_t *data, size_t size);
+
+/*
+ * xochip_load_rom_file(machine, filename)
+ *
+ * Reads a ROM file and loads it with xochip_load_rom().
+ *
+ * Returns 0 on success, -1 on failure (a message is printed).
+ */
+int xochip_load_rom_file(XoChip *machine, const char *filename);
+
+/*
+ * xochip_read(machine, address) / xochip_write(machine, address, value)
+ *
+ * Reads or writes one byte of RAM. A write to a page that does not exist
+ * yet allocates it; if that fails the machine faults with
+ * CHIP8_FAULT_MEMORY_RANGE.
+ */
+uint8_t xochip_read(const XoChip *machine, uint16_t address);
+void xochip_write(XoChip *machine, uint16_t address, uint8_t value);
+
+/*
+ * xochip_run_frame(machine, cycles)
+ *
+ * Executes up to `cycles` instructions, stopping early when the machine
+ * blocks in Fx0A, faults or exits, then counts the timers down once.
+ * Returns the ProcessorEvent bits (processor.h) that occurred: FRAME
+ * always, DISPLAY if a draw, clear, scroll or resolution change ran,
+ * SOUND if the pattern, pitch or sound timer was written, KEY_WAIT or
+ * FAULT if the machine is blocked or halted.
+ */
+int xochip_run_frame(XoChip *machine, unsigned int cycles);
+
+/*
+ * xochip_set_key(machine, key, pressed)
+ *
+ * Presses or releases keypad key 0–F; a press completes an Fx0A wait.
+ */
+void xochip_set_key(XoChip *machine, uint8_t key, uint8_t pressed);
+
+/*
+ * xochip_render(machine, pixels)
+ *
+ * Converts the planes into XOCHIP_WIDTH × XOCHIP_HEIGHT RGBA8888 pixels
+ * (0xRRGGBBAA), row-major, with the four colours of Octo's XO-CHIP
+ * palette.
+ */
+void xochip_render(const XoChip *machine, uint32_t *pixels);
+
+/*
+ * xochip_audio(machine, levels, count, sample_rate)
+ *
+ * Produces the next `count` output samples at `sample_rate`: +1 or -1
+ * following the pattern while the sound timer runs, 0 when silent.
+ * Call once per frame with a frame's worth of samples.
+ */
+void xochip_audio(XoChip *machine, int8_t *levels, size_t count, int sample_rate);
+
+/*
+ * xochip_memory_usage(machine)
+ *
+ * Returns the bytes the machine occupies, pages included.
+ */
+size_t xochip_memory_usage(const XoChip *machine);
+
+#endif
@@ -0,0 +1,189 @@
+#include <stdio.h>
+#include "audio_manager.h"
+#include "processor.h"
+
+#define AUDIO_AMPLITUDE 3000
+#define AUDIO_CHUNK_SAMPLES 256
+
+/* Per-sample states in the ring: silence, the beeper tone, or a fixed level */
+#define AUDIO_STATE_SILENT 0
+#define AUDIO_STATE_TONE 1
+#define AUDIO_STATE_LOW 2
+#define AUDIO_STATE_HIGH 3
+
+AudioManager g_audioManager;
+
+static void AudioManager_Callback(void *userdata, Uint8 *stream, int len)
+{
+    AudioManager *audio = userdata;
+    int16_t *out = (int16_t *)stream;
+    int remaining = len / (int)sizeof(int16_t);
+    uint8_t states[AUDIO_CHUNK_SAMPLES];
+    uint32_t step = 2u * (uint32_t)audio->config.tone_hz;
+    uint32_t rate = (uint32_t)audio->spec.freq;
+
+    while (remaining > 0)
+    {
+        int chunk = remaining < AUDIO_CHUNK_SAMPLES ? remaining : AUDIO_CHUNK_SAMPLES;
+        int got = (int)ring_buffer_read(&audio->tone, states, chunk);
+
+        if (got < chunk)
+        {
+            /* Underrun: pad with silence rather than stalling the device */
+            atomic_fetch_add_explicit(&audio->underruns, 1, memory_order_relaxed);
+            for (int i = got; i < chunk; i++)
+                states[i] = 0;
+        }
+
+        for (int i = 0; i < chunk; i++)
+        {
+            audio->phase += step;
+            if (audio->phase >= rate)
+            {
+                audio->phase -= rate;
+                audio->polarity = !audio->polarity;
+            }
+
+            switch (states[i])
+            {
+            case AUDIO_STATE_TONE:
+                out[i] = audio->polarity ? AUDIO_AMPLITUDE : -AUDIO_AMPLITUDE;
+                break;
+            case AUDIO_STATE_LOW:
+                out[i] = -AUDIO_AMPLITUDE;
+                break;
+            case AUDIO_STATE_HIGH:
+                out[i] = AUDIO_AMPLITUDE;
+                break;
+            default:
+                out[i] = 0;
+                break;
+            }
+        }
+
+        out += chunk;
+        remaining -= chunk;
+    }
+}
+
+int AudioManager_Init(const AudioConfig *config)
+{
+    g_audioManager.config = *config;
+    g_audioManager.device = 0;
+
+    if (config->driver)
+        SDL_setenv("SDL_AUDIODRIVER", config->driver, 1);
+
+    if (SDL_InitSubSystem(SDL_INIT_AUDIO) < 0)
+    {
+        fprintf(stderr, "Audio unavailable: %s\n", SDL_GetError());
+        return 0;
+    }
+
+    SDL_AudioSpec desired = {0};
+    desired.freq = config->sample_rate;
+    desired.format = AUDIO_S16SYS;
+    desired.channels = 1;
+    desired.samples = (Uint16)config->buffer_samples;
+    desired.callback = AudioManager_Callback;
+    desired.userdata = &g_audioManager;
+
+    g_audioManager.device =
+        SDL_OpenAudioDevice(NULL, 0, &desired, &g_audioManager.spec, 0);
+    if (g_audioManager.device == 0)
+    {
+        fprintf(stderr, "Failed to open audio device: %s\n", SDL_GetError());
+        SDL_QuitSubSystem(SDL_INIT_AUDIO);
+        return 0;
+    }
+
+    g_audioManager.latency_samples =
+        (size_t)g_audioManager.spec.freq * config->latency_ms / 1000;
+    if (g_audioManager.latency_samples < g_audioManager.spec.samples)
+        g_audioManager.latency_samples = g_audioManager.spec.samples;
+
+    /* Room for twice the latency target plus a full device buffer */
+    if (ring_buffer_init(&g_audioManager.tone,
+                         2 * g_audioManager.latency_samples + g_audioManager.spec.samples) != 0)
+    {
+        SDL_CloseAudioDevice(g_audioManager.device);
+        SDL_QuitSubSystem(SDL_INIT_AUDIO);
+        g_audioManager.device = 0;
+        return 0;
+    }
+
+    g_audioManager.sample_remainder = 0;
+    g_audioManager.phase = 0;
+    g_audioManager.polarity = 0;
+    atomic_store(&g_audioManager.underruns, 0);
+
+    SDL_PauseAudioDevice(g_audioManager.device, 0);
+    return 1;
+}
+
+void AudioManager_Destroy()
+{
+    if (g_audioManager.device == 0)
+        return;
+
+    unsigned long underruns = atomic_load(&g_audioManager.underruns);
+    if (underruns > 0)
+        fprintf(stderr, "Audio: %lu buffer underruns\n", underruns);
+
+    SDL_CloseAudioDevice(g_audioManager.device);
+    SDL_QuitSubSystem(SDL_INIT_AUDIO);
+    ring_buffer_free(&g_audioManager.tone);
+    g_audioManager.device = 0;
+}
+
+void AudioManager_QueueCycle(int tone_on)
+{
+    if (g_audioManager.device == 0)
+        return;
+
+    const uint32_t cycles_per_second = CHIP8_FRAME_RATE * CHIP8_CYCLES_PER_FRAME;
+
+    g_audioManager.sample_remainder += (uint32_t)g_audioManager.spec.freq;
+    size_t samples = g_audioManager.sample_remainder / cycles_per_second;
+    g_audioManager.sample_remainder %= cycles_per_second;
+
+    /* Free-running emulation may outpace the device; drop instead of lagging */
+    if (!g_audioManager.config.sync_to_audio &&
+        ring_buffer_size(&g_audioManager.tone) >= 2 * g_audioManager.latency_samples)
+        return;
+
+    ring_buffer_fill(&g_audioManager.tone, tone_on ? AUDIO_STATE_TONE : AUDIO_STATE_SILENT, samples);
+}
+
+void AudioManager_QueueSamples(const int8_t *levels, size_t count)
+{
+    if (g_audioManager.device == 0)
+        return;
+
+    if (!g_audioManager.config.sync_to_audio &&
+        ring_buffer_size(&g_audioManager.tone) >= 2 * g_audioManager.latency_samples)
+        return;
+
+    /* Runs of equal levels go into the ring in one fill */
+    size_t start = 0;
+    while (start < count)
+    {
+        size_t end = start + 1;
+        while (end < count && levels[end] == levels[start])
+            end++;
+
+        uint8_t state = levels[start] > 0   ? AUDIO_STATE_HIGH
+                        : levels[start] < 0 ? AUDIO_STATE_LOW
+                                            : AUDIO_STATE_SILENT;
+        ring_buffer_fill(&g_audioManager.tone, state, end - start);
+        start = end;
+    }
+}
+
+int AudioManager_FrameDue()
+{
+    if (g_audioManager.device == 0)
+        return 1;
+
+    return ring_buffer_size(&g_audioManager.tone) < g_audioManager.latency_samples;
+}
@@ -0,0 +1,388 @@
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#endif
+
+#include "capture.h"
+#include "chip8.h"
+#include "processor.h"
+
+/* Number of frames that may be in flight between emulator and encoder */
+#define CAPTURE_QUEUE_DEPTH 8
+
+#define Y4M_LUMA_ON 235
+#define Y4M_LUMA_OFF 16
+#define Y4M_CHROMA_NEUTRAL 128
+
+typedef struct
+{
+    uint8_t pixels[CHIP8_HEIGHT][CHIP8_WIDTH];
+} CaptureFrame;
+
+struct CaptureWriter
+{
+    CaptureConfig config;
+    FILE *output;
+
+    uint8_t *row_buffer;
+    uint8_t *chroma_plane;
+    size_t row_bytes;
+    size_t chroma_bytes;
+};
+
+typedef struct
+{
+    const CaptureConfig *config;
+    CaptureWriter *writer;
+
+    CaptureFrame queue[CAPTURE_QUEUE_DEPTH];
+    unsigned long produced;
+    unsigned long consumed;
+    int finished;
+    int failed;
+
+    pthread_mutex_t lock;
+    pthread_cond_t frame_ready;
+    pthread_cond_t slot_free;
+} CaptureContext;
+
+static double capture_now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int capture_write(CaptureWriter *writer, const void *data, size_t size)
+{
+    return fwrite(data, 1, size, writer->output) == size ? 0 : -1;
+}
+
+static int capture_encode_y4m(CaptureWriter *writer, const uint8_t pixels[CHIP8_HEIGHT][CHIP8_WIDTH])
+{
+    int scale = writer->config.scale;
+
+    if (capture_write(writer, "FRAME\n", 6) != 0)
+        return -1;
+
+    for (int y = 0; y < CHIP8_HEIGHT; y++)
+    {
+        uint8_t *out = writer->row_buffer;
+
+        for (int x = 0; x < CHIP8_WIDTH; x++)
+        {
+            memset(out, pixels[y][x] ? Y4M_LUMA_ON : Y4M_LUMA_OFF, scale);
+            out += scale;
+        }
+
+        for (int i = 0; i < scale; i++)
+        {
+            if (capture_write(writer, writer->row_buffer, writer->row_bytes) != 0)
+                return -1;
+        }
+    }
+
+    /* Cb and Cr planes are constant for a monochrome picture */
+    return capture_write(writer, writer->chroma_plane, writer->chroma_bytes);
+}
+
+static int capture_encode_rgba(CaptureWriter *writer, const uint8_t pixels[CHIP8_HEIGHT][CHIP8_WIDTH])
+{
+    static const uint8_t on[4] = {0xFF, 0xFF, 0xFF, 0xFF};
+    static const uint8_t off[4] = {0x00, 0x00, 0x00, 0xFF};
+    int scale = writer->config.scale;
+
+    for (int y = 0; y < CHIP8_HEIGHT; y++)
+    {
+        uint8_t *out = writer->row_buffer;
+
+        for (int x = 0; x < CHIP8_WIDTH; x++)
+        {
+            const uint8_t *color = pixels[y][x] ? on : off;
+
+            for (int i = 0; i < scale; i++)
+            {
+                memcpy(out, color, 4);
+                out += 4;
+            }
+        }
+
+        for (int i = 0; i < scale; i++)
+        {
+            if (capture_write(writer, writer->row_buffer, writer->row_bytes) != 0)
+                return -1;
+        }
+    }
+
+    return 0;
+}
+
+int capture_writer_frame(CaptureWriter *writer, const uint8_t pixels[CHIP8_HEIGHT][CHIP8_WIDTH])
+{
+    return (writer->config.format == CAPTURE_FORMAT_Y4M)
+               ? capture_encode_y4m(writer, pixels)
+               : capture_encode_rgba(writer, pixels);
+}
+
+static void *capture_encoder_thread(void *arg)
+{
+    CaptureContext *ctx = arg;
+
+    for (;;)
+    {
+        pthread_mutex_lock(&ctx->lock);
+        while (ctx->consumed == ctx->produced && !ctx->finished)
+            pthread_cond_wait(&ctx->frame_ready, &ctx->lock);
+
+        if (ctx->consumed == ctx->produced)
+        {
+            pthread_mutex_unlock(&ctx->lock);
+            break;
+        }
+        pthread_mutex_unlock(&ctx->lock);
+
+        /* The slot is owned by the encoder until consumed is advanced */
+        const CaptureFrame *frame = &ctx->queue[ctx->consumed % CAPTURE_QUEUE_DEPTH];
+        int result = capture_writer_frame(ctx->writer, frame->pixels);
+
+        pthread_mutex_lock(&ctx->lock);
+        ctx->consumed++;
+        if (result != 0)
+            ctx->failed = 1;
+        pthread_cond_signal(&ctx->slot_free);
+        pthread_mutex_unlock(&ctx->lock);
+
+        if (result != 0)
+            break;
+    }
+
+    return NULL;
+}
+
+static FILE *capture_open_output(const char *path)
+{
+    if (strcmp(path, "-") == 0)
+    {
+#ifdef _WIN32
+        _setmode(_fileno(stdout), _O_BINARY);
+#endif
+        return stdout;
+    }
+
+    return fopen(path, "wb");
+}
+
+static void capture_snapshot_display(CaptureFrame *frame)
+{
+    for (int y = 0; y < CHIP8_HEIGHT; y++)
+    {
+        for (int x = 0; x < CHIP8_WIDTH; x++)
+        {
+            frame->pixels[y][x] = chip8_memory.display[y][x] != 0;
+        }
+    }
+}
+
+/* Queues a frame for the encoder, waiting for a free slot; returns -1 once writing has failed */
+static int capture_produce(CaptureContext *ctx, const CaptureFrame *frame)
+{
+    pthread_mutex_lock(&ctx->lock);
+    while (ctx->produced - ctx->consumed == CAPTURE_QUEUE_DEPTH && !ctx->failed)
+        pthread_cond_wait(&ctx->slot_free, &ctx->lock);
+
+    if (ctx->failed)
+    {
+        pthread_mutex_unlock(&ctx->lock);
+        return -1;
+    }
+    pthread_mutex_unlock(&ctx->lock);
+
+    /* The slot is owned by the emulator until produced is advanced */
+    ctx->queue[ctx->produced % CAPTURE_QUEUE_DEPTH] = *frame;
+
+    pthread_mutex_lock(&ctx->lock);
+    ctx->produced++;
+    pthread_cond_signal(&ctx->frame_ready);
+    pthread_mutex_unlock(&ctx->lock);
+    return 0;
+}
+
+CaptureWriter *capture_writer_open(const CaptureConfig *config)
+{
+    if (config->scale < 1)
+    {
+        fprintf(stderr, "ERROR: Capture scale must be at least 1.\n");
+        return NULL;
+    }
+
+    CaptureWriter *writer = calloc(1, sizeof(CaptureWriter));
+    if (writer == NULL)
+    {
+        fprintf(stderr, "ERROR: Out of memory while setting up capture.\n");
+        return NULL;
+    }
+    writer->config = *config;
+
+    writer->output = capture_open_output(config->output_path);
+    if (writer->output == NULL)
+    {
+        perror("Failed to open capture output");
+        free(writer);
+        return NULL;
+    }
+    setvbuf(writer->output, NULL, _IOFBF, 1 << 20);
+
+    int width = CHIP8_WIDTH * config->scale;
+    int height = CHIP8_HEIGHT * config->scale;
+
+    if (config->format == CAPTURE_FORMAT_Y4M)
+    {
+        writer->row_bytes = width;
+        writer->chroma_bytes = 2 * (size_t)(width / 2) * (height / 2);
+        writer->chroma_plane = malloc(writer->chroma_bytes);
+        if (writer->chroma_plane != NULL)
+            memset(writer->chroma_plane, Y4M_CHROMA_NEUTRAL, writer->chroma_bytes);
+    }
+    else
+    {
+        writer->row_bytes = (size_t)width * 4;
+    }
+    writer->row_buffer = malloc(writer->row_bytes);
+
+    if (writer->row_buffer == NULL ||
+        (config->format == CAPTURE_FORMAT_Y4M && writer->chroma_plane == NULL))
+    {
+        fprintf(stderr, "ERROR: Out of memory while setting up capture.\n");
+        capture_writer_close(writer);
+        return NULL;
+    }
+
+    if (config->format == CAPTURE_FORMAT_Y4M &&
+        fprintf(writer->output, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n",
+                width, height, CHIP8_FRAME_RATE) < 0)
+    {
+        perror("Failed to write capture header");
+        capture_writer_close(writer);
+        return NULL;
+    }
+
+    return writer;
+}
+
+int capture_writer_close(CaptureWriter *writer)
+{
+    if (writer == NULL)
+        return 0;
+
+    int status = fflush(writer->output) == 0 ? 0 : -1;
+
+    if (writer->output != stdout)
+        fclose(writer->output);
+
+    free(writer->row_buffer);
+    free(writer->chroma_plane);
+    free(writer);
+    return status;
+}
+
+int capture_run(const CaptureConfig *config)
+{
+    CaptureContext ctx = {0};
+    ctx.config = config;
+
+    ctx.writer = capture_writer_open(config);
+    if (ctx.writer == NULL)
+        return -1;
+
+    int status = 0;
+
+    pthread_mutex_init(&ctx.lock, NULL);
+    pthread_cond_init(&ctx.frame_ready, NULL);
+    pthread_cond_init(&ctx.slot_free, NULL);
+
+    pthread_t encoder;
+    if (pthread_create(&encoder, NULL, capture_encoder_thread, &ctx) != 0)
+    {
+        fprintf(stderr, "ERROR: Failed to start capture encoder thread.\n");
+        status = -1;
+        goto cleanup_sync;
+    }
+
+    double start = capture_now_seconds();
+
+    /* Only the last frame of a processor_frames() run can change the display */
+    CaptureFrame shown;
+    uint64_t shown_hash = chip8_memory.display_hash;
+    capture_snapshot_display(&shown);
+
+    int stopped = 0;
+
+    for (unsigned long frame = 0; frame < config->frames && !stopped;)
+    {
+        unsigned long left = config->frames - frame;
+        unsigned int ran;
+
+        processor_frames(left < UINT_MAX ? (unsigned int)left : UINT_MAX, &ran, NULL);
+
+        for (unsigned int i = 0; i < ran && !stopped; i++)
+        {
+            if (i + 1 == ran && chip8_memory.display_hash != shown_hash)
+            {
+                shown_hash = chip8_memory.display_hash;
+                capture_snapshot_display(&shown);
+            }
+            stopped = capture_produce(&ctx, &shown) != 0;
+        }
+
+        frame += ran;
+    }
+
+    pthread_mutex_lock(&ctx.lock);
+    ctx.finished = 1;
+    pthread_cond_signal(&ctx.frame_ready);
+    pthread_mutex_unlock(&ctx.lock);
+
+    pthread_join(encoder, NULL);
+
+    if (fflush(ctx.writer->output) != 0)
+        ctx.failed = 1;
+
+    double elapsed = capture_now_seconds() - start;
+
+    if (ctx.failed)
+    {
+        perror("Failed to write capture output");
+        status = -1;
+    }
+    else
+    {
+        double realtime = (double)ctx.consumed / CHIP8_FRAME_RATE;
+        fprintf(stderr,
+                "Captured %lu frames in %.3f s (%.1f fps, %.1fx real time)\n",
+                ctx.consumed,
+                elapsed,
+                elapsed > 0 ? ctx.consumed / elapsed : 0.0,
+                elapsed > 0 ? realtime / elapsed : 0.0);
+        processor_report_stats(stderr);
+
+        if (chip8_memory.fault)
+            fprintf(stderr, "CPU halted at 0x%03X: %s\n",
+                    chip8_memory.program_counter, chip8_fault_name(chip8_memory.fault));
+    }
+
+cleanup_sync:
+    pthread_cond_destroy(&ctx.slot_free);
+    pthread_cond_destroy(&ctx.frame_ready);
+    pthread_mutex_destroy(&ctx.lock);
+
+    capture_writer_close(ctx.writer);
+    return status;
+}
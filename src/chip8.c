@@ -2,25 +2,41 @@
 #include <stdlib.h>
 #include <time.h>
 #include <stdint.h>
+#include <string.h>
 #include "chip8.h"
 #include "opcode_table.h"
 
 static void chip8_reset_pc();
 static void chip8_load_fonts();
 
-MEMORY chip8_memory = {0};
+static MEMORY chip8_default_vm = {0};
+_Thread_local MEMORY *chip8_vm = &chip8_default_vm;
 
 void chip8_init()
 {
-    srand(time(NULL));
+    chip8_seed((uint32_t)time(NULL));
     chip8_load_fonts();
     chip8_reset_pc();
     ot_init();
+    chip8_rehash();
+}
+
+void chip8_seed(uint32_t seed)
+{
+    /* xorshift never leaves the all-zero state */
+    chip8_memory.rng_state = seed ? seed : 0x2545F491u;
 }
 
 uint8_t chip8_generate_random_number()
 {
-    return rand() % 256;
+    uint32_t x = chip8_memory.rng_state;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    chip8_memory.rng_state = x;
+
+    return (uint8_t)(x >> 24);
 }
 
 int chip8_load_ROM(const char *filename)
@@ -53,7 +69,7 @@ int chip8_load_ROM(const char *filename)
     {
         fprintf(stderr,
                 "ERROR: ROM size (%ld bytes) is too large. "
-                "It cannot fit into CHIP-8 memory.\n",
+                "It cannot fit into CHIP-8 memory (XO-CHIP ROMs need --xo-chip).\n",
                 size);
         fclose(fp);
         return -1;
@@ -80,9 +96,112 @@ int chip8_load_ROM(const char *filename)
     }
 
     fclose(fp);
+    chip8_rehash();
     return 0;
 }
 
+int chip8_load_ROM_buffer(const uint8_t *data, size_t size)
+{
+    if (size > (4096 - START_ADDRESS))
+    {
+        fprintf(stderr,
+                "ERROR: ROM size (%zu bytes) is too large. "
+                "It cannot fit into CHIP-8 memory.\n",
+                size);
+        return -1;
+    }
+
+    memcpy(chip8_memory.ram + START_ADDRESS, data, size);
+    chip8_rehash();
+    return 0;
+}
+
+void chip8_write_ram(uint16_t address, uint8_t value)
+{
+    chip8_memory.ram_hash ^= chip8_ram_key(address, chip8_memory.ram[address]) ^
+                             chip8_ram_key(address, value);
+    chip8_memory.ram[address] = value;
+}
+
+void chip8_rehash(void)
+{
+    uint64_t ram_hash = 0;
+    uint64_t display_hash = 0;
+
+    for (uint16_t address = 0; address < sizeof(chip8_memory.ram); address++)
+        ram_hash ^= chip8_ram_key(address, chip8_memory.ram[address]);
+
+    for (unsigned row = 0; row < CHIP8_HEIGHT; row++)
+    {
+        for (unsigned col = 0; col < CHIP8_WIDTH; col++)
+        {
+            if (chip8_memory.display[row][col])
+                display_hash ^= chip8_pixel_key(row, col);
+        }
+    }
+
+    chip8_memory.ram_hash = ram_hash;
+    chip8_memory.display_hash = display_hash;
+}
+
+uint64_t chip8_state_hash(void)
+{
+    uint64_t words[11];
+    uint16_t keys = 0;
+
+    for (int key = 0; key < 16; key++)
+        keys |= (uint16_t)(chip8_memory.keypad[key] != 0) << key;
+
+    memcpy(words, chip8_memory.registers, 16);
+    memcpy(words + 2, chip8_memory.stack, 32);
+    words[6] = chip8_memory.index | (uint64_t)chip8_memory.program_counter << 16 |
+               (uint64_t)keys << 32 | (uint64_t)chip8_memory.stack_pointer << 48 |
+               (uint64_t)chip8_memory.fault << 56;
+    words[7] = chip8_memory.delay_timer | chip8_memory.sound_timer << 8 |
+               chip8_memory.waiting_for_key << 16 | chip8_memory.key_register << 24 |
+               (uint64_t)chip8_memory.rng_state << 32;
+    words[8] = chip8_memory.ram_hash;
+    words[9] = chip8_memory.display_hash;
+    words[10] = chip8_memory.frame_cycle;
+
+    uint64_t hash = 0;
+    for (int i = 0; i < 11; i++)
+        hash = chip8_hash_mix(hash ^ words[i]);
+    return hash;
+}
+
+void chip8_set_key(uint8_t key, uint8_t pressed)
+{
+    chip8_memory.keypad[key & 0xFu] = pressed;
+
+    if (pressed && chip8_memory.waiting_for_key)
+    {
+        chip8_memory.registers[chip8_memory.key_register] = key & 0xFu;
+        chip8_memory.waiting_for_key = 0;
+    }
+}
+
+void chip8_fault(uint8_t fault)
+{
+    chip8_memory.fault = fault;
+    chip8_memory.program_counter -= 2;
+}
+
+const char *chip8_fault_name(uint8_t fault)
+{
+    static const char *const names[CHIP8_FAULT_COUNT] = {
+        [CHIP8_FAULT_NONE] = "none",
+        [CHIP8_FAULT_STACK_OVERFLOW] = "stack overflow",
+        [CHIP8_FAULT_STACK_UNDERFLOW] = "stack underflow",
+        [CHIP8_FAULT_MEMORY_RANGE] = "memory access out of range",
+        [CHIP8_FAULT_PC_RANGE] = "program counter out of range",
+        [CHIP8_FAULT_KEY_RANGE] = "key index out of range",
+        [CHIP8_FAULT_INVALID_OPCODE] = "invalid opcode",
+    };
+
+    return fault < CHIP8_FAULT_COUNT ? names[fault] : "unknown fault";
+}
+
 static void chip8_load_fonts()
 {
     uint8_t fontset[FONTSET_SIZE] =
@@ -0,0 +1,961 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "debugger.h"
+#include "chip8.h"
+#include "net.h"
+#include "processor.h"
+
+int debugger_enabled = 0;
+int debugger_active = 0;
+
+#ifndef _WIN32
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+#define DEBUGGER_MAX_BREAKPOINTS 64
+#define DEBUGGER_MAX_WATCHPOINTS 16
+#define DEBUGGER_PACKET_SIZE 4096
+#define DEBUGGER_REGISTER_COUNT 21
+
+/* Z-packet types */
+#define WATCH_WRITE 2
+#define WATCH_READ 3
+#define WATCH_ACCESS 4
+
+/* Signals reported in stop replies */
+#define SIGNAL_INT 2
+#define SIGNAL_ILL 4
+#define SIGNAL_TRAP 5
+#define SIGNAL_SEGV 11
+
+typedef struct
+{
+    uint16_t address;
+    uint16_t length;
+    int type;
+} Watchpoint;
+
+typedef struct
+{
+    int listen_fd;
+    int client_fd;
+    char socket_path[NET_PATH_SIZE];
+
+    int halted;
+    int stepping;
+    int skip_breakpoint;
+    int no_ack;
+
+    uint16_t breakpoints[DEBUGGER_MAX_BREAKPOINTS];
+    int breakpoint_count;
+    Watchpoint watchpoints[DEBUGGER_MAX_WATCHPOINTS];
+    int watchpoint_count;
+
+    char input[DEBUGGER_PACKET_SIZE];
+    size_t input_length;
+} Debugger;
+
+static Debugger dbg = {.listen_fd = -1, .client_fd = -1};
+
+static const char target_xml[] =
+    "<?xml version=\"1.0\"?>"
+    "<!DOCTYPE target SYSTEM \"gdb-target.dtd\">"
+    "<target version=\"1.0\">"
+    "<feature name=\"org.chip8.core\">"
+    "<reg name=\"v0\" bitsize=\"8\" type=\"uint8\"/>"
+    "<reg name=\"v1\" bitsize=\"8\" type=\"uint8\"/>"
+    "<reg name=\"v2\" bitsize=\"8\" type=\"uint8\"/>"
+    "<reg name=\"v3\" bitsize=\"8\" type=\"uint8\"/>"
+    "<reg name=\"v4\" bitsize=\"8\" type=\"uint8\"/>"
+    "<reg name=\"v5\" bitsize=\"8\" type=\"uint8\"/>"
+    "<reg name=\"v6\" bitsize=\"8\" type=\"uint8\"/>"
+    "<reg name=\"v7\" bitsize=\"8\" type=\"uint8\"/>"
+    "<reg name=\"v8\" bitsize=\"8\" type=\"uint8\"/>"
+    "<reg name=\"v9\" bitsize=\"8\" type=\"uint8\"/>"
+    "<reg name=\"va\" bitsize=\"8\" type=\"uint8\"/>"
+    "<reg name=\"vb\" bitsize=\"8\" type=\"uint8\"/>"
+    "<reg name=\"vc\" bitsize=\"8\" type=\"uint8\"/>"
+    "<reg name=\"vd\" bitsize=\"8\" type=\"uint8\"/>"
+    "<reg name=\"ve\" bitsize=\"8\" type=\"uint8\"/>"
+    "<reg name=\"vf\" bitsize=\"8\" type=\"uint8\"/>"
+    "<reg name=\"i\" bitsize=\"16\" type=\"data_ptr\"/>"
+    "<reg name=\"pc\" bitsize=\"16\" type=\"code_ptr\"/>"
+    "<reg name=\"sp\" bitsize=\"8\" type=\"uint8\"/>"
+    "<reg name=\"dt\" bitsize=\"8\" type=\"uint8\"/>"
+    "<reg name=\"st\" bitsize=\"8\" type=\"uint8\"/>"
+    "</feature>"
+    "</target>";
+
+static const char hex_digits[] = "0123456789abcdef";
+
+/* Instrumented execution is only needed while something can stop the machine */
+static void debugger_update_active(void)
+{
+    debugger_active = dbg.halted || dbg.stepping || dbg.breakpoint_count > 0 || dbg.watchpoint_count > 0;
+}
+
+static int hex_value(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
+static char *hex_byte(char *out, uint8_t value)
+{
+    *out++ = hex_digits[value >> 4];
+    *out++ = hex_digits[value & 0xFu];
+    return out;
+}
+
+static int parse_hex_byte(const char *in)
+{
+    int high = hex_value(in[0]);
+    int low = (high < 0) ? -1 : hex_value(in[1]);
+    return (low < 0) ? -1 : (high << 4) | low;
+}
+
+static void debugger_disconnect(void)
+{
+    if (dbg.client_fd < 0)
+        return;
+
+    close(dbg.client_fd);
+    dbg.client_fd = -1;
+    dbg.input_length = 0;
+    dbg.no_ack = 0;
+
+    /* Without a client nobody could resume the machine */
+    dbg.breakpoint_count = 0;
+    dbg.watchpoint_count = 0;
+    dbg.stepping = 0;
+    dbg.halted = 0;
+    debugger_update_active();
+    fprintf(stderr, "Debugger: client disconnected\n");
+}
+
+static int debugger_write(const char *data, size_t length)
+{
+    while (length > 0)
+    {
+        ssize_t written = write(dbg.client_fd, data, length);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                struct pollfd pfd = {dbg.client_fd, POLLOUT, 0};
+                poll(&pfd, 1, 100);
+                continue;
+            }
+            debugger_disconnect();
+            return -1;
+        }
+        data += written;
+        length -= (size_t)written;
+    }
+    return 0;
+}
+
+static void debugger_send(const char *payload)
+{
+    static char packet[2 * DEBUGGER_PACKET_SIZE + 4];
+    size_t length = strlen(payload);
+    uint8_t checksum = 0;
+
+    if (length > sizeof(packet) - 4)
+        length = sizeof(packet) - 4;
+
+    packet[0] = '$';
+    for (size_t i = 0; i < length; i++)
+    {
+        packet[1 + i] = payload[i];
+        checksum += (uint8_t)payload[i];
+    }
+    packet[1 + length] = '#';
+    hex_byte(packet + 2 + length, checksum);
+
+    debugger_write(packet, length + 4);
+}
+
+static void debugger_stop(const char *reason)
+{
+    dbg.halted = 1;
+    dbg.stepping = 0;
+    debugger_active = 1;
+
+    if (dbg.client_fd >= 0)
+        debugger_send(reason);
+}
+
+static void debugger_stop_signal(int signal)
+{
+    char reply[8];
+    snprintf(reply, sizeof(reply), "S%02x", signal);
+    debugger_stop(reply);
+}
+
+static void debugger_stop_fault(void)
+{
+    debugger_stop_signal(chip8_memory.fault == CHIP8_FAULT_INVALID_OPCODE ? SIGNAL_ILL : SIGNAL_SEGV);
+}
+
+/* Returns the value of register `n`, or -1 if there is no such register */
+static int debugger_read_register(int n)
+{
+    if (n >= 0 && n < 16)
+        return chip8_memory.registers[n];
+
+    switch (n)
+    {
+    case 16:
+        return chip8_memory.index;
+    case 17:
+        return chip8_memory.program_counter;
+    case 18:
+        return chip8_memory.stack_pointer;
+    case 19:
+        return chip8_memory.delay_timer;
+    case 20:
+        return chip8_memory.sound_timer;
+    default:
+        return -1;
+    }
+}
+
+static int debugger_register_size(int n)
+{
+    return (n == 16 || n == 17) ? 2 : 1;
+}
+
+static void debugger_write_register(int n, uint16_t value)
+{
+    if (n >= 0 && n < 16)
+        chip8_memory.registers[n] = (uint8_t)value;
+    else if (n == 16)
+        chip8_memory.index = value & 0x0FFFu;
+    else if (n == 17)
+        chip8_memory.program_counter = value & 0x0FFFu;
+    else if (n == 18)
+        chip8_memory.stack_pointer = (uint8_t)(value & 0xFu);
+    else if (n == 19)
+        chip8_memory.delay_timer = (uint8_t)value;
+    else if (n == 20)
+        chip8_memory.sound_timer = (uint8_t)value;
+}
+
+/* Registers are sent little-endian, as GDB expects for a target without a declared byte order */
+static char *debugger_encode_register(char *out, int n)
+{
+    int value = debugger_read_register(n);
+
+    out = hex_byte(out, (uint8_t)value);
+    if (debugger_register_size(n) == 2)
+        out = hex_byte(out, (uint8_t)(value >> 8));
+    return out;
+}
+
+static const char *debugger_decode_register(const char *in, int n)
+{
+    int low = parse_hex_byte(in);
+    if (low < 0)
+        return NULL;
+    in += 2;
+
+    int value = low;
+    if (debugger_register_size(n) == 2)
+    {
+        int high = parse_hex_byte(in);
+        if (high < 0)
+            return NULL;
+        in += 2;
+        value |= high << 8;
+    }
+
+    debugger_write_register(n, (uint16_t)value);
+    return in;
+}
+
+static void debugger_handle_read_registers(void)
+{
+    char reply[2 * DEBUGGER_REGISTER_COUNT * 2 + 1];
+    char *out = reply;
+
+    for (int n = 0; n < DEBUGGER_REGISTER_COUNT; n++)
+        out = debugger_encode_register(out, n);
+    *out = '\0';
+
+    debugger_send(reply);
+}
+
+static void debugger_handle_write_registers(const char *args)
+{
+    for (int n = 0; n < DEBUGGER_REGISTER_COUNT && *args; n++)
+    {
+        args = debugger_decode_register(args, n);
+        if (args == NULL)
+        {
+            debugger_send("E01");
+            return;
+        }
+    }
+    debugger_send("OK");
+}
+
+static void debugger_handle_read_register(const char *args)
+{
+    char reply[8];
+    int n = (int)strtol(args, NULL, 16);
+
+    if (debugger_read_register(n) < 0)
+    {
+        debugger_send("E01");
+        return;
+    }
+
+    *debugger_encode_register(reply, n) = '\0';
+    debugger_send(reply);
+}
+
+static void debugger_handle_write_register(const char *args)
+{
+    char *value;
+    int n = (int)strtol(args, &value, 16);
+
+    if (debugger_read_register(n) < 0 || *value != '=' ||
+        debugger_decode_register(value + 1, n) == NULL)
+    {
+        debugger_send("E01");
+        return;
+    }
+    debugger_send("OK");
+}
+
+/* Parses "addr,length" and clips the range to RAM */
+static int debugger_parse_range(const char *args, unsigned long *address, unsigned long *length, char **end)
+{
+    char *comma;
+
+    *address = strtoul(args, &comma, 16);
+    if (*comma != ',')
+        return -1;
+    *length = strtoul(comma + 1, end, 16);
+
+    if (*address >= sizeof(chip8_memory.ram))
+        return -1;
+    if (*length > sizeof(chip8_memory.ram) - *address)
+        *length = sizeof(chip8_memory.ram) - *address;
+    return 0;
+}
+
+static void debugger_handle_read_memory(const char *args)
+{
+    static char reply[DEBUGGER_PACKET_SIZE];
+    unsigned long address, length;
+    char *end;
+
+    if (debugger_parse_range(args, &address, &length, &end) != 0)
+    {
+        debugger_send("E01");
+        return;
+    }
+
+    if (length > (sizeof(reply) - 1) / 2)
+        length = (sizeof(reply) - 1) / 2;
+
+    char *out = reply;
+    for (unsigned long i = 0; i < length; i++)
+        out = hex_byte(out, chip8_memory.ram[address + i]);
+    *out = '\0';
+
+    debugger_send(reply);
+}
+
+static void debugger_handle_write_memory(const char *args)
+{
+    unsigned long address, length;
+    char *data;
+
+    if (debugger_parse_range(args, &address, &length, &data) != 0 || *data != ':')
+    {
+        debugger_send("E01");
+        return;
+    }
+    data++;
+
+    for (unsigned long i = 0; i < length; i++, data += 2)
+    {
+        int value = parse_hex_byte(data);
+        if (value < 0)
+        {
+            debugger_send("E01");
+            return;
+        }
+        chip8_write_ram(address + i, (uint8_t)value);
+    }
+    debugger_send("OK");
+}
+
+static int debugger_find_breakpoint(uint16_t address)
+{
+    for (int i = 0; i < dbg.breakpoint_count; i++)
+    {
+        if (dbg.breakpoints[i] == address)
+            return i;
+    }
+    return -1;
+}
+
+static int debugger_find_watchpoint(int type, uint16_t address, uint16_t length)
+{
+    for (int i = 0; i < dbg.watchpoint_count; i++)
+    {
+        const Watchpoint *w = &dbg.watchpoints[i];
+        if (w->type == type && w->address == address && w->length == length)
+            return i;
+    }
+    return -1;
+}
+
+static void debugger_handle_breakpoint(const char *args, int insert)
+{
+    char *rest;
+    int type = (int)strtol(args, &rest, 16);
+
+    if (*rest != ',')
+    {
+        debugger_send("E01");
+        return;
+    }
+
+    char *end;
+    unsigned long address = strtoul(rest + 1, &end, 16);
+    unsigned long length = (*end == ',') ? strtoul(end + 1, NULL, 16) : 1;
+    if (length == 0)
+        length = 1;
+
+    if (type == 0 || type == 1)
+    {
+        int i = debugger_find_breakpoint((uint16_t)address);
+
+        if (insert && i < 0)
+        {
+            if (dbg.breakpoint_count == DEBUGGER_MAX_BREAKPOINTS)
+            {
+                debugger_send("E02");
+                return;
+            }
+            dbg.breakpoints[dbg.breakpoint_count++] = (uint16_t)address;
+        }
+        else if (!insert && i >= 0)
+        {
+            dbg.breakpoints[i] = dbg.breakpoints[--dbg.breakpoint_count];
+        }
+        debugger_send("OK");
+    }
+    else if (type == WATCH_WRITE || type == WATCH_READ || type == WATCH_ACCESS)
+    {
+        int i = debugger_find_watchpoint(type, (uint16_t)address, (uint16_t)length);
+
+        if (insert && i < 0)
+        {
+            if (dbg.watchpoint_count == DEBUGGER_MAX_WATCHPOINTS)
+            {
+                debugger_send("E02");
+                return;
+            }
+            dbg.watchpoints[dbg.watchpoint_count++] =
+                (Watchpoint){(uint16_t)address, (uint16_t)length, type};
+        }
+        else if (!insert && i >= 0)
+        {
+            dbg.watchpoints[i] = dbg.watchpoints[--dbg.watchpoint_count];
+        }
+        debugger_send("OK");
+    }
+    else
+    {
+        debugger_send("");
+    }
+}
+
+static void debugger_handle_resume(const char *args, int step)
+{
+    if (*args)
+        chip8_memory.program_counter = (uint16_t)(strtoul(args, NULL, 16) & 0x0FFFu);
+
+    dbg.halted = 0;
+    dbg.stepping = step;
+    /* Do not stop again on the breakpoint the machine is sitting on */
+    dbg.skip_breakpoint = 1;
+}
+
+static void debugger_handle_target_xml(const char *args)
+{
+    static char reply[DEBUGGER_PACKET_SIZE];
+    char *comma;
+    unsigned long offset = strtoul(args, &comma, 16);
+    unsigned long length = (*comma == ',') ? strtoul(comma + 1, NULL, 16) : 0;
+    size_t total = sizeof(target_xml) - 1;
+
+    if (offset >= total)
+    {
+        debugger_send("l");
+        return;
+    }
+
+    if (length > sizeof(reply) - 2)
+        length = sizeof(reply) - 2;
+    if (length > total - offset)
+        length = total - offset;
+
+    reply[0] = (offset + length < total) ? 'm' : 'l';
+    memcpy(reply + 1, target_xml + offset, length);
+    reply[1 + length] = '\0';
+    debugger_send(reply);
+}
+
+static void debugger_handle_query(const char *packet)
+{
+    static const char xfer_prefix[] = "qXfer:features:read:target.xml:";
+    char reply[64];
+
+    if (strncmp(packet, "qSupported", 10) == 0)
+    {
+        snprintf(reply, sizeof(reply),
+                 "PacketSize=%x;qXfer:features:read+;QStartNoAckMode+",
+                 DEBUGGER_PACKET_SIZE);
+        debugger_send(reply);
+    }
+    else if (strncmp(packet, xfer_prefix, sizeof(xfer_prefix) - 1) == 0)
+    {
+        debugger_handle_target_xml(packet + sizeof(xfer_prefix) - 1);
+    }
+    else if (strcmp(packet, "qAttached") == 0)
+    {
+        debugger_send("1");
+    }
+    else if (strcmp(packet, "qC") == 0)
+    {
+        debugger_send("QC1");
+    }
+    else if (strcmp(packet, "qfThreadInfo") == 0)
+    {
+        debugger_send("m1");
+    }
+    else if (strcmp(packet, "qsThreadInfo") == 0)
+    {
+        debugger_send("l");
+    }
+    else
+    {
+        debugger_send("");
+    }
+}
+
+static void debugger_handle_packet(char *packet)
+{
+    char *args = packet + 1;
+
+    switch (packet[0])
+    {
+    case '?':
+        debugger_send("S05");
+        break;
+    case 'g':
+        debugger_handle_read_registers();
+        break;
+    case 'G':
+        debugger_handle_write_registers(args);
+        break;
+    case 'p':
+        debugger_handle_read_register(args);
+        break;
+    case 'P':
+        debugger_handle_write_register(args);
+        break;
+    case 'm':
+        debugger_handle_read_memory(args);
+        break;
+    case 'M':
+        debugger_handle_write_memory(args);
+        break;
+    case 'c':
+        debugger_handle_resume(args, 0);
+        break;
+    case 's':
+        debugger_handle_resume(args, 1);
+        break;
+    case 'Z':
+        debugger_handle_breakpoint(args, 1);
+        break;
+    case 'z':
+        debugger_handle_breakpoint(args, 0);
+        break;
+    case 'q':
+        debugger_handle_query(packet);
+        break;
+    case 'Q':
+        if (strcmp(packet, "QStartNoAckMode") == 0)
+        {
+            debugger_send("OK");
+            dbg.no_ack = 1;
+        }
+        else
+        {
+            debugger_send("");
+        }
+        break;
+    case 'H':
+    case 'T':
+        debugger_send("OK");
+        break;
+    case 'D':
+        debugger_send("OK");
+        debugger_disconnect();
+        break;
+    case 'k':
+        debugger_disconnect();
+        break;
+    default:
+        /* Includes vCont?, vMustReplyEmpty and every unsupported packet */
+        debugger_send("");
+        break;
+    }
+}
+
+/* Consumes complete packets from the input buffer */
+static void debugger_process_input(void)
+{
+    size_t start = 0;
+
+    while (start < dbg.input_length && dbg.client_fd >= 0)
+    {
+        char c = dbg.input[start];
+
+        if (c == 0x03)
+        {
+            start++;
+            if (!dbg.halted)
+                debugger_stop_signal(SIGNAL_INT);
+            continue;
+        }
+
+        if (c != '$')
+        {
+            /* Acknowledgements and line noise */
+            start++;
+            continue;
+        }
+
+        char *hash = memchr(dbg.input + start, '#', dbg.input_length - start);
+        if (hash == NULL || (size_t)(hash - dbg.input) + 3 > dbg.input_length)
+            break;
+
+        uint8_t checksum = 0;
+        for (char *p = dbg.input + start + 1; p < hash; p++)
+            checksum += (uint8_t)*p;
+
+        int expected = parse_hex_byte(hash + 1);
+        size_t next = (size_t)(hash - dbg.input) + 3;
+
+        if (!dbg.no_ack)
+            debugger_write(expected == checksum ? "+" : "-", 1);
+
+        if (expected == checksum && dbg.client_fd >= 0)
+        {
+            *hash = '\0';
+            debugger_handle_packet(dbg.input + start + 1);
+        }
+
+        start = next;
+    }
+
+    if (dbg.client_fd < 0)
+        return;
+
+    if (start > 0)
+    {
+        memmove(dbg.input, dbg.input + start, dbg.input_length - start);
+        dbg.input_length -= start;
+    }
+    else if (dbg.input_length == sizeof(dbg.input))
+    {
+        /* A packet larger than advertised; drop it */
+        dbg.input_length = 0;
+    }
+}
+
+static void debugger_accept(void)
+{
+    int fd = accept(dbg.listen_fd, NULL, NULL);
+    if (fd < 0)
+        return;
+
+    if (dbg.client_fd >= 0)
+    {
+        /* One client at a time */
+        close(fd);
+        return;
+    }
+
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    dbg.client_fd = fd;
+    dbg.input_length = 0;
+    dbg.no_ack = 0;
+    dbg.halted = 1;
+    fprintf(stderr, "Debugger: client connected\n");
+}
+
+static int debugger_receive(int timeout_ms)
+{
+    struct pollfd pfd = {dbg.client_fd, POLLIN, 0};
+
+    if (poll(&pfd, 1, timeout_ms) <= 0)
+        return 0;
+
+    ssize_t received = read(dbg.client_fd,
+                            dbg.input + dbg.input_length,
+                            sizeof(dbg.input) - dbg.input_length);
+    if (received == 0 || (received < 0 && errno != EAGAIN && errno != EINTR))
+    {
+        debugger_disconnect();
+        return 0;
+    }
+    if (received < 0)
+        return 0;
+
+    dbg.input_length += (size_t)received;
+    debugger_process_input();
+    return 1;
+}
+
+int debugger_init(const char *endpoint)
+{
+    dbg.listen_fd = net_listen(endpoint, "debugger", 1, dbg.socket_path);
+    if (dbg.listen_fd < 0)
+        return -1;
+
+    /* A client vanishing mid-reply must not kill the emulator */
+    signal(SIGPIPE, SIG_IGN);
+
+    dbg.halted = 1;
+    debugger_enabled = 1;
+    debugger_active = 1;
+
+    if (dbg.socket_path[0] == '\0')
+        fprintf(stderr, "Debugger: waiting for GDB on 127.0.0.1:%s (target remote :%s)\n", endpoint, endpoint);
+    else
+        fprintf(stderr, "Debugger: waiting for GDB on %s (target remote %s)\n", endpoint, endpoint);
+    return 0;
+}
+
+void debugger_poll(void)
+{
+    if (dbg.client_fd < 0)
+        debugger_accept();
+    if (dbg.client_fd < 0)
+        return;
+
+    /*
+     * While halted, GDB sends one request after each reply; keep serving
+     * for a few milliseconds so a burst of requests is not paced at one
+     * packet per frame.
+     */
+    int rounds = dbg.halted ? 8 : 1;
+    for (int i = 0; i < rounds && dbg.client_fd >= 0; i++)
+    {
+        if (!debugger_receive(dbg.halted ? 1 : 0) && !dbg.halted)
+            break;
+    }
+
+    /* A fault hit on the uninstrumented path is reported here, a frame late */
+    if (dbg.client_fd >= 0 && !dbg.halted && chip8_memory.fault)
+        debugger_stop_fault();
+
+    /* Packets resume, halt, and set or clear breakpoints and watchpoints */
+    debugger_update_active();
+}
+
+/* Returns the watchpoint type hit by `op` at the current I, or 0 */
+static int debugger_check_watchpoints(uint16_t op, uint16_t *hit)
+{
+    unsigned start = chip8_memory.index;
+    unsigned length;
+    int writes;
+
+    switch (op & 0xF0FFu)
+    {
+    case 0xF055:
+        writes = 1;
+        length = ((op >> 8) & 0xFu) + 1;
+        break;
+    case 0xF033:
+        writes = 1;
+        length = 3;
+        break;
+    case 0xF065:
+        writes = 0;
+        length = ((op >> 8) & 0xFu) + 1;
+        break;
+    default:
+        if ((op & 0xF000u) != 0xD000u || (op & 0xFu) == 0)
+            return 0;
+        writes = 0;
+        length = op & 0xFu;
+        break;
+    }
+
+    for (int i = 0; i < dbg.watchpoint_count; i++)
+    {
+        const Watchpoint *w = &dbg.watchpoints[i];
+
+        if (start >= (unsigned)w->address + w->length || start + length <= w->address)
+            continue;
+
+        if (w->type == WATCH_ACCESS ||
+            (w->type == WATCH_WRITE && writes) ||
+            (w->type == WATCH_READ && !writes))
+        {
+            *hit = start > w->address ? (uint16_t)start : w->address;
+            return w->type;
+        }
+    }
+    return 0;
+}
+
+int debugger_cycle(void)
+{
+    if (dbg.halted)
+        return 0;
+
+    if (chip8_memory.fault)
+    {
+        debugger_stop_fault();
+        return 0;
+    }
+
+    if (chip8_memory.waiting_for_key)
+        return 1;
+
+    uint16_t pc = chip8_memory.program_counter;
+
+    /* As in processor_cycle(), nothing is fetched past the end of RAM */
+    if (pc > sizeof(chip8_memory.ram) - 2)
+    {
+        chip8_memory.fault = CHIP8_FAULT_PC_RANGE;
+        debugger_stop_fault();
+        return 0;
+    }
+
+    if (!dbg.skip_breakpoint && debugger_find_breakpoint(pc) >= 0)
+    {
+        debugger_stop_signal(SIGNAL_TRAP);
+        return 0;
+    }
+    dbg.skip_breakpoint = 0;
+
+    uint16_t op = (chip8_memory.ram[pc] << 8) | chip8_memory.ram[pc + 1];
+    uint16_t hit = 0;
+    int watch = dbg.watchpoint_count ? debugger_check_watchpoints(op, &hit) : 0;
+
+    processor_cycle();
+    processor_stats.cycles_executed++;
+
+    if (chip8_memory.fault)
+    {
+        debugger_stop_fault();
+        return 0;
+    }
+
+    /* Watchpoints report after the access, like hardware watchpoints */
+    if (watch)
+    {
+        static const char *const kinds[] = {[WATCH_WRITE] = "watch",
+                                            [WATCH_READ] = "rwatch",
+                                            [WATCH_ACCESS] = "awatch"};
+        char reply[32];
+        snprintf(reply, sizeof(reply), "T%02x%s:%x;", SIGNAL_TRAP, kinds[watch], hit);
+        debugger_stop(reply);
+        return 0;
+    }
+
+    if (dbg.stepping)
+    {
+        debugger_stop_signal(SIGNAL_TRAP);
+        return 0;
+    }
+
+    return 1;
+}
+
+void debugger_frame(void)
+{
+    for (int cycle = 0; cycle < CHIP8_CYCLES_PER_FRAME; cycle++)
+    {
+        if (!debugger_cycle())
+            return;
+    }
+
+    processor_update_timers();
+    processor_stats.frames++;
+}
+
+void debugger_shutdown(void)
+{
+    if (dbg.client_fd >= 0)
+        close(dbg.client_fd);
+    net_close(dbg.listen_fd, dbg.socket_path);
+
+    dbg.client_fd = -1;
+    dbg.listen_fd = -1;
+    debugger_enabled = 0;
+    debugger_active = 0;
+}
+
+#else
+
+int debugger_init(const char *endpoint)
+{
+    (void)endpoint;
+    fprintf(stderr, "ERROR: The debugger is not supported on this platform.\n");
+    return -1;
+}
+
+void debugger_poll(void)
+{
+}
+
+int debugger_cycle(void)
+{
+    processor_cycle();
+    return 1;
+}
+
+void debugger_frame(void)
+{
+    processor_frame();
+}
+
+void debugger_shutdown(void)
+{
+}
+
+#endif
@@ -0,0 +1,684 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "diffcheck.h"
+#include "chip8.h"
+#include "processor.h"
+#include "lockstep.h"
+
+#define DIFFCHECK_MAX_REPORTS 3
+#define DIFFCHECK_KEY_PERIOD 16
+#define DIFFCHECK_RAM_BYTES_SHOWN 8
+#define DIFFCHECK_OPCODES 65536
+
+/* Counts `slots` cycle slots of the current frame and ticks the timers when it ends */
+static void diffcheck_end_slots(MEMORY *vm, unsigned int slots)
+{
+    vm->frame_cycle += (uint8_t)slots;
+    if (vm->frame_cycle >= CHIP8_CYCLES_PER_FRAME)
+    {
+        processor_update_timers();
+        vm->frame_cycle = 0;
+    }
+}
+
+void diffcheck_reference_step(MEMORY *vm)
+{
+    MEMORY *caller_vm = chip8_vm;
+
+    chip8_vm = vm;
+    processor_cycle();
+    diffcheck_end_slots(vm, 1);
+    chip8_vm = caller_vm;
+}
+
+static unsigned int diffcheck_run_step(MEMORY *vm, unsigned int budget)
+{
+    MEMORY *caller_vm = chip8_vm;
+    unsigned int used, flushed;
+
+    chip8_vm = vm;
+    processor_run(budget, &used);
+
+    /* A frame end that coincided with an event is only reported by the next call */
+    if (vm->frame_cycle == CHIP8_CYCLES_PER_FRAME)
+        processor_run(1, &flushed);
+
+    chip8_vm = caller_vm;
+    return used;
+}
+
+static int diffcheck_frame_frame(MEMORY *vms, int count)
+{
+    MEMORY *caller_vm = chip8_vm;
+
+    for (int i = 0; i < count; i++)
+    {
+        chip8_vm = &vms[i];
+        processor_frame();
+    }
+
+    chip8_vm = caller_vm;
+    return 0;
+}
+
+static unsigned int diffcheck_frame_frames(MEMORY *vm, unsigned int frames)
+{
+    MEMORY *caller_vm = chip8_vm;
+    unsigned int ran;
+
+    chip8_vm = vm;
+    processor_frames(frames, &ran, NULL);
+    chip8_vm = caller_vm;
+    return ran;
+}
+
+static _Thread_local LockstepGroup *diffcheck_group;
+static _Thread_local int diffcheck_group_lanes;
+
+static void diffcheck_lockstep_release(void)
+{
+    lockstep_destroy(diffcheck_group);
+    diffcheck_group = NULL;
+    diffcheck_group_lanes = 0;
+}
+
+static int diffcheck_lockstep_frame(MEMORY *vms, int count)
+{
+    if (diffcheck_group_lanes != count)
+    {
+        diffcheck_lockstep_release();
+        diffcheck_group = lockstep_create(count);
+        if (diffcheck_group == NULL)
+        {
+            fprintf(stderr, "ERROR: Out of memory.\n");
+            return -1;
+        }
+        diffcheck_group_lanes = count;
+    }
+
+    for (int lane = 0; lane < count; lane++)
+        lockstep_load(diffcheck_group, lane, &vms[lane]);
+
+    lockstep_frame(diffcheck_group);
+
+    for (int lane = 0; lane < count; lane++)
+        lockstep_store(diffcheck_group, lane, &vms[lane]);
+
+    return 0;
+}
+
+static const DiffEngine diffcheck_engines[] = {
+    {.name = "run", .step = diffcheck_run_step},
+    {.name = "frame", .frame = diffcheck_frame_frame, .frames = diffcheck_frame_frames},
+    {.name = "lockstep", .frame = diffcheck_lockstep_frame, .release = diffcheck_lockstep_release},
+};
+
+#define DIFFCHECK_ENGINE_COUNT (sizeof(diffcheck_engines) / sizeof(diffcheck_engines[0]))
+
+const DiffEngine *diffcheck_find_engine(const char *name)
+{
+    for (size_t i = 0; i < DIFFCHECK_ENGINE_COUNT; i++)
+    {
+        if (strcmp(diffcheck_engines[i].name, name) == 0)
+            return &diffcheck_engines[i];
+    }
+
+    return NULL;
+}
+
+const char *diffcheck_engine_names(void)
+{
+    static char names[64];
+
+    if (names[0] == '\0')
+    {
+        for (size_t i = 0; i < DIFFCHECK_ENGINE_COUNT; i++)
+        {
+            if (i > 0)
+                strcat(names, "|");
+            strcat(names, diffcheck_engines[i].name);
+        }
+    }
+
+    return names;
+}
+
+/* Runs one frame of every machine on an engine, with its own frame function or by steps */
+static int diffcheck_engine_frame(const DiffEngine *engine, MEMORY *vms, int count)
+{
+    if (engine->frame)
+        return engine->frame(vms, count);
+
+    for (int i = 0; i < count; i++)
+    {
+        do
+            engine->step(&vms[i], CHIP8_CYCLES_PER_FRAME);
+        while (vms[i].frame_cycle != 0);
+    }
+
+    return 0;
+}
+
+#define DIFFCHECK_FIELD(field)                                      \
+    if (memcmp(&a->field, &b->field, sizeof(a->field)) != 0)        \
+        return #field;
+
+const char *diffcheck_compare(const MEMORY *a, const MEMORY *b)
+{
+    DIFFCHECK_FIELD(program_counter)
+    DIFFCHECK_FIELD(registers)
+    DIFFCHECK_FIELD(index)
+    DIFFCHECK_FIELD(stack_pointer)
+    DIFFCHECK_FIELD(stack)
+    DIFFCHECK_FIELD(delay_timer)
+    DIFFCHECK_FIELD(sound_timer)
+    DIFFCHECK_FIELD(keypad)
+    DIFFCHECK_FIELD(waiting_for_key)
+    DIFFCHECK_FIELD(key_register)
+    DIFFCHECK_FIELD(fault)
+    DIFFCHECK_FIELD(rng_state)
+    DIFFCHECK_FIELD(ram)
+    DIFFCHECK_FIELD(display)
+    DIFFCHECK_FIELD(ram_hash)
+    DIFFCHECK_FIELD(display_hash)
+    return NULL;
+}
+
+static void diffcheck_row(FILE *out, const char *name, unsigned long long a, unsigned long long b, int digits)
+{
+    fprintf(out, "  %c %-14s 0x%0*llX%*s 0x%0*llX\n", a != b ? '*' : ' ', name,
+            digits, a, 18 - digits, "", digits, b);
+}
+
+static void diffcheck_display_row(FILE *out, const char *label, const MEMORY *vm, int y)
+{
+    char pixels[CHIP8_WIDTH + 1];
+
+    for (int x = 0; x < CHIP8_WIDTH; x++)
+        pixels[x] = vm->display[y][x] ? '#' : '.';
+    pixels[CHIP8_WIDTH] = '\0';
+
+    fprintf(out, "    %-10s %s\n", label, pixels);
+}
+
+void diffcheck_report(FILE *out, const MEMORY *reference, const MEMORY *candidate)
+{
+    const MEMORY *a = reference, *b = candidate;
+    char name[16];
+
+    fprintf(out, "    %-14s %-20s %s\n", "", "reference", "candidate");
+    diffcheck_row(out, "PC", a->program_counter, b->program_counter, 4);
+    diffcheck_row(out, "I", a->index, b->index, 4);
+    for (int r = 0; r < 16; r++)
+    {
+        snprintf(name, sizeof(name), "V%X", r);
+        diffcheck_row(out, name, a->registers[r], b->registers[r], 2);
+    }
+    diffcheck_row(out, "SP", a->stack_pointer, b->stack_pointer, 2);
+    for (int s = 0; s < 16; s++)
+    {
+        if (s < a->stack_pointer || s < b->stack_pointer || a->stack[s] != b->stack[s])
+        {
+            snprintf(name, sizeof(name), "stack[%d]", s);
+            diffcheck_row(out, name, a->stack[s], b->stack[s], 4);
+        }
+    }
+    diffcheck_row(out, "DT", a->delay_timer, b->delay_timer, 2);
+    diffcheck_row(out, "ST", a->sound_timer, b->sound_timer, 2);
+    diffcheck_row(out, "waiting", a->waiting_for_key, b->waiting_for_key, 2);
+    diffcheck_row(out, "key_register", a->key_register, b->key_register, 2);
+    diffcheck_row(out, "fault", a->fault, b->fault, 2);
+    diffcheck_row(out, "rng_state", a->rng_state, b->rng_state, 8);
+    diffcheck_row(out, "ram_hash", a->ram_hash, b->ram_hash, 16);
+    diffcheck_row(out, "display_hash", a->display_hash, b->display_hash, 16);
+
+    if (memcmp(a->keypad, b->keypad, sizeof(a->keypad)) != 0)
+        fprintf(out, "  * keypad differs\n");
+
+    int shown = 0;
+    for (int address = 0; address < (int)sizeof(a->ram); address++)
+    {
+        if (a->ram[address] == b->ram[address])
+            continue;
+
+        if (shown++ == DIFFCHECK_RAM_BYTES_SHOWN)
+        {
+            fprintf(out, "  * ... more RAM differs\n");
+            break;
+        }
+        snprintf(name, sizeof(name), "ram[0x%03X]", address);
+        diffcheck_row(out, name, a->ram[address], b->ram[address], 2);
+    }
+
+    int rows = 0, first_row = -1;
+    for (int y = 0; y < CHIP8_HEIGHT; y++)
+    {
+        if (memcmp(a->display[y], b->display[y], sizeof(a->display[y])) != 0)
+        {
+            if (first_row < 0)
+                first_row = y;
+            rows++;
+        }
+    }
+
+    if (rows > 0)
+    {
+        fprintf(out, "  * display differs in %d rows, first row %d:\n", rows, first_row);
+        diffcheck_display_row(out, "reference", a, first_row);
+        diffcheck_display_row(out, "candidate", b, first_row);
+    }
+}
+
+static uint16_t diffcheck_opcode_at(const MEMORY *vm)
+{
+    if (vm->program_counter > sizeof(vm->ram) - 2)
+        return 0;
+    return (uint16_t)(vm->ram[vm->program_counter] << 8 | vm->ram[vm->program_counter + 1]);
+}
+
+/*
+ * Replays `slots` cycle slots from `start` one instruction at a time to find the first diverging one.
+ * Without single steps, or when the replay does not diverge, reports the whole span instead, with
+ * the end states found by the caller.
+ */
+static void diffcheck_locate(FILE *out, const DiffEngine *engine, const MEMORY *start, unsigned int slots,
+                             unsigned long frame, const MEMORY *reference_end, const MEMORY *candidate_end)
+{
+    MEMORY *reference = malloc(sizeof(MEMORY));
+    MEMORY *candidate = malloc(sizeof(MEMORY));
+
+    if (reference == NULL || candidate == NULL)
+    {
+        free(reference);
+        free(candidate);
+        fprintf(out, "Diverged in frame %lu (out of memory to replay it)\n", frame);
+        diffcheck_report(out, reference_end, candidate_end);
+        return;
+    }
+
+    *reference = *start;
+    *candidate = *start;
+
+    for (unsigned int slot = 0; engine->step && slot < slots; slot++)
+    {
+        uint16_t pc = reference->program_counter;
+        uint16_t op = diffcheck_opcode_at(reference);
+        unsigned int cycle = reference->frame_cycle;
+
+        engine->step(candidate, 1);
+        diffcheck_reference_step(reference);
+
+        const char *field = diffcheck_compare(reference, candidate);
+        if (field)
+        {
+            fprintf(out, "First diverging instruction: %04X at 0x%03X (frame %lu, cycle %u); %s differs\n",
+                    op, pc, frame, cycle, field);
+            diffcheck_report(out, reference, candidate);
+            free(reference);
+            free(candidate);
+            return;
+        }
+    }
+
+    fprintf(out, "Diverged over %u cycle slots from 0x%03X in frame %lu (%s); %s\n",
+            slots, start->program_counter, frame, diffcheck_compare(reference_end, candidate_end),
+            engine->step ? "not reproduced one instruction at a time" : "the engine runs whole frames");
+
+    /* Without a finer step, the reference's instructions are the best pointer into the span */
+    *reference = *start;
+    fprintf(out, "  Reference instructions:");
+    for (unsigned int slot = 0; slot < slots; slot++)
+    {
+        if (!reference->waiting_for_key && !reference->fault)
+            fprintf(out, " %03X:%04X", reference->program_counter, diffcheck_opcode_at(reference));
+        diffcheck_reference_step(reference);
+    }
+    fprintf(out, "\n");
+
+    diffcheck_report(out, reference_end, candidate_end);
+    free(reference);
+    free(candidate);
+}
+
+/* One key held at a time on both machines, changing every DIFFCHECK_KEY_PERIOD frames */
+static void diffcheck_input(MEMORY *vm, unsigned long frame)
+{
+    MEMORY *caller_vm = chip8_vm;
+    uint8_t key = (uint8_t)((frame / DIFFCHECK_KEY_PERIOD) & 0xFu);
+
+    chip8_vm = vm;
+    if (frame > 0)
+        chip8_set_key((uint8_t)(((frame - 1) / DIFFCHECK_KEY_PERIOD) & 0xFu), 0);
+    chip8_set_key(key, 1);
+    chip8_vm = caller_vm;
+}
+
+int diffcheck_run(const MEMORY *initial, const DiffEngine *engine, DiffcheckMode mode,
+                  unsigned long frames, FILE *out)
+{
+    if (engine->step == NULL && mode != DIFFCHECK_FRAME)
+    {
+        fprintf(stderr, "ERROR: The %s engine only runs whole frames; compare by frame.\n", engine->name);
+        return -1;
+    }
+
+    MEMORY *reference = malloc(sizeof(MEMORY));
+    MEMORY *candidate = malloc(sizeof(MEMORY));
+    MEMORY *start = malloc(sizeof(MEMORY));
+    int result = 0;
+
+    if (reference == NULL || candidate == NULL || start == NULL)
+    {
+        fprintf(stderr, "ERROR: Out of memory.\n");
+        free(reference);
+        free(candidate);
+        free(start);
+        return -1;
+    }
+
+    *reference = *initial;
+    reference->frame_cycle = 0;
+    *candidate = *reference;
+
+    for (unsigned long frame = 0; frame < frames && result == 0; frame++)
+    {
+        diffcheck_input(reference, frame);
+        diffcheck_input(candidate, frame);
+
+        if (mode == DIFFCHECK_FRAME)
+        {
+            unsigned int count = 1;
+
+            *start = *reference;
+
+            if (engine->frames)
+            {
+                /* Up to the next key change, which the engine cannot see coming */
+                unsigned long left = DIFFCHECK_KEY_PERIOD - frame % DIFFCHECK_KEY_PERIOD;
+                count = engine->frames(candidate, (unsigned int)(left < frames - frame ? left : frames - frame));
+            }
+            else if (diffcheck_engine_frame(engine, candidate, 1) != 0)
+            {
+                result = -1;
+                break;
+            }
+            for (unsigned int slot = 0; slot < count * CHIP8_CYCLES_PER_FRAME; slot++)
+                diffcheck_reference_step(reference);
+
+            if (diffcheck_compare(reference, candidate))
+            {
+                diffcheck_locate(out, engine, start, count * CHIP8_CYCLES_PER_FRAME, frame, reference, candidate);
+                result = 1;
+            }
+            frame += count - 1;
+            continue;
+        }
+
+        do
+        {
+            unsigned int budget = mode == DIFFCHECK_INSTRUCTION ? 1 : CHIP8_CYCLES_PER_FRAME - candidate->frame_cycle;
+
+            *start = *reference;
+            unsigned int slots = engine->step(candidate, budget);
+            for (unsigned int slot = 0; slot < slots; slot++)
+                diffcheck_reference_step(reference);
+
+            if (diffcheck_compare(reference, candidate))
+            {
+                diffcheck_locate(out, engine, start, slots, frame, reference, candidate);
+                result = 1;
+                break;
+            }
+        } while (reference->frame_cycle != 0);
+    }
+
+    if (engine->release)
+        engine->release();
+
+    free(reference);
+    free(candidate);
+    free(start);
+    return result;
+}
+
+typedef struct
+{
+    const DiffEngine *engine;
+    int states;
+    uint32_t seed;
+    int first;
+    int step;
+    FILE *out;
+    pthread_mutex_t *report_lock;
+    int *reports;
+    long mismatches;
+    int failed;
+    pthread_t thread;
+} DiffcheckWorker;
+
+static uint32_t diffcheck_random(uint32_t *state)
+{
+    uint32_t x = *state;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+/* Random RAM, display, stack, timers and keypad, shared by every opcode of a state */
+static void diffcheck_random_machine(MEMORY *vm, uint32_t *rng)
+{
+    MEMORY *caller_vm = chip8_vm;
+
+    memset(vm, 0, sizeof(*vm));
+
+    for (size_t i = 0; i < sizeof(vm->ram); i++)
+        vm->ram[i] = (uint8_t)diffcheck_random(rng);
+
+    for (int y = 0; y < CHIP8_HEIGHT; y++)
+        for (int x = 0; x < CHIP8_WIDTH; x++)
+            vm->display[y][x] = (diffcheck_random(rng) & 3u) == 0 ? 0xFFFFFFFFu : 0;
+
+    vm->stack_pointer = (uint8_t)(diffcheck_random(rng) % 17u);
+    for (int s = 0; s < 16; s++)
+        vm->stack[s] = (uint16_t)(diffcheck_random(rng) & 0xFFFu);
+
+    vm->delay_timer = (uint8_t)(diffcheck_random(rng) & 1u ? diffcheck_random(rng) : 0);
+    vm->sound_timer = (uint8_t)(diffcheck_random(rng) & 1u ? diffcheck_random(rng) : 0);
+
+    for (int key = 0; key < 16; key++)
+        vm->keypad[key] = (diffcheck_random(rng) & 7u) == 0;
+
+    chip8_vm = vm;
+    chip8_rehash();
+    chip8_vm = caller_vm;
+}
+
+/* Random registers, I and PC, with the opcode at PC; some states make the skips' comparisons equal */
+static void diffcheck_prepare(MEMORY *vm, uint16_t op, int state, uint32_t *rng)
+{
+    MEMORY *caller_vm = chip8_vm;
+    uint8_t x = (op >> 8) & 0xFu, y = (op >> 4) & 0xFu;
+
+    for (int r = 0; r < 16; r++)
+        vm->registers[r] = (uint8_t)diffcheck_random(rng);
+    if (state % 4 == 1)
+        vm->registers[y] = vm->registers[x];
+    else if (state % 4 == 2)
+        vm->registers[x] = op & 0xFFu;
+
+    /* Mostly in range, sometimes near or past the end of RAM to reach the range faults */
+    vm->index = (uint16_t)(state % 8 == 3 ? 0xFF0u + (diffcheck_random(rng) & 0x1Fu)
+                                          : diffcheck_random(rng) & 0xFFFu);
+    vm->program_counter = (uint16_t)(state % 8 == 5 ? 0xFFEu + (diffcheck_random(rng) & 1u)
+                                                    : diffcheck_random(rng) & 0xFFEu);
+    vm->rng_state = diffcheck_random(rng) | 1u;
+    vm->frame_cycle = 0;
+
+    chip8_vm = vm;
+    if (vm->program_counter <= sizeof(vm->ram) - 2)
+    {
+        chip8_write_ram(vm->program_counter, (uint8_t)(op >> 8));
+        chip8_write_ram((uint16_t)(vm->program_counter + 1), (uint8_t)op);
+    }
+    chip8_vm = caller_vm;
+}
+
+static void diffcheck_opcode_mismatch(DiffcheckWorker *worker, uint16_t op, int state, const MEMORY *initial,
+                                      const MEMORY *reference, const MEMORY *candidate)
+{
+    pthread_mutex_lock(worker->report_lock);
+
+    if ((*worker->reports)++ < DIFFCHECK_MAX_REPORTS)
+    {
+        /* Every check starts a frame, so the slots run are where the reference's frame now is */
+        unsigned int slots = reference->frame_cycle ? reference->frame_cycle : CHIP8_CYCLES_PER_FRAME;
+
+        fprintf(worker->out, "Opcode %04X, state %d, from 0x%03X with I=0x%03X:\n",
+                op, state, initial->program_counter, initial->index);
+        diffcheck_locate(worker->out, worker->engine, initial, slots, 0, reference, candidate);
+    }
+
+    pthread_mutex_unlock(worker->report_lock);
+}
+
+static void *diffcheck_opcode_worker(void *arg)
+{
+    DiffcheckWorker *worker = arg;
+    int states = worker->states;
+    MEMORY *base = malloc((size_t)states * sizeof(MEMORY));
+    MEMORY *initial = malloc((size_t)states * sizeof(MEMORY));
+    MEMORY *reference = malloc((size_t)states * sizeof(MEMORY));
+    MEMORY *candidate = malloc((size_t)states * sizeof(MEMORY));
+    uint32_t rng = worker->seed ? worker->seed : 0x2545F491u;
+
+    if (base == NULL || initial == NULL || reference == NULL || candidate == NULL)
+    {
+        worker->failed = 1;
+        goto done;
+    }
+
+    for (int s = 0; s < states; s++)
+        diffcheck_random_machine(&base[s], &rng);
+
+    for (int op = worker->first; op < DIFFCHECK_OPCODES; op += worker->step)
+    {
+        uint32_t op_rng = (worker->seed ^ (uint32_t)op * 0x9E3779B9u) | 1u;
+
+        for (int s = 0; s < states; s++)
+        {
+            initial[s] = base[s];
+            diffcheck_prepare(&initial[s], (uint16_t)op, s, &op_rng);
+            candidate[s] = initial[s];
+            reference[s] = initial[s];
+        }
+
+        if (worker->engine->step)
+        {
+            /* One block starting with the opcode */
+            for (int s = 0; s < states; s++)
+            {
+                unsigned int slots = worker->engine->step(&candidate[s], CHIP8_CYCLES_PER_FRAME);
+                for (unsigned int slot = 0; slot < slots; slot++)
+                    diffcheck_reference_step(&reference[s]);
+            }
+        }
+        else
+        {
+            /* One frame starting with the opcode, every state in its own lane */
+            if (worker->engine->frame(candidate, states) != 0)
+            {
+                worker->failed = 1;
+                break;
+            }
+            for (int s = 0; s < states; s++)
+                for (int slot = 0; slot < CHIP8_CYCLES_PER_FRAME; slot++)
+                    diffcheck_reference_step(&reference[s]);
+        }
+
+        for (int s = 0; s < states; s++)
+        {
+            if (diffcheck_compare(&reference[s], &candidate[s]))
+            {
+                diffcheck_opcode_mismatch(worker, (uint16_t)op, s, &initial[s], &reference[s], &candidate[s]);
+                worker->mismatches++;
+                break;
+            }
+        }
+    }
+
+done:
+    if (worker->engine->release)
+        worker->engine->release();
+
+    free(base);
+    free(initial);
+    free(reference);
+    free(candidate);
+    return NULL;
+}
+
+long diffcheck_opcodes(const DiffEngine *engine, int states, int threads, uint32_t seed, FILE *out)
+{
+    pthread_mutex_t report_lock = PTHREAD_MUTEX_INITIALIZER;
+    int reports = 0;
+    long mismatches = 0;
+    int failed = 0;
+
+    if (states < 1 || states > LOCKSTEP_MAX_LANES || threads < 1)
+    {
+        fprintf(stderr, "ERROR: Between 1 and %d states and at least one thread are needed.\n",
+                LOCKSTEP_MAX_LANES);
+        return -1;
+    }
+
+    DiffcheckWorker *workers = calloc((size_t)threads, sizeof(DiffcheckWorker));
+    if (workers == NULL)
+    {
+        fprintf(stderr, "ERROR: Out of memory.\n");
+        return -1;
+    }
+
+    for (int t = 0; t < threads; t++)
+    {
+        workers[t].engine = engine;
+        workers[t].states = states;
+        workers[t].seed = seed;
+        workers[t].first = t;
+        workers[t].step = threads;
+        workers[t].out = out;
+        workers[t].report_lock = &report_lock;
+        workers[t].reports = &reports;
+
+        if (pthread_create(&workers[t].thread, NULL, diffcheck_opcode_worker, &workers[t]) != 0)
+        {
+            perror("pthread_create");
+            threads = t;
+            failed = 1;
+            break;
+        }
+    }
+
+    for (int t = 0; t < threads; t++)
+    {
+        pthread_join(workers[t].thread, NULL);
+        mismatches += workers[t].mismatches;
+        failed |= workers[t].failed;
+    }
+
+    free(workers);
+
+    if (failed)
+    {
+        fprintf(stderr, "ERROR: The exhaustive check could not finish.\n");
+        return -1;
+    }
+
+    if (reports > DIFFCHECK_MAX_REPORTS)
+        fprintf(out, "... %d more mismatching states not shown\n", reports - DIFFCHECK_MAX_REPORTS);
+    return mismatches;
+}
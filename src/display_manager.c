@@ -1,9 +1,109 @@
+#include <ctype.h>
+#include <string.h>
 #include "display_manager.h"
 #include "chip8.h"
+#include "frame_pacer.h"
+#include "keymap.h"
+#include "metrics.h"
+#include "speed_control.h"
+
+/* Overlay glyphs are 3×5 dots, drawn OVERLAY_DOT window pixels wide */
+#define OVERLAY_DOT 2
+#define OVERLAY_MAX_TEXT 256
 
 DisplayManager g_displayManager;
 
-int DisplayManager_Init(const char *title)
+static char overlay_text[OVERLAY_MAX_TEXT];
+
+/* One octal digit per row, top to bottom; bit 2 is the leftmost dot */
+static const char *DisplayManager_Glyph(char c)
+{
+    static const char digits[10][6] = {
+        "75557", "26227", "71747", "71717", "55711",
+        "74717", "74757", "71111", "75757", "75717"};
+    static const char letters[26][6] = {
+        "25755", "65656", "34443", "65556", "74647", "74644", "34553",
+        "55755", "72227", "11152", "55655", "44447", "57755", "65555",
+        "25552", "65644", "25563", "65655", "34216", "72222", "55557",
+        "55552", "55775", "55255", "55222", "71247"};
+
+    if (c >= '0' && c <= '9')
+        return digits[c - '0'];
+    if (isalpha((unsigned char)c))
+        return letters[toupper((unsigned char)c) - 'A'];
+
+    switch (c)
+    {
+    case '.':
+        return "00002";
+    case '/':
+        return "11244";
+    case '%':
+        return "51245";
+    case ':':
+        return "02020";
+    case '-':
+        return "00700";
+    default:
+        return "00000";
+    }
+}
+
+static void DisplayManager_DrawOverlay(void)
+{
+    static SDL_Rect dots[OVERLAY_MAX_TEXT * 15];
+    int count = 0;
+    int lines = 1, column = 0, columns = 0;
+
+    for (const char *c = overlay_text; *c; c++)
+    {
+        if (*c == '\n')
+        {
+            lines++;
+            column = 0;
+            continue;
+        }
+
+        const char *glyph = DisplayManager_Glyph(*c);
+        for (int row = 0; row < 5; row++)
+        {
+            for (int dot = 0; dot < 3; dot++)
+            {
+                if (((glyph[row] - '0') >> (2 - dot)) & 1)
+                {
+                    dots[count].x = OVERLAY_DOT * (1 + column * 4 + dot);
+                    dots[count].y = OVERLAY_DOT * (1 + (lines - 1) * 6 + row);
+                    dots[count].w = OVERLAY_DOT;
+                    dots[count].h = OVERLAY_DOT;
+                    count++;
+                }
+            }
+        }
+
+        if (++column > columns)
+            columns = column;
+    }
+
+    SDL_Rect background = {0, 0, OVERLAY_DOT * (columns * 4 + 1), OVERLAY_DOT * (lines * 6 + 1)};
+
+    SDL_SetRenderDrawBlendMode(g_displayManager.renderer, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderDrawColor(g_displayManager.renderer, 0, 0, 0, 160);
+    SDL_RenderFillRect(g_displayManager.renderer, &background);
+    SDL_SetRenderDrawColor(g_displayManager.renderer, 0, 255, 0, 255);
+    SDL_RenderFillRects(g_displayManager.renderer, dots, count);
+    SDL_SetRenderDrawColor(g_displayManager.renderer, 0, 0, 0, 255);
+}
+
+void DisplayManager_SetOverlay(const char *text)
+{
+    if (text == NULL)
+        text = "";
+
+    strncpy(overlay_text, text, sizeof(overlay_text) - 1);
+    overlay_text[sizeof(overlay_text) - 1] = '\0';
+}
+
+int DisplayManager_Init(const char *title, int vsync)
 {
     if (SDL_Init(SDL_INIT_VIDEO) < 0)
         return 0;
@@ -21,8 +121,12 @@ int DisplayManager_Init(const char *title)
     if (!g_displayManager.window)
         return 0;
 
+    Uint32 renderer_flags = SDL_RENDERER_ACCELERATED;
+    if (vsync)
+        renderer_flags |= SDL_RENDERER_PRESENTVSYNC;
+
     g_displayManager.renderer =
-        SDL_CreateRenderer(g_displayManager.window, -1, SDL_RENDERER_ACCELERATED);
+        SDL_CreateRenderer(g_displayManager.window, -1, renderer_flags);
     if (!g_displayManager.renderer)
         return 0;
 
@@ -47,8 +151,26 @@ void DisplayManager_Destroy()
     SDL_Quit();
 }
 
+static void DisplayManager_Present(const uint32_t *pixels, int width, int64_t start_ns)
+{
+    SDL_UpdateTexture(g_displayManager.texture, NULL, pixels, width * (int)sizeof(uint32_t));
+    SDL_RenderClear(g_displayManager.renderer);
+    SDL_RenderCopy(g_displayManager.renderer, g_displayManager.texture, NULL, NULL);
+    if (overlay_text[0])
+        DisplayManager_DrawOverlay();
+
+    int64_t present_ns = frame_pacer_now_ns();
+    SDL_RenderPresent(g_displayManager.renderer);
+    int64_t end_ns = frame_pacer_now_ns();
+
+    metrics_frontend.display_updates++;
+    metrics_frontend.display_update_ns += end_ns - start_ns;
+    metrics_frontend.present_ns += end_ns - present_ns;
+}
+
 void DisplayManager_Update()
 {
+    int64_t start_ns = frame_pacer_now_ns();
     uint32_t pixels[CHIP8_HEIGHT][CHIP8_WIDTH];
 
     for (int y = 0; y < CHIP8_HEIGHT; y++)
@@ -59,10 +181,53 @@ void DisplayManager_Update()
         }
     }
 
-    SDL_UpdateTexture(g_displayManager.texture, NULL, pixels, CHIP8_WIDTH * sizeof(uint32_t));
-    SDL_RenderClear(g_displayManager.renderer);
-    SDL_RenderCopy(g_displayManager.renderer, g_displayManager.texture, NULL, NULL);
-    SDL_RenderPresent(g_displayManager.renderer);
+    DisplayManager_Present(&pixels[0][0], CHIP8_WIDTH, start_ns);
+}
+
+void DisplayManager_UpdateRGBA(const uint32_t *pixels, int width, int height)
+{
+    int64_t start_ns = frame_pacer_now_ns();
+    int texture_width, texture_height;
+
+    SDL_QueryTexture(g_displayManager.texture, NULL, NULL, &texture_width, &texture_height);
+    if (texture_width != width || texture_height != height)
+    {
+        SDL_Texture *texture = SDL_CreateTexture(
+            g_displayManager.renderer,
+            SDL_PIXELFORMAT_RGBA8888,
+            SDL_TEXTUREACCESS_STREAMING,
+            width,
+            height);
+        if (!texture)
+            return;
+
+        SDL_DestroyTexture(g_displayManager.texture);
+        g_displayManager.texture = texture;
+    }
+
+    DisplayManager_Present(pixels, width, start_ns);
+}
+
+static int DisplayManager_HandleEvent(const SDL_Event *event)
+{
+    metrics_frontend.input_events++;
+
+    if (event->type == SDL_QUIT)
+        return 1;
+
+    else if (event->type == SDL_KEYDOWN && event->key.keysym.sym == SDLK_ESCAPE)
+        return 1;
+
+    else if (event->type == SDL_KEYDOWN || event->type == SDL_KEYUP)
+    {
+        int key = keymap_lookup(event->key.keysym.sym);
+        if (key >= 0)
+            chip8_set_key((uint8_t)key, event->type == SDL_KEYDOWN);
+        else if (!event->key.repeat)
+            speed_control_key(event->key.keysym.sym, event->type == SDL_KEYDOWN, 1);
+    }
+
+    return 0;
 }
 
 int DisplayManager_ProcessInput()
@@ -71,121 +236,24 @@ int DisplayManager_ProcessInput()
 
     while (SDL_PollEvent(&event))
     {
-        if (event.type == SDL_QUIT)
+        if (DisplayManager_HandleEvent(&event))
             return 1;
-
-        else if (event.type == SDL_KEYDOWN)
-        {
-            switch (event.key.keysym.sym)
-            {
-            case SDLK_ESCAPE:
-                return 1;
-            case SDLK_x:
-                chip8_memory.keypad[0] = 1;
-                break;
-            case SDLK_1:
-                chip8_memory.keypad[1] = 1;
-                break;
-            case SDLK_2:
-                chip8_memory.keypad[2] = 1;
-                break;
-            case SDLK_3:
-                chip8_memory.keypad[3] = 1;
-                break;
-            case SDLK_q:
-                chip8_memory.keypad[4] = 1;
-                break;
-            case SDLK_w:
-                chip8_memory.keypad[5] = 1;
-                break;
-            case SDLK_e:
-                chip8_memory.keypad[6] = 1;
-                break;
-            case SDLK_a:
-                chip8_memory.keypad[7] = 1;
-                break;
-            case SDLK_s:
-                chip8_memory.keypad[8] = 1;
-                break;
-            case SDLK_d:
-                chip8_memory.keypad[9] = 1;
-                break;
-            case SDLK_z:
-                chip8_memory.keypad[0xA] = 1;
-                break;
-            case SDLK_c:
-                chip8_memory.keypad[0xB] = 1;
-                break;
-            case SDLK_4:
-                chip8_memory.keypad[0xC] = 1;
-                break;
-            case SDLK_r:
-                chip8_memory.keypad[0xD] = 1;
-                break;
-            case SDLK_f:
-                chip8_memory.keypad[0xE] = 1;
-                break;
-            case SDLK_v:
-                chip8_memory.keypad[0xF] = 1;
-                break;
-            }
-        }
-
-        else if (event.type == SDL_KEYUP)
-        {
-            switch (event.key.keysym.sym)
-            {
-            case SDLK_x:
-                chip8_memory.keypad[0] = 0;
-                break;
-            case SDLK_1:
-                chip8_memory.keypad[1] = 0;
-                break;
-            case SDLK_2:
-                chip8_memory.keypad[2] = 0;
-                break;
-            case SDLK_3:
-                chip8_memory.keypad[3] = 0;
-                break;
-            case SDLK_q:
-                chip8_memory.keypad[4] = 0;
-                break;
-            case SDLK_w:
-                chip8_memory.keypad[5] = 0;
-                break;
-            case SDLK_e:
-                chip8_memory.keypad[6] = 0;
-                break;
-            case SDLK_a:
-                chip8_memory.keypad[7] = 0;
-                break;
-            case SDLK_s:
-                chip8_memory.keypad[8] = 0;
-                break;
-            case SDLK_d:
-                chip8_memory.keypad[9] = 0;
-                break;
-            case SDLK_z:
-                chip8_memory.keypad[0xA] = 0;
-                break;
-            case SDLK_c:
-                chip8_memory.keypad[0xB] = 0;
-                break;
-            case SDLK_4:
-                chip8_memory.keypad[0xC] = 0;
-                break;
-            case SDLK_r:
-                chip8_memory.keypad[0xD] = 0;
-                break;
-            case SDLK_f:
-                chip8_memory.keypad[0xE] = 0;
-                break;
-            case SDLK_v:
-                chip8_memory.keypad[0xF] = 0;
-                break;
-            }
-        }
     }
 
     return 0;
 }
+
+int DisplayManager_WaitInput(int timeout_ms)
+{
+    SDL_Event event;
+    int received = (timeout_ms < 0) ? SDL_WaitEvent(&event)
+                                    : SDL_WaitEventTimeout(&event, timeout_ms);
+
+    if (!received)
+        return 0;
+
+    if (DisplayManager_HandleEvent(&event))
+        return 1;
+
+    return DisplayManager_ProcessInput();
+}
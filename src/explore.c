@@ -0,0 +1,808 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "explore.h"
+#include "chip8.h"
+#include "processor.h"
+
+#define EXPLORE_BATCH_SIZE 64
+#define EXPLORE_LINE_SIZE 64
+#define EXPLORE_LINES (4096 / EXPLORE_LINE_SIZE)
+#define EXPLORE_PIXELS (CHIP8_HEIGHT * CHIP8_WIDTH)
+#define EXPLORE_NO_GOAL UINT32_MAX
+
+/* Machine state of one search node; RAM lines equal to the root are left out */
+typedef struct
+{
+    uint8_t registers[16];
+    uint16_t stack[16];
+    uint16_t index;
+    uint16_t program_counter;
+    uint8_t stack_pointer;
+    uint8_t delay_timer;
+    uint8_t sound_timer;
+    uint8_t waiting_for_key;
+    uint8_t key_register;
+    uint8_t fault;
+    uint32_t rng_state;
+    uint64_t ram_hash;
+    uint64_t display_hash;
+    uint8_t display[EXPLORE_PIXELS / 8];
+    uint64_t ram_lines;
+    uint8_t ram[]; /* EXPLORE_LINE_SIZE bytes per bit set in ram_lines */
+} ExploreSnapshot;
+
+typedef struct
+{
+    uint32_t parent;
+    uint16_t action;
+    uint16_t depth;
+    double score;
+    ExploreSnapshot *snapshot; /* NULL once expanded */
+} ExploreNode;
+
+/* Outcome of running one action from one batch node */
+typedef struct
+{
+    uint64_t hash;
+    ExploreSnapshot *snapshot;
+    double score;
+    uint8_t fault;
+    uint8_t known;
+    uint8_t goal;
+} ExploreChild;
+
+typedef struct
+{
+    Explorer *explorer;
+    pthread_t thread;
+    MEMORY parent;
+    MEMORY vm;
+} ExploreWorker;
+
+struct Explorer
+{
+    ExploreConfig config;
+    uint16_t *actions;
+    MEMORY root;
+
+    ExploreNode *nodes;
+    size_t node_count;
+    size_t node_capacity;
+    size_t next_node;  /* Breadth-first: next node to expand */
+    uint32_t *heap;    /* Best-first: nodes ordered by score */
+    size_t heap_count;
+    uint32_t goal_node;
+
+    uint64_t *set;     /* Open addressing; 0 marks an empty slot */
+    size_t set_capacity;
+    size_t set_count;
+
+    uint32_t batch[EXPLORE_BATCH_SIZE];
+    int batch_count;
+    ExploreChild *children;
+    atomic_int next_job;
+
+    ExploreStats stats;
+    unsigned long long snapshots_encoded;
+    unsigned long long snapshot_bytes_encoded;
+
+    ExploreWorker *workers;
+    int worker_count;
+    int threads_started;
+    unsigned long generation;
+    int pending;
+    int stopping;
+
+    pthread_mutex_t lock;
+    pthread_cond_t start;
+    pthread_cond_t finished;
+};
+
+static double explore_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/*
+ * Hash set
+ */
+
+static int explore_set_contains(const Explorer *explorer, uint64_t hash)
+{
+    size_t mask = explorer->set_capacity - 1;
+
+    hash = hash ? hash : 1;
+    for (size_t slot = hash & mask; explorer->set[slot]; slot = (slot + 1) & mask)
+    {
+        if (explorer->set[slot] == hash)
+            return 1;
+    }
+    return 0;
+}
+
+/* Returns 1 if inserted, 0 if already present, -1 if out of memory */
+static int explore_set_insert(Explorer *explorer, uint64_t hash)
+{
+    hash = hash ? hash : 1;
+
+    /* Keep the load factor at or below one half */
+    if (2 * (explorer->set_count + 1) > explorer->set_capacity)
+    {
+        size_t capacity = explorer->set_capacity * 2;
+        uint64_t *set = calloc(capacity, sizeof(uint64_t));
+        if (set == NULL)
+            return -1;
+
+        for (size_t i = 0; i < explorer->set_capacity; i++)
+        {
+            uint64_t entry = explorer->set[i];
+            if (entry == 0)
+                continue;
+
+            size_t slot = entry & (capacity - 1);
+            while (set[slot])
+                slot = (slot + 1) & (capacity - 1);
+            set[slot] = entry;
+        }
+
+        free(explorer->set);
+        explorer->set = set;
+        explorer->set_capacity = capacity;
+    }
+
+    size_t mask = explorer->set_capacity - 1;
+    size_t slot = hash & mask;
+    for (; explorer->set[slot]; slot = (slot + 1) & mask)
+    {
+        if (explorer->set[slot] == hash)
+            return 0;
+    }
+
+    explorer->set[slot] = hash;
+    explorer->set_count++;
+    return 1;
+}
+
+/*
+ * Best-first heap; ties go to the older node so the order is deterministic
+ */
+
+static int explore_before(const Explorer *explorer, uint32_t a, uint32_t b)
+{
+    double score_a = explorer->nodes[a].score;
+    double score_b = explorer->nodes[b].score;
+    return score_a > score_b || (score_a == score_b && a < b);
+}
+
+static void explore_heap_push(Explorer *explorer, uint32_t node)
+{
+    size_t i = explorer->heap_count++;
+
+    while (i > 0)
+    {
+        size_t parent = (i - 1) / 2;
+        if (!explore_before(explorer, node, explorer->heap[parent]))
+            break;
+        explorer->heap[i] = explorer->heap[parent];
+        i = parent;
+    }
+    explorer->heap[i] = node;
+}
+
+static uint32_t explore_heap_pop(Explorer *explorer)
+{
+    uint32_t top = explorer->heap[0];
+    uint32_t last = explorer->heap[--explorer->heap_count];
+    size_t i = 0;
+
+    for (;;)
+    {
+        size_t child = 2 * i + 1;
+        if (child >= explorer->heap_count)
+            break;
+        if (child + 1 < explorer->heap_count &&
+            explore_before(explorer, explorer->heap[child + 1], explorer->heap[child]))
+            child++;
+        if (!explore_before(explorer, explorer->heap[child], last))
+            break;
+        explorer->heap[i] = explorer->heap[child];
+        i = child;
+    }
+    if (explorer->heap_count > 0)
+        explorer->heap[i] = last;
+    return top;
+}
+
+/*
+ * Snapshots
+ */
+
+static ExploreSnapshot *explore_encode(const Explorer *explorer, const MEMORY *vm, size_t *size)
+{
+    uint64_t lines = 0;
+    int line_count = 0;
+
+    for (int line = 0; line < EXPLORE_LINES; line++)
+    {
+        size_t offset = (size_t)line * EXPLORE_LINE_SIZE;
+        if (memcmp(vm->ram + offset, explorer->root.ram + offset, EXPLORE_LINE_SIZE) != 0)
+        {
+            lines |= 1ull << line;
+            line_count++;
+        }
+    }
+
+    *size = sizeof(ExploreSnapshot) + (size_t)line_count * EXPLORE_LINE_SIZE;
+    ExploreSnapshot *snapshot = malloc(*size);
+    if (snapshot == NULL)
+        return NULL;
+
+    memcpy(snapshot->registers, vm->registers, sizeof(snapshot->registers));
+    memcpy(snapshot->stack, vm->stack, sizeof(snapshot->stack));
+    snapshot->index = vm->index;
+    snapshot->program_counter = vm->program_counter;
+    snapshot->stack_pointer = vm->stack_pointer;
+    snapshot->delay_timer = vm->delay_timer;
+    snapshot->sound_timer = vm->sound_timer;
+    snapshot->waiting_for_key = vm->waiting_for_key;
+    snapshot->key_register = vm->key_register;
+    snapshot->fault = vm->fault;
+    snapshot->rng_state = vm->rng_state;
+    snapshot->ram_hash = vm->ram_hash;
+    snapshot->display_hash = vm->display_hash;
+
+    const uint32_t *pixels = &vm->display[0][0];
+    for (int i = 0; i < EXPLORE_PIXELS / 8; i++)
+    {
+        uint8_t bits = 0;
+        for (int bit = 0; bit < 8; bit++)
+            bits |= (uint8_t)(pixels[i * 8 + bit] != 0) << bit;
+        snapshot->display[i] = bits;
+    }
+
+    snapshot->ram_lines = lines;
+    uint8_t *out = snapshot->ram;
+    for (int line = 0; line < EXPLORE_LINES; line++)
+    {
+        if (lines & (1ull << line))
+        {
+            memcpy(out, vm->ram + (size_t)line * EXPLORE_LINE_SIZE, EXPLORE_LINE_SIZE);
+            out += EXPLORE_LINE_SIZE;
+        }
+    }
+
+    return snapshot;
+}
+
+static void explore_decode(const Explorer *explorer, const ExploreSnapshot *snapshot, MEMORY *vm)
+{
+    memcpy(vm->ram, explorer->root.ram, sizeof(vm->ram));
+
+    const uint8_t *in = snapshot->ram;
+    for (int line = 0; line < EXPLORE_LINES; line++)
+    {
+        if (snapshot->ram_lines & (1ull << line))
+        {
+            memcpy(vm->ram + (size_t)line * EXPLORE_LINE_SIZE, in, EXPLORE_LINE_SIZE);
+            in += EXPLORE_LINE_SIZE;
+        }
+    }
+
+    memcpy(vm->registers, snapshot->registers, sizeof(vm->registers));
+    memcpy(vm->stack, snapshot->stack, sizeof(vm->stack));
+    vm->index = snapshot->index;
+    vm->program_counter = snapshot->program_counter;
+    memset(vm->keypad, 0, sizeof(vm->keypad));
+    vm->stack_pointer = snapshot->stack_pointer;
+    vm->delay_timer = snapshot->delay_timer;
+    vm->sound_timer = snapshot->sound_timer;
+    vm->waiting_for_key = snapshot->waiting_for_key;
+    vm->key_register = snapshot->key_register;
+    vm->fault = snapshot->fault;
+    vm->rng_state = snapshot->rng_state;
+    vm->ram_hash = snapshot->ram_hash;
+    vm->display_hash = snapshot->display_hash;
+
+    uint32_t *pixels = &vm->display[0][0];
+    for (int i = 0; i < EXPLORE_PIXELS; i++)
+        pixels[i] = ((snapshot->display[i / 8] >> (i % 8)) & 1u) ? 0xFFFFFFFF : 0x00000000;
+}
+
+static size_t explore_snapshot_size(const ExploreSnapshot *snapshot)
+{
+    return sizeof(ExploreSnapshot) +
+           (size_t)__builtin_popcountll(snapshot->ram_lines) * EXPLORE_LINE_SIZE;
+}
+
+/*
+ * Expansion
+ */
+
+/* Runs every action from batch entry `b`; chip8_vm points at worker->vm */
+static void explore_expand(Explorer *explorer, ExploreWorker *worker, int b)
+{
+    const ExploreConfig *config = &explorer->config;
+    const ExploreNode *node = &explorer->nodes[explorer->batch[b]];
+
+    explore_decode(explorer, node->snapshot, &worker->parent);
+
+    for (int a = 0; a < config->action_count; a++)
+    {
+        ExploreChild *child = &explorer->children[b * config->action_count + a];
+        uint16_t action = explorer->actions[a];
+
+        memcpy(&worker->vm, &worker->parent, sizeof(MEMORY));
+        for (uint8_t key = 0; key < 16; key++)
+            chip8_set_key(key, (action >> key) & 1u);
+        for (int f = 0; f < config->frames_per_step && !chip8_memory.fault;)
+        {
+            unsigned int ran;
+            processor_frames((unsigned int)(config->frames_per_step - f), &ran, NULL);
+            f += (int)ran;
+        }
+
+        /* The next step sets every key, so held keys are not part of a state */
+        memset(chip8_memory.keypad, 0, sizeof(chip8_memory.keypad));
+
+        child->hash = chip8_state_hash();
+        child->fault = chip8_memory.fault;
+        child->known = (uint8_t)explore_set_contains(explorer, child->hash);
+        child->snapshot = NULL;
+        child->score = 0.0;
+        child->goal = 0;
+
+        /* Faulted states are counted but never expanded, so need no snapshot */
+        if (child->known || child->fault)
+            continue;
+
+        size_t size;
+        child->snapshot = explore_encode(explorer, &worker->vm, &size);
+        if (config->score)
+            child->score = config->score(&worker->vm, config->user);
+        if (config->goal)
+            child->goal = config->goal(&worker->vm, config->user) != 0;
+    }
+}
+
+static void explore_work(Explorer *explorer, ExploreWorker *worker)
+{
+    chip8_vm = &worker->vm;
+
+    for (;;)
+    {
+        int b = atomic_fetch_add_explicit(&explorer->next_job, 1, memory_order_relaxed);
+        if (b >= explorer->batch_count)
+            break;
+        explore_expand(explorer, worker, b);
+    }
+}
+
+static void *explore_worker(void *arg)
+{
+    ExploreWorker *worker = arg;
+    Explorer *explorer = worker->explorer;
+    unsigned long seen = 0;
+
+    for (;;)
+    {
+        pthread_mutex_lock(&explorer->lock);
+        while (explorer->generation == seen && !explorer->stopping)
+            pthread_cond_wait(&explorer->start, &explorer->lock);
+
+        if (explorer->stopping)
+        {
+            pthread_mutex_unlock(&explorer->lock);
+            break;
+        }
+        seen = explorer->generation;
+        pthread_mutex_unlock(&explorer->lock);
+
+        explore_work(explorer, worker);
+
+        pthread_mutex_lock(&explorer->lock);
+        if (--explorer->pending == 0)
+            pthread_cond_signal(&explorer->finished);
+        pthread_mutex_unlock(&explorer->lock);
+    }
+
+    return NULL;
+}
+
+/* Expands the current batch on all threads; worker 0 is the caller */
+static void explore_dispatch(Explorer *explorer)
+{
+    MEMORY *caller_vm = chip8_vm;
+
+    atomic_store_explicit(&explorer->next_job, 0, memory_order_relaxed);
+
+    if (explorer->worker_count > 1)
+    {
+        pthread_mutex_lock(&explorer->lock);
+        explorer->generation++;
+        explorer->pending = explorer->worker_count - 1;
+        pthread_cond_broadcast(&explorer->start);
+        pthread_mutex_unlock(&explorer->lock);
+    }
+
+    explore_work(explorer, &explorer->workers[0]);
+
+    if (explorer->worker_count > 1)
+    {
+        pthread_mutex_lock(&explorer->lock);
+        while (explorer->pending > 0)
+            pthread_cond_wait(&explorer->finished, &explorer->lock);
+        pthread_mutex_unlock(&explorer->lock);
+    }
+
+    chip8_vm = caller_vm;
+}
+
+/* Appends a node that owns `snapshot`; returns its index or -1 if out of memory */
+static long explore_add_node(Explorer *explorer, uint32_t parent, uint16_t action, uint16_t depth,
+                             double score, ExploreSnapshot *snapshot)
+{
+    if (explorer->node_count == explorer->node_capacity)
+    {
+        size_t capacity = explorer->node_capacity ? explorer->node_capacity * 2 : 1024;
+        ExploreNode *nodes = realloc(explorer->nodes, capacity * sizeof(ExploreNode));
+        uint32_t *heap = realloc(explorer->heap, capacity * sizeof(uint32_t));
+
+        if (nodes != NULL)
+            explorer->nodes = nodes;
+        if (heap != NULL)
+            explorer->heap = heap;
+        if (nodes == NULL || heap == NULL)
+            return -1;
+        explorer->node_capacity = capacity;
+    }
+
+    size_t index = explorer->node_count++;
+    ExploreNode *node = &explorer->nodes[index];
+    node->parent = parent;
+    node->action = action;
+    node->depth = depth;
+    node->score = score;
+    node->snapshot = snapshot;
+
+    explorer->stats.snapshot_bytes += explore_snapshot_size(snapshot);
+    if (explorer->stats.snapshot_bytes > explorer->stats.peak_snapshot_bytes)
+        explorer->stats.peak_snapshot_bytes = explorer->stats.snapshot_bytes;
+    explorer->snapshots_encoded++;
+    explorer->snapshot_bytes_encoded += explore_snapshot_size(snapshot);
+
+    if (depth > explorer->stats.max_depth)
+        explorer->stats.max_depth = depth;
+    if (explorer->config.strategy == EXPLORE_BEST_FIRST)
+        explore_heap_push(explorer, (uint32_t)index);
+
+    return (long)index;
+}
+
+static void explore_release(Explorer *explorer, ExploreNode *node)
+{
+    if (node->snapshot == NULL)
+        return;
+
+    explorer->stats.snapshot_bytes -= explore_snapshot_size(node->snapshot);
+    free(node->snapshot);
+    node->snapshot = NULL;
+}
+
+static int explore_at_limit(const Explorer *explorer)
+{
+    return explorer->config.max_states && explorer->stats.unique >= explorer->config.max_states;
+}
+
+/* Fills the batch with the next expandable nodes; returns how many */
+static int explore_next_batch(Explorer *explorer)
+{
+    int max_depth = explorer->config.max_depth;
+    explorer->batch_count = 0;
+
+    while (explorer->batch_count < EXPLORE_BATCH_SIZE)
+    {
+        uint32_t index;
+
+        if (explorer->config.strategy == EXPLORE_BEST_FIRST)
+        {
+            if (explorer->heap_count == 0)
+                break;
+            index = explore_heap_pop(explorer);
+        }
+        else
+        {
+            if (explorer->next_node == explorer->node_count)
+                break;
+            index = (uint32_t)explorer->next_node++;
+        }
+
+        ExploreNode *node = &explorer->nodes[index];
+        if (max_depth && node->depth >= max_depth)
+        {
+            explore_release(explorer, node);
+            continue;
+        }
+        explorer->batch[explorer->batch_count++] = index;
+    }
+
+    return explorer->batch_count;
+}
+
+/* Adds the batch's new children in a fixed order; returns -1 if out of memory */
+static int explore_merge(Explorer *explorer)
+{
+    int action_count = explorer->config.action_count;
+    int result = 0;
+
+    for (int b = 0; b < explorer->batch_count; b++)
+    {
+        uint32_t parent = explorer->batch[b];
+        uint16_t depth = explorer->nodes[parent].depth + 1;
+
+        for (int a = 0; a < action_count; a++)
+        {
+            ExploreChild *child = &explorer->children[b * action_count + a];
+            int stop = result != 0 || explorer->goal_node != EXPLORE_NO_GOAL || explore_at_limit(explorer);
+
+            if (stop)
+            {
+                free(child->snapshot);
+                continue;
+            }
+
+            explorer->stats.generated++;
+            if (child->known)
+            {
+                explorer->stats.duplicates++;
+                continue;
+            }
+
+            int inserted = explore_set_insert(explorer, child->hash);
+            if (inserted <= 0)
+            {
+                free(child->snapshot);
+                if (inserted == 0)
+                    explorer->stats.duplicates++;
+                else
+                    result = -1;
+                continue;
+            }
+
+            explorer->stats.unique++;
+            if (child->fault)
+            {
+                explorer->stats.faults++;
+                continue;
+            }
+
+            if (child->snapshot == NULL)
+            {
+                result = -1;
+                continue;
+            }
+
+            long index = explore_add_node(explorer, parent, explorer->actions[a], depth,
+                                          child->score, child->snapshot);
+            if (index < 0)
+            {
+                free(child->snapshot);
+                result = -1;
+                continue;
+            }
+
+            if (child->goal)
+                explorer->goal_node = (uint32_t)index;
+        }
+
+        explorer->stats.expanded++;
+        explore_release(explorer, &explorer->nodes[parent]);
+    }
+
+    return result;
+}
+
+int explore_run(Explorer *explorer)
+{
+    double start = explore_now();
+    int result = 0;
+
+    while (explorer->goal_node == EXPLORE_NO_GOAL && !explore_at_limit(explorer))
+    {
+        if (explore_next_batch(explorer) == 0)
+            break;
+
+        explore_dispatch(explorer);
+
+        if (explore_merge(explorer) != 0)
+        {
+            fprintf(stderr, "ERROR: Out of memory during state exploration.\n");
+            result = -1;
+            break;
+        }
+    }
+
+    explorer->stats.seconds += explore_now() - start;
+
+    if (result < 0)
+        return -1;
+    return explorer->goal_node != EXPLORE_NO_GOAL;
+}
+
+int explore_goal_path(const Explorer *explorer, uint16_t *actions, int capacity)
+{
+    if (explorer->goal_node == EXPLORE_NO_GOAL)
+        return -1;
+
+    int length = explorer->nodes[explorer->goal_node].depth;
+    if (length > capacity)
+        return -1;
+
+    uint32_t index = explorer->goal_node;
+    for (int i = length - 1; i >= 0; i--)
+    {
+        actions[i] = explorer->nodes[index].action;
+        index = explorer->nodes[index].parent;
+    }
+    return length;
+}
+
+const ExploreStats *explore_get_stats(const Explorer *explorer)
+{
+    return &explorer->stats;
+}
+
+void explore_report_stats(const Explorer *explorer, FILE *out)
+{
+    const ExploreStats *stats = &explorer->stats;
+
+    fprintf(out,
+            "Explore: %llu unique states, %llu generated in %.2f s (%.0f states/s), "
+            "%llu expanded, %llu duplicates, %llu faults, depth %d, "
+            "snapshots avg %.0f B (peak %.1f MB)\n",
+            stats->unique,
+            stats->generated,
+            stats->seconds,
+            stats->seconds > 0 ? stats->generated / stats->seconds : 0.0,
+            stats->expanded,
+            stats->duplicates,
+            stats->faults,
+            stats->max_depth,
+            explorer->snapshots_encoded
+                ? (double)explorer->snapshot_bytes_encoded / explorer->snapshots_encoded
+                : 0.0,
+            stats->peak_snapshot_bytes / 1e6);
+}
+
+static int explore_default_threads(void)
+{
+#ifdef _SC_NPROCESSORS_ONLN
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    return cpus > 0 ? (int)cpus : 1;
+#else
+    return 1;
+#endif
+}
+
+Explorer *explore_create(const MEMORY *root, const ExploreConfig *config)
+{
+    if (config->actions != NULL && config->action_count <= 0)
+    {
+        fprintf(stderr, "ERROR: At least one action is required.\n");
+        return NULL;
+    }
+
+    Explorer *explorer = calloc(1, sizeof(Explorer));
+    if (explorer == NULL)
+    {
+        fprintf(stderr, "ERROR: Out of memory while creating the explorer.\n");
+        return NULL;
+    }
+
+    explorer->config = *config;
+    explorer->goal_node = EXPLORE_NO_GOAL;
+    if (explorer->config.frames_per_step < 1)
+        explorer->config.frames_per_step = 1;
+    if (config->actions == NULL)
+        explorer->config.action_count = 16;
+
+    int threads = config->num_threads > 0 ? config->num_threads : explore_default_threads();
+    int action_count = explorer->config.action_count;
+
+    explorer->actions = calloc((size_t)action_count, sizeof(uint16_t));
+    explorer->children = calloc((size_t)EXPLORE_BATCH_SIZE * action_count, sizeof(ExploreChild));
+    explorer->workers = calloc((size_t)threads, sizeof(ExploreWorker));
+    explorer->set_capacity = 1024;
+    explorer->set = calloc(explorer->set_capacity, sizeof(uint64_t));
+
+    if (explorer->actions == NULL || explorer->children == NULL || explorer->workers == NULL ||
+        explorer->set == NULL)
+    {
+        fprintf(stderr, "ERROR: Out of memory while creating the explorer.\n");
+        explore_destroy(explorer);
+        return NULL;
+    }
+
+    for (int a = 0; a < action_count; a++)
+        explorer->actions[a] = config->actions ? config->actions[a] : (uint16_t)(1u << a);
+    explorer->config.actions = explorer->actions;
+
+    /* The root's incremental hashes may be stale if its RAM was written directly */
+    MEMORY *caller_vm = chip8_vm;
+    explorer->root = *root;
+    chip8_vm = &explorer->root;
+    chip8_rehash();
+    uint64_t root_hash = chip8_state_hash();
+    chip8_vm = caller_vm;
+
+    size_t size;
+    ExploreSnapshot *snapshot = explore_encode(explorer, &explorer->root, &size);
+    if (snapshot == NULL || explore_set_insert(explorer, root_hash) < 0 ||
+        explore_add_node(explorer, 0, 0, 0, 0.0, snapshot) < 0)
+    {
+        free(snapshot);
+        fprintf(stderr, "ERROR: Out of memory while creating the explorer.\n");
+        explore_destroy(explorer);
+        return NULL;
+    }
+    explorer->stats.unique = 1;
+
+    pthread_mutex_init(&explorer->lock, NULL);
+    pthread_cond_init(&explorer->start, NULL);
+    pthread_cond_init(&explorer->finished, NULL);
+    explorer->threads_started = 1;
+
+    explorer->workers[0].explorer = explorer;
+    explorer->worker_count = 1;
+    for (int t = 1; t < threads; t++)
+    {
+        explorer->workers[t].explorer = explorer;
+        if (pthread_create(&explorer->workers[t].thread, NULL, explore_worker, &explorer->workers[t]) != 0)
+        {
+            fprintf(stderr, "ERROR: Failed to start explorer worker thread.\n");
+            explore_destroy(explorer);
+            return NULL;
+        }
+        explorer->worker_count++;
+    }
+
+    return explorer;
+}
+
+void explore_destroy(Explorer *explorer)
+{
+    if (explorer == NULL)
+        return;
+
+    if (explorer->threads_started)
+    {
+        pthread_mutex_lock(&explorer->lock);
+        explorer->stopping = 1;
+        pthread_cond_broadcast(&explorer->start);
+        pthread_mutex_unlock(&explorer->lock);
+
+        for (int t = 1; t < explorer->worker_count; t++)
+            pthread_join(explorer->workers[t].thread, NULL);
+
+        pthread_cond_destroy(&explorer->finished);
+        pthread_cond_destroy(&explorer->start);
+        pthread_mutex_destroy(&explorer->lock);
+    }
+
+    for (size_t i = 0; i < explorer->node_count; i++)
+        free(explorer->nodes[i].snapshot);
+
+    free(explorer->nodes);
+    free(explorer->heap);
+    free(explorer->set);
+    free(explorer->children);
+    free(explorer->workers);
+    free(explorer->actions);
+    free(explorer);
+}
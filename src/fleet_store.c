@@ -0,0 +1,287 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "fleet_store.h"
+
+#ifndef _WIN32
+
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "chip8.h"
+
+#define FLEET_STORE_FNV_OFFSET 0xCBF29CE484222325ull
+#define FLEET_STORE_FNV_PRIME 0x100000001B3ull
+
+/* The checksum runs over frames and vm as whole 64-bit words */
+_Static_assert(sizeof(MEMORY) % sizeof(uint64_t) == 0, "MEMORY must be a whole number of words");
+_Static_assert(offsetof(FleetStoreCopy, vm) == offsetof(FleetStoreCopy, frames) + sizeof(uint64_t),
+               "frames and vm must be contiguous");
+
+struct FleetStore
+{
+    uint8_t *mapping;
+    size_t size;
+    size_t stride;
+    int slots;
+    int8_t *latest;          /* Copy holding the newest complete checkpoint, or -1 */
+    uint64_t *generation;    /* Highest generation begun in the slot */
+    FleetSlotStatus *status; /* What the slot held when the file was opened */
+};
+
+static FleetStoreCopy *fleet_store_copy(FleetStore *store, int slot, int copy)
+{
+    return (FleetStoreCopy *)(store->mapping + FLEET_STORE_ALIGN + (size_t)slot * store->stride) + copy;
+}
+
+static uint64_t fleet_store_checksum(const FleetStoreCopy *copy, uint64_t generation)
+{
+    const uint64_t *words = &copy->frames;
+    size_t count = (sizeof(copy->frames) + sizeof(copy->vm)) / sizeof(uint64_t);
+    uint64_t hash = chip8_hash_mix(generation);
+
+    for (size_t i = 0; i < count; i++)
+        hash = chip8_hash_mix(hash ^ words[i]);
+
+    return hash;
+}
+
+static int fleet_store_complete(const FleetStoreCopy *copy)
+{
+    return copy->end != 0 && copy->begin == copy->end && copy->checksum == fleet_store_checksum(copy, copy->end);
+}
+
+/* Finds each slot's newest complete copy */
+static void fleet_store_scan(FleetStore *store)
+{
+    for (int slot = 0; slot < store->slots; slot++)
+    {
+        FleetStoreCopy *copies[2] = {fleet_store_copy(store, slot, 0), fleet_store_copy(store, slot, 1)};
+        int newest_begun = copies[1]->begin > copies[0]->begin;
+        int latest = -1;
+
+        for (int copy = 0; copy < 2; copy++)
+        {
+            if (fleet_store_complete(copies[copy]) && (latest < 0 || copies[copy]->end > copies[latest]->end))
+                latest = copy;
+        }
+
+        store->latest[slot] = (int8_t)latest;
+        store->generation[slot] = copies[newest_begun]->begin;
+
+        if (latest < 0)
+            store->status[slot] = FLEET_SLOT_EMPTY;
+        else if (copies[latest]->end < store->generation[slot])
+            store->status[slot] = FLEET_SLOT_ROLLED_BACK;
+        else
+            store->status[slot] = FLEET_SLOT_LATEST;
+    }
+}
+
+static uint64_t fleet_store_rom_hash(const uint8_t *rom, size_t rom_size)
+{
+    uint64_t hash = FLEET_STORE_FNV_OFFSET;
+
+    for (size_t i = 0; i < rom_size; i++)
+    {
+        hash ^= rom[i];
+        hash *= FLEET_STORE_FNV_PRIME;
+    }
+    return hash;
+}
+
+FleetStore *fleet_store_open(const char *path, int slots, const uint8_t *rom, size_t rom_size)
+{
+    size_t stride = (2 * sizeof(FleetStoreCopy) + FLEET_STORE_ALIGN - 1) / FLEET_STORE_ALIGN * FLEET_STORE_ALIGN;
+    size_t size = FLEET_STORE_ALIGN + (size_t)slots * stride;
+    uint64_t rom_hash = fleet_store_rom_hash(rom, rom_size);
+    struct stat st;
+
+    if (slots < 1)
+    {
+        fprintf(stderr, "ERROR: A fleet needs at least one session.\n");
+        return NULL;
+    }
+
+    int fd = open(path, O_RDWR | O_CREAT, 0600);
+    if (fd < 0 || fstat(fd, &st) != 0)
+    {
+        perror("ERROR: Failed to open the fleet file");
+        if (fd >= 0)
+            close(fd);
+        return NULL;
+    }
+
+    if (st.st_size != 0 && (size_t)st.st_size != size)
+    {
+        fprintf(stderr, "ERROR: %s holds a fleet of another size; remove it or use another file.\n", path);
+        close(fd);
+        return NULL;
+    }
+
+    if (st.st_size == 0 && ftruncate(fd, (off_t)size) != 0)
+    {
+        perror("ERROR: Failed to size the fleet file");
+        close(fd);
+        return NULL;
+    }
+
+    void *mapping = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (mapping == MAP_FAILED)
+    {
+        perror("ERROR: Failed to map the fleet file");
+        return NULL;
+    }
+
+    FleetStoreHeader *header = mapping;
+
+    /* A new file, or one whose creation never finished: every slot is still zero */
+    if (header->magic == 0)
+    {
+        header->version = FLEET_STORE_VERSION;
+        header->slots = (uint32_t)slots;
+        header->stride = (uint32_t)stride;
+        header->memory_size = (uint32_t)sizeof(MEMORY);
+        header->rom_hash = rom_hash;
+        atomic_thread_fence(memory_order_release);
+        header->magic = FLEET_STORE_MAGIC;
+    }
+    else if (header->magic != FLEET_STORE_MAGIC || header->version != FLEET_STORE_VERSION ||
+             header->slots != (uint32_t)slots || header->stride != stride ||
+             header->memory_size != sizeof(MEMORY) || header->rom_hash != rom_hash)
+    {
+        fprintf(stderr, "ERROR: %s holds the fleet of another ROM or build; remove it or use another file.\n",
+                path);
+        munmap(mapping, size);
+        return NULL;
+    }
+
+    FleetStore *store = calloc(1, sizeof(FleetStore));
+    if (store)
+    {
+        store->latest = calloc((size_t)slots, sizeof(*store->latest));
+        store->generation = calloc((size_t)slots, sizeof(*store->generation));
+        store->status = calloc((size_t)slots, sizeof(*store->status));
+    }
+
+    if (store == NULL || store->latest == NULL || store->generation == NULL || store->status == NULL)
+    {
+        fprintf(stderr, "ERROR: Out of memory.\n");
+        munmap(mapping, size);
+        if (store)
+        {
+            free(store->latest);
+            free(store->generation);
+            free(store->status);
+            free(store);
+        }
+        return NULL;
+    }
+
+    store->mapping = mapping;
+    store->size = size;
+    store->stride = stride;
+    store->slots = slots;
+    fleet_store_scan(store);
+    return store;
+}
+
+FleetSlotStatus fleet_store_load(FleetStore *store, int slot, MEMORY *vm, uint64_t *frames)
+{
+    if (store->latest[slot] < 0)
+        return FLEET_SLOT_EMPTY;
+
+    const FleetStoreCopy *copy = fleet_store_copy(store, slot, store->latest[slot]);
+    memcpy(vm, &copy->vm, sizeof(MEMORY));
+    *frames = copy->frames;
+    return store->status[slot];
+}
+
+void fleet_store_save(FleetStore *store, int slot, const MEMORY *vm, uint64_t frames)
+{
+    int target = store->latest[slot] == 0 ? 1 : 0;
+    FleetStoreCopy *copy = fleet_store_copy(store, slot, target);
+    uint64_t generation = store->generation[slot] + 1;
+
+    copy->begin = generation;
+    atomic_thread_fence(memory_order_release);
+
+    copy->frames = frames;
+    memcpy(&copy->vm, vm, sizeof(MEMORY));
+    copy->checksum = fleet_store_checksum(copy, generation);
+    atomic_thread_fence(memory_order_release);
+
+    copy->end = generation;
+
+    store->latest[slot] = (int8_t)target;
+    store->generation[slot] = generation;
+}
+
+int fleet_store_sync(FleetStore *store)
+{
+    if (msync(store->mapping, store->size, MS_SYNC) != 0)
+    {
+        perror("ERROR: Failed to write back the fleet file");
+        return -1;
+    }
+    return 0;
+}
+
+void fleet_store_close(FleetStore *store)
+{
+    if (store == NULL)
+        return;
+
+    fleet_store_sync(store);
+    munmap(store->mapping, store->size);
+    free(store->latest);
+    free(store->generation);
+    free(store->status);
+    free(store);
+}
+
+#else
+
+FleetStore *fleet_store_open(const char *path, int slots, const uint8_t *rom, size_t rom_size)
+{
+    (void)path;
+    (void)slots;
+    (void)rom;
+    (void)rom_size;
+    fprintf(stderr, "ERROR: Persistent fleet state is not supported on this platform.\n");
+    return NULL;
+}
+
+FleetSlotStatus fleet_store_load(FleetStore *store, int slot, MEMORY *vm, uint64_t *frames)
+{
+    (void)store;
+    (void)slot;
+    (void)vm;
+    (void)frames;
+    return FLEET_SLOT_EMPTY;
+}
+
+void fleet_store_save(FleetStore *store, int slot, const MEMORY *vm, uint64_t frames)
+{
+    (void)store;
+    (void)slot;
+    (void)vm;
+    (void)frames;
+}
+
+int fleet_store_sync(FleetStore *store)
+{
+    (void)store;
+    return -1;
+}
+
+void fleet_store_close(FleetStore *store)
+{
+    (void)store;
+}
+
+#endif
@@ -0,0 +1,139 @@
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include "frame_pacer.h"
+
+#define NS_PER_SECOND 1000000000LL
+
+static void frame_pacer_record(FramePacer *pacer, int64_t now)
+{
+    int64_t frame_ns = now - pacer->last_mark_ns;
+    pacer->last_mark_ns = now;
+
+    pacer->history[pacer->history_next] = (uint32_t)(frame_ns > UINT32_MAX ? UINT32_MAX : frame_ns);
+    pacer->history_next = (pacer->history_next + 1) % FRAME_PACER_HISTORY;
+    pacer->frames++;
+
+    if (frame_ns > pacer->max_ns)
+        pacer->max_ns = frame_ns;
+}
+
+static void frame_pacer_sleep_until(int64_t deadline)
+{
+    struct timespec ts;
+    ts.tv_sec = deadline / NS_PER_SECOND;
+    ts.tv_nsec = deadline % NS_PER_SECOND;
+
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+        ;
+}
+
+static int frame_pacer_compare(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+int64_t frame_pacer_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * NS_PER_SECOND + ts.tv_nsec;
+}
+
+void frame_pacer_sleep_ns(int64_t ns)
+{
+    if (ns > 0)
+        frame_pacer_sleep_until(frame_pacer_now_ns() + ns);
+}
+
+void frame_pacer_init(FramePacer *pacer, int rate_hz, int vsync)
+{
+    memset(pacer, 0, sizeof(*pacer));
+    pacer->period_ns = NS_PER_SECOND / rate_hz;
+    pacer->vsync = vsync;
+    pacer->last_mark_ns = frame_pacer_now_ns();
+    pacer->deadline_ns = pacer->last_mark_ns + pacer->period_ns;
+}
+
+void frame_pacer_wait(FramePacer *pacer)
+{
+    if (pacer->vsync)
+    {
+        frame_pacer_mark(pacer);
+        return;
+    }
+
+    int64_t now = frame_pacer_now_ns();
+
+    if (now > pacer->deadline_ns + FRAME_PACER_MISS_TOLERANCE_NS)
+        pacer->missed++;
+
+    if (pacer->deadline_ns - now > FRAME_PACER_SPIN_NS)
+        frame_pacer_sleep_until(pacer->deadline_ns - FRAME_PACER_SPIN_NS);
+
+    do
+    {
+        now = frame_pacer_now_ns();
+    } while (now < pacer->deadline_ns);
+
+    frame_pacer_record(pacer, now);
+
+    pacer->deadline_ns += pacer->period_ns;
+    if (now - pacer->deadline_ns > pacer->period_ns)
+        pacer->deadline_ns = now + pacer->period_ns;
+}
+
+void frame_pacer_mark(FramePacer *pacer)
+{
+    int64_t now = frame_pacer_now_ns();
+
+    if (now - pacer->last_mark_ns > pacer->period_ns + FRAME_PACER_MISS_TOLERANCE_NS)
+        pacer->missed++;
+
+    frame_pacer_record(pacer, now);
+    pacer->deadline_ns = now + pacer->period_ns;
+}
+
+void frame_pacer_resume(FramePacer *pacer)
+{
+    pacer->last_mark_ns = frame_pacer_now_ns();
+    pacer->deadline_ns = pacer->last_mark_ns + pacer->period_ns;
+}
+
+void frame_pacer_get_stats(const FramePacer *pacer, FramePacerStats *stats)
+{
+    static uint32_t sorted[FRAME_PACER_HISTORY];
+    size_t count = pacer->frames < FRAME_PACER_HISTORY ? pacer->frames : FRAME_PACER_HISTORY;
+
+    memset(stats, 0, sizeof(*stats));
+    stats->frames = pacer->frames;
+    stats->missed = pacer->missed;
+    stats->max_ns = pacer->max_ns;
+
+    if (count == 0)
+        return;
+
+    memcpy(sorted, pacer->history, count * sizeof(uint32_t));
+    qsort(sorted, count, sizeof(uint32_t), frame_pacer_compare);
+
+    stats->p50_ns = sorted[(count - 1) * 50 / 100];
+    stats->p99_ns = sorted[(count - 1) * 99 / 100];
+}
+
+void frame_pacer_report(const FramePacer *pacer, FILE *out)
+{
+    FramePacerStats stats;
+    frame_pacer_get_stats(pacer, &stats);
+
+    fprintf(out,
+            "Frames: %lu, frame time p50 %.3f ms, p99 %.3f ms, max %.3f ms, "
+            "missed deadlines: %lu\n",
+            stats.frames,
+            stats.p50_ns / 1e6,
+            stats.p99_ns / 1e6,
+            stats.max_ns / 1e6,
+            stats.missed);
+}
@@ -0,0 +1,238 @@
+#include <stdio.h>
+#include <string.h>
+#include "frontend.h"
+#include "chip8.h"
+#include "frame_pacer.h"
+#include "metrics.h"
+#include "processor.h"
+#include "terminal_display.h"
+
+static int frontend_terminal_init(const FrontendConfig *config)
+{
+    (void)config;
+    return terminal_display_init(TERMINAL_CELLS_HALF_BLOCKS);
+}
+
+static int frontend_braille_init(const FrontendConfig *config)
+{
+    (void)config;
+    return terminal_display_init(TERMINAL_CELLS_BRAILLE);
+}
+
+static void frontend_terminal_destroy(void)
+{
+    const TerminalStats *stats = terminal_display_stats();
+
+    terminal_display_destroy();
+    fprintf(stderr, "Terminal: %llu updates, %llu cells, %.1f bytes per update\n",
+            stats->updates, stats->cells_written,
+            stats->updates ? (double)stats->bytes_written / stats->updates : 0.0);
+}
+
+/* The null backend also fills in what the others cannot do */
+static int frontend_null_init(const FrontendConfig *config)
+{
+    (void)config;
+    return 0;
+}
+
+static void frontend_null_present(void)
+{
+    metrics_frontend.display_updates++;
+}
+
+static void frontend_null_set_overlay(const char *text)
+{
+    (void)text;
+}
+
+static int frontend_null_poll_input(void)
+{
+    return 0;
+}
+
+/* There is no input to wait for, so never sleep longer than a frame */
+static int frontend_null_wait_input(int timeout_ms)
+{
+    int64_t frame_ns = 1000000000LL / CHIP8_FRAME_RATE;
+    int64_t timeout_ns = (int64_t)timeout_ms * 1000000;
+
+    frame_pacer_sleep_ns(timeout_ms < 0 || timeout_ns > frame_ns ? frame_ns : timeout_ns);
+    return 0;
+}
+
+static void frontend_null_queue_audio(int tone_on)
+{
+    (void)tone_on;
+}
+
+static int frontend_null_audio_frame_due(void)
+{
+    return -1;
+}
+
+static void frontend_null_destroy(void)
+{
+}
+
+static void frontend_null_present_rgba(const uint32_t *pixels, int width, int height)
+{
+    (void)pixels;
+    (void)width;
+    (void)height;
+    metrics_frontend.display_updates++;
+}
+
+static int frontend_null_audio_sample_rate(void)
+{
+    return 0;
+}
+
+static CaptureWriter *frontend_record_writer;
+static unsigned long frontend_record_frames;
+static int frontend_record_failed;
+
+static int frontend_record_init(const FrontendConfig *config)
+{
+    if (config->record.output_path == NULL)
+    {
+        fprintf(stderr, "ERROR: The record frontend needs an output file (--record <file|->).\n");
+        return -1;
+    }
+
+    frontend_record_writer = capture_writer_open(&config->record);
+    frontend_record_frames = 0;
+    frontend_record_failed = 0;
+    return frontend_record_writer ? 0 : -1;
+}
+
+static void frontend_record_present(void)
+{
+    int64_t start_ns = frame_pacer_now_ns();
+    uint8_t pixels[CHIP8_HEIGHT][CHIP8_WIDTH];
+
+    if (frontend_record_failed)
+        return;
+
+    for (int y = 0; y < CHIP8_HEIGHT; y++)
+        for (int x = 0; x < CHIP8_WIDTH; x++)
+            pixels[y][x] = chip8_memory.display[y][x] != 0;
+
+    if (capture_writer_frame(frontend_record_writer, pixels) != 0)
+    {
+        perror("Failed to write recording");
+        frontend_record_failed = 1;
+        return;
+    }
+    frontend_record_frames++;
+
+    metrics_frontend.display_updates++;
+    metrics_frontend.display_update_ns += frame_pacer_now_ns() - start_ns;
+}
+
+static void frontend_record_destroy(void)
+{
+    if (capture_writer_close(frontend_record_writer) != 0 && !frontend_record_failed)
+        perror("Failed to write recording");
+
+    frontend_record_writer = NULL;
+    fprintf(stderr, "Recorded %lu frames\n", frontend_record_frames);
+}
+
+static const FrontendBackend frontend_terminal = {
+    .name = "terminal",
+    .flags = FRONTEND_TERMINAL,
+    .init = frontend_terminal_init,
+    .present = terminal_display_update,
+    .set_overlay = terminal_display_set_status,
+    .poll_input = terminal_display_process_input,
+    .wait_input = terminal_display_wait_input,
+    .queue_audio = frontend_null_queue_audio,
+    .audio_frame_due = frontend_null_audio_frame_due,
+    .destroy = frontend_terminal_destroy,
+};
+
+static const FrontendBackend frontend_braille = {
+    .name = "braille",
+    .flags = FRONTEND_TERMINAL,
+    .init = frontend_braille_init,
+    .present = terminal_display_update,
+    .set_overlay = terminal_display_set_status,
+    .poll_input = terminal_display_process_input,
+    .wait_input = terminal_display_wait_input,
+    .queue_audio = frontend_null_queue_audio,
+    .audio_frame_due = frontend_null_audio_frame_due,
+    .destroy = frontend_terminal_destroy,
+};
+
+static const FrontendBackend frontend_null = {
+    .name = "null",
+    .flags = 0,
+    .init = frontend_null_init,
+    .present = frontend_null_present,
+    .set_overlay = frontend_null_set_overlay,
+    .poll_input = frontend_null_poll_input,
+    .wait_input = frontend_null_wait_input,
+    .queue_audio = frontend_null_queue_audio,
+    .audio_frame_due = frontend_null_audio_frame_due,
+    .destroy = frontend_null_destroy,
+    .present_rgba = frontend_null_present_rgba,
+    .audio_sample_rate = frontend_null_audio_sample_rate,
+};
+
+static const FrontendBackend frontend_record = {
+    .name = "record",
+    .flags = FRONTEND_EVERY_FRAME,
+    .init = frontend_record_init,
+    .present = frontend_record_present,
+    .set_overlay = frontend_null_set_overlay,
+    .poll_input = frontend_null_poll_input,
+    .wait_input = frontend_null_wait_input,
+    .queue_audio = frontend_null_queue_audio,
+    .audio_frame_due = frontend_null_audio_frame_due,
+    .destroy = frontend_record_destroy,
+};
+
+/* The first entry is the default */
+static const FrontendBackend *const frontend_backends[] = {
+#ifndef CHIP8_NO_SDL
+    &frontend_sdl,
+#endif
+    &frontend_terminal,
+    &frontend_braille,
+    &frontend_null,
+    &frontend_record,
+};
+
+#define FRONTEND_COUNT (sizeof(frontend_backends) / sizeof(frontend_backends[0]))
+
+const FrontendBackend *frontend_find(const char *name)
+{
+    if (name == NULL)
+        return frontend_backends[0];
+
+    for (size_t i = 0; i < FRONTEND_COUNT; i++)
+    {
+        if (strcmp(frontend_backends[i]->name, name) == 0)
+            return frontend_backends[i];
+    }
+
+    return NULL;
+}
+
+const char *frontend_names(void)
+{
+    static char names[64];
+
+    if (names[0] == '\0')
+    {
+        for (size_t i = 0; i < FRONTEND_COUNT; i++)
+        {
+            if (i > 0)
+                strcat(names, "|");
+            strcat(names, frontend_backends[i]->name);
+        }
+    }
+
+    return names;
+}
@@ -0,0 +1,54 @@
+#include <stdio.h>
+#include "frontend.h"
+#include "display_manager.h"
+#include "audio_manager.h"
+
+static int frontend_sdl_init(const FrontendConfig *config)
+{
+    if (!DisplayManager_Init(config->title, config->vsync))
+    {
+        fprintf(stderr, "Failed to initialize display: %s\n", SDL_GetError());
+        return -1;
+    }
+
+    /* Without audio the emulator carries on silently */
+    if (config->audio_enabled)
+        AudioManager_Init(&config->audio);
+
+    return 0;
+}
+
+static int frontend_sdl_audio_frame_due(void)
+{
+    if (g_audioManager.device == 0)
+        return -1;
+
+    return AudioManager_FrameDue();
+}
+
+static int frontend_sdl_audio_sample_rate(void)
+{
+    return g_audioManager.device ? g_audioManager.spec.freq : 0;
+}
+
+static void frontend_sdl_destroy(void)
+{
+    AudioManager_Destroy();
+    DisplayManager_Destroy();
+}
+
+const FrontendBackend frontend_sdl = {
+    .name = "sdl",
+    .flags = 0,
+    .init = frontend_sdl_init,
+    .present = DisplayManager_Update,
+    .set_overlay = DisplayManager_SetOverlay,
+    .poll_input = DisplayManager_ProcessInput,
+    .wait_input = DisplayManager_WaitInput,
+    .queue_audio = AudioManager_QueueCycle,
+    .audio_frame_due = frontend_sdl_audio_frame_due,
+    .destroy = frontend_sdl_destroy,
+    .present_rgba = DisplayManager_UpdateRGBA,
+    .audio_sample_rate = frontend_sdl_audio_sample_rate,
+    .queue_wave = AudioManager_QueueSamples,
+};
@@ -1,6 +1,7 @@
 #include "instructions.h"
 #include "chip8.h"
 #include "opcode_table.h"
+#include "processor.h"
 #include "memory.h"
 #include <math.h>
 #include <string.h>
@@ -8,10 +9,17 @@
 void OP_00E0()
 {
     memset(chip8_memory.display, 0, sizeof(chip8_memory.display));
+    chip8_memory.display_hash = 0;
 }
 
 void OP_00EE()
 {
+    if (chip8_memory.stack_pointer == 0)
+    {
+        chip8_fault(CHIP8_FAULT_STACK_UNDERFLOW);
+        return;
+    }
+
     chip8_memory.program_counter = chip8_memory.stack[--chip8_memory.stack_pointer];
 }
 
@@ -22,6 +30,12 @@ void OP_1nnn()
 
 void OP_2nnn()
 {
+    if (chip8_memory.stack_pointer == 16)
+    {
+        chip8_fault(CHIP8_FAULT_STACK_OVERFLOW);
+        return;
+    }
+
     chip8_memory.stack[chip8_memory.stack_pointer++] = chip8_memory.program_counter;
     chip8_memory.program_counter = opcode & 0x0FFFu;
 }
@@ -185,7 +199,14 @@ void OP_Dxyn()
     uint8_t register_value_x = chip8_memory.registers[register_address_x];
     uint8_t register_value_y = chip8_memory.registers[register_address_y];
 
+    if (chip8_memory.index + sprite_size > sizeof(chip8_memory.ram))
+    {
+        chip8_fault(CHIP8_FAULT_MEMORY_RANGE);
+        return;
+    }
+
     chip8_memory.registers[0xF] = 0;
+    unsigned int drawn = 0;
 
     for (uint8_t i = 0; i < sprite_size; i++)
     {
@@ -210,9 +231,14 @@ void OP_Dxyn()
 
                 chip8_memory.display[row][col] =
                     result ? 0xFFFFFFFF : 0x00000000;
+                chip8_memory.display_hash ^= chip8_pixel_key(row, col);
+                drawn++;
             }
         }
     }
+
+    processor_stats.draw_calls++;
+    processor_stats.pixels_drawn += drawn;
 }
 
 void OP_Ex9E()
@@ -220,6 +246,12 @@ void OP_Ex9E()
     uint8_t register_address = (opcode & 0x0F00u) >> 8u;
     uint8_t register_value = chip8_memory.registers[register_address];
 
+    if (register_value > 0xF)
+    {
+        chip8_fault(CHIP8_FAULT_KEY_RANGE);
+        return;
+    }
+
     chip8_memory.program_counter += ((chip8_memory.keypad[register_value]) ? 2 : 0);
 }
 
@@ -228,6 +260,12 @@ void OP_ExA1()
     uint8_t register_address = (opcode & 0x0F00u) >> 8u;
     uint8_t register_value = chip8_memory.registers[register_address];
 
+    if (register_value > 0xF)
+    {
+        chip8_fault(CHIP8_FAULT_KEY_RANGE);
+        return;
+    }
+
     chip8_memory.program_counter += (!(chip8_memory.keypad[register_value]) ? 2 : 0);
 }
 
@@ -251,7 +289,8 @@ void OP_Fx0A()
         }
     }
 
-    chip8_memory.program_counter -= 2;
+    chip8_memory.waiting_for_key = 1;
+    chip8_memory.key_register = register_address;
 }
 
 void OP_Fx15()
@@ -288,20 +327,32 @@ void OP_Fx33()
     uint8_t register_address = (opcode & 0x0F00u) >> 8u;
     uint8_t register_value = chip8_memory.registers[register_address];
 
-    chip8_memory.ram[chip8_memory.index + 2] = register_value % 10;
+    if (chip8_memory.index + 3 > sizeof(chip8_memory.ram))
+    {
+        chip8_fault(CHIP8_FAULT_MEMORY_RANGE);
+        return;
+    }
+
+    chip8_write_ram(chip8_memory.index + 2, register_value % 10);
     register_value /= 10;
-    chip8_memory.ram[chip8_memory.index + 1] = register_value % 10;
+    chip8_write_ram(chip8_memory.index + 1, register_value % 10);
     register_value /= 10;
-    chip8_memory.ram[chip8_memory.index] = register_value;
+    chip8_write_ram(chip8_memory.index, register_value);
 }
 
 void OP_Fx55()
 {
     uint8_t register_address = (opcode & 0x0F00u) >> 8u;
 
+    if (chip8_memory.index + register_address + 1 > sizeof(chip8_memory.ram))
+    {
+        chip8_fault(CHIP8_FAULT_MEMORY_RANGE);
+        return;
+    }
+
     for (uint8_t i = 0; i <= register_address; i++)
     {
-        chip8_memory.ram[chip8_memory.index + i] = chip8_memory.registers[i];
+        chip8_write_ram(chip8_memory.index + i, chip8_memory.registers[i]);
     }
 }
 
@@ -309,6 +360,12 @@ void OP_Fx65()
 {
     uint8_t register_address = (opcode & 0x0F00u) >> 8u;
 
+    if (chip8_memory.index + register_address + 1 > sizeof(chip8_memory.ram))
+    {
+        chip8_fault(CHIP8_FAULT_MEMORY_RANGE);
+        return;
+    }
+
     for (uint8_t i = 0; i <= register_address; i++)
     {
         chip8_memory.registers[i] = chip8_memory.ram[chip8_memory.index + i];
@@ -0,0 +1,48 @@
+#include <ctype.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "keymap.h"
+
+/* Keypad key + 1 for every host key code, 0 for unmapped keys */
+static uint8_t keymap_table[256];
+static int keymap_ready = 0;
+
+int keymap_set(const char *keys)
+{
+    uint8_t table[256] = {0};
+
+    if (strlen(keys) != 16)
+    {
+        fprintf(stderr, "ERROR: A keymap needs exactly 16 keys, one for each of 0-F.\n");
+        return -1;
+    }
+
+    for (int key = 0; key < 16; key++)
+    {
+        unsigned char c = (unsigned char)tolower((unsigned char)keys[key]);
+
+        if (!isgraph(c) || table[c])
+        {
+            fprintf(stderr, "ERROR: Keymap key '%c' is not printable or is used twice.\n", keys[key]);
+            return -1;
+        }
+        table[c] = (uint8_t)(key + 1);
+        table[toupper(c)] = (uint8_t)(key + 1);
+    }
+
+    memcpy(keymap_table, table, sizeof(keymap_table));
+    keymap_ready = 1;
+    return 0;
+}
+
+int keymap_lookup(int host_key)
+{
+    if (!keymap_ready)
+        keymap_set(KEYMAP_DEFAULT);
+
+    if (host_key < 0 || host_key > 255)
+        return -1;
+
+    return keymap_table[host_key] - 1;
+}
@@ -0,0 +1,197 @@
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include "libchip8.h"
+#include "chip8.h"
+#include "processor.h"
+
+#define LIBCHIP8_FNV_OFFSET 0xCBF29CE484222325ull
+#define LIBCHIP8_FNV_PRIME 0x100000001B3ull
+
+struct Chip8Machine
+{
+    MEMORY vm;
+    MEMORY pristine; /* State right after the last ROM load */
+    uint32_t seed;
+};
+
+/* Points chip8_vm at `machine`; returns the previous target */
+static MEMORY *libchip8_enter(Chip8Machine *machine)
+{
+    MEMORY *caller_vm = chip8_vm;
+    chip8_vm = &machine->vm;
+    return caller_vm;
+}
+
+static void libchip8_init(Chip8Machine *machine)
+{
+    MEMORY *caller_vm = libchip8_enter(machine);
+
+    memset(&machine->vm, 0, sizeof(MEMORY));
+    chip8_init();
+    chip8_seed(machine->seed);
+
+    chip8_vm = caller_vm;
+}
+
+Chip8Machine *libchip8_create(uint32_t seed)
+{
+    Chip8Machine *machine = calloc(1, sizeof(Chip8Machine));
+    if (machine == NULL)
+        return NULL;
+
+    machine->seed = seed;
+    libchip8_init(machine);
+    machine->pristine = machine->vm;
+    return machine;
+}
+
+void libchip8_destroy(Chip8Machine *machine)
+{
+    free(machine);
+}
+
+int libchip8_load_rom(Chip8Machine *machine, const uint8_t *data, size_t size)
+{
+    libchip8_init(machine);
+
+    MEMORY *caller_vm = libchip8_enter(machine);
+    int result = chip8_load_ROM_buffer(data, size);
+    chip8_vm = caller_vm;
+
+    if (result != 0)
+        return -1;
+
+    machine->pristine = machine->vm;
+    return 0;
+}
+
+void libchip8_reset(Chip8Machine *machine)
+{
+    machine->vm = machine->pristine;
+}
+
+int libchip8_run_cycles(Chip8Machine *machine, unsigned long cycles)
+{
+    MEMORY *caller_vm = libchip8_enter(machine);
+    int stopped = 0;
+
+    while (cycles > 0 && !stopped)
+    {
+        unsigned int used;
+        int events = processor_run(cycles < UINT_MAX ? (unsigned int)cycles : UINT_MAX, &used);
+
+        /* A stopped machine uses no cycles until the debugger resumes it */
+        stopped = (events & PROCESSOR_EVENT_BREAKPOINT) != 0;
+        cycles -= used;
+    }
+
+    /* A frame end held back by an event on its last slot is applied now, as the cycles ran out on it */
+    if (!stopped && machine->vm.frame_cycle == CHIP8_CYCLES_PER_FRAME)
+    {
+        unsigned int used;
+        processor_run(0, &used);
+    }
+
+    chip8_vm = caller_vm;
+    return stopped ? LIBCHIP8_STOPPED : machine->vm.fault;
+}
+
+int libchip8_run_frames(Chip8Machine *machine, unsigned long frames)
+{
+    if (machine->vm.frame_cycle != 0)
+        libchip8_run_cycles(machine, CHIP8_CYCLES_PER_FRAME - machine->vm.frame_cycle);
+
+    MEMORY *caller_vm = libchip8_enter(machine);
+
+    /* Idle frames are skipped in bulk, so a long wait costs little */
+    while (frames > 0)
+    {
+        unsigned int ran;
+        processor_frames(frames < UINT_MAX ? (unsigned int)frames : UINT_MAX, &ran, NULL);
+        frames -= ran;
+    }
+
+    chip8_vm = caller_vm;
+    return machine->vm.fault;
+}
+
+void libchip8_set_key(Chip8Machine *machine, uint8_t key, uint8_t pressed)
+{
+    MEMORY *caller_vm = libchip8_enter(machine);
+    chip8_set_key(key, pressed);
+    chip8_vm = caller_vm;
+}
+
+void libchip8_set_keypad(Chip8Machine *machine, uint16_t keys)
+{
+    MEMORY *caller_vm = libchip8_enter(machine);
+
+    for (uint8_t key = 0; key < 16; key++)
+        chip8_set_key(key, (keys >> key) & 1u);
+
+    chip8_vm = caller_vm;
+}
+
+const uint32_t *libchip8_framebuffer(const Chip8Machine *machine)
+{
+    return &machine->vm.display[0][0];
+}
+
+int libchip8_sound_active(const Chip8Machine *machine)
+{
+    return machine->vm.sound_timer > 0;
+}
+
+static uint64_t libchip8_hash_bytes(uint64_t hash, const uint8_t *data, size_t size)
+{
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= data[i];
+        hash *= LIBCHIP8_FNV_PRIME;
+    }
+    return hash;
+}
+
+/* Hashes `value` as `size` little-endian bytes, independent of the host */
+static uint64_t libchip8_hash_value(uint64_t hash, uint32_t value, int size)
+{
+    for (int i = 0; i < size; i++)
+    {
+        hash ^= (value >> (8 * i)) & 0xFFu;
+        hash *= LIBCHIP8_FNV_PRIME;
+    }
+    return hash;
+}
+
+uint64_t libchip8_hash(const Chip8Machine *machine)
+{
+    const MEMORY *vm = &machine->vm;
+    uint64_t hash = LIBCHIP8_FNV_OFFSET;
+
+    hash = libchip8_hash_bytes(hash, vm->registers, sizeof(vm->registers));
+    hash = libchip8_hash_bytes(hash, vm->ram, sizeof(vm->ram));
+    hash = libchip8_hash_value(hash, vm->index, 2);
+    hash = libchip8_hash_value(hash, vm->program_counter, 2);
+    for (int i = 0; i < 16; i++)
+        hash = libchip8_hash_value(hash, vm->stack[i], 2);
+    hash = libchip8_hash_value(hash, vm->stack_pointer, 1);
+    hash = libchip8_hash_value(hash, vm->delay_timer, 1);
+    hash = libchip8_hash_value(hash, vm->sound_timer, 1);
+    hash = libchip8_hash_bytes(hash, vm->keypad, sizeof(vm->keypad));
+    hash = libchip8_hash_value(hash, vm->waiting_for_key, 1);
+    hash = libchip8_hash_value(hash, vm->key_register, 1);
+    hash = libchip8_hash_value(hash, vm->fault, 1);
+    hash = libchip8_hash_value(hash, vm->rng_state, 4);
+
+    /* Pixels are on or off; hash one byte each so the pixel format does not matter */
+    for (int i = 0; i < CHIP8_HEIGHT * CHIP8_WIDTH; i++)
+        hash = libchip8_hash_value(hash, (&vm->display[0][0])[i] != 0, 1);
+
+    return libchip8_hash_value(hash, vm->frame_cycle, 1);
+}
+
+MEMORY *libchip8_state(Chip8Machine *machine)
+{
+    return &machine->vm;
+}
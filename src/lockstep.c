@@ -0,0 +1,383 @@
+#include <stdlib.h>
+#include <string.h>
+#include "lockstep.h"
+#include "chip8.h"
+#include "processor.h"
+#include "opcode_table.h"
+
+#define LOCKSTEP_LINE_SHIFT 6
+#define LOCKSTEP_ALIGNMENT 64
+
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) && defined(__linux__)
+#define LOCKSTEP_TARGETS __attribute__((target_clones("avx2", "default")))
+#else
+#define LOCKSTEP_TARGETS
+#endif
+
+/* Replaces the lanes of `old` selected by mask `m` with `value` */
+#define BLEND(old, value, m) (((old) & ~(m)) | ((value) & (m)))
+
+/* Row alignment: a 32-lane row of uint16_t is one 64-byte vector */
+#define LOCKSTEP_ROW __attribute__((aligned(LOCKSTEP_ALIGNMENT)))
+
+/* State lockstep_scalar() copies besides PC: V0–VF as bits 0–15, then these */
+#define LOCKSTEP_SYNC_I (1u << 16)
+#define LOCKSTEP_SYNC_TIMERS (1u << 17)
+#define LOCKSTEP_SYNC_STACK (1u << 18)
+#define LOCKSTEP_SYNC_ALL 0x7FFFFu
+
+/*
+ * The hot state is kept in rows of LOCKSTEP_MAX_LANES entries, one row per
+ * register. The frame kernel for a group (lockstep_kernel.h) views the
+ * first 8, 16 or 32 entries of each row as one vector.
+ */
+struct LockstepGroup
+{
+    uint8_t V[16][LOCKSTEP_MAX_LANES] LOCKSTEP_ROW;
+    uint16_t I[LOCKSTEP_MAX_LANES] LOCKSTEP_ROW;
+    uint16_t PC[LOCKSTEP_MAX_LANES] LOCKSTEP_ROW;
+    uint16_t stack[16][LOCKSTEP_MAX_LANES] LOCKSTEP_ROW;
+    uint8_t SP[LOCKSTEP_MAX_LANES] LOCKSTEP_ROW;
+    uint8_t delay_timer[LOCKSTEP_MAX_LANES] LOCKSTEP_ROW;
+    uint8_t sound_timer[LOCKSTEP_MAX_LANES] LOCKSTEP_ROW;
+    uint8_t budget[LOCKSTEP_MAX_LANES] LOCKSTEP_ROW;
+    int8_t halted[LOCKSTEP_MAX_LANES] LOCKSTEP_ROW; /* -1 for lanes that cannot run: unused, faulted or waiting for a key */
+
+    MEMORY *vms;
+    int lanes;
+    int layout_dirty;
+    uint64_t written_lines; /* 64-byte RAM lines that may differ between lanes */
+    LockstepStats stats;
+    void *allocation;
+};
+
+static void lockstep_mark_written(LockstepGroup *group, unsigned address, unsigned length)
+{
+    unsigned last = address + length - 1;
+
+    if (last >= sizeof(((MEMORY *)0)->ram))
+        last = sizeof(((MEMORY *)0)->ram) - 1;
+
+    for (unsigned line = address >> LOCKSTEP_LINE_SHIFT; line <= last >> LOCKSTEP_LINE_SHIFT; line++)
+        group->written_lines |= 1ull << line;
+}
+
+/* Marks every line whose contents differ from lane 0 in any loaded lane */
+static void lockstep_compare_lanes(LockstepGroup *group)
+{
+    const unsigned line_size = 1u << LOCKSTEP_LINE_SHIFT;
+    const uint8_t *reference = group->vms[0].ram;
+
+    for (int lane = 1; lane < group->lanes; lane++)
+    {
+        for (unsigned address = 0; address < sizeof(group->vms[0].ram); address += line_size)
+        {
+            if (memcmp(reference + address, group->vms[lane].ram + address, line_size) != 0)
+                lockstep_mark_written(group, address, line_size);
+        }
+    }
+
+    group->layout_dirty = 0;
+}
+
+static void lockstep_sync_halted(LockstepGroup *group, int lane)
+{
+    const MEMORY *vm = &group->vms[lane];
+    group->halted[lane] = (vm->fault || vm->waiting_for_key) ? -1 : 0;
+}
+
+/*
+ * Runs the regular handler for `op` on one lane, copying PC and the state
+ * in `sync` (LOCKSTEP_SYNC_*) between the rows and the lane's MEMORY
+ */
+static void lockstep_scalar(LockstepGroup *group, int lane, uint16_t op, uint32_t sync)
+{
+    MEMORY *vm = &group->vms[lane];
+
+    for (uint32_t r = sync & 0xFFFFu; r != 0; r &= r - 1)
+        vm->registers[__builtin_ctz(r)] = group->V[__builtin_ctz(r)][lane];
+    if (sync & LOCKSTEP_SYNC_I)
+        vm->index = group->I[lane];
+    if (sync & LOCKSTEP_SYNC_TIMERS)
+    {
+        vm->delay_timer = group->delay_timer[lane];
+        vm->sound_timer = group->sound_timer[lane];
+    }
+    if (sync & LOCKSTEP_SYNC_STACK)
+    {
+        for (int s = 0; s < 16; s++)
+            vm->stack[s] = group->stack[s][lane];
+        vm->stack_pointer = group->SP[lane];
+    }
+    vm->program_counter = group->PC[lane];
+
+    chip8_vm = vm;
+    opcode = op;
+    ot_execute();
+
+    for (uint32_t r = sync & 0xFFFFu; r != 0; r &= r - 1)
+        group->V[__builtin_ctz(r)][lane] = vm->registers[__builtin_ctz(r)];
+    if (sync & LOCKSTEP_SYNC_I)
+        group->I[lane] = vm->index;
+    if (sync & LOCKSTEP_SYNC_TIMERS)
+    {
+        group->delay_timer[lane] = vm->delay_timer;
+        group->sound_timer[lane] = vm->sound_timer;
+    }
+    if (sync & LOCKSTEP_SYNC_STACK)
+    {
+        for (int s = 0; s < 16; s++)
+            group->stack[s][lane] = vm->stack[s];
+        group->SP[lane] = vm->stack_pointer;
+    }
+    group->PC[lane] = vm->program_counter;
+
+    lockstep_sync_halted(group, lane);
+    group->stats.scalar_calls++;
+}
+
+static void lockstep_scalar_all(LockstepGroup *group, uint16_t op, const int8_t *mask, uint32_t sync)
+{
+    for (int lane = 0; lane < group->lanes; lane++)
+    {
+        if (mask[lane])
+            lockstep_scalar(group, lane, op, sync);
+    }
+}
+
+/* Faults one lane the way chip8_fault() would */
+static void lockstep_fault(LockstepGroup *group, int lane, uint8_t fault)
+{
+    group->vms[lane].fault = fault;
+    group->PC[lane] -= 2;
+    group->halted[lane] = -1;
+}
+
+/* chip8_write_ram() for a lane that chip8_vm does not point at */
+static void lockstep_write_ram(MEMORY *vm, unsigned address, uint8_t value)
+{
+    vm->ram_hash ^= chip8_ram_key(address, vm->ram[address]) ^ chip8_ram_key(address, value);
+    vm->ram[address] = value;
+}
+
+/* Fx33, Fx55 and Fx65 touch only RAM, I and V, so they run per lane in place */
+static void lockstep_memory_op(LockstepGroup *group, uint16_t op, const int8_t *mask)
+{
+    unsigned x = (op >> 8) & 0xFu;
+    unsigned length = (op & 0xFFu) == 0x33u ? 3 : x + 1;
+
+    for (int lane = 0; lane < group->lanes; lane++)
+    {
+        if (!mask[lane])
+            continue;
+
+        const uint8_t *ram = group->vms[lane].ram;
+        unsigned index = group->I[lane];
+
+        if (index + length > sizeof(group->vms[lane].ram))
+        {
+            lockstep_fault(group, lane, CHIP8_FAULT_MEMORY_RANGE);
+            continue;
+        }
+
+        switch (op & 0xFFu)
+        {
+        case 0x33:
+        {
+            uint8_t value = group->V[x][lane];
+            lockstep_write_ram(&group->vms[lane], index + 2, value % 10);
+            lockstep_write_ram(&group->vms[lane], index + 1, (value / 10) % 10);
+            lockstep_write_ram(&group->vms[lane], index, value / 100);
+            break;
+        }
+        case 0x55:
+            for (unsigned r = 0; r <= x; r++)
+                lockstep_write_ram(&group->vms[lane], index + r, group->V[r][lane]);
+            break;
+        default:
+            for (unsigned r = 0; r <= x; r++)
+                group->V[r][lane] = ram[index + r];
+            break;
+        }
+
+        if ((op & 0xFFu) != 0x65u)
+            lockstep_mark_written(group, index, length);
+    }
+}
+
+/* Ex9E and ExA1 read only the lane's keypad; returns nonzero if no two lanes branched differently */
+static int lockstep_key_skip(LockstepGroup *group, uint16_t op, const int8_t *mask)
+{
+    unsigned x = (op >> 8) & 0xFu;
+    int skip_if_pressed = (op & 0xFFu) == 0x9Eu;
+    int skipped = 0, stayed = 0;
+
+    for (int lane = 0; lane < group->lanes; lane++)
+    {
+        if (!mask[lane])
+            continue;
+
+        uint8_t key = group->V[x][lane];
+        if (key > 0xF)
+        {
+            lockstep_fault(group, lane, CHIP8_FAULT_KEY_RANGE);
+            continue;
+        }
+
+        if ((group->vms[lane].keypad[key] != 0) == skip_if_pressed)
+        {
+            group->PC[lane] += 2;
+            skipped = 1;
+        }
+        else
+        {
+            stayed = 1;
+        }
+    }
+
+    return !(skipped && stayed);
+}
+
+#define LOCKSTEP_WIDTH 8
+#include "lockstep_kernel.h"
+#undef LOCKSTEP_WIDTH
+
+#define LOCKSTEP_WIDTH 16
+#include "lockstep_kernel.h"
+#undef LOCKSTEP_WIDTH
+
+#define LOCKSTEP_WIDTH 32
+#include "lockstep_kernel.h"
+#undef LOCKSTEP_WIDTH
+
+LockstepGroup *lockstep_create(int lanes)
+{
+    if (lanes < 1 || lanes > LOCKSTEP_MAX_LANES)
+        return NULL;
+
+    /* Vector members need more alignment than malloc guarantees */
+    void *allocation = calloc(1, sizeof(LockstepGroup) + LOCKSTEP_ALIGNMENT);
+    if (allocation == NULL)
+        return NULL;
+
+    LockstepGroup *group =
+        (LockstepGroup *)(((uintptr_t)allocation + LOCKSTEP_ALIGNMENT - 1) & ~(uintptr_t)(LOCKSTEP_ALIGNMENT - 1));
+    group->allocation = allocation;
+    group->lanes = lanes;
+    group->vms = calloc((size_t)lanes, sizeof(MEMORY));
+    if (group->vms == NULL)
+    {
+        free(allocation);
+        return NULL;
+    }
+
+    for (int lane = 0; lane < LOCKSTEP_MAX_LANES; lane++)
+        group->halted[lane] = -1;
+
+    return group;
+}
+
+void lockstep_load(LockstepGroup *group, int lane, const MEMORY *vm)
+{
+    group->vms[lane] = *vm;
+
+    for (int r = 0; r < 16; r++)
+        group->V[r][lane] = vm->registers[r];
+    group->I[lane] = vm->index;
+    group->PC[lane] = vm->program_counter;
+    for (int s = 0; s < 16; s++)
+        group->stack[s][lane] = vm->stack[s];
+    group->SP[lane] = vm->stack_pointer;
+    group->delay_timer[lane] = vm->delay_timer;
+    group->sound_timer[lane] = vm->sound_timer;
+
+    lockstep_sync_halted(group, lane);
+    group->layout_dirty = 1;
+}
+
+void lockstep_store(const LockstepGroup *group, int lane, MEMORY *vm)
+{
+    *vm = group->vms[lane];
+
+    for (int r = 0; r < 16; r++)
+        vm->registers[r] = group->V[r][lane];
+    vm->index = group->I[lane];
+    vm->program_counter = group->PC[lane];
+    for (int s = 0; s < 16; s++)
+        vm->stack[s] = group->stack[s][lane];
+    vm->stack_pointer = group->SP[lane];
+    vm->delay_timer = group->delay_timer[lane];
+    vm->sound_timer = group->sound_timer[lane];
+}
+
+void lockstep_set_key(LockstepGroup *group, int lane, uint8_t key, uint8_t pressed)
+{
+    MEMORY *vm = &group->vms[lane];
+    int was_waiting = vm->waiting_for_key;
+    MEMORY *caller_vm = chip8_vm;
+
+    chip8_vm = vm;
+    chip8_set_key(key, pressed);
+    chip8_vm = caller_vm;
+
+    /* A completed key wait wrote Vx through the MEMORY copy */
+    if (was_waiting && !vm->waiting_for_key)
+        group->V[vm->key_register][lane] = vm->registers[vm->key_register];
+
+    lockstep_sync_halted(group, lane);
+}
+
+LOCKSTEP_TARGETS void lockstep_frame(LockstepGroup *group)
+{
+    MEMORY *caller_vm = chip8_vm;
+
+    if (group->layout_dirty)
+        lockstep_compare_lanes(group);
+
+    /* The narrowest kernel that covers the group */
+    if (group->lanes <= 8)
+        lockstep_frame_8(group);
+    else if (group->lanes <= 16)
+        lockstep_frame_16(group);
+    else
+        lockstep_frame_32(group);
+
+    for (int lane = 0; lane < group->lanes; lane++)
+        group->stats.lane_instructions += CHIP8_CYCLES_PER_FRAME - group->budget[lane];
+    group->stats.frames++;
+
+    chip8_vm = caller_vm;
+}
+
+const LockstepStats *lockstep_get_stats(const LockstepGroup *group)
+{
+    return &group->stats;
+}
+
+void lockstep_report_stats(const LockstepGroup *group, FILE *out)
+{
+    const LockstepStats *stats = &group->stats;
+    double utilisation = stats->steps
+                             ? 100.0 * stats->lane_instructions / ((double)stats->steps * group->lanes)
+                             : 0.0;
+
+    fprintf(out,
+            "Lockstep: %d lanes, %llu frames, %llu steps, %llu lane instructions, "
+            "utilisation %.1f%%, %llu scalar handler calls, %llu divergent fetches\n",
+            group->lanes,
+            stats->frames,
+            stats->steps,
+            stats->lane_instructions,
+            utilisation,
+            stats->scalar_calls,
+            stats->divergent_fetches);
+}
+
+void lockstep_destroy(LockstepGroup *group)
+{
+    if (group == NULL)
+        return;
+
+    free(group->vms);
+    free(group->allocation);
+}
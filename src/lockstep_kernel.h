@@ -0,0 +1,401 @@
+/*
+ * LOCKSTEP KERNEL
+ *
+ * The vector half of lockstep.c, included there once per group width with
+ * LOCKSTEP_WIDTH set to 8, 16 or 32. Each inclusion defines
+ * lockstep_frame_<width>(), whose vectors hold exactly LOCKSTEP_WIDTH lanes
+ * and map onto the first LOCKSTEP_WIDTH entries of the group's register
+ * rows, so a group of 8 machines does not pay for 32-lane vectors.
+ *
+ * Not a standalone header: it has no include guard, and everything it
+ * defines is named after the width or undefined again at the end.
+ */
+
+#define LOCKSTEP_PASTE_(name, width) name##_##width
+#define LOCKSTEP_PASTE(name, width) LOCKSTEP_PASTE_(name, width)
+#define LOCKSTEP_NAME(name) LOCKSTEP_PASTE(name, LOCKSTEP_WIDTH)
+
+typedef uint8_t LOCKSTEP_NAME(lane_u8) __attribute__((vector_size(LOCKSTEP_WIDTH)));
+typedef int8_t LOCKSTEP_NAME(lane_i8) __attribute__((vector_size(LOCKSTEP_WIDTH)));
+typedef uint16_t LOCKSTEP_NAME(lane_u16) __attribute__((vector_size(2 * LOCKSTEP_WIDTH)));
+typedef int16_t LOCKSTEP_NAME(lane_i16) __attribute__((vector_size(2 * LOCKSTEP_WIDTH)));
+
+#define LaneU8 LOCKSTEP_NAME(lane_u8)
+#define LaneI8 LOCKSTEP_NAME(lane_i8)
+#define LaneU16 LOCKSTEP_NAME(lane_u16)
+#define LaneI16 LOCKSTEP_NAME(lane_i16)
+
+/* The group's register rows, viewed as vectors of this width */
+#define REG_V(r) (*(LaneU8 *)group->V[r])
+#define REG_I (*(LaneU16 *)group->I)
+#define REG_PC (*(LaneU16 *)group->PC)
+#define REG_STACK(s) (*(LaneU16 *)group->stack[s])
+#define REG_SP (*(LaneU8 *)group->SP)
+#define REG_DT (*(LaneU8 *)group->delay_timer)
+#define REG_ST (*(LaneU8 *)group->sound_timer)
+#define REG_BUDGET (*(LaneU8 *)group->budget)
+#define REG_HALTED (*(LaneI8 *)group->halted)
+
+/* Advances PC past the next instruction in active lanes where `condition` holds */
+#define SKIP_IF(condition)                           \
+    (skip = (condition) & *m8, LOCKSTEP_NAME(lockstep_skip)(group, &skip, m8))
+
+static inline int LOCKSTEP_NAME(lockstep_any)(const LaneI8 *mask)
+{
+    uint64_t words[LOCKSTEP_WIDTH / 8];
+    uint64_t any = 0;
+
+    memcpy(words, mask, sizeof(words));
+    for (int i = 0; i < LOCKSTEP_WIDTH / 8; i++)
+        any |= words[i];
+
+    return any != 0;
+}
+
+static inline int LOCKSTEP_NAME(lockstep_same)(const LaneI8 *a, const LaneI8 *b)
+{
+    LaneI8 differ = *a ^ *b;
+    return !LOCKSTEP_NAME(lockstep_any)(&differ);
+}
+
+/* Returns nonzero if the active lanes all took the same branch */
+static inline int LOCKSTEP_NAME(lockstep_skip)(LockstepGroup *group, const LaneI8 *skip, const LaneI8 *m8)
+{
+    REG_PC += (LaneU16)__builtin_convertvector(*skip, LaneI16) & 2;
+
+    return !LOCKSTEP_NAME(lockstep_any)(skip) || LOCKSTEP_NAME(lockstep_same)(skip, m8);
+}
+
+/* Faults the lanes in `faulting` and drops them from `m8` */
+static inline void LOCKSTEP_NAME(lockstep_fault_lanes)(LockstepGroup *group, LaneI8 *m8, const LaneI8 *faulting,
+                                                       uint8_t fault)
+{
+    if (!LOCKSTEP_NAME(lockstep_any)(faulting))
+        return;
+
+    for (int lane = 0; lane < group->lanes; lane++)
+    {
+        if ((*faulting)[lane])
+            lockstep_fault(group, lane, fault);
+    }
+
+    *m8 &= ~*faulting;
+}
+
+/*
+ * 2nnn and 00EE on the stack rows. When every active lane has the same
+ * stack depth, which is the common case, only that slot is touched.
+ */
+static inline void LOCKSTEP_NAME(lockstep_call)(LockstepGroup *group, uint16_t target, int leader,
+                                               const LaneI8 *active)
+{
+    LaneU8 sp = REG_SP;
+    LaneI8 m8 = *active;
+    LaneI8 full = (sp == 16) & m8;
+
+    LOCKSTEP_NAME(lockstep_fault_lanes)(group, &m8, &full, CHIP8_FAULT_STACK_OVERFLOW);
+
+    LaneU16 w = (LaneU16)__builtin_convertvector(m8, LaneI16);
+    uint8_t depth = sp[leader];
+
+    LaneI8 other = (sp != depth) & m8;
+
+    if (depth < 16 && !LOCKSTEP_NAME(lockstep_any)(&other))
+    {
+        REG_STACK(depth) = BLEND(REG_STACK(depth), REG_PC, w);
+    }
+    else
+    {
+        LaneU16 sp16 = __builtin_convertvector(sp, LaneU16);
+        for (unsigned s = 0; s < 16; s++)
+            REG_STACK(s) = BLEND(REG_STACK(s), REG_PC, w & (LaneU16)(sp16 == (uint16_t)s));
+    }
+
+    REG_SP = BLEND(sp, sp + 1, (LaneU8)m8);
+    REG_PC = BLEND(REG_PC, target, w);
+}
+
+static inline void LOCKSTEP_NAME(lockstep_return)(LockstepGroup *group, int leader, const LaneI8 *active)
+{
+    LaneU8 sp = REG_SP;
+    LaneI8 m8 = *active;
+    LaneI8 empty = (sp == 0) & m8;
+
+    LOCKSTEP_NAME(lockstep_fault_lanes)(group, &m8, &empty, CHIP8_FAULT_STACK_UNDERFLOW);
+
+    LaneU16 w = (LaneU16)__builtin_convertvector(m8, LaneI16);
+    LaneU8 top = sp - 1;
+    uint8_t slot = top[leader];
+    LaneI8 other = (top != slot) & m8;
+
+    if (slot < 16 && !LOCKSTEP_NAME(lockstep_any)(&other))
+    {
+        REG_PC = BLEND(REG_PC, REG_STACK(slot), w);
+    }
+    else
+    {
+        LaneU16 top16 = __builtin_convertvector(top, LaneU16);
+        for (unsigned s = 0; s < 16; s++)
+            REG_PC = BLEND(REG_PC, REG_STACK(s), w & (LaneU16)(top16 == (uint16_t)s));
+    }
+
+    REG_SP = BLEND(sp, top, (LaneU8)m8);
+}
+
+/*
+ * Executes `op` on the lanes in `m8`, whose PCs already point past it.
+ * Returns nonzero if those lanes all end at the same PC (lanes it halts
+ * aside), so the next step needs no lowest-PC search.
+ */
+static inline __attribute__((always_inline)) int LOCKSTEP_NAME(lockstep_execute)(LockstepGroup *group, uint16_t op,
+                                                                                 int leader, const LaneI8 *m8)
+{
+    LaneU8 m = (LaneU8)*m8;
+    LaneU16 w = (LaneU16)__builtin_convertvector(*m8, LaneI16);
+    const int8_t *mask = (const int8_t *)m8;
+    LaneI8 skip;
+    unsigned x = (op >> 8) & 0xFu;
+    unsigned y = (op >> 4) & 0xFu;
+    uint8_t kk = op & 0xFFu;
+    uint16_t nnn = op & 0x0FFFu;
+
+    switch (op >> 12)
+    {
+    case 0x0:
+        if (op == 0x00E0)
+        {
+            lockstep_scalar_all(group, op, mask, 0);
+            return 1;
+        }
+        if (op == 0x00EE)
+        {
+            LOCKSTEP_NAME(lockstep_return)(group, leader, m8);
+            return 1;
+        }
+        break;
+    case 0x1:
+        REG_PC = BLEND(REG_PC, nnn, w);
+        return 1;
+    case 0x2:
+        LOCKSTEP_NAME(lockstep_call)(group, nnn, leader, m8);
+        return 1;
+    case 0x3:
+        return SKIP_IF(REG_V(x) == kk);
+    case 0x4:
+        return SKIP_IF(REG_V(x) != kk);
+    case 0x5:
+        return SKIP_IF(REG_V(x) == REG_V(y));
+    case 0x6:
+        REG_V(x) = BLEND(REG_V(x), kk, m);
+        return 1;
+    case 0x7:
+        REG_V(x) = BLEND(REG_V(x), REG_V(x) + kk, m);
+        return 1;
+    case 0x8:
+        /* Statement order mirrors instructions.c, which matters when x or y is F */
+        switch (op & 0xFu)
+        {
+        case 0x0:
+            REG_V(x) = BLEND(REG_V(x), REG_V(y), m);
+            return 1;
+        case 0x1:
+            REG_V(x) = BLEND(REG_V(x), REG_V(x) | REG_V(y), m);
+            return 1;
+        case 0x2:
+            REG_V(x) = BLEND(REG_V(x), REG_V(x) & REG_V(y), m);
+            return 1;
+        case 0x3:
+            REG_V(x) = BLEND(REG_V(x), REG_V(x) ^ REG_V(y), m);
+            return 1;
+        case 0x4:
+        {
+            LaneU8 sum = REG_V(x) + REG_V(y);
+            LaneU8 carry = (LaneU8)(sum < REG_V(x)) & 1;
+            REG_V(0xF) = BLEND(REG_V(0xF), carry, m);
+            REG_V(x) = BLEND(REG_V(x), sum, m);
+            return 1;
+        }
+        case 0x5:
+            REG_V(0xF) = BLEND(REG_V(0xF), (LaneU8)(REG_V(x) > REG_V(y)) & 1, m);
+            REG_V(x) = BLEND(REG_V(x), REG_V(x) - REG_V(y), m);
+            return 1;
+        case 0x6:
+            REG_V(0xF) = BLEND(REG_V(0xF), REG_V(x) & 1, m);
+            REG_V(x) = BLEND(REG_V(x), REG_V(x) >> 1, m);
+            return 1;
+        case 0x7:
+            REG_V(0xF) = BLEND(REG_V(0xF), (LaneU8)(REG_V(y) > REG_V(x)) & 1, m);
+            REG_V(x) = BLEND(REG_V(x), REG_V(y) - REG_V(x), m);
+            return 1;
+        case 0xE:
+            REG_V(0xF) = BLEND(REG_V(0xF), REG_V(x) >> 7, m);
+            REG_V(x) = BLEND(REG_V(x), REG_V(x) << 1, m);
+            return 1;
+        default:
+            break;
+        }
+        break;
+    case 0x9:
+        return SKIP_IF(REG_V(x) != REG_V(y));
+    case 0xA:
+        REG_I = BLEND(REG_I, nnn, w);
+        return 1;
+    case 0xB:
+        REG_PC = BLEND(REG_PC, __builtin_convertvector(REG_V(0), LaneU16) + nnn, w);
+        return 0;
+    case 0xC:
+        lockstep_scalar_all(group, op, mask, 1u << x);
+        return 1;
+    case 0xD:
+        lockstep_scalar_all(group, op, mask, (1u << x) | (1u << y) | (1u << 0xF) | LOCKSTEP_SYNC_I);
+        return 1;
+    case 0xE:
+        if (kk == 0x9E || kk == 0xA1)
+            return lockstep_key_skip(group, op, mask);
+        break;
+    case 0xF:
+        switch (kk)
+        {
+        case 0x07:
+            REG_V(x) = BLEND(REG_V(x), REG_DT, m);
+            return 1;
+        case 0x15:
+            REG_DT = BLEND(REG_DT, REG_V(x), m);
+            return 1;
+        case 0x18:
+            REG_ST = BLEND(REG_ST, REG_V(x), m);
+            return 1;
+        case 0x1E:
+            REG_I = BLEND(REG_I, REG_I + __builtin_convertvector(REG_V(x), LaneU16), w);
+            return 1;
+        case 0x29:
+            REG_I = BLEND(REG_I, FONTSET_START_ADDRESS + 5 * __builtin_convertvector(REG_V(x), LaneU16), w);
+            return 1;
+        case 0x33:
+        case 0x55:
+        case 0x65:
+            lockstep_memory_op(group, op, mask);
+            return 1;
+        default:
+            break;
+        }
+        break;
+    default:
+        break;
+    }
+
+    lockstep_scalar_all(group, op, mask, LOCKSTEP_SYNC_ALL);
+    return 0;
+}
+
+static inline __attribute__((always_inline)) void LOCKSTEP_NAME(lockstep_frame)(LockstepGroup *group)
+{
+    int shared = 0; /* Every eligible lane is known to be at `pc` */
+    uint16_t pc = 0;
+
+    REG_BUDGET = (LaneU8){0} + CHIP8_CYCLES_PER_FRAME;
+
+    for (;;)
+    {
+        LaneI8 eligible = (REG_BUDGET != 0) & ~REG_HALTED;
+        LaneI8 m8;
+
+        if (shared)
+        {
+            if (!LOCKSTEP_NAME(lockstep_any)(&eligible))
+                break;
+
+            m8 = eligible;
+        }
+        else
+        {
+            LaneU16 pcs = REG_PC | (LaneU16)~__builtin_convertvector(eligible, LaneI16);
+
+            pc = 0xFFFF;
+            for (int lane = 0; lane < LOCKSTEP_WIDTH; lane++)
+                pc = pcs[lane] < pc ? pcs[lane] : pc;
+
+            if (pc == 0xFFFF)
+                break;
+
+            m8 = __builtin_convertvector(pcs == pc, LaneI8);
+            shared = LOCKSTEP_NAME(lockstep_same)(&m8, &eligible);
+        }
+
+        int leader = 0;
+        while (!m8[leader])
+            leader++;
+
+        if (pc > sizeof(((MEMORY *)0)->ram) - 2)
+        {
+            for (int lane = leader; lane < group->lanes; lane++)
+            {
+                if (m8[lane])
+                {
+                    group->vms[lane].fault = CHIP8_FAULT_PC_RANGE;
+                    group->halted[lane] = -1;
+                }
+            }
+            continue;
+        }
+
+        const uint8_t *code = group->vms[leader].ram;
+        uint16_t op = (code[pc] << 8) | code[pc + 1];
+
+        if ((group->written_lines >> (pc >> LOCKSTEP_LINE_SHIFT)) & 3u)
+        {
+            /* Code may differ here; only share the opcode with matching lanes */
+            for (int lane = leader + 1; lane < group->lanes; lane++)
+            {
+                const uint8_t *ram = group->vms[lane].ram;
+                if (m8[lane] && ((ram[pc] << 8) | ram[pc + 1]) != op)
+                {
+                    m8[lane] = 0;
+                    shared = 0;
+                }
+            }
+            group->stats.divergent_fetches++;
+        }
+
+        REG_PC += (LaneU16)__builtin_convertvector(m8, LaneI16) & 2;
+        REG_BUDGET += (LaneU8)m8;
+        group->stats.steps++;
+
+        if (!LOCKSTEP_NAME(lockstep_execute)(group, op, leader, &m8))
+        {
+            shared = 0;
+            continue;
+        }
+
+        /* Still together: the next PC is that of any lane left running */
+        for (int lane = leader; shared && lane < group->lanes; lane++)
+        {
+            if (m8[lane] && !group->halted[lane])
+            {
+                pc = group->PC[lane];
+                break;
+            }
+        }
+    }
+
+    REG_DT -= (LaneU8)(REG_DT != 0) & 1;
+    REG_ST -= (LaneU8)(REG_ST != 0) & 1;
+}
+
+#undef SKIP_IF
+#undef REG_V
+#undef REG_I
+#undef REG_PC
+#undef REG_STACK
+#undef REG_SP
+#undef REG_DT
+#undef REG_ST
+#undef REG_BUDGET
+#undef REG_HALTED
+#undef LaneU8
+#undef LaneI8
+#undef LaneU16
+#undef LaneI16
+#undef LOCKSTEP_NAME
+#undef LOCKSTEP_PASTE
+#undef LOCKSTEP_PASTE_
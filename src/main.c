@@ -1,45 +1,972 @@
+#include <signal.h>
 #include <stdio.h>
-#include <SDL2/SDL.h>
+#include <stdlib.h>
+#include <string.h>
+#ifndef CHIP8_NO_SDL
+#include <SDL2/SDL.h> /* SDL_main on Windows */
+#endif
 
 #include "chip8.h"
 #include "processor.h"
-#include "display_manager.h"
+#include "frontend.h"
+#include "capture.h"
+#include "keymap.h"
+#include "frame_pacer.h"
+#include "debugger.h"
+#include "stream.h"
+#include "shm_export.h"
+#include "metrics.h"
+#include "speed_control.h"
+#include "xochip.h"
+#include "libchip8.h"
+#include "scheduler.h"
+#include "fleet_store.h"
+#ifndef CHIP8_NO_SDL
+#include "wall_display.h"
+#endif
+
+static void print_usage(const char *program)
+{
+    printf("Usage: %s [options] <ROM file>\n"
+           "\n"
+           "Options:\n"
+           "  --capture <file|->   Run headless at maximum speed and write every\n"
+           "                       frame to a file or to stdout (\"-\")\n"
+           "  --format <y4m|rgba>  Capture output format (default: y4m)\n"
+           "  --scale <n>          Capture pixel scale factor (default: %d)\n"
+           "  --frames <n>         Number of frames to capture (default: 600) or to\n"
+           "                       stream (default: until interrupted)\n"
+           "  --stream <port|path> Run headless and stream the display on a loopback\n"
+           "                       TCP port or a Unix socket, accepting key events\n"
+           "  --unpaced            Stream as fast as possible instead of at 60 Hz\n"
+           "  --shm <name>         Publish every frame to a POSIX shared-memory\n"
+           "                       segment for other local processes\n"
+           "  --shm-state          Also publish registers, timers, stack and RAM\n"
+           "  --metrics <port|path>\n"
+           "                       Serve Prometheus metrics on a loopback TCP port\n"
+           "                       or a Unix socket\n"
+           "  --stats              Print a metrics line to stderr every second\n"
+           "  --hud                Show live metrics over the display\n"
+           "  --frontend <name>    Display, input and audio backend: %s\n"
+           "                       (default: %s)\n"
+           "  --terminal           Same as --frontend terminal\n"
+           "  --braille            Same as --frontend braille\n"
+           "  --record <file|->    Same as --frontend record: show nothing, but write\n"
+           "                       every frame in real time (--format, --scale)\n"
+           "  --keymap <keys>      Host keys for keypad keys 0-F, 16 characters\n"
+           "                       (default: " KEYMAP_DEFAULT ")\n"
+           "  --no-audio           Disable the beeper\n"
+           "  --audio-driver <n>   SDL audio driver (e.g. dummy, disk)\n"
+           "  --audio-buffer <n>   Audio device buffer in samples (default: 512)\n"
+           "  --audio-latency <ms> Target queued audio latency (default: 50)\n"
+           "  --audio-sync         Pace emulation by the audio device clock\n"
+           "  --speed <x|max>      Emulation speed multiplier (default: 1)\n"
+           "  --ff-speed <x|max>   Fast-forward speed, Tab held or = (default: 4)\n"
+           "  --slow-speed <x>     Slow-motion speed, toggled with - (default: 0.25)\n"
+           "  --vsync              Present frames in sync with the display refresh\n"
+           "  --xo-chip            Run an XO-CHIP program (implied by a .xo8 ROM)\n"
+           "  --cycles <n>         XO-CHIP instructions per frame (default: %d)\n"
+           "  --wall <n>           Run n sessions of the ROM in a grid in one window;\n"
+           "                       click a session to give it the keyboard\n"
+           "  --fleet <file>       Keep the state of every --wall session in a file,\n"
+           "                       resuming them from it on the next start\n"
+           "  --checkpoint <n>     Frames between saves to the --fleet file (default: 60)\n"
+           "  --gdb <port|path>    Start halted and serve the GDB remote protocol on\n"
+           "                       a loopback TCP port or a Unix socket\n",
+           program, CHIP8_PIXEL_SCALE, frontend_names(), frontend_find(NULL)->name,
+           XOCHIP_CYCLES_PER_FRAME);
+}
+
+static const FrontendBackend *frontend;
+
+/* Lets frontends without input (null, record) be stopped cleanly with Ctrl-C or kill */
+static volatile sig_atomic_t quit_requested = 0;
+
+static void request_quit(int signum)
+{
+    (void)signum;
+    quit_requested = 1;
+}
+
+/* Leaves signals alone that the frontend (SDL) already handles */
+static void install_quit_handler(int signum)
+{
+    void (*previous)(int) = signal(signum, request_quit);
+    if (previous != SIG_DFL)
+        signal(signum, previous);
+}
+
+/*
+ * Runs one frame or, muted and without a debugger, up to `frames` of them,
+ * skipping idle ones in bulk. `audible` is zero away from normal speed,
+ * where the beeper is muted. Returns the number of frames run.
+ */
+static unsigned int run_frames(int audible, unsigned int frames)
+{
+    /* Silence needs no slot-accurate beeper: the audio just keeps flowing */
+    if (!audible && !debugger_enabled)
+    {
+        unsigned int ran;
+        processor_frames(frames, &ran, NULL);
+
+        for (unsigned int i = 0; i < ran * CHIP8_CYCLES_PER_FRAME; i++)
+            frontend->queue_audio(0);
+        return ran;
+    }
+
+    if (debugger_enabled)
+        debugger_poll();
+
+    /* Audio keeps flowing for every cycle slot, even while blocked in Fx0A */
+    for (;;)
+    {
+        int tone_on = audible && chip8_memory.sound_timer > 0;
+        unsigned int used;
+        int events = processor_run(CHIP8_CYCLES_PER_FRAME, &used);
+
+        /* The beeper can only change on the last slot, and not at all when the timers ticked */
+        int tone_last = (events & PROCESSOR_EVENT_FRAME) ? tone_on : audible && chip8_memory.sound_timer > 0;
+        for (unsigned int i = 0; i < used; i++)
+            frontend->queue_audio(i + 1 < used ? tone_on : tone_last);
+
+        if (events & (PROCESSOR_EVENT_FRAME | PROCESSOR_EVENT_BREAKPOINT))
+            break;
+    }
+
+    return 1;
+}
+
+/* Shows the speed away from normal speed: the requested one, then the achieved one once measured */
+static void show_speed(double speed, const MetricsSample *sample)
+{
+    char text[32] = "";
+
+    if (speed != speed_control.normal)
+    {
+        if (sample)
+            snprintf(text, sizeof(text), "SPEED %.2fX", sample->speed);
+        else if (speed == SPEED_UNCAPPED)
+            snprintf(text, sizeof(text), "SPEED MAX");
+        else
+            snprintf(text, sizeof(text), "SPEED %.2fX", speed);
+    }
+
+    frontend->set_overlay(text);
+}
+
+/*
+ * Sleeps on input while blocked in Fx0A. With a timer running, the frame
+ * still ends on the pacer's deadline so the timers keep ticking at 60 Hz:
+ * input that leaves the CPU blocked (mouse motion, window events, key
+ * releases) only sends it back to sleep. A listening debugger and the
+ * metrics endpoint are polled throughout; a client stopping the machine
+ * ends the wait, and so does a metrics sample falling due while idle, so
+ * the main loop takes it.
+ */
+static int wait_for_key(FramePacer *pacer)
+{
+    /* Without running timers nothing can change until a key arrives */
+    int idle = chip8_memory.delay_timer == 0 && chip8_memory.sound_timer == 0;
+
+    for (;;)
+    {
+        int timeout_ms = metrics_wait_ms(idle);
+
+        if (!idle)
+        {
+            int64_t remaining = pacer->deadline_ns - frame_pacer_now_ns();
+            if (remaining <= 0)
+                break;
+
+            /* Rounded up, so the wait never ends short of the deadline */
+            int frame_ms = (int)((remaining + 999999) / 1000000);
+            if (timeout_ms < 0 || frame_ms < timeout_ms)
+                timeout_ms = frame_ms;
+        }
+        else if (timeout_ms == 0)
+        {
+            break;
+        }
+
+        if (debugger_enabled && (timeout_ms < 0 || timeout_ms > DEBUGGER_POLL_MS))
+            timeout_ms = DEBUGGER_POLL_MS;
+
+        if (frontend->wait_input(timeout_ms))
+            return 1;
+
+        metrics_poll();
+        if (debugger_enabled)
+            debugger_poll();
+
+        if (!chip8_memory.waiting_for_key || debugger_active)
+            break;
+    }
+
+    /* A key that ended the wait early still leaves the next frame to the deadline */
+    if (idle)
+        frame_pacer_resume(pacer);
+    else
+        frame_pacer_wait(pacer);
+    return 0;
+}
+
+static int has_extension(const char *path, const char *extension)
+{
+    const char *dot = strrchr(path, '.');
+    return dot && strcmp(dot, extension) == 0;
+}
+
+/* XO-CHIP runs on its own machine; keys still arrive in chip8_memory.keypad */
+static int run_xochip(const char *rom_path, unsigned int cycles, const FrontendConfig *frontend_config,
+                      const MetricsConfig *metrics_config, int hud)
+{
+    static uint32_t pixels[XOCHIP_HEIGHT * XOCHIP_WIDTH];
+    static int8_t levels[48000 / CHIP8_FRAME_RATE];
+
+    if (frontend->present_rgba == NULL)
+    {
+        fprintf(stderr, "ERROR: The %s frontend cannot show XO-CHIP programs.\n", frontend->name);
+        return 1;
+    }
+
+    XoChip *machine = xochip_create(chip8_memory.rng_state);
+    if (machine == NULL)
+    {
+        fprintf(stderr, "ERROR: Out of memory.\n");
+        return 1;
+    }
+
+    if (xochip_load_rom_file(machine, rom_path) != 0)
+    {
+        xochip_destroy(machine);
+        return 1;
+    }
+
+    if (frontend->init(frontend_config) != 0)
+    {
+        xochip_destroy(machine);
+        return 1;
+    }
+
+    if (metrics_init(metrics_config) != 0)
+    {
+        frontend->destroy();
+        xochip_destroy(machine);
+        return 1;
+    }
+
+    int sample_rate = frontend->queue_wave ? frontend->audio_sample_rate() : 0;
+    size_t samples_per_frame = (size_t)sample_rate / CHIP8_FRAME_RATE;
+    uint32_t sample_remainder = 0;
+
+    if (samples_per_frame >= sizeof(levels))
+    {
+        fprintf(stderr, "XO-CHIP audio needs a sample rate below 48000 Hz; playing silently\n");
+        sample_rate = 0;
+    }
+
+    int audio_synced = frontend_config->audio.sync_to_audio && sample_rate > 0;
+    double shown_speed = speed_control.normal;
+
+    FramePacer pacer;
+    frame_pacer_init(&pacer, CHIP8_FRAME_RATE, frontend_config->vsync);
+    int quit = 0;
+    int fault_reported = 0;
+
+    install_quit_handler(SIGINT);
+    install_quit_handler(SIGTERM);
+
+    while (!quit && !quit_requested)
+    {
+        quit = frontend->poll_input();
+
+        for (uint8_t key = 0; key < 16; key++)
+        {
+            if (machine->keypad[key] != chip8_memory.keypad[key])
+                xochip_set_key(machine, key, chip8_memory.keypad[key]);
+        }
+
+        double speed = speed_control_multiplier();
+        unsigned int frames_run = 0;
+        int events = 0;
+
+        speed_control_begin_period();
+        while (speed_control_frame_due(frames_run, pacer.deadline_ns))
+        {
+            events |= xochip_run_frame(machine, cycles);
+            frames_run++;
+
+            if (events & (PROCESSOR_EVENT_KEY_WAIT | PROCESSOR_EVENT_FAULT))
+                break;
+        }
+
+        if ((events & PROCESSOR_EVENT_DISPLAY) || (frontend->flags & FRONTEND_EVERY_FRAME))
+        {
+            xochip_render(machine, pixels);
+            frontend->present_rgba(pixels, XOCHIP_WIDTH, XOCHIP_HEIGHT);
+        }
+
+        /* The pattern only plays at normal speed */
+        if (sample_rate > 0 && speed == 1.0)
+        {
+            /* Whole samples per frame, with the fraction carried over */
+            sample_remainder += (uint32_t)sample_rate;
+            size_t count = sample_remainder / CHIP8_FRAME_RATE;
+            sample_remainder %= CHIP8_FRAME_RATE;
+
+            xochip_audio(machine, levels, count, sample_rate);
+            frontend->queue_wave(levels, count);
+        }
+
+        const MetricsSample *sample = metrics_frame();
+        if (sample && hud)
+        {
+            char text[128];
+            metrics_format_hud(sample, text, sizeof(text));
+            frontend->set_overlay(text);
+        }
+        else if (!hud && (speed != shown_speed || (sample && speed != speed_control.normal)))
+        {
+            show_speed(speed, sample);
+            shown_speed = speed;
+        }
+
+        if ((machine->fault || machine->exited) && !fault_reported)
+        {
+            if (machine->fault)
+                fprintf(stderr, "CPU halted at 0x%04X: %s\n",
+                        machine->pc, chip8_fault_name(machine->fault));
+            else
+                fprintf(stderr, "Program exited (00FD)\n");
+            fault_reported = 1;
+        }
+
+        if (audio_synced && speed == 1.0)
+        {
+            while (frontend->audio_frame_due() == 0)
+                frame_pacer_sleep_ns(FRAME_PACER_SPIN_NS);
+            frame_pacer_mark(&pacer);
+        }
+        else
+        {
+            frame_pacer_wait(&pacer);
+        }
+    }
+
+    fprintf(stderr, "XO-CHIP memory: %zu bytes\n", xochip_memory_usage(machine));
+
+    metrics_shutdown();
+    frontend->destroy();
+    xochip_destroy(machine);
+
+    frame_pacer_report(&pacer, stderr);
+    return 0;
+}
+
+#ifndef CHIP8_NO_SDL
+typedef struct
+{
+    Chip8Machine **machines;
+    Scheduler *scheduler;
+    FleetStore *fleet;
+    uint64_t *frames; /* Frames each session has run */
+    uint8_t *dirty;   /* Sessions changed since their last checkpoint */
+    int dirty_count;
+} WallHost;
+
+static void wall_mark_dirty(WallHost *host, int session)
+{
+    if (!host->dirty[session])
+    {
+        host->dirty[session] = 1;
+        host->dirty_count++;
+    }
+}
+
+static void wall_key(int session, uint8_t key, uint8_t pressed, void *context)
+{
+    WallHost *host = context;
+
+    scheduler_set_key(host->scheduler, session, key, pressed);
+    wall_mark_dirty(host, session);
+}
+
+static void wall_frame(int session, int events, void *context)
+{
+    WallHost *host = context;
+    MEMORY *vm = libchip8_state(host->machines[session]);
+
+    host->frames[session]++;
+    wall_mark_dirty(host, session);
+
+    if (events & PROCESSOR_EVENT_DISPLAY)
+        wall_display_update(session, vm->display);
+
+    if (events & PROCESSOR_EVENT_FAULT)
+        fprintf(stderr, "Session %d: CPU halted at 0x%03X: %s\n",
+                session, vm->program_counter, chip8_fault_name(vm->fault));
+}
+
+/* Puts every session saved in the fleet file back, with its keys released: nobody holds them any more */
+static void wall_resume(WallHost *host, int sessions, const char *fleet_path)
+{
+    int resumed = 0, rolled_back = 0;
+
+    for (int i = 0; i < sessions; i++)
+    {
+        MEMORY *vm = libchip8_state(host->machines[i]);
+        FleetSlotStatus status = fleet_store_load(host->fleet, i, vm, &host->frames[i]);
+        if (status == FLEET_SLOT_EMPTY)
+            continue;
+
+        resumed++;
+        rolled_back += status == FLEET_SLOT_ROLLED_BACK;
+
+        for (uint8_t key = 0; key < 16; key++)
+        {
+            if (vm->keypad[key])
+                libchip8_set_key(host->machines[i], key, 0);
+        }
+        wall_display_update(i, vm->display);
+    }
+
+    if (resumed > 0)
+        fprintf(stderr, "Resumed %d of %d sessions from %s (%d rolled back one checkpoint)\n",
+                resumed, sessions, fleet_path, rolled_back);
+}
+
+/* Saves the sessions that changed since their last checkpoint and writes them back to the file */
+static void wall_checkpoint(WallHost *host, int sessions)
+{
+    if (host->fleet == NULL || host->dirty_count == 0)
+        return;
+
+    for (int i = 0; i < sessions; i++)
+    {
+        if (host->dirty[i])
+        {
+            /* scheduler_machine() brings the timers of a parked session up to date */
+            fleet_store_save(host->fleet, i, libchip8_state(scheduler_machine(host->scheduler, i)),
+                             host->frames[i]);
+            host->dirty[i] = 0;
+        }
+    }
+
+    host->dirty_count = 0;
+    fleet_store_sync(host->fleet);
+}
+
+/*
+ * Every session runs the same ROM with its own seed, on the scheduler; only changed tiles are
+ * redrawn. With a fleet file, sessions resume from it and are checkpointed every `checkpoint` frames.
+ */
+static int run_wall(const char *rom_path, int sessions, const char *fleet_path, unsigned int checkpoint,
+                    const FrontendConfig *frontend_config)
+{
+    static uint8_t rom[4096];
+    WallHost host = {0};
+
+    if (sessions < 1 || sessions > WALL_MAX_SESSIONS)
+    {
+        fprintf(stderr, "ERROR: --wall needs 1 to %d sessions.\n", WALL_MAX_SESSIONS);
+        return 1;
+    }
+
+    FILE *fp = fopen(rom_path, "rb");
+    if (fp == NULL)
+    {
+        perror("Failed to open ROM file");
+        return 1;
+    }
+    size_t size = fread(rom, 1, sizeof(rom), fp);
+    fclose(fp);
+
+    host.machines = calloc((size_t)sessions, sizeof(Chip8Machine *));
+    host.frames = calloc((size_t)sessions, sizeof(uint64_t));
+    host.dirty = calloc((size_t)sessions, sizeof(uint8_t));
+    host.scheduler = scheduler_create(frame_pacer_now_ns(), wall_frame, &host);
+    int failed = host.machines == NULL || host.frames == NULL || host.dirty == NULL || host.scheduler == NULL;
+
+    for (int i = 0; !failed && i < sessions; i++)
+    {
+        host.machines[i] = libchip8_create(chip8_memory.rng_state + (uint32_t)i);
+        failed = host.machines[i] == NULL || libchip8_load_rom(host.machines[i], rom, size) != 0 ||
+                 scheduler_add(host.scheduler, host.machines[i]) != i;
+    }
+
+    if (failed)
+        fprintf(stderr, "ERROR: Could not create %d sessions.\n", sessions);
+    else if (fleet_path && (host.fleet = fleet_store_open(fleet_path, sessions, rom, size)) == NULL)
+        failed = 1;
+    else if (wall_display_init(frontend_config->title, frontend_config->vsync, sessions, wall_key, &host) != 0)
+        failed = 1;
+    else if (host.fleet)
+        wall_resume(&host, sessions, fleet_path);
+
+    int64_t checkpoint_ns = (int64_t)checkpoint * 1000000000 / CHIP8_FRAME_RATE;
+    int64_t next_checkpoint = frame_pacer_now_ns() + checkpoint_ns;
+    int quit = failed;
+
+    while (!quit && !quit_requested)
+    {
+        scheduler_run(host.scheduler, frame_pacer_now_ns());
+        wall_display_present();
+
+        /* Sleep until the next tick with work to do, or indefinitely if every session is parked */
+        int64_t next = scheduler_next_deadline(host.scheduler);
+        int64_t now = frame_pacer_now_ns();
+        int timeout_ms = next == INT64_MAX ? -1 : next > now ? (int)((next - now + 999999) / 1000000) : 0;
+
+        /* Nothing changes while every session is parked, so save what did before going to sleep */
+        if (now >= next_checkpoint || timeout_ms < 0)
+        {
+            wall_checkpoint(&host, sessions);
+            next_checkpoint = now + checkpoint_ns;
+        }
+
+        quit = wall_display_wait_input(timeout_ms);
+    }
+
+    if (!failed)
+    {
+        const SchedulerStats *stats = scheduler_stats(host.scheduler);
+        fprintf(stderr, "Scheduler: %llu frames run, %llu skipped, %llu ticks dropped; %d of %d sessions parked\n",
+                stats->frames_run, stats->frames_skipped, stats->ticks_dropped, stats->parked, stats->sessions);
+        wall_display_destroy();
+        wall_checkpoint(&host, sessions);
+    }
+
+    fleet_store_close(host.fleet);
+    for (int i = 0; host.machines && i < sessions; i++)
+        libchip8_destroy(host.machines[i]);
+    scheduler_destroy(host.scheduler);
+    free(host.machines);
+    free(host.frames);
+    free(host.dirty);
+    return failed ? 1 : 0;
+}
+#endif
 
 int main(int argc, char *argv[])
 {
-    if (argc < 2)
+    const char *rom_path = NULL;
+    int capture = 0;
+    CaptureConfig capture_config = {
+        .output_path = NULL,
+        .format = CAPTURE_FORMAT_Y4M,
+        .scale = CHIP8_PIXEL_SCALE,
+        .frames = 600,
+    };
+    const char *stream_endpoint = NULL;
+    StreamConfig stream_config = {
+        .endpoint = NULL,
+        .frames = 0,
+        .unpaced = 0,
+    };
+    const char *shm_name = NULL;
+    uint32_t shm_flags = 0;
+    MetricsConfig metrics_config = {
+        .endpoint = NULL,
+        .log = 0,
+        .hud = 0,
+    };
+    int hud = 0;
+    const char *frontend_name = NULL;
+    const char *gdb_endpoint = NULL;
+    int xo_chip = 0;
+    unsigned int xochip_cycles = XOCHIP_CYCLES_PER_FRAME;
+    int wall_sessions = 0;
+    const char *fleet_path = NULL;
+    unsigned int checkpoint = CHIP8_FRAME_RATE;
+    FrontendConfig frontend_config = {
+        .title = "CHIP-8 Emulator",
+        .vsync = 0,
+        .audio_enabled = 1,
+        .audio = {
+            .driver = NULL,
+            .sample_rate = 44100,
+            .buffer_samples = 512,
+            .latency_ms = 50,
+            .tone_hz = 440,
+            .sync_to_audio = 0,
+        },
+    };
+    AudioConfig *audio_config = &frontend_config.audio;
+
+    for (int i = 1; i < argc; i++)
     {
-        printf("Usage: %s <ROM file>\n", argv[0]);
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (strcmp(arg, "--capture") == 0 && value)
+        {
+            capture = 1;
+            capture_config.output_path = value;
+            i++;
+        }
+        else if (strcmp(arg, "--format") == 0 && value)
+        {
+            if (strcmp(value, "y4m") == 0)
+                capture_config.format = CAPTURE_FORMAT_Y4M;
+            else if (strcmp(value, "rgba") == 0)
+                capture_config.format = CAPTURE_FORMAT_RGBA;
+            else
+            {
+                print_usage(argv[0]);
+                return 1;
+            }
+            i++;
+        }
+        else if (strcmp(arg, "--scale") == 0 && value)
+        {
+            capture_config.scale = atoi(value);
+            i++;
+        }
+        else if (strcmp(arg, "--frames") == 0 && value)
+        {
+            capture_config.frames = strtoul(value, NULL, 10);
+            stream_config.frames = capture_config.frames;
+            i++;
+        }
+        else if (strcmp(arg, "--stream") == 0 && value)
+        {
+            stream_endpoint = value;
+            i++;
+        }
+        else if (strcmp(arg, "--unpaced") == 0)
+        {
+            stream_config.unpaced = 1;
+        }
+        else if (strcmp(arg, "--shm") == 0 && value)
+        {
+            shm_name = value;
+            i++;
+        }
+        else if (strcmp(arg, "--shm-state") == 0)
+        {
+            shm_flags |= SHM_EXPORT_STATE;
+        }
+        else if (strcmp(arg, "--metrics") == 0 && value)
+        {
+            metrics_config.endpoint = value;
+            i++;
+        }
+        else if (strcmp(arg, "--stats") == 0)
+        {
+            metrics_config.log = 1;
+        }
+        else if (strcmp(arg, "--hud") == 0)
+        {
+            hud = 1;
+            metrics_config.hud = 1;
+        }
+        else if (strcmp(arg, "--frontend") == 0 && value)
+        {
+            frontend_name = value;
+            i++;
+        }
+        else if (strcmp(arg, "--terminal") == 0)
+        {
+            frontend_name = "terminal";
+        }
+        else if (strcmp(arg, "--braille") == 0)
+        {
+            frontend_name = "braille";
+        }
+        else if (strcmp(arg, "--record") == 0 && value)
+        {
+            frontend_name = "record";
+            capture_config.output_path = value;
+            i++;
+        }
+        else if (strcmp(arg, "--keymap") == 0 && value)
+        {
+            if (keymap_set(value) != 0)
+                return 1;
+            i++;
+        }
+        else if (strcmp(arg, "--no-audio") == 0)
+        {
+            frontend_config.audio_enabled = 0;
+        }
+        else if (strcmp(arg, "--audio-driver") == 0 && value)
+        {
+            audio_config->driver = value;
+            i++;
+        }
+        else if (strcmp(arg, "--audio-buffer") == 0 && value)
+        {
+            audio_config->buffer_samples = atoi(value);
+            i++;
+        }
+        else if (strcmp(arg, "--audio-latency") == 0 && value)
+        {
+            audio_config->latency_ms = atoi(value);
+            i++;
+        }
+        else if (strcmp(arg, "--audio-sync") == 0)
+        {
+            audio_config->sync_to_audio = 1;
+        }
+        else if (strcmp(arg, "--vsync") == 0)
+        {
+            frontend_config.vsync = 1;
+        }
+        else if (strcmp(arg, "--gdb") == 0 && value)
+        {
+            gdb_endpoint = value;
+            i++;
+        }
+        else if (strcmp(arg, "--speed") == 0 && value)
+        {
+            if (speed_control_parse(value, &speed_control.normal) != 0)
+                return 1;
+            i++;
+        }
+        else if (strcmp(arg, "--ff-speed") == 0 && value)
+        {
+            if (speed_control_parse(value, &speed_control.fast_forward) != 0)
+                return 1;
+            i++;
+        }
+        else if (strcmp(arg, "--slow-speed") == 0 && value)
+        {
+            if (speed_control_parse(value, &speed_control.slow_motion) != 0 ||
+                speed_control.slow_motion == SPEED_UNCAPPED)
+            {
+                fprintf(stderr, "ERROR: --slow-speed needs a number.\n");
+                return 1;
+            }
+            i++;
+        }
+        else if (strcmp(arg, "--xo-chip") == 0)
+        {
+            xo_chip = 1;
+        }
+        else if (strcmp(arg, "--cycles") == 0 && value)
+        {
+            xochip_cycles = (unsigned int)strtoul(value, NULL, 10);
+            i++;
+        }
+        else if (strcmp(arg, "--wall") == 0 && value)
+        {
+            wall_sessions = atoi(value);
+            if (wall_sessions < 1)
+            {
+                fprintf(stderr, "ERROR: --wall needs a number of sessions.\n");
+                return 1;
+            }
+            i++;
+        }
+        else if (strcmp(arg, "--fleet") == 0 && value)
+        {
+            fleet_path = value;
+            i++;
+        }
+        else if (strcmp(arg, "--checkpoint") == 0 && value)
+        {
+            checkpoint = (unsigned int)strtoul(value, NULL, 10);
+            if (checkpoint < 1)
+            {
+                fprintf(stderr, "ERROR: --checkpoint needs a number of frames.\n");
+                return 1;
+            }
+            i++;
+        }
+        else if (arg[0] == '-' && arg[1] == '-')
+        {
+            print_usage(argv[0]);
+            return 1;
+        }
+        else
+        {
+            rom_path = arg;
+        }
+    }
+
+    frontend = frontend_find(frontend_name);
+    if (rom_path == NULL || frontend == NULL)
+    {
+        print_usage(argv[0]);
         return 1;
     }
 
     chip8_init();
 
-    if (!DisplayManager_Init("CHIP-8 Emulator"))
+    if (xo_chip || has_extension(rom_path, ".xo8"))
     {
-        printf("Failed to initialize display!\n");
+        if (capture || stream_endpoint || shm_name || gdb_endpoint)
+        {
+            fprintf(stderr, "ERROR: --capture, --stream, --shm and --gdb do not support XO-CHIP.\n");
+            return 1;
+        }
+
+        frontend_config.title = "XO-CHIP Emulator";
+        return run_xochip(rom_path, xochip_cycles, &frontend_config, &metrics_config, hud);
+    }
+
+    if (wall_sessions)
+    {
+#ifdef CHIP8_NO_SDL
+        fprintf(stderr, "ERROR: --wall needs SDL; this build has none.\n");
+        return 1;
+#else
+        if (capture || stream_endpoint || shm_name || gdb_endpoint || strcmp(frontend->name, "sdl") != 0)
+        {
+            fprintf(stderr, "ERROR: --wall runs in an SDL window, without --capture, --stream, --shm or --gdb.\n");
+            return 1;
+        }
+
+        frontend_config.title = "CHIP-8 Wall";
+        return run_wall(rom_path, wall_sessions, fleet_path, checkpoint, &frontend_config);
+#endif
+    }
+
+    if (fleet_path)
+    {
+        fprintf(stderr, "ERROR: --fleet keeps the sessions of --wall.\n");
         return 1;
     }
 
-    if (chip8_load_ROM(argv[1]) == 1)
+    if (chip8_load_ROM(rom_path) != 0)
     {
         printf("Failed to load ROM!\n");
         return 1;
     }
 
+    if (capture)
+        return capture_run(&capture_config) == 0 ? 0 : 1;
+
+    if (stream_endpoint)
+    {
+        stream_config.endpoint = stream_endpoint;
+        return stream_run(&stream_config) == 0 ? 0 : 1;
+    }
+
+    frontend_config.record = capture_config;
+    if (frontend->init(&frontend_config) != 0)
+        return 1;
+
+    if (gdb_endpoint && debugger_init(gdb_endpoint) != 0)
+    {
+        frontend->destroy();
+        return 1;
+    }
+
+    ShmExport *shm_export = NULL;
+    if (shm_name && (shm_export = shm_export_create(shm_name, shm_flags)) == NULL)
+    {
+        debugger_shutdown();
+        frontend->destroy();
+        return 1;
+    }
+
+    if (metrics_init(&metrics_config) != 0)
+    {
+        shm_export_destroy(shm_export);
+        debugger_shutdown();
+        frontend->destroy();
+        return 1;
+    }
+
+    int audio_synced = audio_config->sync_to_audio && frontend->audio_frame_due() >= 0;
+
+    FramePacer pacer;
+    frame_pacer_init(&pacer, CHIP8_FRAME_RATE, frontend_config.vsync);
     int quit = 0;
+    int fault_reported = 0;
+    uint64_t frame = 0;
+
+    install_quit_handler(SIGINT);
+    install_quit_handler(SIGTERM);
 
-    while (!quit)
+    double shown_speed = speed_control.normal;
+
+    while (!quit && !quit_requested)
     {
-        quit = DisplayManager_ProcessInput();
+        quit = frontend->poll_input();
+
+        int was_blocked = chip8_memory.waiting_for_key;
+        double speed = speed_control_multiplier();
+        unsigned int frames_run = 0;
+
+        /* Emulate the frames this display period owes, then present once */
+        speed_control_begin_period();
+        while (speed_control_frame_due(frames_run, pacer.deadline_ns))
+        {
+            /* Frames owed beyond this one may be skipped with it, up to the highest finite speed */
+            unsigned int owed = speed_control.credit < 1000.0 ? 1 + (unsigned int)speed_control.credit : 1000;
+            unsigned int ran = run_frames(speed == 1.0, owed);
 
-        processor_cycle();
+            speed_control.credit -= ran - 1;
+            frames_run += ran;
+            frame += ran;
 
-        DisplayManager_Update();
+            if (shm_export)
+                shm_export_publish(shm_export, chip8_vm, frame);
 
-        SDL_Delay(2);
+            if (chip8_memory.waiting_for_key || chip8_memory.fault || debugger_active)
+                break;
+        }
+
+        const MetricsSample *sample = metrics_frame();
+        int overlay_changed = 0;
+        if (sample && hud)
+        {
+            char text[128];
+            metrics_format_hud(sample, text, sizeof(text));
+            frontend->set_overlay(text);
+            overlay_changed = 1;
+        }
+        else if (!hud && (speed != shown_speed || (sample && speed != speed_control.normal)))
+        {
+            show_speed(speed, sample);
+            shown_speed = speed;
+            overlay_changed = 1;
+        }
+
+        /* While blocked, only a new overlay (e.g. the HUD) needs presenting */
+        if ((frames_run > 0 && !was_blocked) || overlay_changed || (frontend->flags & FRONTEND_EVERY_FRAME))
+            frontend->present();
+
+        if (chip8_memory.fault && !fault_reported)
+        {
+            char text[128];
+            snprintf(text, sizeof(text), "CPU halted at 0x%03X: %s",
+                     chip8_memory.program_counter, chip8_fault_name(chip8_memory.fault));
+
+            /* stderr would land on the terminal display's screen */
+            if (frontend->flags & FRONTEND_TERMINAL)
+                frontend->set_overlay(text);
+            else
+                fprintf(stderr, "%s\n", text);
+            fault_reported = 1;
+        }
+
+        /* While the debugger can stop the machine, every instruction is checked, so never block */
+        if (chip8_memory.waiting_for_key && !debugger_active &&
+            !(audio_synced && chip8_memory.sound_timer > 0))
+        {
+            quit |= wait_for_key(&pacer);
+        }
+        else if (audio_synced && speed == 1.0)
+        {
+            while (frontend->audio_frame_due() == 0)
+                frame_pacer_sleep_ns(FRAME_PACER_SPIN_NS);
+            frame_pacer_mark(&pacer);
+        }
+        else
+        {
+            frame_pacer_wait(&pacer);
+        }
     }
 
-    DisplayManager_Destroy();
+    metrics_shutdown();
+    shm_export_destroy(shm_export);
+    debugger_shutdown();
+    frontend->destroy();
+
+    /* Reported after a terminal frontend is gone, so it stays on screen */
+    frame_pacer_report(&pacer, stderr);
     return 0;
 }
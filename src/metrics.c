@@ -0,0 +1,352 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "metrics.h"
+#include "processor.h"
+#include "frame_pacer.h"
+#include "net.h"
+
+FrontendCounters metrics_frontend = {0};
+
+/* Counter values at the start of the current interval */
+typedef struct
+{
+    int64_t time_ns;
+    ProcessorStats cpu;
+    FrontendCounters frontend;
+} MetricsSnapshot;
+
+static MetricsConfig metrics_config;
+static MetricsSnapshot metrics_previous;
+static MetricsSample metrics_sample;
+
+static void metrics_take_snapshot(MetricsSnapshot *snapshot, int64_t now)
+{
+    snapshot->time_ns = now;
+    snapshot->cpu = processor_stats;
+    snapshot->frontend = metrics_frontend;
+}
+
+static double metrics_per(double value, double count)
+{
+    return count > 0 ? value / count : 0.0;
+}
+
+static void metrics_compute(const MetricsSnapshot *from, const MetricsSnapshot *to, MetricsSample *sample)
+{
+    double seconds = (to->time_ns - from->time_ns) / 1e9;
+    double frames = (double)(to->cpu.frames - from->cpu.frames);
+    double instructions = (double)(to->cpu.cycles_executed - from->cpu.cycles_executed);
+    double updates = (double)(to->frontend.display_updates - from->frontend.display_updates);
+
+    sample->seconds = seconds;
+    sample->fps = metrics_per(frames, seconds);
+    sample->speed = sample->fps / CHIP8_FRAME_RATE;
+    sample->ips = metrics_per(instructions, seconds);
+    sample->target_ips = (double)CHIP8_CYCLES_PER_FRAME * CHIP8_FRAME_RATE;
+    sample->instructions_per_frame = metrics_per(instructions, frames);
+    sample->draw_calls_per_frame = metrics_per((double)(to->cpu.draw_calls - from->cpu.draw_calls), frames);
+    sample->pixels_per_frame = metrics_per((double)(to->cpu.pixels_drawn - from->cpu.pixels_drawn), frames);
+    sample->update_ms = metrics_per((to->frontend.display_update_ns - from->frontend.display_update_ns) / 1e6, updates);
+    sample->present_ms = metrics_per((to->frontend.present_ns - from->frontend.present_ns) / 1e6, updates);
+    sample->input_events_per_sec =
+        metrics_per((double)(to->frontend.input_events - from->frontend.input_events), seconds);
+}
+
+static void metrics_log(const MetricsSample *sample)
+{
+    fprintf(stderr,
+            "Metrics: %.1f fps (%.2fx), %.0f IPS (%.0f%% of %.0f), %.1f instructions/frame, "
+            "%.2f draws/frame, %.1f pixels/frame, update %.3f ms (present %.3f ms), "
+            "%.1f input events/s\n",
+            sample->fps, sample->speed, sample->ips,
+            metrics_per(100.0 * sample->ips, sample->target_ips), sample->target_ips,
+            sample->instructions_per_frame, sample->draw_calls_per_frame, sample->pixels_per_frame,
+            sample->update_ms, sample->present_ms, sample->input_events_per_sec);
+}
+
+void metrics_format_hud(const MetricsSample *sample, char *text, size_t size)
+{
+    snprintf(text, size,
+             "FPS %.1f %.2fX\n"
+             "IPS %.0f/%.0f\n"
+             "DRAW %.1f PX %.0f\n"
+             "UPD %.2f PRES %.2f MS\n"
+             "IN %.0f/S",
+             sample->fps, sample->speed, sample->ips, sample->target_ips,
+             sample->draw_calls_per_frame, sample->pixels_per_frame,
+             sample->update_ms, sample->present_ms,
+             sample->input_events_per_sec);
+}
+
+/* Prometheus text exposition of the current counters and the last sample */
+static int metrics_format_prometheus(char *out, size_t size)
+{
+    const ProcessorStats *cpu = &processor_stats;
+    const FrontendCounters *frontend = &metrics_frontend;
+
+    return snprintf(out, size,
+                    "# HELP chip8_frames_total Frames emulated.\n"
+                    "# TYPE chip8_frames_total counter\n"
+                    "chip8_frames_total %llu\n"
+                    "# HELP chip8_instructions_total Instructions executed.\n"
+                    "# TYPE chip8_instructions_total counter\n"
+                    "chip8_instructions_total %llu\n"
+                    "# HELP chip8_draw_calls_total Dxyn instructions executed.\n"
+                    "# TYPE chip8_draw_calls_total counter\n"
+                    "chip8_draw_calls_total %llu\n"
+                    "# HELP chip8_pixels_drawn_total Pixels toggled by Dxyn.\n"
+                    "# TYPE chip8_pixels_drawn_total counter\n"
+                    "chip8_pixels_drawn_total %llu\n"
+                    "# HELP chip8_display_updates_total Frames presented.\n"
+                    "# TYPE chip8_display_updates_total counter\n"
+                    "chip8_display_updates_total %llu\n"
+                    "# HELP chip8_display_update_seconds_total Time spent updating the display.\n"
+                    "# TYPE chip8_display_update_seconds_total counter\n"
+                    "chip8_display_update_seconds_total %.9f\n"
+                    "# HELP chip8_present_seconds_total Time spent in SDL_RenderPresent.\n"
+                    "# TYPE chip8_present_seconds_total counter\n"
+                    "chip8_present_seconds_total %.9f\n"
+                    "# HELP chip8_input_events_total Input events handled.\n"
+                    "# TYPE chip8_input_events_total counter\n"
+                    "chip8_input_events_total %llu\n"
+                    "# HELP chip8_frames_per_second Frames emulated per second, last interval.\n"
+                    "# TYPE chip8_frames_per_second gauge\n"
+                    "chip8_frames_per_second %.3f\n"
+                    "# HELP chip8_speed_ratio Achieved speed relative to real time, last interval.\n"
+                    "# TYPE chip8_speed_ratio gauge\n"
+                    "chip8_speed_ratio %.3f\n"
+                    "# HELP chip8_instructions_per_second Instructions per second, last interval.\n"
+                    "# TYPE chip8_instructions_per_second gauge\n"
+                    "chip8_instructions_per_second %.3f\n"
+                    "# HELP chip8_target_instructions_per_second Instructions per second at full speed.\n"
+                    "# TYPE chip8_target_instructions_per_second gauge\n"
+                    "chip8_target_instructions_per_second %.0f\n",
+                    cpu->frames, cpu->cycles_executed, cpu->draw_calls, cpu->pixels_drawn,
+                    frontend->display_updates,
+                    frontend->display_update_ns / 1e9, frontend->present_ns / 1e9,
+                    frontend->input_events,
+                    metrics_sample.fps, metrics_sample.speed, metrics_sample.ips,
+                    (double)CHIP8_CYCLES_PER_FRAME * CHIP8_FRAME_RATE);
+}
+
+#ifndef _WIN32
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+#define METRICS_MAX_CONNECTIONS 4
+#define METRICS_REQUEST_SIZE 2048
+/* A scraper that has not finished its request in this time is dropped */
+#define METRICS_REQUEST_TIMEOUT_NS 2000000000LL
+
+typedef struct
+{
+    int fd;
+    int64_t accepted_ns;
+    char request[METRICS_REQUEST_SIZE];
+    size_t request_length;
+} MetricsConnection;
+
+static int metrics_listen_fd = -1;
+static char metrics_socket_path[NET_PATH_SIZE];
+static MetricsConnection metrics_connections[METRICS_MAX_CONNECTIONS];
+
+static void metrics_close(MetricsConnection *connection)
+{
+    close(connection->fd);
+    connection->fd = -1;
+}
+
+static void metrics_respond(MetricsConnection *connection)
+{
+    char body[4096];
+    char header[128];
+    int body_length = metrics_format_prometheus(body, sizeof(body));
+    int header_length = snprintf(header, sizeof(header),
+                                 "HTTP/1.0 200 OK\r\n"
+                                 "Content-Type: text/plain; version=0.0.4\r\n"
+                                 "Content-Length: %d\r\n"
+                                 "Connection: close\r\n\r\n",
+                                 body_length);
+
+    /* Both parts fit in the socket buffer of a fresh connection */
+    if (send(connection->fd, header, (size_t)header_length, MSG_NOSIGNAL) == header_length)
+        send(connection->fd, body, (size_t)body_length, MSG_NOSIGNAL);
+
+    metrics_close(connection);
+}
+
+static void metrics_serve(int64_t now)
+{
+    for (;;)
+    {
+        int fd = accept(metrics_listen_fd, NULL, NULL);
+        if (fd < 0)
+            break;
+
+        MetricsConnection *connection = NULL;
+        for (int i = 0; i < METRICS_MAX_CONNECTIONS && connection == NULL; i++)
+        {
+            if (metrics_connections[i].fd < 0)
+                connection = &metrics_connections[i];
+        }
+
+        if (connection == NULL)
+        {
+            close(fd);
+            continue;
+        }
+
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        connection->fd = fd;
+        connection->accepted_ns = now;
+        connection->request_length = 0;
+    }
+
+    for (int i = 0; i < METRICS_MAX_CONNECTIONS; i++)
+    {
+        MetricsConnection *connection = &metrics_connections[i];
+        if (connection->fd < 0)
+            continue;
+
+        size_t space = sizeof(connection->request) - 1 - connection->request_length;
+        ssize_t received = recv(connection->fd, connection->request + connection->request_length, space, 0);
+
+        if (received == 0 || (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR))
+        {
+            metrics_close(connection);
+            continue;
+        }
+
+        if (received > 0)
+        {
+            connection->request_length += (size_t)received;
+            connection->request[connection->request_length] = '\0';
+        }
+
+        /* Any request is answered with the metrics once its headers are complete */
+        if (strstr(connection->request, "\r\n\r\n") != NULL || strstr(connection->request, "\n\n") != NULL ||
+            connection->request_length == sizeof(connection->request) - 1)
+        {
+            metrics_respond(connection);
+        }
+        else if (now - connection->accepted_ns > METRICS_REQUEST_TIMEOUT_NS)
+        {
+            metrics_close(connection);
+        }
+    }
+}
+
+static int metrics_open_endpoint(const char *endpoint)
+{
+    for (int i = 0; i < METRICS_MAX_CONNECTIONS; i++)
+        metrics_connections[i].fd = -1;
+
+    metrics_listen_fd = net_listen(endpoint, "metrics", METRICS_MAX_CONNECTIONS, metrics_socket_path);
+    if (metrics_listen_fd < 0)
+        return -1;
+
+    fprintf(stderr, "Metrics: serving Prometheus text on %s%s\n",
+            metrics_socket_path[0] ? "" : "127.0.0.1:", endpoint);
+    return 0;
+}
+
+static void metrics_close_endpoint(void)
+{
+    if (metrics_listen_fd < 0)
+        return;
+
+    for (int i = 0; i < METRICS_MAX_CONNECTIONS; i++)
+    {
+        if (metrics_connections[i].fd >= 0)
+            metrics_close(&metrics_connections[i]);
+    }
+
+    net_close(metrics_listen_fd, metrics_socket_path);
+    metrics_listen_fd = -1;
+}
+
+#else
+
+static int metrics_listen_fd = -1;
+
+static void metrics_serve(int64_t now)
+{
+    (void)now;
+}
+
+static int metrics_open_endpoint(const char *endpoint)
+{
+    (void)endpoint;
+    fprintf(stderr, "ERROR: The metrics endpoint is not supported on this platform.\n");
+    return -1;
+}
+
+static void metrics_close_endpoint(void)
+{
+}
+
+#endif
+
+int metrics_init(const MetricsConfig *config)
+{
+    metrics_config = *config;
+    memset(&metrics_sample, 0, sizeof(metrics_sample));
+    metrics_take_snapshot(&metrics_previous, frame_pacer_now_ns());
+
+    if (config->endpoint)
+        return metrics_open_endpoint(config->endpoint);
+
+    return 0;
+}
+
+int metrics_wait_ms(int idle)
+{
+    int timeout_ms = metrics_listen_fd >= 0 ? METRICS_POLL_MS : -1;
+
+    if (idle && (metrics_listen_fd >= 0 || metrics_config.log || metrics_config.hud))
+    {
+        int64_t left_ns = metrics_previous.time_ns + METRICS_INTERVAL_NS - frame_pacer_now_ns();
+        int left_ms = left_ns > 0 ? (int)((left_ns + 999999) / 1000000) : 0;
+
+        if (timeout_ms < 0 || left_ms < timeout_ms)
+            timeout_ms = left_ms;
+    }
+
+    return timeout_ms;
+}
+
+void metrics_poll(void)
+{
+    if (metrics_listen_fd >= 0)
+        metrics_serve(frame_pacer_now_ns());
+}
+
+const MetricsSample *metrics_frame(void)
+{
+    int64_t now = frame_pacer_now_ns();
+
+    if (metrics_listen_fd >= 0)
+        metrics_serve(now);
+
+    if (now - metrics_previous.time_ns < METRICS_INTERVAL_NS)
+        return NULL;
+
+    MetricsSnapshot current;
+    metrics_take_snapshot(&current, now);
+    metrics_compute(&metrics_previous, &current, &metrics_sample);
+    metrics_previous = current;
+
+    if (metrics_config.log)
+        metrics_log(&metrics_sample);
+
+    return &metrics_sample;
+}
+
+void metrics_shutdown(void)
+{
+    metrics_close_endpoint();
+}
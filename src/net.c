@@ -0,0 +1,131 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "net.h"
+
+#ifndef _WIN32
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+_Static_assert(sizeof(((struct sockaddr_un *)0)->sun_path) <= NET_PATH_SIZE, "NET_PATH_SIZE is too small");
+
+static int net_bind_tcp(int port)
+{
+    struct sockaddr_in address = {0};
+    address.sin_family = AF_INET;
+    address.sin_port = htons((uint16_t)port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0)
+        return -1;
+
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    if (bind(fd, (struct sockaddr *)&address, sizeof(address)) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static int net_bind_unix(const char *path)
+{
+    struct sockaddr_un address = {0};
+    struct stat st;
+
+    if (strlen(path) >= sizeof(address.sun_path))
+    {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, path);
+
+    /* Remove a socket left behind by a previous run, but nothing else */
+    if (stat(path, &st) == 0 && S_ISSOCK(st.st_mode))
+        unlink(path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+        return -1;
+
+    if (bind(fd, (struct sockaddr *)&address, sizeof(address)) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int net_listen(const char *endpoint, const char *name, int backlog, char unix_path[NET_PATH_SIZE])
+{
+    char *end;
+    long port = strtol(endpoint, &end, 10);
+    int tcp = (*endpoint != '\0' && *end == '\0');
+
+    unix_path[0] = '\0';
+
+    if (tcp && (port <= 0 || port > 65535))
+    {
+        fprintf(stderr, "ERROR: Invalid %s port %s.\n", name, endpoint);
+        return -1;
+    }
+
+    int fd = tcp ? net_bind_tcp((int)port) : net_bind_unix(endpoint);
+    if (fd >= 0 && !tcp)
+        strcpy(unix_path, endpoint);
+
+    if (fd < 0 || listen(fd, backlog) != 0)
+    {
+        fprintf(stderr, "ERROR: Failed to open %s socket %s: %s\n", name, endpoint, strerror(errno));
+        net_close(fd, unix_path);
+        return -1;
+    }
+
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    return fd;
+}
+
+void net_close(int fd, char unix_path[NET_PATH_SIZE])
+{
+    if (fd < 0)
+        return;
+
+    close(fd);
+    if (unix_path[0] != '\0')
+    {
+        unlink(unix_path);
+        unix_path[0] = '\0';
+    }
+}
+
+#else
+
+int net_listen(const char *endpoint, const char *name, int backlog, char unix_path[NET_PATH_SIZE])
+{
+    (void)endpoint;
+    (void)backlog;
+    unix_path[0] = '\0';
+    fprintf(stderr, "ERROR: The %s socket is not supported on this platform.\n", name);
+    return -1;
+}
+
+void net_close(int fd, char unix_path[NET_PATH_SIZE])
+{
+    (void)fd;
+    (void)unix_path;
+}
+
+#endif
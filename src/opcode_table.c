@@ -1,9 +1,10 @@
 #include "opcode_table.h"
 #include "instructions.h"
+#include "chip8.h"
 #include <stdio.h>
 #include <stdint.h>
 
-uint16_t opcode = 0;
+_Thread_local uint16_t opcode = 0;
 
 typedef void (*OpcodeFunc)(void);
 
@@ -11,7 +12,7 @@ static OpcodeFunc mainTable[0x10];
 static OpcodeFunc table0[0x10];
 static OpcodeFunc table8[0x10];
 static OpcodeFunc tableE[0x10];
-static OpcodeFunc tableF[0x66];
+static OpcodeFunc tableF[0x100];
 
 static void Table0(void);
 static void Table8(void);
@@ -46,7 +47,7 @@ void ot_init(void)
     mainTable[0xF] = TableF;
 
     /* Initialize secondary tables */
-    for (int i = 0; i <= 0xE; ++i)
+    for (int i = 0; i < 0x10; ++i)
     {
         table0[i] = OP_NULL;
         table8[i] = OP_NULL;
@@ -73,7 +74,7 @@ void ot_init(void)
     tableE[0xE] = OP_Ex9E;
 
     /* 0xF*** opcodes (low byte) */
-    for (int i = 0; i <= 0x65; ++i)
+    for (int i = 0; i < 0x100; ++i)
     {
         tableF[i] = OP_NULL;
     }
@@ -99,6 +100,13 @@ void ot_execute(void)
 
 static void Table0(void)
 {
+    /* Only 00E0 and 00EE exist; 0nnn machine-code calls are not supported */
+    if ((opcode & 0xFFF0u) != 0x00E0u)
+    {
+        OP_NULL();
+        return;
+    }
+
     uint8_t index = (uint8_t)(opcode & 0x000Fu);
     OpcodeFunc func = table0[index];
     func();
@@ -128,5 +136,5 @@ static void TableF(void)
 static void OP_NULL(void)
 {
     /* Unhandled opcode */
-    fprintf(stderr, "Unhandled opcode: 0x%04X\n", opcode);
+    chip8_fault(CHIP8_FAULT_INVALID_OPCODE);
 }
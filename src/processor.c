@@ -1,8 +1,314 @@
+#include <limits.h>
+#include <string.h>
 #include "chip8.h"
 #include "opcode_table.h"
+#include "processor.h"
+#include "debugger.h"
+
+_Thread_local ProcessorStats processor_stats = {0};
+
+/*
+ * State captured at a backward jump, compared against the next arrival at
+ * the same jump to decide whether the loop in between made any progress.
+ */
+typedef struct
+{
+    int valid;
+    int pure;
+    int cycle;
+    uint16_t target;
+    uint16_t index;
+    uint8_t registers[16];
+} IdleProbe;
+
+/*
+ * Frames beyond the current one that a processor_frames() run may skip
+ * into (horizon) and what its idle loops skipped: the frame ends crossed
+ * and the frames known to follow unchanged (see processor_frames()).
+ */
+typedef struct
+{
+    unsigned int horizon;
+    unsigned int crossed;
+    unsigned int idle;
+} IdleSpan;
+
+static int processor_is_pure(uint16_t op)
+{
+    switch (op >> 12)
+    {
+    case 0x0: /* CLS, RET */
+    case 0x2: /* CALL */
+    case 0xC: /* RND */
+    case 0xD: /* DRW */
+        return 0;
+    case 0x8:
+        return (op & 0xFu) <= 0x7u || (op & 0xFu) == 0xEu;
+    case 0xE:
+        return (op & 0xFFu) == 0x9Eu || (op & 0xFFu) == 0xA1u;
+    case 0xF:
+        switch (op & 0xFFu)
+        {
+        case 0x07:
+        case 0x1E:
+        case 0x29:
+        case 0x65:
+            return 1;
+        default:
+            return 0;
+        }
+    default:
+        return 1;
+    }
+}
+
+/*
+ * Called at a backward jump to `target`, `cycle` cycles into a slice.
+ * Returns the loop's period in cycles if it came back to the jump with the
+ * same registers and I after an iteration without side effects, or 0.
+ */
+static int processor_probe_idle(IdleProbe *probe, uint16_t target, uint16_t index, int cycle)
+{
+    int period = 0;
+
+    if (probe->valid && probe->pure && probe->target == target && probe->index == index &&
+        memcmp(probe->registers, chip8_memory.registers, sizeof(probe->registers)) == 0)
+    {
+        /* Same state as one iteration ago: the loop repeats until the slice ends */
+        period = cycle - probe->cycle;
+    }
+
+    probe->valid = 1;
+    probe->pure = 1;
+    probe->cycle = cycle;
+    probe->target = target;
+    probe->index = index;
+    memcpy(probe->registers, chip8_memory.registers, sizeof(probe->registers));
+    return period;
+}
+
+/*
+ * What one iteration of an idle loop does with the delay timer, from
+ * processor_idle_frames().
+ */
+typedef struct
+{
+    uint16_t loaded;      /* Registers loaded by Fx07 */
+    uint8_t load_step[16]; /* Position in the iteration of each one's last Fx07 */
+} IdleTrace;
+
+/*
+ * Replays one iteration (`period` instructions from `target`) of an idle
+ * loop on a copy of the registers and returns how many frame ends it can
+ * be skipped across unchanged: PROCESSOR_IDLE_FOREVER if it does not
+ * depend on the timers; while the delay timer stays above the values its
+ * tests compare against if it only loads DT into registers that 3xkk/4xkk
+ * test; 0 for anything else. The sound timer must not run out on the way,
+ * as the frame end it does is an event.
+ */
+static unsigned int processor_idle_frames(const MEMORY *vm, uint16_t target, unsigned int period, IdleTrace *trace)
+{
+    uint8_t V[16];
+    uint16_t used = 0;
+    uint16_t equal = 0;
+    int below[16];
+    uint8_t dt = vm->delay_timer;
+    uint16_t pc = target;
+
+    memcpy(V, vm->registers, sizeof(V));
+    trace->loaded = 0;
+    for (int x = 0; x < 16; x++)
+        below[x] = -1;
+
+    for (unsigned int step = 0; step < period; step++)
+    {
+        if (pc > sizeof(vm->ram) - 2)
+            return 0;
+
+        uint16_t op = (uint16_t)((vm->ram[pc] << 8) | vm->ram[pc + 1]);
+        uint8_t x = (op & 0x0F00u) >> 8u;
+        uint8_t y = (op & 0x00F0u) >> 4u;
+        uint8_t kk = op & 0x00FFu;
+
+        pc += 2;
+
+        switch (op >> 12)
+        {
+        case 0x1:
+            pc = op & 0x0FFFu;
+            break;
+        case 0x3:
+        case 0x4:
+            /* The only use a register loaded from DT may have */
+            if (kk == dt)
+                equal |= 1u << x;
+            else if (kk < dt && kk > below[x])
+                below[x] = kk;
+            pc += ((V[x] == kk) == ((op >> 12) == 0x3)) ? 2 : 0;
+            break;
+        case 0x5:
+        case 0x9:
+            if ((op & 0xFu) != 0)
+                return 0;
+            used |= (1u << x) | (1u << y);
+            pc += ((V[x] == V[y]) == ((op >> 12) == 0x5)) ? 2 : 0;
+            break;
+        case 0x6:
+            used |= 1u << x;
+            V[x] = kk;
+            break;
+        case 0x7:
+            used |= 1u << x;
+            V[x] += kk;
+            break;
+        case 0x8:
+            used |= (1u << x) | (1u << y);
+            switch (op & 0xFu)
+            {
+            case 0x0:
+                V[x] = V[y];
+                break;
+            case 0x1:
+                V[x] |= V[y];
+                break;
+            case 0x2:
+                V[x] &= V[y];
+                break;
+            case 0x3:
+                V[x] ^= V[y];
+                break;
+            default:
+                return 0;
+            }
+            break;
+        case 0xA:
+            break;
+        case 0xE:
+            if ((kk != 0x9E && kk != 0xA1) || V[x] > 0xF)
+                return 0;
+            used |= 1u << x;
+            pc += ((vm->keypad[V[x]] != 0) == (kk == 0x9E)) ? 2 : 0;
+            break;
+        case 0xF:
+            switch (kk)
+            {
+            case 0x07:
+                V[x] = dt;
+                trace->loaded |= 1u << x;
+                trace->load_step[x] = (uint8_t)step;
+                break;
+            case 0x1E:
+            case 0x29:
+                used |= 1u << x;
+                break;
+            default:
+                return 0;
+            }
+            break;
+        default:
+            return 0;
+        }
+    }
+
+    /* Not the loop that was detected, e.g. a period too long for one trace */
+    if (pc != target || (trace->loaded & used))
+        return 0;
+
+    unsigned int frames = PROCESSOR_IDLE_FOREVER;
+
+    if (trace->loaded && dt > 0)
+    {
+        int limit = -1;
+
+        if (equal & trace->loaded)
+            return 0;
+
+        for (int x = 0; x < 16; x++)
+        {
+            if ((trace->loaded & (1u << x)) && below[x] > limit)
+                limit = below[x];
+        }
+
+        /* Each frame end takes DT one step closer to the first value a test reacts to */
+        if (limit >= 0)
+            frames = (unsigned int)(dt - limit - 1);
+    }
+
+    if (vm->sound_timer > 0 && frames > vm->sound_timer - 1u)
+        frames = vm->sound_timer - 1u;
+
+    return frames;
+}
+
+/*
+ * Called when the idle loop at `target` with a period of `period` cycles
+ * has been found `executed` slots into a slice of `budget`. Returns the
+ * number of slots to skip: the whole iterations that fit in the rest of
+ * the slice or, with a span, in as many of the following frames as the
+ * loop is known to spend unchanged, up to span->horizon.
+ */
+static unsigned int processor_skip_idle(MEMORY *vm, IdleSpan *span, uint16_t target, unsigned int period,
+                                        unsigned int executed, unsigned int budget)
+{
+    unsigned int frames = 0;
+    unsigned int idle = 0;
+    IdleTrace trace;
+
+    if (span != NULL)
+    {
+        idle = processor_idle_frames(vm, target, period, &trace);
+        frames = idle < span->horizon ? idle : span->horizon;
+
+        /* Keeps the slot counts within an int; a longer wait is found again in the frame landed in */
+        if (frames > INT_MAX / CHIP8_CYCLES_PER_FRAME / 2)
+            frames = INT_MAX / CHIP8_CYCLES_PER_FRAME / 2;
+    }
+
+    unsigned int skip = (budget - executed + frames * CHIP8_CYCLES_PER_FRAME) / period * period;
+
+    if (skip > 0)
+    {
+        processor_stats.idle_loops_detected++;
+        processor_stats.idle_cycles_skipped += skip;
+    }
+
+    if (span == NULL)
+        return skip;
+
+    /* Slots since the start of the slice's frame, at the landing point */
+    unsigned int landing = vm->frame_cycle + executed + skip;
+    unsigned int crossed = (landing - 1) / CHIP8_CYCLES_PER_FRAME;
+
+    /* A register loaded from DT holds what its last Fx07 read, in whichever frame that ran */
+    for (int x = 0; x < 16 && crossed > 0; x++)
+    {
+        if (trace.loaded & (1u << x))
+        {
+            unsigned int ticks = (landing - period + trace.load_step[x]) / CHIP8_CYCLES_PER_FRAME;
+            vm->registers[x] = ticks < vm->delay_timer ? (uint8_t)(vm->delay_timer - ticks) : 0;
+        }
+    }
+
+    /* The frame the loop lands in may be the last one a timer leaves unchanged */
+    if (idle == PROCESSOR_IDLE_FOREVER)
+        span->idle = idle;
+    else
+        span->idle = idle > crossed ? idle - crossed - 1 : 0;
+
+    return skip;
+}
 
 void processor_cycle(void)
 {
+    if (chip8_memory.waiting_for_key || chip8_memory.fault)
+        return;
+
+    if (chip8_memory.program_counter > sizeof(chip8_memory.ram) - 2)
+    {
+        chip8_memory.fault = CHIP8_FAULT_PC_RANGE;
+        return;
+    }
+
     /* Fetch opcode (big-endian) */
     opcode = (chip8_memory.ram[chip8_memory.program_counter] << 8) |
              (chip8_memory.ram[chip8_memory.program_counter + 1]);
@@ -12,11 +318,425 @@ void processor_cycle(void)
 
     /* Decode + Execute */
     ot_execute();
+}
 
-    /* Timers */
+void processor_update_timers(void)
+{
     if (chip8_memory.delay_timer > 0)
         chip8_memory.delay_timer--;
 
     if (chip8_memory.sound_timer > 0)
         chip8_memory.sound_timer--;
 }
+
+/*
+ * Applies `frames` whole frames in which nothing but the timers changes,
+ * none of them turning the beeper off, by ticking the timers in bulk.
+ */
+static void processor_skip_frames(MEMORY *vm, unsigned int frames)
+{
+    vm->delay_timer = frames < vm->delay_timer ? (uint8_t)(vm->delay_timer - frames) : 0;
+    vm->sound_timer = frames < vm->sound_timer ? (uint8_t)(vm->sound_timer - frames) : 0;
+
+    processor_stats.frames += frames;
+    processor_stats.frames_skipped += frames;
+}
+
+/*
+ * Runs up to `budget` instructions of an unblocked CPU within one frame.
+ * PC and I live in locals; the common instructions are executed inline and
+ * everything else (drawing, RAM writes, key input, faults) goes through
+ * the handler table with the locals written back around the call. Idle
+ * loops are skipped to the end of the slice or, given a span, across the
+ * frame ends after it; *ran then exceeds `budget`.
+ */
+static int processor_run_slice(MEMORY *vm, unsigned int budget, IdleSpan *span, unsigned int *ran)
+{
+    uint8_t *V = vm->registers;
+    const uint8_t *ram = vm->ram;
+    uint16_t pc = vm->program_counter;
+    uint16_t index = vm->index;
+    unsigned int executed = 0;
+    unsigned int skipped = 0;
+    IdleProbe probe = {0};
+    int events = 0;
+
+    while (executed < budget && !events)
+    {
+        if (pc > sizeof(vm->ram) - 2)
+        {
+            vm->fault = CHIP8_FAULT_PC_RANGE;
+            events |= PROCESSOR_EVENT_FAULT;
+            executed++;
+            break;
+        }
+
+        uint16_t op = (uint16_t)((ram[pc] << 8) | ram[pc + 1]);
+        uint8_t x = (op & 0x0F00u) >> 8u;
+        uint8_t y = (op & 0x00F0u) >> 4u;
+        uint8_t kk = op & 0x00FFu;
+
+        pc += 2;
+        executed++;
+
+        switch (op >> 12)
+        {
+        case 0x1:
+        {
+            uint16_t target = op & 0x0FFFu;
+
+            /* Only backward unconditional jumps can close a polling loop */
+            if (target <= pc - 2)
+            {
+                int period = processor_probe_idle(&probe, target, index, (int)executed);
+
+                if (period > 0)
+                {
+                    unsigned int idle = processor_skip_idle(vm, span, target, (unsigned int)period, executed, budget);
+                    executed += idle;
+                    skipped += idle;
+                    probe.cycle += (int)idle;
+                }
+            }
+
+            /* Past the budget after skipping into a later frame, which ends the slice */
+            pc = target;
+            continue;
+        }
+        case 0x2:
+            if (vm->stack_pointer == 16)
+                break;
+            probe.pure = 0;
+            vm->stack[vm->stack_pointer++] = pc;
+            pc = op & 0x0FFFu;
+            continue;
+        case 0x3:
+            pc += (V[x] == kk) ? 2 : 0;
+            continue;
+        case 0x4:
+            pc += (V[x] != kk) ? 2 : 0;
+            continue;
+        case 0x5:
+            if ((op & 0xFu) != 0)
+                break;
+            pc += (V[x] == V[y]) ? 2 : 0;
+            continue;
+        case 0x6:
+            V[x] = kk;
+            continue;
+        case 0x7:
+            V[x] += kk;
+            continue;
+        case 0x8:
+        {
+            /* As in instructions.c, flags are written first and the result reads VF back */
+            uint8_t vx = V[x], vy = V[y];
+
+            switch (op & 0xFu)
+            {
+            case 0x0:
+                V[x] = vy;
+                continue;
+            case 0x1:
+                V[x] = vx | vy;
+                continue;
+            case 0x2:
+                V[x] = vx & vy;
+                continue;
+            case 0x3:
+                V[x] = vx ^ vy;
+                continue;
+            case 0x4:
+                V[0xF] = (vx + vy > 0xFF) ? 1 : 0;
+                V[x] = (uint8_t)(vx + vy);
+                continue;
+            case 0x5:
+                V[0xF] = (vx > vy) ? 1 : 0;
+                V[x] = (uint8_t)(V[x] - V[y]);
+                continue;
+            case 0x6:
+                V[0xF] = vx & 0x1u;
+                V[x] = V[x] >> 1;
+                continue;
+            case 0x7:
+                V[0xF] = (vy > vx) ? 1 : 0;
+                V[x] = (uint8_t)(V[y] - V[x]);
+                continue;
+            case 0xE:
+                V[0xF] = vx >> 7u;
+                V[x] = (uint8_t)(V[x] << 1);
+                continue;
+            }
+            break;
+        }
+        case 0x9:
+            if ((op & 0xFu) != 0)
+                break;
+            pc += (V[x] != V[y]) ? 2 : 0;
+            continue;
+        case 0xA:
+            index = op & 0x0FFFu;
+            continue;
+        case 0xB:
+            pc = V[0x0] + (op & 0x0FFFu);
+            continue;
+        case 0xF:
+            switch (kk)
+            {
+            case 0x07:
+                V[x] = vm->delay_timer;
+                continue;
+            case 0x15:
+                probe.pure = 0;
+                vm->delay_timer = V[x];
+                continue;
+            case 0x18:
+                probe.pure = 0;
+                if ((vm->sound_timer > 0) != (V[x] > 0))
+                    events |= PROCESSOR_EVENT_SOUND;
+                vm->sound_timer = V[x];
+                continue;
+            case 0x1E:
+                index += V[x];
+                continue;
+            case 0x29:
+                index = FONTSET_START_ADDRESS + (5 * V[x]);
+                continue;
+            }
+            break;
+        }
+
+        /* Everything else runs through the handler table */
+        uint64_t display_hash = vm->display_hash;
+
+        vm->program_counter = pc;
+        vm->index = index;
+        opcode = op;
+        ot_execute();
+        pc = vm->program_counter;
+        index = vm->index;
+
+        if (!processor_is_pure(op))
+            probe.pure = 0;
+
+        if (vm->display_hash != display_hash)
+            events |= PROCESSOR_EVENT_DISPLAY;
+        if (vm->waiting_for_key)
+            events |= PROCESSOR_EVENT_KEY_WAIT;
+        if (vm->fault)
+            events |= PROCESSOR_EVENT_FAULT;
+    }
+
+    vm->program_counter = pc;
+    vm->index = index;
+    processor_stats.cycles_executed += executed - skipped;
+    *ran = executed;
+    return events;
+}
+
+/* Same as processor_run_slice(), one debugger_cycle() at a time */
+static int processor_run_debug(MEMORY *vm, unsigned int budget, unsigned int *ran)
+{
+    unsigned int slots = 0;
+    int events = 0;
+
+    while (slots < budget && !events)
+    {
+        uint64_t display_hash = vm->display_hash;
+        int sounding = vm->sound_timer > 0;
+
+        if (!debugger_cycle())
+        {
+            events |= PROCESSOR_EVENT_BREAKPOINT | (vm->fault ? PROCESSOR_EVENT_FAULT : 0);
+            break;
+        }
+        slots++;
+
+        if (vm->display_hash != display_hash)
+            events |= PROCESSOR_EVENT_DISPLAY;
+        if (sounding != (vm->sound_timer > 0))
+            events |= PROCESSOR_EVENT_SOUND;
+        if (vm->waiting_for_key)
+            events |= PROCESSOR_EVENT_KEY_WAIT;
+    }
+
+    *ran = slots;
+    return events;
+}
+
+/* Ticks the timers at the end of a frame */
+static int processor_end_frame(MEMORY *vm)
+{
+    int sounding = vm->sound_timer > 0;
+
+    processor_update_timers();
+    processor_stats.frames++;
+    vm->frame_cycle = 0;
+
+    return PROCESSOR_EVENT_FRAME | (sounding != (vm->sound_timer > 0) ? PROCESSOR_EVENT_SOUND : 0);
+}
+
+/*
+ * processor_run() itself. A span lets idle loops skip across frame ends,
+ * whose timer ticks are applied in bulk; the call then returns when the
+ * slice that did so is done, with more slots used than budgeted.
+ */
+static int processor_advance(MEMORY *vm, unsigned int budget, IdleSpan *span, unsigned int *used)
+{
+    unsigned int slots = 0;
+    int events = 0;
+
+    /* A frame end that coincided with an instruction's event is reported on its own */
+    if (vm->frame_cycle == CHIP8_CYCLES_PER_FRAME)
+    {
+        *used = 0;
+        return processor_end_frame(vm);
+    }
+
+    while (slots < budget && !events)
+    {
+        unsigned int frame_left = CHIP8_CYCLES_PER_FRAME - vm->frame_cycle;
+        unsigned int slice = budget - slots < frame_left ? budget - slots : frame_left;
+        int blocked = !debugger_active && (vm->waiting_for_key || vm->fault);
+        unsigned int ran;
+
+        if (blocked)
+        {
+            /* Nothing can change before the frame ends */
+            events = vm->fault ? PROCESSOR_EVENT_FAULT : PROCESSOR_EVENT_KEY_WAIT;
+            ran = slice;
+        }
+        else if (debugger_active)
+        {
+            /* debugger_cycle() counts the instructions it executes */
+            events = processor_run_debug(vm, slice, &ran);
+        }
+        else
+        {
+            /* Only a slice that runs to the end of its frame may skip past it */
+            events = processor_run_slice(vm, slice, slice == frame_left ? span : NULL, &ran);
+        }
+
+        slots += ran;
+
+        if (ran > slice)
+        {
+            /* Land in the frame the idle loop skipped into, with the frames before it ticked */
+            unsigned int landing = vm->frame_cycle + ran;
+            unsigned int crossed = (landing - 1) / CHIP8_CYCLES_PER_FRAME;
+
+            processor_skip_frames(vm, crossed);
+            span->crossed += crossed;
+            vm->frame_cycle = (uint8_t)(landing - crossed * CHIP8_CYCLES_PER_FRAME);
+        }
+        else
+        {
+            vm->frame_cycle += (uint8_t)ran;
+        }
+
+        if (vm->frame_cycle == CHIP8_CYCLES_PER_FRAME && (blocked || !events))
+            events |= processor_end_frame(vm);
+    }
+
+    *used = slots;
+    return events;
+}
+
+int processor_run(unsigned int budget, unsigned int *used)
+{
+    return processor_advance(chip8_vm, budget, NULL, used);
+}
+
+int processor_frames(unsigned int frames, unsigned int *ran, unsigned int *idle)
+{
+    MEMORY *vm = chip8_vm;
+    uint8_t frame_cycle = vm->frame_cycle;
+    unsigned int done = 0;
+    int events = 0;
+    IdleSpan span = {0};
+
+    if (debugger_enabled)
+    {
+        /* The debugger is polled once per frame, so only one runs */
+        debugger_poll();
+        if (debugger_active)
+        {
+            debugger_frame();
+            *ran = 1;
+            if (idle != NULL)
+                *idle = 0;
+            return PROCESSOR_EVENT_FRAME;
+        }
+        frames = frames < 1 ? frames : 1;
+    }
+
+    vm->frame_cycle = 0;
+
+    while (done < frames)
+    {
+        int blocked = vm->waiting_for_key || vm->fault;
+        unsigned int used;
+
+        if (blocked)
+        {
+            /* Only the timers run; the frame the beeper turns off in is run for its event */
+            unsigned int skip = frames - done - 1;
+
+            if (vm->sound_timer > 0 && skip > vm->sound_timer - 1u)
+                skip = vm->sound_timer - 1u;
+
+            processor_skip_frames(vm, skip);
+            done += skip;
+        }
+
+        span.horizon = frames - done - 1;
+        span.crossed = 0;
+        span.idle = 0;
+
+        events = 0;
+        while (!(events & (PROCESSOR_EVENT_FRAME | PROCESSOR_EVENT_BREAKPOINT)))
+            events |= processor_advance(vm, CHIP8_CYCLES_PER_FRAME, &span, &used);
+
+        done += 1 + span.crossed;
+
+        /* Stop where the caller has something to react to */
+        if ((events & (PROCESSOR_EVENT_DISPLAY | PROCESSOR_EVENT_SOUND | PROCESSOR_EVENT_BREAKPOINT)) ||
+            (!blocked && (vm->waiting_for_key || vm->fault)))
+        {
+            break;
+        }
+    }
+
+    if (idle != NULL)
+    {
+        if (vm->waiting_for_key || vm->fault)
+            *idle = vm->sound_timer > 0 ? vm->sound_timer - 1u : PROCESSOR_IDLE_FOREVER;
+        else
+            *idle = span.idle;
+    }
+
+    vm->frame_cycle = frame_cycle;
+    *ran = done;
+    return events;
+}
+
+void processor_frame(void)
+{
+    unsigned int ran;
+    processor_frames(1, &ran, NULL);
+}
+
+void processor_report_stats(FILE *out)
+{
+    unsigned long long total = processor_stats.cycles_executed + processor_stats.idle_cycles_skipped;
+
+    fprintf(out,
+            "CPU: %llu frames (%llu fast-forwarded), %llu cycles executed, %llu idle loops fast-forwarded, "
+            "%llu cycles skipped (%.1f%%)\n",
+            processor_stats.frames,
+            processor_stats.frames_skipped,
+            processor_stats.cycles_executed,
+            processor_stats.idle_loops_detected,
+            processor_stats.idle_cycles_skipped,
+            total ? 100.0 * processor_stats.idle_cycles_skipped / total : 0.0);
+}
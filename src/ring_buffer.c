@@ -0,0 +1,76 @@
+#include <stdlib.h>
+#include <string.h>
+#include "ring_buffer.h"
+
+int ring_buffer_init(RingBuffer *rb, size_t capacity)
+{
+    size_t size = 1;
+    while (size < capacity)
+        size <<= 1;
+
+    rb->data = malloc(size);
+    if (rb->data == NULL)
+        return -1;
+
+    rb->capacity = size;
+    rb->mask = size - 1;
+    atomic_init(&rb->head, 0);
+    atomic_init(&rb->tail, 0);
+    return 0;
+}
+
+void ring_buffer_free(RingBuffer *rb)
+{
+    free(rb->data);
+    rb->data = NULL;
+    rb->capacity = 0;
+}
+
+size_t ring_buffer_size(RingBuffer *rb)
+{
+    size_t head = atomic_load_explicit(&rb->head, memory_order_acquire);
+    size_t tail = atomic_load_explicit(&rb->tail, memory_order_acquire);
+    return head - tail;
+}
+
+size_t ring_buffer_fill(RingBuffer *rb, uint8_t value, size_t count)
+{
+    size_t head = atomic_load_explicit(&rb->head, memory_order_relaxed);
+    size_t tail = atomic_load_explicit(&rb->tail, memory_order_acquire);
+    size_t space = rb->capacity - (head - tail);
+
+    if (count > space)
+        count = space;
+
+    size_t offset = head & rb->mask;
+    size_t first = rb->capacity - offset;
+    if (first > count)
+        first = count;
+
+    memset(rb->data + offset, value, first);
+    memset(rb->data, value, count - first);
+
+    atomic_store_explicit(&rb->head, head + count, memory_order_release);
+    return count;
+}
+
+size_t ring_buffer_read(RingBuffer *rb, uint8_t *out, size_t count)
+{
+    size_t tail = atomic_load_explicit(&rb->tail, memory_order_relaxed);
+    size_t head = atomic_load_explicit(&rb->head, memory_order_acquire);
+    size_t available = head - tail;
+
+    if (count > available)
+        count = available;
+
+    size_t offset = tail & rb->mask;
+    size_t first = rb->capacity - offset;
+    if (first > count)
+        first = count;
+
+    memcpy(out, rb->data + offset, first);
+    memcpy(out + first, rb->data, count - first);
+
+    atomic_store_explicit(&rb->tail, tail + count, memory_order_release);
+    return count;
+}
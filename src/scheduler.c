@@ -0,0 +1,350 @@
+#include <limits.h>
+#include <stdlib.h>
+#include "scheduler.h"
+#include "chip8.h"
+#include "processor.h"
+
+#define SCHEDULER_NONE (-1)
+
+typedef struct
+{
+    Chip8Machine *machine; /* NULL for a free slot */
+    uint64_t next_tick;    /* Tick of the next frame the machine owes */
+    uint64_t due_tick;     /* Tick the wheel entry fires at */
+    int prev, next;        /* Wheel slot list */
+    int in_wheel;
+    int parked;
+    int idle; /* Parked in an idle loop, not blocked */
+} SchedulerSession;
+
+struct Scheduler
+{
+    int64_t start_ns;
+    uint64_t tick; /* Next tick to run */
+    SchedulerFrameFunc on_frame;
+    void *context;
+
+    SchedulerSession *sessions;
+    int capacity;
+    int wheel[SCHEDULER_WHEEL_SLOTS];
+
+    SchedulerStats stats;
+};
+
+static int64_t scheduler_tick_ns(const Scheduler *scheduler, uint64_t tick)
+{
+    return scheduler->start_ns + (int64_t)(tick * 1000000000ull / CHIP8_FRAME_RATE);
+}
+
+static void scheduler_insert(Scheduler *scheduler, int id, uint64_t due_tick)
+{
+    SchedulerSession *session = &scheduler->sessions[id];
+    int *head = &scheduler->wheel[due_tick % SCHEDULER_WHEEL_SLOTS];
+
+    session->due_tick = due_tick;
+    session->prev = SCHEDULER_NONE;
+    session->next = *head;
+    if (*head != SCHEDULER_NONE)
+        scheduler->sessions[*head].prev = id;
+    *head = id;
+    session->in_wheel = 1;
+}
+
+static void scheduler_unlink(Scheduler *scheduler, int id)
+{
+    SchedulerSession *session = &scheduler->sessions[id];
+
+    if (!session->in_wheel)
+        return;
+
+    if (session->prev != SCHEDULER_NONE)
+        scheduler->sessions[session->prev].next = session->next;
+    else
+        scheduler->wheel[session->due_tick % SCHEDULER_WHEEL_SLOTS] = session->next;
+
+    if (session->next != SCHEDULER_NONE)
+        scheduler->sessions[session->next].prev = session->prev;
+
+    session->in_wheel = 0;
+}
+
+/*
+ * Brings a parked session up to `tick`: a blocked one only needs the timer
+ * ticks of the frames it slept through, an idle one runs them, which
+ * processor_frames() fast-forwards.
+ */
+static void scheduler_settle(Scheduler *scheduler, SchedulerSession *session, uint64_t tick)
+{
+    if (session->next_tick >= tick)
+        return;
+
+    uint64_t frames = tick - session->next_tick;
+    MEMORY *vm = libchip8_state(session->machine);
+
+    if (session->idle)
+    {
+        MEMORY *caller_vm = chip8_vm;
+
+        chip8_vm = vm;
+        for (uint64_t left = frames; left > 0;)
+        {
+            unsigned int ran;
+            processor_frames(left < UINT_MAX ? (unsigned int)left : UINT_MAX, &ran, NULL);
+            left -= ran;
+        }
+        chip8_vm = caller_vm;
+    }
+    else
+    {
+        vm->delay_timer = frames < vm->delay_timer ? (uint8_t)(vm->delay_timer - frames) : 0;
+        vm->sound_timer = frames < vm->sound_timer ? (uint8_t)(vm->sound_timer - frames) : 0;
+    }
+
+    session->next_tick = tick;
+    scheduler->stats.frames_skipped += frames;
+}
+
+static void scheduler_park(Scheduler *scheduler, int id)
+{
+    SchedulerSession *session = &scheduler->sessions[id];
+    const MEMORY *vm = libchip8_state(session->machine);
+    uint8_t timer = vm->delay_timer > vm->sound_timer ? vm->delay_timer : vm->sound_timer;
+
+    if (!session->parked)
+        scheduler->stats.parked++;
+    session->parked = 1;
+    session->idle = 0;
+
+    /* Timer ticks are invisible until the last one, which turns off the beeper */
+    if (timer > 0)
+        scheduler_insert(scheduler, id, session->next_tick + timer - 1);
+}
+
+/* Parks a session whose next `frames` frames are known to be idle (see processor_frames()) */
+static void scheduler_park_idle(Scheduler *scheduler, int id, unsigned int frames)
+{
+    SchedulerSession *session = &scheduler->sessions[id];
+
+    if (!session->parked)
+        scheduler->stats.parked++;
+    session->parked = 1;
+    session->idle = 1;
+
+    /* Counts other than PROCESSOR_IDLE_FOREVER are below 255, so they fit the wheel */
+    if (frames != PROCESSOR_IDLE_FOREVER)
+        scheduler_insert(scheduler, id, session->next_tick + frames);
+}
+
+/*
+ * Runs the session's frame for `tick`; returns its ProcessorEvent bits and
+ * the number of idle frames known to follow (see processor_frames()).
+ */
+static int scheduler_run_frame(Scheduler *scheduler, int id, uint64_t tick, int *blocked, unsigned int *idle)
+{
+    SchedulerSession *session = &scheduler->sessions[id];
+    MEMORY *caller_vm = chip8_vm;
+    unsigned int ran;
+
+    scheduler_settle(scheduler, session, tick);
+    chip8_vm = libchip8_state(session->machine);
+
+    int events = processor_frames(1, &ran, idle);
+
+    *blocked = chip8_memory.waiting_for_key || chip8_memory.fault;
+    chip8_vm = caller_vm;
+
+    session->next_tick = tick + 1;
+    scheduler->stats.frames_run++;
+    return events;
+}
+
+Scheduler *scheduler_create(int64_t start_ns, SchedulerFrameFunc on_frame, void *context)
+{
+    Scheduler *scheduler = calloc(1, sizeof(Scheduler));
+    if (scheduler == NULL)
+        return NULL;
+
+    scheduler->start_ns = start_ns;
+    scheduler->on_frame = on_frame;
+    scheduler->context = context;
+
+    for (int i = 0; i < SCHEDULER_WHEEL_SLOTS; i++)
+        scheduler->wheel[i] = SCHEDULER_NONE;
+
+    return scheduler;
+}
+
+void scheduler_destroy(Scheduler *scheduler)
+{
+    if (scheduler == NULL)
+        return;
+
+    free(scheduler->sessions);
+    free(scheduler);
+}
+
+int scheduler_add(Scheduler *scheduler, Chip8Machine *machine)
+{
+    int id = 0;
+    while (id < scheduler->capacity && scheduler->sessions[id].machine != NULL)
+        id++;
+
+    if (id == scheduler->capacity)
+    {
+        int capacity = scheduler->capacity ? 2 * scheduler->capacity : 64;
+        SchedulerSession *sessions = realloc(scheduler->sessions, capacity * sizeof(SchedulerSession));
+        if (sessions == NULL)
+            return -1;
+
+        for (int i = scheduler->capacity; i < capacity; i++)
+            sessions[i].machine = NULL;
+
+        scheduler->sessions = sessions;
+        scheduler->capacity = capacity;
+    }
+
+    SchedulerSession *session = &scheduler->sessions[id];
+    session->machine = machine;
+    session->next_tick = scheduler->tick;
+    session->in_wheel = 0;
+    session->parked = 0;
+    session->idle = 0;
+
+    scheduler_insert(scheduler, id, scheduler->tick);
+    scheduler->stats.sessions++;
+    return id;
+}
+
+Chip8Machine *scheduler_remove(Scheduler *scheduler, int session)
+{
+    Chip8Machine *machine = scheduler_machine(scheduler, session);
+    SchedulerSession *s = &scheduler->sessions[session];
+
+    scheduler_unlink(scheduler, session);
+    if (s->parked)
+        scheduler->stats.parked--;
+
+    s->machine = NULL;
+    scheduler->stats.sessions--;
+    return machine;
+}
+
+Chip8Machine *scheduler_machine(Scheduler *scheduler, int session)
+{
+    SchedulerSession *s = &scheduler->sessions[session];
+
+    if (s->parked)
+        scheduler_settle(scheduler, s, scheduler->tick);
+
+    return s->machine;
+}
+
+void scheduler_set_key(Scheduler *scheduler, int session, uint8_t key, uint8_t pressed)
+{
+    SchedulerSession *s = &scheduler->sessions[session];
+    const MEMORY *vm = libchip8_state(s->machine);
+
+    /* The frames slept through ran with the keys as they were */
+    if (s->parked)
+        scheduler_settle(scheduler, s, scheduler->tick);
+
+    libchip8_set_key(s->machine, key, pressed);
+
+    if (s->parked && !vm->waiting_for_key && !vm->fault)
+        scheduler_wake(scheduler, session);
+}
+
+void scheduler_wake(Scheduler *scheduler, int session)
+{
+    SchedulerSession *s = &scheduler->sessions[session];
+
+    if (!s->parked)
+        return;
+
+    scheduler_settle(scheduler, s, scheduler->tick);
+    scheduler_unlink(scheduler, session);
+    scheduler_insert(scheduler, session, scheduler->tick);
+
+    s->parked = 0;
+    s->idle = 0;
+    scheduler->stats.parked--;
+    scheduler->stats.key_wakeups++;
+}
+
+unsigned long scheduler_run(Scheduler *scheduler, int64_t now_ns)
+{
+    unsigned long frames = 0;
+    uint64_t last = scheduler->tick + SCHEDULER_MAX_CATCH_UP - 1;
+    int64_t late_ns = now_ns - scheduler_tick_ns(scheduler, last);
+
+    /* Too far behind: make the last tick this call may run due now, and drop the ones before */
+    if (late_ns >= 1000000000 / CHIP8_FRAME_RATE)
+    {
+        scheduler->stats.ticks_dropped += (uint64_t)late_ns * CHIP8_FRAME_RATE / 1000000000u;
+        scheduler->start_ns = now_ns - (int64_t)(last * 1000000000ull / CHIP8_FRAME_RATE);
+    }
+
+    while (scheduler_tick_ns(scheduler, scheduler->tick) <= now_ns)
+    {
+        uint64_t tick = scheduler->tick;
+        int *head = &scheduler->wheel[tick % SCHEDULER_WHEEL_SLOTS];
+
+        /* Sessions run in this tick are reinserted at least one tick ahead */
+        while (*head != SCHEDULER_NONE)
+        {
+            int id = *head;
+            SchedulerSession *session = &scheduler->sessions[id];
+
+            scheduler_unlink(scheduler, id);
+            if (session->parked)
+                scheduler->stats.timer_wakeups++;
+
+            int blocked;
+            unsigned int idle;
+            int events = scheduler_run_frame(scheduler, id, tick, &blocked, &idle);
+            frames++;
+
+            if (blocked)
+            {
+                scheduler_park(scheduler, id);
+            }
+            else if (idle > 0)
+            {
+                scheduler_park_idle(scheduler, id, idle);
+            }
+            else
+            {
+                if (session->parked)
+                {
+                    session->parked = 0;
+                    session->idle = 0;
+                    scheduler->stats.parked--;
+                }
+                scheduler_insert(scheduler, id, tick + 1);
+            }
+
+            if (scheduler->on_frame)
+                scheduler->on_frame(id, events, scheduler->context);
+        }
+
+        scheduler->tick++;
+    }
+
+    return frames;
+}
+
+int64_t scheduler_next_deadline(const Scheduler *scheduler)
+{
+    for (uint64_t tick = scheduler->tick; tick < scheduler->tick + SCHEDULER_WHEEL_SLOTS; tick++)
+    {
+        if (scheduler->wheel[tick % SCHEDULER_WHEEL_SLOTS] != SCHEDULER_NONE)
+            return scheduler_tick_ns(scheduler, tick);
+    }
+
+    return INT64_MAX;
+}
+
+const SchedulerStats *scheduler_stats(const Scheduler *scheduler)
+{
+    return &scheduler->stats;
+}
@@ -0,0 +1,206 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "shm_export.h"
+
+#ifndef _WIN32
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "frame_pacer.h"
+
+struct ShmExport
+{
+    ShmExportSegment *segment;
+    char name[256];
+};
+
+/* POSIX shared-memory names are a single '/' followed by the name */
+static int shm_export_name(const char *name, char *out, size_t size)
+{
+    int written = snprintf(out, size, "%s%s", name[0] == '/' ? "" : "/", name);
+    if (written < 0 || (size_t)written >= size || strchr(out + 1, '/') != NULL)
+    {
+        fprintf(stderr, "ERROR: Invalid shared-memory name: %s\n", name);
+        return -1;
+    }
+    return 0;
+}
+
+ShmExport *shm_export_create(const char *name, uint32_t flags)
+{
+    ShmExport *exporter = calloc(1, sizeof(ShmExport));
+    if (exporter == NULL)
+        return NULL;
+
+    if (shm_export_name(name, exporter->name, sizeof(exporter->name)) != 0)
+    {
+        free(exporter);
+        return NULL;
+    }
+
+    int fd = shm_open(exporter->name, O_RDWR | O_CREAT, 0600);
+    if (fd < 0 || ftruncate(fd, sizeof(ShmExportSegment)) != 0)
+    {
+        perror("ERROR: Failed to create shared memory");
+        if (fd >= 0)
+        {
+            close(fd);
+            shm_unlink(exporter->name);
+        }
+        free(exporter);
+        return NULL;
+    }
+
+    void *mapping = mmap(NULL, sizeof(ShmExportSegment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (mapping == MAP_FAILED)
+    {
+        perror("ERROR: Failed to map shared memory");
+        shm_unlink(exporter->name);
+        free(exporter);
+        return NULL;
+    }
+
+    /* A segment left behind by an earlier run is reset; a blank display hashes to 0 */
+    ShmExportSegment *segment = mapping;
+    memset(segment, 0, sizeof(ShmExportSegment));
+    segment->version = SHM_EXPORT_VERSION;
+    segment->size = sizeof(ShmExportSegment);
+    segment->flags = flags & SHM_EXPORT_STATE;
+    atomic_store_explicit(&segment->sequence, 0, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    segment->magic = SHM_EXPORT_MAGIC;
+
+    exporter->segment = segment;
+    return exporter;
+}
+
+void shm_export_publish(ShmExport *exporter, const MEMORY *vm, uint64_t frame)
+{
+    ShmExportSegment *segment = exporter->segment;
+    uint64_t sequence = atomic_load_explicit(&segment->sequence, memory_order_relaxed);
+
+    atomic_store_explicit(&segment->sequence, sequence + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    segment->frame = frame;
+    segment->published_ns = frame_pacer_now_ns();
+
+    if (segment->display_hash != vm->display_hash)
+    {
+        memcpy(segment->display, vm->display, sizeof(segment->display));
+        segment->display_hash = vm->display_hash;
+    }
+
+    if (segment->flags & SHM_EXPORT_STATE)
+    {
+        memcpy(segment->registers, vm->registers, sizeof(segment->registers));
+        segment->index = vm->index;
+        segment->program_counter = vm->program_counter;
+        memcpy(segment->stack, vm->stack, sizeof(segment->stack));
+        segment->stack_pointer = vm->stack_pointer;
+        segment->delay_timer = vm->delay_timer;
+        segment->sound_timer = vm->sound_timer;
+        segment->fault = vm->fault;
+        memcpy(segment->ram, vm->ram, sizeof(segment->ram));
+    }
+
+    atomic_store_explicit(&segment->sequence, sequence + 2, memory_order_release);
+}
+
+void shm_export_destroy(ShmExport *exporter)
+{
+    if (exporter == NULL)
+        return;
+
+    munmap(exporter->segment, sizeof(ShmExportSegment));
+    shm_unlink(exporter->name);
+    free(exporter);
+}
+
+const ShmExportSegment *shm_export_open(const char *name)
+{
+    char path[256];
+    if (shm_export_name(name, path, sizeof(path)) != 0)
+        return NULL;
+
+    int fd = shm_open(path, O_RDONLY, 0);
+    if (fd < 0)
+    {
+        perror("ERROR: Failed to open shared memory");
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(ShmExportSegment))
+    {
+        fprintf(stderr, "ERROR: Shared memory %s is not a CHIP-8 export.\n", path);
+        close(fd);
+        return NULL;
+    }
+
+    void *mapping = mmap(NULL, sizeof(ShmExportSegment), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (mapping == MAP_FAILED)
+    {
+        perror("ERROR: Failed to map shared memory");
+        return NULL;
+    }
+
+    const ShmExportSegment *segment = mapping;
+    if (segment->magic != SHM_EXPORT_MAGIC || segment->version != SHM_EXPORT_VERSION ||
+        segment->size != sizeof(ShmExportSegment))
+    {
+        fprintf(stderr, "ERROR: Shared memory %s has an unsupported layout.\n", path);
+        munmap(mapping, sizeof(ShmExportSegment));
+        return NULL;
+    }
+
+    return segment;
+}
+
+void shm_export_close(const ShmExportSegment *segment)
+{
+    munmap((void *)segment, sizeof(ShmExportSegment));
+}
+
+#else
+
+ShmExport *shm_export_create(const char *name, uint32_t flags)
+{
+    (void)name;
+    (void)flags;
+    fprintf(stderr, "ERROR: Shared-memory export is not supported on this platform.\n");
+    return NULL;
+}
+
+void shm_export_publish(ShmExport *exporter, const MEMORY *vm, uint64_t frame)
+{
+    (void)exporter;
+    (void)vm;
+    (void)frame;
+}
+
+void shm_export_destroy(ShmExport *exporter)
+{
+    (void)exporter;
+}
+
+const ShmExportSegment *shm_export_open(const char *name)
+{
+    (void)name;
+    fprintf(stderr, "ERROR: Shared-memory export is not supported on this platform.\n");
+    return NULL;
+}
+
+void shm_export_close(const ShmExportSegment *segment)
+{
+    (void)segment;
+}
+
+#endif
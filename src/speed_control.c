@@ -0,0 +1,99 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "speed_control.h"
+#include "frame_pacer.h"
+
+SpeedControl speed_control = {
+    .normal = 1.0,
+    .fast_forward = 4.0,
+    .slow_motion = 0.25,
+};
+
+int speed_control_parse(const char *text, double *multiplier)
+{
+    char *end;
+
+    if (strcmp(text, "max") == 0)
+    {
+        *multiplier = SPEED_UNCAPPED;
+        return 0;
+    }
+
+    double value = strtod(text, &end);
+    if (end == text || *end != '\0' || !(value > 0.0 && value <= 1000.0))
+    {
+        fprintf(stderr, "ERROR: A speed must be a number above 0 and at most 1000, or \"max\".\n");
+        return -1;
+    }
+
+    *multiplier = value;
+    return 0;
+}
+
+int speed_control_key(int host_key, int pressed, int releases)
+{
+    switch (host_key)
+    {
+    case SPEED_KEY_HOLD:
+        if (releases)
+            speed_control.held = pressed;
+        else if (pressed)
+            speed_control.toggled = !speed_control.toggled;
+        break;
+    case SPEED_KEY_FAST_FORWARD:
+        if (pressed)
+        {
+            speed_control.toggled = !speed_control.toggled;
+            speed_control.slow = 0;
+        }
+        break;
+    case SPEED_KEY_SLOW_MOTION:
+        if (pressed)
+        {
+            speed_control.slow = !speed_control.slow;
+            speed_control.toggled = 0;
+        }
+        break;
+    default:
+        return 0;
+    }
+
+    /* Whatever was owed at the old speed no longer is */
+    speed_control.credit = 0.0;
+    return 1;
+}
+
+double speed_control_multiplier(void)
+{
+    if (speed_control.held || speed_control.toggled)
+        return speed_control.fast_forward;
+    if (speed_control.slow)
+        return speed_control.slow_motion;
+    return speed_control.normal;
+}
+
+void speed_control_begin_period(void)
+{
+    double multiplier = speed_control_multiplier();
+
+    /* Fractions carry over (slow motion); whole frames left unrun last period are dropped */
+    speed_control.credit -= (double)(long long)speed_control.credit;
+
+    if (multiplier == SPEED_UNCAPPED)
+        speed_control.credit = 1e9;
+    else
+        speed_control.credit += multiplier;
+}
+
+int speed_control_frame_due(unsigned int frames_run, int64_t deadline_ns)
+{
+    if (speed_control.credit < 1.0)
+        return 0;
+
+    if (frames_run > 0 && frame_pacer_now_ns() >= deadline_ns - SPEED_PRESENT_MARGIN_NS)
+        return 0;
+
+    speed_control.credit -= 1.0;
+    return 1;
+}
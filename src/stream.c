@@ -0,0 +1,424 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "stream.h"
+#include "chip8.h"
+#include "processor.h"
+#include "frame_pacer.h"
+#include "net.h"
+
+void stream_pack_display(const MEMORY *vm, uint8_t *bitmap)
+{
+    const uint32_t *pixels = &vm->display[0][0];
+
+    for (int i = 0; i < STREAM_BITMAP_BYTES; i++)
+    {
+        uint8_t bits = 0;
+        for (int bit = 0; bit < 8; bit++)
+            bits = (uint8_t)(bits << 1) | (pixels[i * 8 + bit] != 0);
+        bitmap[i] = bits;
+    }
+}
+
+size_t stream_encode_delta(const uint8_t *previous, const uint8_t *current, uint8_t *out)
+{
+    uint8_t delta[STREAM_BITMAP_BYTES];
+    size_t length = 0;
+    int i = 0;
+
+    for (int j = 0; j < STREAM_BITMAP_BYTES; j++)
+        delta[j] = previous[j] ^ current[j];
+
+    while (i < STREAM_BITMAP_BYTES)
+    {
+        int run = 1;
+        while (i + run < STREAM_BITMAP_BYTES && run < 130 && delta[i + run] == delta[i])
+            run++;
+
+        if (run >= 3)
+        {
+            out[length++] = (uint8_t)(0x80 + run - 3);
+            out[length++] = delta[i];
+            i += run;
+            continue;
+        }
+
+        /* Literals extend up to the next run of three or more; shorter runs would not pay */
+        int start = i;
+        int count = 0;
+        while (i < STREAM_BITMAP_BYTES && count < 128 &&
+               !(i + 2 < STREAM_BITMAP_BYTES && delta[i + 1] == delta[i] && delta[i + 2] == delta[i]))
+        {
+            i++;
+            count++;
+        }
+
+        out[length++] = (uint8_t)(count - 1);
+        memcpy(out + length, delta + start, (size_t)count);
+        length += (size_t)count;
+    }
+
+    return length;
+}
+
+int stream_decode_delta(const uint8_t *payload, size_t length, uint8_t *bitmap)
+{
+    size_t in = 0;
+    int out = 0;
+
+    while (in < length)
+    {
+        uint8_t control = payload[in++];
+
+        if (control < 0x80)
+        {
+            int count = control + 1;
+            if (in + (size_t)count > length || out + count > STREAM_BITMAP_BYTES)
+                return -1;
+            for (int i = 0; i < count; i++)
+                bitmap[out++] ^= payload[in++];
+        }
+        else
+        {
+            int count = control - 0x80 + 3;
+            if (in >= length || out + count > STREAM_BITMAP_BYTES)
+                return -1;
+            uint8_t value = payload[in++];
+            for (int i = 0; i < count; i++)
+                bitmap[out++] ^= value;
+        }
+    }
+
+    return out == STREAM_BITMAP_BYTES ? 0 : -1;
+}
+
+#ifndef _WIN32
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+/* Room for a few frames; a client further behind than this gets frames skipped */
+#define STREAM_OUTPUT_SIZE (8 * (STREAM_HEADER_SIZE + STREAM_MAX_PAYLOAD))
+#define STREAM_FLAG_KEY_FRAME 0x01
+
+typedef struct
+{
+    int fd;
+    int has_frame;
+    uint8_t sent[STREAM_BITMAP_BYTES];
+    uint64_t sent_hash;
+    uint64_t input_ns;
+
+    uint8_t input[STREAM_KEY_EVENT_SIZE];
+    size_t input_length;
+    uint8_t output[STREAM_OUTPUT_SIZE];
+    size_t output_length;
+} StreamClient;
+
+typedef struct
+{
+    int listen_fd;
+    char socket_path[NET_PATH_SIZE];
+    StreamClient clients[STREAM_MAX_CLIENTS];
+
+    unsigned long frames;
+    unsigned long frames_sent;
+    unsigned long frames_skipped;
+    unsigned long long bytes_sent;
+    unsigned long key_events;
+    unsigned long clients_served;
+} StreamServer;
+
+static volatile sig_atomic_t stream_stopping = 0;
+
+static void stream_handle_signal(int signal)
+{
+    (void)signal;
+    stream_stopping = 1;
+}
+
+static void put_u16(uint8_t *out, uint16_t value)
+{
+    out[0] = (uint8_t)value;
+    out[1] = (uint8_t)(value >> 8);
+}
+
+static void put_u32(uint8_t *out, uint32_t value)
+{
+    for (int i = 0; i < 4; i++)
+        out[i] = (uint8_t)(value >> (8 * i));
+}
+
+static void put_u64(uint8_t *out, uint64_t value)
+{
+    for (int i = 0; i < 8; i++)
+        out[i] = (uint8_t)(value >> (8 * i));
+}
+
+static uint64_t get_u64(const uint8_t *in)
+{
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; i--)
+        value = (value << 8) | in[i];
+    return value;
+}
+
+static void stream_disconnect(StreamClient *client)
+{
+    close(client->fd);
+    client->fd = -1;
+}
+
+static void stream_accept(StreamServer *server)
+{
+    for (;;)
+    {
+        int fd = accept(server->listen_fd, NULL, NULL);
+        if (fd < 0)
+            return;
+
+        StreamClient *client = NULL;
+        for (int i = 0; i < STREAM_MAX_CLIENTS && client == NULL; i++)
+        {
+            if (server->clients[i].fd < 0)
+                client = &server->clients[i];
+        }
+
+        if (client == NULL)
+        {
+            close(fd);
+            continue;
+        }
+
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+        memset(client, 0, sizeof(*client));
+        client->fd = fd;
+        server->clients_served++;
+    }
+}
+
+/* Applies every complete key event the client has sent */
+static void stream_receive(StreamServer *server, StreamClient *client)
+{
+    uint8_t buffer[512];
+
+    for (;;)
+    {
+        ssize_t received = recv(client->fd, buffer, sizeof(buffer), 0);
+        if (received == 0 || (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR))
+        {
+            stream_disconnect(client);
+            return;
+        }
+        if (received < 0)
+            return;
+
+        for (ssize_t i = 0; i < received; i++)
+        {
+            client->input[client->input_length++] = buffer[i];
+
+            if (client->input[0] != 'K')
+            {
+                stream_disconnect(client);
+                return;
+            }
+            if (client->input_length < STREAM_KEY_EVENT_SIZE)
+                continue;
+
+            chip8_set_key(client->input[1] & 0xFu, client->input[1] >> 7);
+            client->input_ns = get_u64(client->input + 2);
+            client->input_length = 0;
+            server->key_events++;
+        }
+    }
+}
+
+static void stream_flush(StreamClient *client)
+{
+    size_t written = 0;
+
+    while (written < client->output_length)
+    {
+        ssize_t result = send(client->fd, client->output + written, client->output_length - written,
+                              MSG_NOSIGNAL);
+        if (result < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+            {
+                stream_disconnect(client);
+                return;
+            }
+            break;
+        }
+        written += (size_t)result;
+    }
+
+    memmove(client->output, client->output + written, client->output_length - written);
+    client->output_length -= written;
+}
+
+/* Queues the current frame for one client; `bitmap` is the packed display */
+static void stream_queue_frame(StreamServer *server, StreamClient *client, const uint8_t *bitmap,
+                               int64_t produced_ns)
+{
+    static const uint8_t blank[STREAM_BITMAP_BYTES] = {0};
+    uint8_t payload[STREAM_MAX_PAYLOAD];
+
+    int key_frame = !client->has_frame;
+    size_t length = stream_encode_delta(key_frame ? blank : client->sent, bitmap, payload);
+
+    if (client->output_length + STREAM_HEADER_SIZE + length > sizeof(client->output))
+    {
+        server->frames_skipped++;
+        return;
+    }
+
+    uint8_t *header = client->output + client->output_length;
+    header[0] = 'F';
+    header[1] = key_frame ? STREAM_FLAG_KEY_FRAME : 0;
+    put_u16(header + 2, (uint16_t)length);
+    put_u32(header + 4, (uint32_t)server->frames);
+    put_u64(header + 8, (uint64_t)produced_ns);
+    put_u64(header + 16, client->input_ns);
+    memcpy(header + STREAM_HEADER_SIZE, payload, length);
+    client->output_length += STREAM_HEADER_SIZE + length;
+
+    memcpy(client->sent, bitmap, STREAM_BITMAP_BYTES);
+    client->sent_hash = chip8_memory.display_hash;
+    client->has_frame = 1;
+
+    server->frames_sent++;
+    server->bytes_sent += STREAM_HEADER_SIZE + length;
+}
+
+static void stream_publish(StreamServer *server)
+{
+    uint8_t bitmap[STREAM_BITMAP_BYTES];
+    int packed = 0;
+    int64_t produced_ns = frame_pacer_now_ns();
+
+    for (int i = 0; i < STREAM_MAX_CLIENTS; i++)
+    {
+        StreamClient *client = &server->clients[i];
+        if (client->fd < 0)
+            continue;
+
+        /* The display hash changes exactly when Dxyn/00E0 changed a pixel */
+        if (!client->has_frame || client->sent_hash != chip8_memory.display_hash)
+        {
+            if (!packed)
+            {
+                stream_pack_display(&chip8_memory, bitmap);
+                packed = 1;
+            }
+            stream_queue_frame(server, client, bitmap, produced_ns);
+        }
+
+        if (client->output_length > 0)
+            stream_flush(client);
+    }
+}
+
+static void stream_report(const StreamServer *server, double elapsed)
+{
+    fprintf(stderr,
+            "Stream: %lu frames in %.2f s, %lu sent (%lu skipped) to %lu clients, "
+            "%llu bytes (%.1f bytes/frame sent, %.1f bytes/frame emulated), %lu key events\n",
+            server->frames,
+            elapsed,
+            server->frames_sent,
+            server->frames_skipped,
+            server->clients_served,
+            server->bytes_sent,
+            server->frames_sent ? (double)server->bytes_sent / server->frames_sent : 0.0,
+            server->frames ? (double)server->bytes_sent / server->frames : 0.0,
+            server->key_events);
+}
+
+int stream_run(const StreamConfig *config)
+{
+    static StreamServer server;
+
+    memset(&server, 0, sizeof(server));
+    for (int i = 0; i < STREAM_MAX_CLIENTS; i++)
+        server.clients[i].fd = -1;
+
+    server.listen_fd = net_listen(config->endpoint, "stream", STREAM_MAX_CLIENTS, server.socket_path);
+    if (server.listen_fd < 0)
+        return -1;
+
+    if (server.socket_path[0] == '\0')
+        fprintf(stderr, "Stream: serving on 127.0.0.1:%s\n", config->endpoint);
+    else
+        fprintf(stderr, "Stream: serving on %s\n", config->endpoint);
+
+    stream_stopping = 0;
+    void (*previous_int)(int) = signal(SIGINT, stream_handle_signal);
+    void (*previous_term)(int) = signal(SIGTERM, stream_handle_signal);
+
+    FramePacer pacer;
+    frame_pacer_init(&pacer, CHIP8_FRAME_RATE, config->unpaced);
+    int64_t start = frame_pacer_now_ns();
+
+    while (!stream_stopping && (config->frames == 0 || server.frames < config->frames))
+    {
+        stream_accept(&server);
+        for (int i = 0; i < STREAM_MAX_CLIENTS; i++)
+        {
+            if (server.clients[i].fd >= 0)
+                stream_receive(&server, &server.clients[i]);
+        }
+
+        processor_frame();
+        server.frames++;
+        stream_publish(&server);
+
+        frame_pacer_wait(&pacer);
+    }
+
+    /* Give connected clients a last chance to receive what is queued */
+    for (int i = 0; i < STREAM_MAX_CLIENTS; i++)
+    {
+        StreamClient *client = &server.clients[i];
+        if (client->fd < 0)
+            continue;
+
+        fcntl(client->fd, F_SETFL, fcntl(client->fd, F_GETFL) & ~O_NONBLOCK);
+        stream_flush(client);
+        if (client->fd >= 0)
+            stream_disconnect(client);
+    }
+
+    signal(SIGINT, previous_int);
+    signal(SIGTERM, previous_term);
+    net_close(server.listen_fd, server.socket_path);
+
+    stream_report(&server, (frame_pacer_now_ns() - start) / 1e9);
+    frame_pacer_report(&pacer, stderr);
+    if (chip8_memory.fault)
+        fprintf(stderr, "CPU halted at 0x%03X: %s\n",
+                chip8_memory.program_counter, chip8_fault_name(chip8_memory.fault));
+    return 0;
+}
+
+#else
+
+int stream_run(const StreamConfig *config)
+{
+    (void)config;
+    fprintf(stderr, "ERROR: Frame streaming is not supported on this platform.\n");
+    return -1;
+}
+
+#endif
@@ -0,0 +1,397 @@
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "terminal_display.h"
+#include "chip8.h"
+#include "frame_pacer.h"
+#include "keymap.h"
+#include "metrics.h"
+#include "speed_control.h"
+
+/* Worst case per frame: every half-block cell with a cursor move each, and the status line */
+#define TERMINAL_OUTPUT_SIZE (CHIP8_WIDTH * CHIP8_HEIGHT / 2 * 12 + 1024)
+#define TERMINAL_STATUS_SIZE 256
+#define TERMINAL_UNKNOWN_CELL 0xFFFFu
+
+static TerminalStats terminal_stats;
+
+const TerminalStats *terminal_display_stats(void)
+{
+    return &terminal_stats;
+}
+
+#ifndef _WIN32
+
+#include <errno.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+typedef struct
+{
+    int active;
+    TerminalCells cells;
+    int columns, rows; /* Size of the display in cells */
+    struct termios saved_termios;
+    uint16_t shadow[CHIP8_HEIGHT][CHIP8_WIDTH]; /* Cell last written, or TERMINAL_UNKNOWN_CELL */
+    int key_hold[16];                           /* Frames left before each keypad key is released */
+    char status[TERMINAL_STATUS_SIZE];
+    int status_dirty;
+    char output[TERMINAL_OUTPUT_SIZE];
+    size_t length;
+} TerminalDisplay;
+
+static TerminalDisplay terminal;
+
+static void terminal_append(const char *data, size_t length)
+{
+    if (terminal.length + length <= sizeof(terminal.output))
+    {
+        memcpy(terminal.output + terminal.length, data, length);
+        terminal.length += length;
+    }
+}
+
+static void terminal_appendf(const char *format, ...)
+{
+    char text[32];
+    va_list args;
+
+    va_start(args, format);
+    int length = vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    terminal_append(text, (size_t)length);
+}
+
+static void terminal_flush(void)
+{
+    size_t written = 0;
+
+    while (written < terminal.length)
+    {
+        ssize_t n = write(STDOUT_FILENO, terminal.output + written, terminal.length - written);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            break;
+        written += (size_t)n;
+    }
+
+    terminal_stats.bytes_written += written;
+    terminal.length = 0;
+}
+
+static uint16_t terminal_cell(int row, int column)
+{
+    if (terminal.cells == TERMINAL_CELLS_HALF_BLOCKS)
+    {
+        return (uint16_t)((chip8_memory.display[2 * row][column] != 0) |
+                          (chip8_memory.display[2 * row + 1][column] != 0) << 1);
+    }
+
+    /* Braille dots 1–3 and 7 are the left column top to bottom, 4–6 and 8 the right */
+    static const uint8_t dots[4][2] = {{0x01, 0x08}, {0x02, 0x10}, {0x04, 0x20}, {0x40, 0x80}};
+    uint16_t cell = 0;
+
+    for (int y = 0; y < 4; y++)
+    {
+        for (int x = 0; x < 2; x++)
+        {
+            if (chip8_memory.display[4 * row + y][2 * column + x])
+                cell |= dots[y][x];
+        }
+    }
+    return cell;
+}
+
+/* Appends the UTF-8 encoding of a cell; always 1 byte (space) or 3 bytes */
+static void terminal_append_cell(uint16_t cell)
+{
+    static const char *const half_blocks[4] = {" ", "\xE2\x96\x80", "\xE2\x96\x84", "\xE2\x96\x88"};
+
+    if (terminal.cells == TERMINAL_CELLS_HALF_BLOCKS)
+    {
+        terminal_append(half_blocks[cell], cell ? 3 : 1);
+        return;
+    }
+
+    unsigned int code_point = 0x2800u + cell;
+    char utf8[3] = {(char)(0xE0u | (code_point >> 12)),
+                    (char)(0x80u | ((code_point >> 6) & 0x3Fu)),
+                    (char)(0x80u | (code_point & 0x3Fu))};
+    terminal_append(utf8, sizeof(utf8));
+}
+
+static int terminal_cell_bytes(uint16_t cell)
+{
+    return (terminal.cells == TERMINAL_CELLS_HALF_BLOCKS && cell == 0) ? 1 : 3;
+}
+
+static void terminal_draw_row(int row, const uint16_t *cells)
+{
+    int cursor = -1; /* Column the cursor is at in this row, if known */
+
+    for (int column = 0; column < terminal.columns; column++)
+    {
+        if (cells[column] == terminal.shadow[row][column])
+            continue;
+
+        if (cursor < 0)
+        {
+            terminal_appendf("\x1b[%d;%dH", row + 1, column + 1);
+        }
+        else if (cursor < column)
+        {
+            /* Rewrite the unchanged gap if that is shorter than moving over it */
+            int gap_bytes = 0;
+            for (int c = cursor; c < column; c++)
+                gap_bytes += terminal_cell_bytes(cells[c]);
+
+            int move_bytes = snprintf(NULL, 0, "\x1b[%dC", column - cursor);
+            if (gap_bytes <= move_bytes)
+            {
+                for (int c = cursor; c < column; c++)
+                    terminal_append_cell(cells[c]);
+            }
+            else
+            {
+                terminal_appendf("\x1b[%dC", column - cursor);
+            }
+        }
+
+        terminal_append_cell(cells[column]);
+        terminal.shadow[row][column] = cells[column];
+        terminal_stats.cells_written++;
+        cursor = column + 1;
+    }
+}
+
+static void terminal_draw_status(void)
+{
+    terminal_appendf("\x1b[%d;%dH\x1b[2K", terminal.rows + 1, 1);
+
+    for (const char *c = terminal.status; *c; c++)
+        terminal_append(*c == '\n' ? "  " : c, *c == '\n' ? 2 : 1);
+
+    terminal.status_dirty = 0;
+}
+
+void terminal_display_update(void)
+{
+    int64_t start_ns = frame_pacer_now_ns();
+    uint16_t cells[CHIP8_WIDTH];
+
+    if (!terminal.active)
+        return;
+
+    for (int row = 0; row < terminal.rows; row++)
+    {
+        for (int column = 0; column < terminal.columns; column++)
+            cells[column] = terminal_cell(row, column);
+        terminal_draw_row(row, cells);
+    }
+
+    if (terminal.status_dirty)
+        terminal_draw_status();
+
+    int64_t present_ns = frame_pacer_now_ns();
+    terminal_flush();
+    int64_t end_ns = frame_pacer_now_ns();
+
+    terminal_stats.updates++;
+    metrics_frontend.display_updates++;
+    metrics_frontend.display_update_ns += end_ns - start_ns;
+    metrics_frontend.present_ns += end_ns - present_ns;
+}
+
+void terminal_display_set_status(const char *text)
+{
+    if (text == NULL)
+        text = "";
+
+    if (strncmp(terminal.status, text, sizeof(terminal.status) - 1) == 0)
+        return;
+
+    strncpy(terminal.status, text, sizeof(terminal.status) - 1);
+    terminal.status[sizeof(terminal.status) - 1] = '\0';
+    terminal.status_dirty = 1;
+}
+
+static void terminal_redraw(void)
+{
+    for (int row = 0; row < CHIP8_HEIGHT; row++)
+        for (int column = 0; column < CHIP8_WIDTH; column++)
+            terminal.shadow[row][column] = TERMINAL_UNKNOWN_CELL;
+
+    terminal_append("\x1b[2J", 4);
+    terminal.status_dirty = 1;
+}
+
+/* Handles the bytes of one read(); returns 1 if quit was requested */
+static int terminal_handle_input(const unsigned char *input, ssize_t length)
+{
+    for (ssize_t i = 0; i < length; i++)
+    {
+        unsigned char c = input[i];
+        metrics_frontend.input_events++;
+
+        if (c == 0x03)
+            return 1;
+
+        /* A lone Esc quits; Esc starting a sequence (arrow keys, ...) is skipped */
+        if (c == 0x1B)
+        {
+            if (length == 1)
+                return 1;
+            break;
+        }
+
+        if (c == 0x0C)
+        {
+            terminal_redraw();
+            continue;
+        }
+
+        int key = keymap_lookup(c);
+        if (key >= 0)
+        {
+            chip8_set_key((uint8_t)key, 1);
+            terminal.key_hold[key] = TERMINAL_KEY_HOLD_FRAMES;
+        }
+        else
+        {
+            speed_control_key(c, 1, 0);
+        }
+    }
+
+    return 0;
+}
+
+int terminal_display_process_input(void)
+{
+    unsigned char input[64];
+    ssize_t length;
+
+    /* Release keys first, so a key repeated this frame stays down */
+    for (uint8_t key = 0; key < 16; key++)
+    {
+        if (terminal.key_hold[key] > 0 && --terminal.key_hold[key] == 0)
+            chip8_set_key(key, 0);
+    }
+
+    while ((length = read(STDIN_FILENO, input, sizeof(input))) > 0)
+    {
+        if (terminal_handle_input(input, length))
+            return 1;
+    }
+
+    return 0;
+}
+
+int terminal_display_wait_input(int timeout_ms)
+{
+    struct pollfd pfd = {.fd = STDIN_FILENO, .events = POLLIN};
+
+    if (poll(&pfd, 1, timeout_ms) < 0 && errno != EINTR)
+        return 0;
+
+    return terminal_display_process_input();
+}
+
+static void terminal_restore(void)
+{
+    if (!terminal.active)
+        return;
+
+    terminal_append("\x1b[0m\x1b[?25h\x1b[?1049l", 19);
+    terminal_flush();
+    tcsetattr(STDIN_FILENO, TCSAFLUSH, &terminal.saved_termios);
+    terminal.active = 0;
+}
+
+int terminal_display_init(TerminalCells cells)
+{
+    if (!isatty(STDIN_FILENO) || !isatty(STDOUT_FILENO))
+    {
+        fprintf(stderr, "ERROR: The terminal display needs a terminal on stdin and stdout.\n");
+        return -1;
+    }
+
+    if (tcgetattr(STDIN_FILENO, &terminal.saved_termios) != 0)
+    {
+        perror("tcgetattr");
+        return -1;
+    }
+
+    /* Raw input: no echo, no line buffering, no signals from Ctrl-C; reads never block */
+    struct termios raw = terminal.saved_termios;
+    raw.c_iflag &= ~(tcflag_t)(IXON | ICRNL | BRKINT | INPCK | ISTRIP);
+    raw.c_lflag &= ~(tcflag_t)(ECHO | ICANON | ISIG | IEXTEN);
+    raw.c_cc[VMIN] = 0;
+    raw.c_cc[VTIME] = 0;
+
+    if (tcsetattr(STDIN_FILENO, TCSAFLUSH, &raw) != 0)
+    {
+        perror("tcsetattr");
+        return -1;
+    }
+
+    terminal.cells = cells;
+    terminal.columns = cells == TERMINAL_CELLS_BRAILLE ? CHIP8_WIDTH / 2 : CHIP8_WIDTH;
+    terminal.rows = cells == TERMINAL_CELLS_BRAILLE ? CHIP8_HEIGHT / 4 : CHIP8_HEIGHT / 2;
+    memset(terminal.key_hold, 0, sizeof(terminal.key_hold));
+    terminal.active = 1;
+
+    static int registered = 0;
+    if (!registered)
+    {
+        atexit(terminal_restore);
+        registered = 1;
+    }
+
+    terminal_append("\x1b[?1049h\x1b[?25l", 14);
+    terminal_redraw();
+    terminal_flush();
+    return 0;
+}
+
+void terminal_display_destroy(void)
+{
+    terminal_restore();
+}
+
+#else
+
+int terminal_display_init(TerminalCells cells)
+{
+    (void)cells;
+    fprintf(stderr, "ERROR: The terminal display is not supported on this platform.\n");
+    return -1;
+}
+
+void terminal_display_update(void)
+{
+}
+
+void terminal_display_set_status(const char *text)
+{
+    (void)text;
+}
+
+int terminal_display_process_input(void)
+{
+    return 0;
+}
+
+int terminal_display_wait_input(int timeout_ms)
+{
+    (void)timeout_ms;
+    return 0;
+}
+
+void terminal_display_destroy(void)
+{
+}
+
+#endif
@@ -0,0 +1,383 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "vec_env.h"
+#include "chip8.h"
+#include "processor.h"
+
+#define VEC_ENV_FRAME_SIZE (CHIP8_HEIGHT * CHIP8_WIDTH)
+
+typedef enum
+{
+    VEC_ENV_COMMAND_RESET,
+    VEC_ENV_COMMAND_STEP
+} VecEnvCommand;
+
+typedef struct
+{
+    VecEnv *env;
+    pthread_t thread;
+    int first;
+    int count;
+} VecEnvWorker;
+
+struct VecEnv
+{
+    VecEnvConfig config;
+    VecEnvRewardSource *rewards;
+
+    MEMORY pristine;
+    MEMORY *vms;
+    unsigned long *episode_frames;
+    uint32_t *episodes;
+
+    /* Arguments of the command being executed */
+    VecEnvCommand command;
+    const uint16_t *actions;
+    float *reward_out;
+    uint8_t *done_out;
+    uint8_t *observations;
+
+    VecEnvWorker *workers;
+    int worker_count;
+    int threads_started;
+    unsigned long generation;
+    int pending;
+    int stopping;
+
+    pthread_mutex_t lock;
+    pthread_cond_t start;
+    pthread_cond_t finished;
+};
+
+static int64_t vec_env_counter(const MEMORY *vm, const VecEnvRewardSource *source)
+{
+    int64_t value = 0;
+
+    for (int i = 0; i < source->bytes; i++)
+    {
+        uint8_t byte = vm->ram[source->address + i];
+        value = source->bcd ? value * 10 + byte : (value << 8) | byte;
+    }
+    return value;
+}
+
+static void vec_env_observe(const MEMORY *vm, uint8_t *restrict out)
+{
+    const uint32_t *restrict pixels = &vm->display[0][0];
+
+    /* Flat and branch-free so the compiler can vectorize the narrowing */
+    for (int i = 0; i < VEC_ENV_FRAME_SIZE; i++)
+        out[i] = (uint8_t)(pixels[i] != 0);
+}
+
+/* Resets the environment chip8_vm points at */
+static void vec_env_reset_one(VecEnv *env, int i)
+{
+    memcpy(chip8_vm, &env->pristine, sizeof(MEMORY));
+    chip8_seed(env->config.seed ^ ((uint32_t)i * 0x9E3779B9u) ^ (env->episodes[i] * 0x85EBCA6Bu));
+
+    env->episodes[i]++;
+    env->episode_frames[i] = 0;
+}
+
+/* Steps the environment chip8_vm points at; returns 1 if its episode ended */
+static int vec_env_step_one(VecEnv *env, int i, uint16_t action, float *reward)
+{
+    int64_t before[VEC_ENV_MAX_REWARDS];
+
+    for (int r = 0; r < env->config.reward_count; r++)
+        before[r] = vec_env_counter(chip8_vm, &env->rewards[r]);
+
+    for (uint8_t key = 0; key < 16; key++)
+        chip8_set_key(key, (action >> key) & 1u);
+
+    /* The keys hold for the whole step, so idle frames are skipped in bulk */
+    for (int f = 0; f < env->config.frame_skip && !chip8_memory.fault;)
+    {
+        unsigned int ran;
+        processor_frames((unsigned int)(env->config.frame_skip - f), &ran, NULL);
+        f += (int)ran;
+        env->episode_frames[i] += ran;
+    }
+
+    float total = 0.0f;
+    for (int r = 0; r < env->config.reward_count; r++)
+    {
+        int64_t delta = vec_env_counter(chip8_vm, &env->rewards[r]) - before[r];
+        total += env->rewards[r].scale * (float)delta;
+    }
+    *reward = total;
+
+    return chip8_memory.fault ||
+           (env->config.max_episode_frames &&
+            env->episode_frames[i] >= env->config.max_episode_frames);
+}
+
+static void vec_env_run_slice(VecEnv *env, int first, int count)
+{
+    for (int i = first; i < first + count; i++)
+    {
+        chip8_vm = &env->vms[i];
+
+        if (env->command == VEC_ENV_COMMAND_RESET)
+        {
+            vec_env_reset_one(env, i);
+        }
+        else
+        {
+            float reward;
+            int done = vec_env_step_one(env, i, env->actions[i], &reward);
+
+            if (done)
+                vec_env_reset_one(env, i);
+            if (env->reward_out)
+                env->reward_out[i] = reward;
+            if (env->done_out)
+                env->done_out[i] = (uint8_t)done;
+        }
+
+        if (env->observations)
+            vec_env_observe(&env->vms[i], env->observations + (size_t)i * VEC_ENV_FRAME_SIZE);
+    }
+}
+
+static void *vec_env_worker(void *arg)
+{
+    VecEnvWorker *worker = arg;
+    VecEnv *env = worker->env;
+    unsigned long seen = 0;
+
+    for (;;)
+    {
+        pthread_mutex_lock(&env->lock);
+        while (env->generation == seen && !env->stopping)
+            pthread_cond_wait(&env->start, &env->lock);
+
+        if (env->stopping)
+        {
+            pthread_mutex_unlock(&env->lock);
+            break;
+        }
+        seen = env->generation;
+        pthread_mutex_unlock(&env->lock);
+
+        vec_env_run_slice(env, worker->first, worker->count);
+
+        pthread_mutex_lock(&env->lock);
+        if (--env->pending == 0)
+            pthread_cond_signal(&env->finished);
+        pthread_mutex_unlock(&env->lock);
+    }
+
+    return NULL;
+}
+
+/* Runs the current command on every environment; worker 0 is the caller */
+static void vec_env_dispatch(VecEnv *env)
+{
+    MEMORY *caller_vm = chip8_vm;
+
+    if (env->worker_count > 1)
+    {
+        pthread_mutex_lock(&env->lock);
+        env->generation++;
+        env->pending = env->worker_count - 1;
+        pthread_cond_broadcast(&env->start);
+        pthread_mutex_unlock(&env->lock);
+    }
+
+    vec_env_run_slice(env, env->workers[0].first, env->workers[0].count);
+
+    if (env->worker_count > 1)
+    {
+        pthread_mutex_lock(&env->lock);
+        while (env->pending > 0)
+            pthread_cond_wait(&env->finished, &env->lock);
+        pthread_mutex_unlock(&env->lock);
+    }
+
+    chip8_vm = caller_vm;
+}
+
+static int vec_env_default_threads(void)
+{
+#ifdef _SC_NPROCESSORS_ONLN
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    return cpus > 0 ? (int)cpus : 1;
+#else
+    return 1;
+#endif
+}
+
+static int vec_env_validate(const VecEnvConfig *config)
+{
+    if (config->num_envs <= 0)
+    {
+        fprintf(stderr, "ERROR: num_envs must be positive.\n");
+        return -1;
+    }
+
+    if (config->reward_count < 0 || config->reward_count > VEC_ENV_MAX_REWARDS)
+    {
+        fprintf(stderr, "ERROR: At most %d reward sources are supported.\n", VEC_ENV_MAX_REWARDS);
+        return -1;
+    }
+
+    for (int r = 0; r < config->reward_count; r++)
+    {
+        const VecEnvRewardSource *source = &config->rewards[r];
+        int max_bytes = source->bcd ? 9 : 4;
+
+        if (source->bytes < 1 || source->bytes > max_bytes ||
+            source->address + source->bytes > sizeof(((MEMORY *)0)->ram))
+        {
+            fprintf(stderr, "ERROR: Invalid reward source at 0x%03X.\n", source->address);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+VecEnv *vec_env_create(const char *rom_path, const VecEnvConfig *config)
+{
+    if (vec_env_validate(config) != 0)
+        return NULL;
+
+    VecEnv *env = calloc(1, sizeof(VecEnv));
+    if (env == NULL)
+    {
+        fprintf(stderr, "ERROR: Out of memory while creating environments.\n");
+        return NULL;
+    }
+
+    env->config = *config;
+    if (env->config.frame_skip < 1)
+        env->config.frame_skip = 1;
+
+    int threads = config->num_threads > 0 ? config->num_threads : vec_env_default_threads();
+    if (threads > config->num_envs)
+        threads = config->num_envs;
+
+    size_t n = (size_t)config->num_envs;
+    env->vms = calloc(n, sizeof(MEMORY));
+    env->episode_frames = calloc(n, sizeof(unsigned long));
+    env->episodes = calloc(n, sizeof(uint32_t));
+    env->workers = calloc((size_t)threads, sizeof(VecEnvWorker));
+    env->rewards = calloc(config->reward_count > 0 ? (size_t)config->reward_count : 1,
+                          sizeof(VecEnvRewardSource));
+
+    if (env->vms == NULL || env->episode_frames == NULL || env->episodes == NULL ||
+        env->workers == NULL || env->rewards == NULL)
+    {
+        fprintf(stderr, "ERROR: Out of memory while creating environments.\n");
+        vec_env_destroy(env);
+        return NULL;
+    }
+
+    if (config->reward_count > 0)
+        memcpy(env->rewards, config->rewards, (size_t)config->reward_count * sizeof(VecEnvRewardSource));
+    env->config.rewards = env->rewards;
+
+    /* Build the pristine snapshot in place, without touching the caller's machine */
+    MEMORY *caller_vm = chip8_vm;
+    chip8_vm = &env->pristine;
+    chip8_init();
+    int loaded = chip8_load_ROM(rom_path);
+    chip8_vm = caller_vm;
+
+    if (loaded != 0)
+    {
+        vec_env_destroy(env);
+        return NULL;
+    }
+
+    pthread_mutex_init(&env->lock, NULL);
+    pthread_cond_init(&env->start, NULL);
+    pthread_cond_init(&env->finished, NULL);
+    env->threads_started = 1;
+
+    /* Spread the remainder so slices differ in size by at most one */
+    int first = 0;
+    for (int t = 0; t < threads; t++)
+    {
+        VecEnvWorker *worker = &env->workers[t];
+        worker->env = env;
+        worker->first = first;
+        worker->count = config->num_envs / threads + (t < config->num_envs % threads);
+        first += worker->count;
+    }
+
+    env->worker_count = 1;
+    for (int t = 1; t < threads; t++)
+    {
+        if (pthread_create(&env->workers[t].thread, NULL, vec_env_worker, &env->workers[t]) != 0)
+        {
+            fprintf(stderr, "ERROR: Failed to start environment worker thread.\n");
+            vec_env_destroy(env);
+            return NULL;
+        }
+        env->worker_count++;
+    }
+
+    vec_env_reset(env, NULL);
+    return env;
+}
+
+void vec_env_reset(VecEnv *env, uint8_t *observations)
+{
+    env->command = VEC_ENV_COMMAND_RESET;
+    env->observations = observations;
+    vec_env_dispatch(env);
+}
+
+void vec_env_step(VecEnv *env, const uint16_t *actions, float *rewards,
+                  uint8_t *dones, uint8_t *observations)
+{
+    env->command = VEC_ENV_COMMAND_STEP;
+    env->actions = actions;
+    env->reward_out = rewards;
+    env->done_out = dones;
+    env->observations = observations;
+    vec_env_dispatch(env);
+}
+
+int vec_env_num_envs(const VecEnv *env)
+{
+    return env->config.num_envs;
+}
+
+MEMORY *vec_env_get(VecEnv *env, int i)
+{
+    return (i >= 0 && i < env->config.num_envs) ? &env->vms[i] : NULL;
+}
+
+void vec_env_destroy(VecEnv *env)
+{
+    if (env == NULL)
+        return;
+
+    if (env->threads_started)
+    {
+        pthread_mutex_lock(&env->lock);
+        env->stopping = 1;
+        pthread_cond_broadcast(&env->start);
+        pthread_mutex_unlock(&env->lock);
+
+        for (int t = 1; t < env->worker_count; t++)
+            pthread_join(env->workers[t].thread, NULL);
+
+        pthread_cond_destroy(&env->finished);
+        pthread_cond_destroy(&env->start);
+        pthread_mutex_destroy(&env->lock);
+    }
+
+    free(env->vms);
+    free(env->episode_frames);
+    free(env->episodes);
+    free(env->workers);
+    free(env->rewards);
+    free(env);
+}
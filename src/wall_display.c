@@ -0,0 +1,318 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <SDL2/SDL.h>
+#include "wall_display.h"
+#include "keymap.h"
+
+/* Grid lines and the focus outline */
+#define WALL_GRID_GRAY 48
+#define WALL_FOCUS_WIDTH 2
+
+typedef struct
+{
+    SDL_Window *window;
+    SDL_Renderer *renderer;
+    SDL_Texture *texture;
+    const char *title;
+    int sessions;
+    int columns;
+    int rows;
+    int scale;
+    uint32_t *atlas;
+    uint8_t *dirty; /* One flag per grid cell, row-major */
+    int dirty_count;
+    int redraw;
+    int focus;
+    uint8_t held[16];
+    WallKeyFunc on_key;
+    void *context;
+} WallDisplay;
+
+static WallDisplay wall;
+static WallStats wall_stats;
+
+const WallStats *wall_display_stats(void)
+{
+    return &wall_stats;
+}
+
+static void wall_display_set_title(void)
+{
+    char title[128];
+
+    snprintf(title, sizeof(title), "%s — %d sessions, session %d focused", wall.title, wall.sessions, wall.focus);
+    SDL_SetWindowTitle(wall.window, title);
+}
+
+int wall_display_init(const char *title, int vsync, int sessions, WallKeyFunc on_key, void *context)
+{
+    if (sessions < 1 || sessions > WALL_MAX_SESSIONS)
+    {
+        fprintf(stderr, "ERROR: A wall shows 1 to %d sessions.\n", WALL_MAX_SESSIONS);
+        return -1;
+    }
+
+    memset(&wall, 0, sizeof(wall));
+    wall.title = title;
+    wall.sessions = sessions;
+    wall.on_key = on_key;
+    wall.context = context;
+
+    /* A square grid of 2:1 tiles, so the window is 2:1 too */
+    while (wall.columns * wall.columns < sessions)
+        wall.columns++;
+    wall.rows = (sessions + wall.columns - 1) / wall.columns;
+    wall.scale = WALL_WINDOW_WIDTH / (wall.columns * CHIP8_WIDTH);
+    if (wall.scale < 1)
+        wall.scale = 1;
+
+    int atlas_width = wall.columns * CHIP8_WIDTH;
+    int atlas_height = wall.rows * CHIP8_HEIGHT;
+
+    wall.atlas = calloc((size_t)atlas_width * atlas_height, sizeof(uint32_t));
+    wall.dirty = calloc((size_t)wall.columns * wall.rows, sizeof(uint8_t));
+    if (wall.atlas == NULL || wall.dirty == NULL)
+    {
+        fprintf(stderr, "ERROR: Out of memory.\n");
+        free(wall.atlas);
+        free(wall.dirty);
+        return -1;
+    }
+
+    if (SDL_Init(SDL_INIT_VIDEO) < 0)
+    {
+        fprintf(stderr, "ERROR: SDL_Init failed: %s\n", SDL_GetError());
+        free(wall.atlas);
+        free(wall.dirty);
+        return -1;
+    }
+
+    wall.window = SDL_CreateWindow(title, SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
+                                   atlas_width * wall.scale, atlas_height * wall.scale, SDL_WINDOW_SHOWN);
+    if (wall.window)
+        wall.renderer = SDL_CreateRenderer(wall.window, -1,
+                                           SDL_RENDERER_ACCELERATED | (vsync ? SDL_RENDERER_PRESENTVSYNC : 0));
+    if (wall.renderer)
+        wall.texture = SDL_CreateTexture(wall.renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_STREAMING,
+                                         atlas_width, atlas_height);
+    if (!wall.texture)
+    {
+        fprintf(stderr, "ERROR: Could not open the wall window: %s\n", SDL_GetError());
+        wall_display_destroy();
+        return -1;
+    }
+
+    /* The texture starts undefined: upload every cell once, empty ones included */
+    memset(wall.dirty, 1, (size_t)wall.columns * wall.rows);
+    wall.dirty_count = wall.columns * wall.rows;
+    wall.redraw = 1;
+    wall_display_set_title();
+    return 0;
+}
+
+void wall_display_update(int session, const uint32_t display[CHIP8_HEIGHT][CHIP8_WIDTH])
+{
+    int atlas_width = wall.columns * CHIP8_WIDTH;
+    int row = session / wall.columns;
+    uint32_t *tile = wall.atlas + (size_t)row * CHIP8_HEIGHT * atlas_width + (session % wall.columns) * CHIP8_WIDTH;
+
+    for (int y = 0; y < CHIP8_HEIGHT; y++)
+        memcpy(tile + (size_t)y * atlas_width, display[y], sizeof(display[y]));
+
+    if (!wall.dirty[session])
+    {
+        wall.dirty[session] = 1;
+        wall.dirty_count++;
+    }
+    wall.redraw = 1;
+    wall_stats.tile_updates++;
+}
+
+static void wall_display_draw_grid(void)
+{
+    int tile_width = CHIP8_WIDTH * wall.scale;
+    int tile_height = CHIP8_HEIGHT * wall.scale;
+    int width = wall.columns * tile_width;
+    int height = wall.rows * tile_height;
+
+    SDL_SetRenderDrawColor(wall.renderer, WALL_GRID_GRAY, WALL_GRID_GRAY, WALL_GRID_GRAY, 255);
+    for (int column = 1; column < wall.columns; column++)
+        SDL_RenderDrawLine(wall.renderer, column * tile_width, 0, column * tile_width, height - 1);
+    for (int row = 1; row < wall.rows; row++)
+        SDL_RenderDrawLine(wall.renderer, 0, row * tile_height, width - 1, row * tile_height);
+
+    SDL_Rect outline = {
+        (wall.focus % wall.columns) * tile_width,
+        (wall.focus / wall.columns) * tile_height,
+        tile_width,
+        tile_height,
+    };
+
+    SDL_SetRenderDrawColor(wall.renderer, 0, 255, 0, 255);
+    for (int i = 0; i < WALL_FOCUS_WIDTH; i++)
+    {
+        SDL_RenderDrawRect(wall.renderer, &outline);
+        outline.x++;
+        outline.y++;
+        outline.w -= 2;
+        outline.h -= 2;
+    }
+
+    SDL_SetRenderDrawColor(wall.renderer, 0, 0, 0, 255);
+}
+
+/* Uploads each run of dirty cells in a grid row as one rectangle, and clears the flags */
+static void wall_display_upload(void)
+{
+    int atlas_width = wall.columns * CHIP8_WIDTH;
+
+    for (int row = 0; row < wall.rows && wall.dirty_count > 0; row++)
+    {
+        uint8_t *dirty = wall.dirty + (size_t)row * wall.columns;
+
+        for (int column = 0; column < wall.columns; column++)
+        {
+            if (!dirty[column])
+                continue;
+
+            int first = column;
+            while (column < wall.columns && dirty[column])
+                dirty[column++] = 0;
+
+            SDL_Rect rect = {
+                first * CHIP8_WIDTH,
+                row * CHIP8_HEIGHT,
+                (column - first) * CHIP8_WIDTH,
+                CHIP8_HEIGHT,
+            };
+
+            SDL_UpdateTexture(wall.texture, &rect, wall.atlas + (size_t)rect.y * atlas_width + rect.x,
+                              atlas_width * (int)sizeof(uint32_t));
+            wall.dirty_count -= column - first;
+            wall_stats.uploads++;
+            wall_stats.bytes_uploaded += (unsigned long long)rect.w * rect.h * sizeof(uint32_t);
+        }
+    }
+}
+
+void wall_display_present(void)
+{
+    if (!wall.redraw)
+        return;
+
+    if (wall.dirty_count > 0)
+        wall_display_upload();
+
+    SDL_RenderClear(wall.renderer);
+    SDL_RenderCopy(wall.renderer, wall.texture, NULL, NULL);
+    wall_display_draw_grid();
+    SDL_RenderPresent(wall.renderer);
+
+    wall.redraw = 0;
+    wall_stats.presents++;
+}
+
+static void wall_display_set_focus(int session)
+{
+    if (session == wall.focus || session < 0 || session >= wall.sessions)
+        return;
+
+    /* The old session would otherwise keep a key down forever */
+    for (uint8_t key = 0; key < 16; key++)
+    {
+        if (wall.held[key])
+        {
+            wall.on_key(wall.focus, key, 0, wall.context);
+            wall.held[key] = 0;
+        }
+    }
+
+    wall.focus = session;
+    wall.redraw = 1;
+    wall_display_set_title();
+}
+
+static int wall_display_handle_event(const SDL_Event *event)
+{
+    switch (event->type)
+    {
+    case SDL_QUIT:
+        return 1;
+    case SDL_MOUSEBUTTONDOWN:
+        if (event->button.button == SDL_BUTTON_LEFT)
+        {
+            int column = event->button.x / (CHIP8_WIDTH * wall.scale);
+            int row = event->button.y / (CHIP8_HEIGHT * wall.scale);
+            if (column < wall.columns)
+                wall_display_set_focus(row * wall.columns + column);
+        }
+        break;
+    case SDL_WINDOWEVENT:
+        if (event->window.event == SDL_WINDOWEVENT_EXPOSED)
+            wall.redraw = 1;
+        break;
+    case SDL_KEYDOWN:
+    case SDL_KEYUP:
+    {
+        if (event->type == SDL_KEYDOWN && event->key.keysym.sym == SDLK_ESCAPE)
+            return 1;
+
+        int key = keymap_lookup(event->key.keysym.sym);
+        uint8_t pressed = event->type == SDL_KEYDOWN;
+        if (key >= 0 && !event->key.repeat)
+        {
+            wall.held[key] = pressed;
+            wall.on_key(wall.focus, (uint8_t)key, pressed, wall.context);
+        }
+        break;
+    }
+    }
+
+    return 0;
+}
+
+int wall_display_wait_input(int timeout_ms)
+{
+    SDL_Event event;
+
+    if (timeout_ms != 0)
+    {
+        int received = (timeout_ms < 0) ? SDL_WaitEvent(&event) : SDL_WaitEventTimeout(&event, timeout_ms);
+        if (received && wall_display_handle_event(&event))
+            return 1;
+    }
+
+    while (SDL_PollEvent(&event))
+    {
+        if (wall_display_handle_event(&event))
+            return 1;
+    }
+
+    return 0;
+}
+
+int wall_display_focus(void)
+{
+    return wall.focus;
+}
+
+void wall_display_destroy(void)
+{
+    if (wall_stats.presents > 0)
+        fprintf(stderr, "Wall: %llu presents, %llu tile updates, %.1f uploads and %.1f KB per present\n",
+                wall_stats.presents, wall_stats.tile_updates, (double)wall_stats.uploads / wall_stats.presents,
+                (double)wall_stats.bytes_uploaded / wall_stats.presents / 1024.0);
+
+    if (wall.texture)
+        SDL_DestroyTexture(wall.texture);
+    if (wall.renderer)
+        SDL_DestroyRenderer(wall.renderer);
+    if (wall.window)
+        SDL_DestroyWindow(wall.window);
+    SDL_Quit();
+
+    free(wall.atlas);
+    free(wall.dirty);
+    memset(&wall, 0, sizeof(wall));
+}
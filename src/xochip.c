@@ -0,0 +1,719 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "xochip.h"
+#include "memory.h"
+#include "processor.h"
+
+#define XOCHIP_BIG_FONT_ADDRESS (FONTSET_START_ADDRESS + FONTSET_SIZE)
+#define XOCHIP_PATTERN_BITS 128
+
+/* Same small font as chip8.c, followed by the 8×10 SUPER-CHIP digits */
+static const uint8_t xochip_small_font[FONTSET_SIZE] = {
+    0xF0, 0x90, 0x90, 0x90, 0xF0, 0x20, 0x60, 0x20, 0x20, 0x70, // 0 1
+    0xF0, 0x10, 0xF0, 0x80, 0xF0, 0xF0, 0x10, 0xF0, 0x10, 0xF0, // 2 3
+    0x90, 0x90, 0xF0, 0x10, 0x10, 0xF0, 0x80, 0xF0, 0x10, 0xF0, // 4 5
+    0xF0, 0x80, 0xF0, 0x90, 0xF0, 0xF0, 0x10, 0x20, 0x40, 0x40, // 6 7
+    0xF0, 0x90, 0xF0, 0x90, 0xF0, 0xF0, 0x90, 0xF0, 0x10, 0xF0, // 8 9
+    0xF0, 0x90, 0xF0, 0x90, 0x90, 0xE0, 0x90, 0xE0, 0x90, 0xE0, // A B
+    0xF0, 0x80, 0x80, 0x80, 0xF0, 0xE0, 0x90, 0x90, 0x90, 0xE0, // C D
+    0xF0, 0x80, 0xF0, 0x80, 0xF0, 0xF0, 0x80, 0xF0, 0x80, 0x80  // E F
+};
+
+static const uint8_t xochip_big_font[16 * 10] = {
+    0xFF, 0xFF, 0xC3, 0xC3, 0xC3, 0xC3, 0xC3, 0xC3, 0xFF, 0xFF, // 0
+    0x18, 0x78, 0x78, 0x18, 0x18, 0x18, 0x18, 0x18, 0xFF, 0xFF, // 1
+    0xFF, 0xFF, 0x03, 0x03, 0xFF, 0xFF, 0xC0, 0xC0, 0xFF, 0xFF, // 2
+    0xFF, 0xFF, 0x03, 0x03, 0xFF, 0xFF, 0x03, 0x03, 0xFF, 0xFF, // 3
+    0xC3, 0xC3, 0xC3, 0xC3, 0xFF, 0xFF, 0x03, 0x03, 0x03, 0x03, // 4
+    0xFF, 0xFF, 0xC0, 0xC0, 0xFF, 0xFF, 0x03, 0x03, 0xFF, 0xFF, // 5
+    0xFF, 0xFF, 0xC0, 0xC0, 0xFF, 0xFF, 0xC3, 0xC3, 0xFF, 0xFF, // 6
+    0xFF, 0xFF, 0x03, 0x03, 0x06, 0x0C, 0x18, 0x18, 0x18, 0x18, // 7
+    0xFF, 0xFF, 0xC3, 0xC3, 0xFF, 0xFF, 0xC3, 0xC3, 0xFF, 0xFF, // 8
+    0xFF, 0xFF, 0xC3, 0xC3, 0xFF, 0xFF, 0x03, 0x03, 0xFF, 0xFF, // 9
+    0x7E, 0xFF, 0xC3, 0xC3, 0xC3, 0xFF, 0xFF, 0xC3, 0xC3, 0xC3, // A
+    0xFC, 0xFC, 0xC3, 0xC3, 0xFC, 0xFC, 0xC3, 0xC3, 0xFC, 0xFC, // B
+    0x3C, 0xFF, 0xC3, 0xC0, 0xC0, 0xC0, 0xC0, 0xC3, 0xFF, 0x3C, // C
+    0xFC, 0xFE, 0xC3, 0xC3, 0xC3, 0xC3, 0xC3, 0xC3, 0xFE, 0xFC, // D
+    0xFF, 0xFF, 0xC0, 0xC0, 0xFF, 0xFF, 0xC0, 0xC0, 0xFF, 0xFF, // E
+    0xFF, 0xFF, 0xC0, 0xC0, 0xFF, 0xFF, 0xC0, 0xC0, 0xC0, 0xC0  // F
+};
+
+/* Octo's XO-CHIP colours: background, plane 0, plane 1, both planes */
+static const uint32_t xochip_palette[4] = {0x996600FFu, 0xFFCC00FFu, 0xFF6600FFu, 0x662200FFu};
+
+XoChip *xochip_create(uint32_t seed)
+{
+    XoChip *machine = calloc(1, sizeof(XoChip));
+    if (machine == NULL)
+        return NULL;
+
+    machine->pc = START_ADDRESS;
+    machine->planes = 1;
+    machine->pitch = 64;
+    machine->rng_state = seed ? seed : 0x2545F491u;
+
+    /* Until a program loads its own pattern, the beeper is a square wave */
+    memset(machine->pattern, 0xF0, sizeof(machine->pattern));
+
+    for (int i = 0; i < FONTSET_SIZE; i++)
+        xochip_write(machine, (uint16_t)(FONTSET_START_ADDRESS + i), xochip_small_font[i]);
+    for (int i = 0; i < (int)sizeof(xochip_big_font); i++)
+        xochip_write(machine, (uint16_t)(XOCHIP_BIG_FONT_ADDRESS + i), xochip_big_font[i]);
+
+    if (machine->fault)
+    {
+        xochip_destroy(machine);
+        return NULL;
+    }
+    return machine;
+}
+
+void xochip_destroy(XoChip *machine)
+{
+    if (machine == NULL)
+        return;
+
+    for (int i = 0; i < XOCHIP_PAGES; i++)
+        free(machine->pages[i]);
+    free(machine);
+}
+
+int xochip_load_rom(XoChip *machine, const uint8_t *data, size_t size)
+{
+    if (size > 65536 - START_ADDRESS)
+    {
+        fprintf(stderr, "ERROR: ROM is too large for XO-CHIP (%zu bytes, at most %d).\n",
+                size, 65536 - START_ADDRESS);
+        return -1;
+    }
+
+    for (size_t i = 0; i < size; i++)
+        xochip_write(machine, (uint16_t)(START_ADDRESS + i), data[i]);
+
+    if (machine->fault)
+    {
+        fprintf(stderr, "ERROR: Out of memory while loading the ROM.\n");
+        return -1;
+    }
+    return 0;
+}
+
+int xochip_load_rom_file(XoChip *machine, const char *filename)
+{
+    static uint8_t data[65536];
+
+    FILE *fp = fopen(filename, "rb");
+    if (fp == NULL)
+    {
+        perror("Failed to open ROM file");
+        return -1;
+    }
+
+    /* Read one byte more than fits, so that oversized ROMs are detected */
+    size_t size = fread(data, 1, sizeof(data), fp);
+    if (ferror(fp))
+    {
+        perror("Failed to read ROM file");
+        fclose(fp);
+        return -1;
+    }
+    fclose(fp);
+
+    return xochip_load_rom(machine, data, size);
+}
+
+uint8_t xochip_read(const XoChip *machine, uint16_t address)
+{
+    const uint8_t *page = machine->pages[address / XOCHIP_PAGE_SIZE];
+    return page ? page[address % XOCHIP_PAGE_SIZE] : 0;
+}
+
+void xochip_write(XoChip *machine, uint16_t address, uint8_t value)
+{
+    uint8_t **page = &machine->pages[address / XOCHIP_PAGE_SIZE];
+
+    if (*page == NULL)
+    {
+        /* Zero needs no page */
+        if (value == 0)
+            return;
+
+        *page = calloc(1, XOCHIP_PAGE_SIZE);
+        if (*page == NULL)
+        {
+            machine->fault = CHIP8_FAULT_MEMORY_RANGE;
+            return;
+        }
+    }
+
+    (*page)[address % XOCHIP_PAGE_SIZE] = value;
+}
+
+static uint16_t xochip_fetch(const XoChip *machine, uint16_t address)
+{
+    return (uint16_t)(xochip_read(machine, address) << 8 | xochip_read(machine, (uint16_t)(address + 1)));
+}
+
+/* Skips the next instruction, which is 4 bytes long if it is F000 nnnn */
+static void xochip_skip(XoChip *machine)
+{
+    machine->pc += xochip_fetch(machine, machine->pc) == 0xF000u ? 4 : 2;
+}
+
+static void xochip_fault(XoChip *machine, uint8_t fault)
+{
+    machine->fault = fault;
+    machine->pc -= 2;
+}
+
+static uint8_t xochip_random(XoChip *machine)
+{
+    uint32_t x = machine->rng_state;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    machine->rng_state = x;
+
+    return (uint8_t)(x >> 24);
+}
+
+static void xochip_clear(XoChip *machine, uint8_t planes)
+{
+    for (int p = 0; p < 2; p++)
+    {
+        if (planes & (1u << p))
+            memset(machine->plane[p], 0, sizeof(machine->plane[p]));
+    }
+}
+
+/* Vertical scroll by `rows` (positive: down); rows scrolled in are blank */
+static void xochip_scroll_vertical(XoChip *machine, int rows)
+{
+    int height = machine->hires ? XOCHIP_HEIGHT : XOCHIP_HEIGHT / 2;
+    int count = rows < 0 ? -rows : rows;
+    size_t row_bytes = sizeof(machine->plane[0][0]);
+
+    if (count > height)
+        count = height;
+
+    for (int p = 0; p < 2; p++)
+    {
+        if (!(machine->planes & (1u << p)))
+            continue;
+
+        uint64_t (*plane)[XOCHIP_WIDTH / 64] = machine->plane[p];
+
+        if (rows > 0)
+        {
+            memmove(plane[count], plane[0], (size_t)(height - count) * row_bytes);
+            memset(plane[0], 0, (size_t)count * row_bytes);
+        }
+        else
+        {
+            memmove(plane[0], plane[count], (size_t)(height - count) * row_bytes);
+            memset(plane[height - count], 0, (size_t)count * row_bytes);
+        }
+    }
+}
+
+/* Horizontal scroll by 4 pixels, right or left */
+static void xochip_scroll_horizontal(XoChip *machine, int right)
+{
+    int height = machine->hires ? XOCHIP_HEIGHT : XOCHIP_HEIGHT / 2;
+
+    for (int p = 0; p < 2; p++)
+    {
+        if (!(machine->planes & (1u << p)))
+            continue;
+
+        for (int y = 0; y < height; y++)
+        {
+            uint64_t *row = machine->plane[p][y];
+
+            if (!machine->hires)
+                row[0] = right ? row[0] >> 4 : row[0] << 4;
+            else if (right)
+            {
+                row[1] = row[1] >> 4 | row[0] << 60;
+                row[0] >>= 4;
+            }
+            else
+            {
+                row[0] = row[0] << 4 | row[1] >> 60;
+                row[1] <<= 4;
+            }
+        }
+    }
+}
+
+static void xochip_set_resolution(XoChip *machine, uint8_t hires)
+{
+    machine->hires = hires;
+    xochip_clear(machine, 3);
+}
+
+/* XORs `bits` (16 pixels, leftmost in bit 15) into a row at column x, wrapping; returns collisions */
+static uint64_t xochip_draw_row(uint64_t *row, int hires, uint16_t bits, unsigned int x)
+{
+    uint64_t hi = (uint64_t)bits << 48;
+    uint64_t lo = 0;
+
+    if (!hires)
+    {
+        uint64_t mask = x ? (hi >> x | hi << (64 - x)) : hi;
+        uint64_t collided = row[0] & mask;
+        row[0] ^= mask;
+        return collided;
+    }
+
+    /* Rotate the 128-bit row mask right by x */
+    if (x >= 64)
+    {
+        lo = hi;
+        hi = 0;
+        x -= 64;
+    }
+    if (x)
+    {
+        uint64_t new_hi = hi >> x | lo << (64 - x);
+        lo = lo >> x | hi << (64 - x);
+        hi = new_hi;
+    }
+
+    uint64_t collided = (row[0] & hi) | (row[1] & lo);
+    row[0] ^= hi;
+    row[1] ^= lo;
+    return collided;
+}
+
+static void xochip_draw(XoChip *machine, uint8_t x, uint8_t y, uint8_t n)
+{
+    unsigned int width = machine->hires ? XOCHIP_WIDTH : XOCHIP_WIDTH / 2;
+    unsigned int height = machine->hires ? XOCHIP_HEIGHT : XOCHIP_HEIGHT / 2;
+    unsigned int rows = n ? n : 16;
+    uint16_t address = machine->index;
+    uint64_t collided = 0;
+    unsigned int drawn = 0;
+
+    x %= width;
+    y %= height;
+
+    /* Each selected plane takes its own sprite data, one after the other */
+    for (int p = 0; p < 2; p++)
+    {
+        if (!(machine->planes & (1u << p)))
+            continue;
+
+        for (unsigned int r = 0; r < rows; r++)
+        {
+            uint16_t bits;
+            if (n == 0)
+            {
+                bits = xochip_fetch(machine, address);
+                address += 2;
+            }
+            else
+            {
+                bits = (uint16_t)(xochip_read(machine, address) << 8);
+                address += 1;
+            }
+
+            if (bits)
+            {
+                uint64_t *row = machine->plane[p][(y + r) % height];
+                collided |= xochip_draw_row(row, machine->hires, bits, x);
+                drawn += (unsigned int)__builtin_popcount(bits);
+            }
+        }
+    }
+
+    machine->registers[0xF] = collided != 0;
+    processor_stats.draw_calls++;
+    processor_stats.pixels_drawn += drawn;
+}
+
+/* Executes one instruction; returns the ProcessorEvent bits it caused */
+static int xochip_step(XoChip *machine)
+{
+    if (machine->pc > 0xFFFEu)
+    {
+        machine->fault = CHIP8_FAULT_PC_RANGE;
+        return 0;
+    }
+
+    uint16_t op = xochip_fetch(machine, machine->pc);
+    uint8_t *v = machine->registers;
+    uint8_t x = (op >> 8) & 0xF;
+    uint8_t y = (op >> 4) & 0xF;
+    uint8_t n = op & 0xF;
+    uint8_t kk = op & 0xFF;
+    uint16_t nnn = op & 0x0FFF;
+
+    machine->pc += 2;
+    processor_stats.cycles_executed++;
+
+    switch (op >> 12)
+    {
+    case 0x0:
+        if (op == 0x00E0)
+        {
+            xochip_clear(machine, machine->planes);
+            return PROCESSOR_EVENT_DISPLAY;
+        }
+        if (op == 0x00EE)
+        {
+            if (machine->sp == 0)
+                xochip_fault(machine, CHIP8_FAULT_STACK_UNDERFLOW);
+            else
+                machine->pc = machine->stack[--machine->sp];
+            return 0;
+        }
+        if ((op & 0xFFF0) == 0x00C0 || (op & 0xFFF0) == 0x00D0)
+        {
+            xochip_scroll_vertical(machine, (op & 0xFFF0) == 0x00C0 ? n : -n);
+            return PROCESSOR_EVENT_DISPLAY;
+        }
+        switch (op)
+        {
+        case 0x00FB:
+        case 0x00FC:
+            xochip_scroll_horizontal(machine, op == 0x00FB);
+            return PROCESSOR_EVENT_DISPLAY;
+        case 0x00FD:
+            machine->exited = 1;
+            return 0;
+        case 0x00FE:
+        case 0x00FF:
+            xochip_set_resolution(machine, op == 0x00FF);
+            return PROCESSOR_EVENT_DISPLAY;
+        }
+        break;
+
+    case 0x1:
+        machine->pc = nnn;
+        return 0;
+
+    case 0x2:
+        if (machine->sp == 16)
+        {
+            xochip_fault(machine, CHIP8_FAULT_STACK_OVERFLOW);
+            return 0;
+        }
+        machine->stack[machine->sp++] = machine->pc;
+        machine->pc = nnn;
+        return 0;
+
+    case 0x3:
+        if (v[x] == kk)
+            xochip_skip(machine);
+        return 0;
+
+    case 0x4:
+        if (v[x] != kk)
+            xochip_skip(machine);
+        return 0;
+
+    case 0x5:
+        if (n == 0)
+        {
+            if (v[x] == v[y])
+                xochip_skip(machine);
+            return 0;
+        }
+        if (n == 2 || n == 3)
+        {
+            int step = x <= y ? 1 : -1;
+            uint16_t address = machine->index;
+
+            for (int r = x;; r += step, address++)
+            {
+                if (n == 2)
+                    xochip_write(machine, address, v[r]);
+                else
+                    v[r] = xochip_read(machine, address);
+                if (r == y)
+                    break;
+            }
+            return 0;
+        }
+        break;
+
+    case 0x6:
+        v[x] = kk;
+        return 0;
+
+    case 0x7:
+        v[x] += kk;
+        return 0;
+
+    case 0x8:
+    {
+        uint8_t flag;
+
+        switch (n)
+        {
+        case 0x0:
+            v[x] = v[y];
+            return 0;
+        case 0x1:
+            v[x] |= v[y];
+            return 0;
+        case 0x2:
+            v[x] &= v[y];
+            return 0;
+        case 0x3:
+            v[x] ^= v[y];
+            return 0;
+        case 0x4:
+            flag = v[x] + v[y] > 0xFF;
+            v[x] += v[y];
+            v[0xF] = flag;
+            return 0;
+        case 0x5:
+            flag = v[x] >= v[y];
+            v[x] -= v[y];
+            v[0xF] = flag;
+            return 0;
+        case 0x6:
+            flag = v[y] & 1u;
+            v[x] = v[y] >> 1;
+            v[0xF] = flag;
+            return 0;
+        case 0x7:
+            flag = v[y] >= v[x];
+            v[x] = v[y] - v[x];
+            v[0xF] = flag;
+            return 0;
+        case 0xE:
+            flag = v[y] >> 7;
+            v[x] = (uint8_t)(v[y] << 1);
+            v[0xF] = flag;
+            return 0;
+        }
+        break;
+    }
+
+    case 0x9:
+        if (n == 0)
+        {
+            if (v[x] != v[y])
+                xochip_skip(machine);
+            return 0;
+        }
+        break;
+
+    case 0xA:
+        machine->index = nnn;
+        return 0;
+
+    case 0xB:
+        machine->pc = (uint16_t)(nnn + v[0]);
+        return 0;
+
+    case 0xC:
+        v[x] = xochip_random(machine) & kk;
+        return 0;
+
+    case 0xD:
+        xochip_draw(machine, v[x], v[y], n);
+        return PROCESSOR_EVENT_DISPLAY;
+
+    case 0xE:
+        if (kk == 0x9E || kk == 0xA1)
+        {
+            if (v[x] > 0xF)
+                xochip_fault(machine, CHIP8_FAULT_KEY_RANGE);
+            else if ((machine->keypad[v[x]] != 0) == (kk == 0x9E))
+                xochip_skip(machine);
+            return 0;
+        }
+        break;
+
+    case 0xF:
+        if (op == 0xF000)
+        {
+            machine->index = xochip_fetch(machine, machine->pc);
+            machine->pc += 2;
+            return 0;
+        }
+        if (kk == 0x01)
+        {
+            machine->planes = x & 3u;
+            return 0;
+        }
+        if (op == 0xF002)
+        {
+            for (int i = 0; i < 16; i++)
+                machine->pattern[i] = xochip_read(machine, (uint16_t)(machine->index + i));
+            return PROCESSOR_EVENT_SOUND;
+        }
+
+        switch (kk)
+        {
+        case 0x07:
+            v[x] = machine->delay_timer;
+            return 0;
+        case 0x0A:
+            for (uint8_t key = 0; key < 16; key++)
+            {
+                if (machine->keypad[key])
+                {
+                    v[x] = key;
+                    return 0;
+                }
+            }
+            machine->waiting_for_key = 1;
+            machine->key_register = x;
+            return 0;
+        case 0x15:
+            machine->delay_timer = v[x];
+            return 0;
+        case 0x18:
+            machine->sound_timer = v[x];
+            return PROCESSOR_EVENT_SOUND;
+        case 0x1E:
+            machine->index += v[x];
+            return 0;
+        case 0x29:
+            machine->index = (uint16_t)(FONTSET_START_ADDRESS + 5 * (v[x] & 0xF));
+            return 0;
+        case 0x30:
+            machine->index = (uint16_t)(XOCHIP_BIG_FONT_ADDRESS + 10 * (v[x] & 0xF));
+            return 0;
+        case 0x33:
+            xochip_write(machine, machine->index, v[x] / 100);
+            xochip_write(machine, (uint16_t)(machine->index + 1), v[x] / 10 % 10);
+            xochip_write(machine, (uint16_t)(machine->index + 2), v[x] % 10);
+            return 0;
+        case 0x3A:
+            machine->pitch = v[x];
+            return PROCESSOR_EVENT_SOUND;
+        case 0x55:
+            for (int r = 0; r <= x; r++)
+                xochip_write(machine, machine->index++, v[r]);
+            return 0;
+        case 0x65:
+            for (int r = 0; r <= x; r++)
+                v[r] = xochip_read(machine, machine->index++);
+            return 0;
+        case 0x75:
+            memcpy(machine->flags, v, (size_t)x + 1);
+            return 0;
+        case 0x85:
+            memcpy(v, machine->flags, (size_t)x + 1);
+            return 0;
+        }
+        break;
+    }
+
+    xochip_fault(machine, CHIP8_FAULT_INVALID_OPCODE);
+    return 0;
+}
+
+int xochip_run_frame(XoChip *machine, unsigned int cycles)
+{
+    int events = PROCESSOR_EVENT_FRAME;
+
+    for (unsigned int i = 0; i < cycles; i++)
+    {
+        if (machine->waiting_for_key || machine->fault || machine->exited)
+            break;
+        events |= xochip_step(machine);
+    }
+
+    if (machine->delay_timer > 0)
+        machine->delay_timer--;
+    if (machine->sound_timer > 0)
+    {
+        machine->sound_timer--;
+        if (machine->sound_timer == 0)
+            events |= PROCESSOR_EVENT_SOUND;
+    }
+
+    if (machine->waiting_for_key)
+        events |= PROCESSOR_EVENT_KEY_WAIT;
+    if (machine->fault || machine->exited)
+        events |= PROCESSOR_EVENT_FAULT;
+
+    processor_stats.frames++;
+    return events;
+}
+
+void xochip_set_key(XoChip *machine, uint8_t key, uint8_t pressed)
+{
+    if (key > 0xF)
+        return;
+
+    machine->keypad[key] = pressed;
+
+    if (pressed && machine->waiting_for_key)
+    {
+        machine->registers[machine->key_register] = key;
+        machine->waiting_for_key = 0;
+    }
+}
+
+void xochip_render(const XoChip *machine, uint32_t *pixels)
+{
+    int scale = machine->hires ? 1 : 2;
+
+    for (int y = 0; y < XOCHIP_HEIGHT; y++)
+    {
+        const uint64_t *row0 = machine->plane[0][y / scale];
+        const uint64_t *row1 = machine->plane[1][y / scale];
+
+        for (int x = 0; x < XOCHIP_WIDTH; x++)
+        {
+            int column = x / scale;
+            int shift = 63 - column % 64;
+            int color = (int)(row0[column / 64] >> shift & 1u) | (int)(row1[column / 64] >> shift & 1u) << 1;
+
+            pixels[y * XOCHIP_WIDTH + x] = xochip_palette[color];
+        }
+    }
+}
+
+void xochip_audio(XoChip *machine, int8_t *levels, size_t count, int sample_rate)
+{
+    /* 4000 × 2^((pitch − 64) / 48) bits per second, in octaves and 48ths of one */
+    int steps = machine->pitch - 64;
+    int octaves = steps >= 0 ? steps / 48 : -((47 - steps) / 48);
+    double rate = 4000.0;
+
+    for (int i = 0; i < steps - 48 * octaves; i++)
+        rate *= 1.0145453349375237; /* 2^(1/48) */
+    for (int i = 0; i < octaves; i++)
+        rate *= 2.0;
+    for (int i = 0; i > octaves; i--)
+        rate *= 0.5;
+
+    uint32_t step = (uint32_t)(rate * 65536.0 / sample_rate);
+    const uint32_t period = XOCHIP_PATTERN_BITS << 16;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (machine->sound_timer == 0)
+        {
+            levels[i] = 0;
+            continue;
+        }
+
+        unsigned int bit = machine->audio_phase >> 16;
+        levels[i] = (machine->pattern[bit / 8] >> (7 - bit % 8)) & 1u ? 1 : -1;
+        machine->audio_phase = (machine->audio_phase + step) % period;
+    }
+}
+
+size_t xochip_memory_usage(const XoChip *machine)
+{
+    size_t bytes = sizeof(XoChip);
+
+    for (int i = 0; i < XOCHIP_PAGES; i++)
+    {
+        if (machine->pages[i])
+            bytes += XOCHIP_PAGE_SIZE;
+    }
+    return bytes;
+}
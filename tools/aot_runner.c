@@ -0,0 +1,105 @@
+/*
+ * chip8-aot-run — runs a ROM translated by chip8-aot and reports the
+ * speedup against the interpreter on the same ROM.
+ *
+ * Usage: chip8-aot-run <ROM file> [frames]
+ *
+ * The ROM is first run for the given number of frames with
+ * processor_frame(), then reset to the same initial state (which includes
+ * the random-number generator) and run again with the translated code, falling back to
+ * processor_cycle() wherever aot_run() declines. Both runs must end in
+ * the same machine state.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "chip8.h"
+#include "processor.h"
+#include "opcode_table.h"
+#include "aot.h"
+
+static unsigned long long native_cycles;
+static unsigned long long interpreted_cycles;
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void aot_frame(void)
+{
+    int cycles = 0;
+
+    while (cycles < CHIP8_CYCLES_PER_FRAME && !chip8_memory.waiting_for_key && !chip8_memory.fault)
+    {
+        int executed = aot_run(CHIP8_CYCLES_PER_FRAME - cycles);
+
+        if (executed == 0)
+        {
+            processor_cycle();
+            executed = 1;
+            interpreted_cycles++;
+
+            if ((opcode & 0xF0FFu) == 0xF033u)
+                aot_invalidate(chip8_memory.index, 3);
+            else if ((opcode & 0xF0FFu) == 0xF055u)
+                aot_invalidate(chip8_memory.index, ((opcode & 0x0F00u) >> 8) + 1);
+        }
+        else
+        {
+            native_cycles += executed;
+        }
+
+        cycles += executed;
+    }
+
+    processor_update_timers();
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        printf("Usage: %s <ROM file> [frames]\n", argv[0]);
+        return 1;
+    }
+
+    unsigned long frames = argc > 2 ? strtoul(argv[2], NULL, 10) : 1000000;
+
+    chip8_init();
+    if (chip8_load_ROM(argv[1]) != 0)
+        return 1;
+
+    static MEMORY pristine;
+    static MEMORY interpreted_state;
+    pristine = chip8_memory;
+
+    double start = now_seconds();
+    for (unsigned long i = 0; i < frames; i++)
+        processor_frame();
+    double interpreter_time = now_seconds() - start;
+    interpreted_state = chip8_memory;
+
+    chip8_memory = pristine;
+    start = now_seconds();
+    for (unsigned long i = 0; i < frames; i++)
+        aot_frame();
+    double aot_time = now_seconds() - start;
+
+    int match = memcmp(&interpreted_state, &chip8_memory, sizeof(MEMORY)) == 0;
+    unsigned long long total = native_cycles + interpreted_cycles;
+
+    printf("ROM:          %s (translated from %s)\n", argv[1], aot_rom_name);
+    printf("Frames:       %lu\n", frames);
+    printf("Interpreter:  %.3f s\n", interpreter_time);
+    printf("AOT:          %.3f s (%.1f%% of %llu cycles native)\n",
+           aot_time, total ? 100.0 * native_cycles / total : 0.0, total);
+    printf("Speedup:      %.2fx\n", aot_time > 0 ? interpreter_time / aot_time : 0.0);
+    printf("Final state:  %s\n", match ? "identical" : "DIFFERENT");
+
+    return match ? 0 : 1;
+}
@@ -0,0 +1,607 @@
+/*
+ * chip8-aot — static recompiler from CHIP-8 ROM to C.
+ *
+ * Usage: chip8-aot <ROM file> [-o <output.c>]
+ *
+ * See include/aot.h for the contract between the generated translation
+ * unit and the runtime.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "memory.h"
+
+#define RAM_SIZE 4096
+
+typedef enum
+{
+    K_INVALID,
+    K_CLS,
+    K_RET,
+    K_JP,
+    K_CALL,
+    K_SE_IMM,
+    K_SNE_IMM,
+    K_SE_REG,
+    K_LD_IMM,
+    K_ADD_IMM,
+    K_ALU,
+    K_SNE_REG,
+    K_LD_I,
+    K_JP_V0,
+    K_RND,
+    K_DRW,
+    K_SKP,
+    K_SKNP,
+    K_LD_VX_DT,
+    K_WAIT_KEY,
+    K_LD_DT,
+    K_LD_ST,
+    K_ADD_I,
+    K_LD_F,
+    K_BCD,
+    K_STORE,
+    K_LOAD
+} Kind;
+
+static uint8_t image[RAM_SIZE];
+static unsigned rom_end;
+
+static uint8_t reached[RAM_SIZE];
+static uint8_t leader[RAM_SIZE];
+static uint8_t code_byte[RAM_SIZE];
+static uint16_t worklist[RAM_SIZE];
+static int worklist_size;
+static int block_id[RAM_SIZE];
+
+static uint16_t fetch(unsigned address)
+{
+    return (uint16_t)((image[address] << 8) | image[address + 1]);
+}
+
+/* Mirrors the dispatch tables built by ot_init() */
+static Kind decode(uint16_t op)
+{
+    switch (op >> 12)
+    {
+    case 0x0:
+        if (op == 0x00E0u)
+            return K_CLS;
+        if (op == 0x00EEu)
+            return K_RET;
+        return K_INVALID;
+    case 0x1:
+        return K_JP;
+    case 0x2:
+        return K_CALL;
+    case 0x3:
+        return K_SE_IMM;
+    case 0x4:
+        return K_SNE_IMM;
+    case 0x5:
+        return K_SE_REG;
+    case 0x6:
+        return K_LD_IMM;
+    case 0x7:
+        return K_ADD_IMM;
+    case 0x8:
+        return ((op & 0xFu) <= 0x7u || (op & 0xFu) == 0xEu) ? K_ALU : K_INVALID;
+    case 0x9:
+        return K_SNE_REG;
+    case 0xA:
+        return K_LD_I;
+    case 0xB:
+        return K_JP_V0;
+    case 0xC:
+        return K_RND;
+    case 0xD:
+        return K_DRW;
+    case 0xE:
+        if ((op & 0xFu) == 0xEu)
+            return K_SKP;
+        if ((op & 0xFu) == 0x1u)
+            return K_SKNP;
+        return K_INVALID;
+    default:
+        switch (op & 0xFFu)
+        {
+        case 0x07:
+            return K_LD_VX_DT;
+        case 0x0A:
+            return K_WAIT_KEY;
+        case 0x15:
+            return K_LD_DT;
+        case 0x18:
+            return K_LD_ST;
+        case 0x1E:
+            return K_ADD_I;
+        case 0x29:
+            return K_LD_F;
+        case 0x33:
+            return K_BCD;
+        case 0x55:
+            return K_STORE;
+        case 0x65:
+            return K_LOAD;
+        default:
+            return K_INVALID;
+        }
+    }
+}
+
+static int is_skip(Kind kind)
+{
+    return kind == K_SE_IMM || kind == K_SNE_IMM || kind == K_SE_REG ||
+           kind == K_SNE_REG || kind == K_SKP || kind == K_SKNP;
+}
+
+static int is_terminator(Kind kind)
+{
+    return is_skip(kind) || kind == K_JP || kind == K_CALL || kind == K_RET ||
+           kind == K_JP_V0 || kind == K_WAIT_KEY;
+}
+
+static int decodable(unsigned address)
+{
+    return address >= START_ADDRESS && address + 1 < rom_end &&
+           decode(fetch(address)) != K_INVALID;
+}
+
+static void enqueue(unsigned address, int is_leader)
+{
+    if (!decodable(address))
+        return;
+
+    if (is_leader)
+        leader[address] = 1;
+
+    if (!reached[address])
+    {
+        reached[address] = 1;
+        worklist[worklist_size++] = (uint16_t)address;
+    }
+}
+
+static void explore(void)
+{
+    enqueue(START_ADDRESS, 1);
+
+    while (worklist_size > 0)
+    {
+        unsigned address = worklist[--worklist_size];
+        uint16_t op = fetch(address);
+        Kind kind = decode(op);
+
+        code_byte[address] = code_byte[address + 1] = 1;
+
+        if (kind == K_JP)
+            enqueue(op & 0x0FFFu, 1);
+        else if (kind == K_CALL)
+        {
+            enqueue(op & 0x0FFFu, 1);
+            enqueue(address + 2, 1);
+        }
+        else if (is_skip(kind))
+        {
+            enqueue(address + 2, 1);
+            enqueue(address + 4, 1);
+        }
+        else if (kind == K_WAIT_KEY)
+            enqueue(address + 2, 1);
+        else if (kind != K_RET && kind != K_JP_V0)
+            enqueue(address + 2, 0);
+    }
+}
+
+static void emit_goto(FILE *out, unsigned target)
+{
+    fprintf(out, "    PC = 0x%03X;\n", target);
+    if (target < RAM_SIZE && reached[target] && leader[target])
+        fprintf(out, "    goto B_%03X;\n", target);
+    else
+        fprintf(out, "    goto dispatch;\n");
+}
+
+static void emit_skip(FILE *out, unsigned address, const char *condition)
+{
+    fprintf(out, "    if (%s)\n    {\n", condition);
+    fprintf(out, "        PC = 0x%03X;\n", address + 4);
+    if (address + 4 < RAM_SIZE && reached[address + 4] && leader[address + 4])
+        fprintf(out, "        goto B_%03X;\n", address + 4);
+    else
+        fprintf(out, "        goto dispatch;\n");
+    fprintf(out, "    }\n");
+    emit_goto(out, address + 2);
+}
+
+static void emit_call(FILE *out, uint16_t op, const char *handler)
+{
+    fprintf(out, "    opcode = 0x%04X;\n    %s();\n", op, handler);
+}
+
+/* Calls a handler that may raise a fault; PC must be current for chip8_fault() */
+static void emit_checked_call(FILE *out, unsigned address, uint16_t op, const char *handler)
+{
+    fprintf(out, "    PC = 0x%03X;\n", address + 2);
+    emit_call(out, op, handler);
+    fprintf(out, "    if (chip8_memory.fault)\n        return cycles;\n");
+}
+
+/* Emits one instruction; returns 1 if it ended the block */
+static int emit_instruction(FILE *out, unsigned address, int block)
+{
+    uint16_t op = fetch(address);
+    Kind kind = decode(op);
+    unsigned x = (op >> 8) & 0xFu;
+    unsigned y = (op >> 4) & 0xFu;
+    unsigned kk = op & 0xFFu;
+    unsigned nnn = op & 0xFFFu;
+    char condition[64];
+
+    fprintf(out, "    /* %03X: %04X */\n", address, op);
+    if (block_id[address] < 0)
+        fprintf(out, "I_%03X:\n", address);
+    fprintf(out, "    if (cycles == budget)\n    {\n        PC = 0x%03X;\n        return cycles;\n    }\n", address);
+    fprintf(out, "    cycles++;\n");
+
+    switch (kind)
+    {
+    case K_CLS:
+        emit_call(out, op, "OP_00E0");
+        return 0;
+    case K_RET:
+        emit_checked_call(out, address, op, "OP_00EE");
+        fprintf(out, "    goto dispatch;\n");
+        return 1;
+    case K_JP:
+        emit_goto(out, nnn);
+        return 1;
+    case K_CALL:
+        emit_checked_call(out, address, op, "OP_2nnn");
+        emit_goto(out, nnn);
+        return 1;
+    case K_SE_IMM:
+        snprintf(condition, sizeof(condition), "V[0x%X] == 0x%02X", x, kk);
+        emit_skip(out, address, condition);
+        return 1;
+    case K_SNE_IMM:
+        snprintf(condition, sizeof(condition), "V[0x%X] != 0x%02X", x, kk);
+        emit_skip(out, address, condition);
+        return 1;
+    case K_SE_REG:
+        snprintf(condition, sizeof(condition), "V[0x%X] == V[0x%X]", x, y);
+        emit_skip(out, address, condition);
+        return 1;
+    case K_SNE_REG:
+        snprintf(condition, sizeof(condition), "V[0x%X] != V[0x%X]", x, y);
+        emit_skip(out, address, condition);
+        return 1;
+    case K_SKP:
+    case K_SKNP:
+        emit_checked_call(out, address, op, kind == K_SKP ? "OP_Ex9E" : "OP_ExA1");
+        fprintf(out, "    goto dispatch;\n");
+        return 1;
+    case K_LD_IMM:
+        fprintf(out, "    V[0x%X] = 0x%02X;\n", x, kk);
+        return 0;
+    case K_ADD_IMM:
+        fprintf(out, "    V[0x%X] += 0x%02X;\n", x, kk);
+        return 0;
+    case K_ALU:
+        switch (op & 0xFu)
+        {
+        case 0x0:
+            fprintf(out, "    V[0x%X] = V[0x%X];\n", x, y);
+            break;
+        case 0x1:
+            fprintf(out, "    V[0x%X] |= V[0x%X];\n", x, y);
+            break;
+        case 0x2:
+            fprintf(out, "    V[0x%X] &= V[0x%X];\n", x, y);
+            break;
+        case 0x3:
+            fprintf(out, "    V[0x%X] ^= V[0x%X];\n", x, y);
+            break;
+        case 0x4:
+            fprintf(out,
+                    "    sum = V[0x%X] + V[0x%X];\n"
+                    "    V[0xF] = (sum > 0xFFu) ? 1 : 0;\n"
+                    "    V[0x%X] = (uint8_t)sum;\n",
+                    x, y, x);
+            break;
+        case 0x5:
+            fprintf(out,
+                    "    V[0xF] = (V[0x%X] > V[0x%X]) ? 1 : 0;\n"
+                    "    V[0x%X] -= V[0x%X];\n",
+                    x, y, x, y);
+            break;
+        case 0x6:
+            fprintf(out,
+                    "    V[0xF] = V[0x%X] & 0x1u;\n"
+                    "    V[0x%X] >>= 1;\n",
+                    x, x);
+            break;
+        case 0x7:
+            fprintf(out,
+                    "    V[0xF] = (V[0x%X] > V[0x%X]) ? 1 : 0;\n"
+                    "    V[0x%X] = V[0x%X] - V[0x%X];\n",
+                    y, x, x, y, x);
+            break;
+        default:
+            fprintf(out,
+                    "    V[0xF] = V[0x%X] >> 7u;\n"
+                    "    V[0x%X] <<= 1;\n",
+                    x, x);
+            break;
+        }
+        return 0;
+    case K_LD_I:
+        fprintf(out, "    I = 0x%03X;\n", nnn);
+        return 0;
+    case K_JP_V0:
+        emit_call(out, op, "OP_Bnnn");
+        fprintf(out, "    goto dispatch;\n");
+        return 1;
+    case K_RND:
+        emit_call(out, op, "OP_Cxkk");
+        return 0;
+    case K_DRW:
+        emit_checked_call(out, address, op, "OP_Dxyn");
+        return 0;
+    case K_LD_VX_DT:
+        fprintf(out, "    V[0x%X] = chip8_memory.delay_timer;\n", x);
+        return 0;
+    case K_WAIT_KEY:
+        emit_call(out, op, "OP_Fx0A");
+        fprintf(out, "    if (chip8_memory.waiting_for_key)\n    {\n");
+        fprintf(out, "        PC = 0x%03X;\n        return cycles;\n    }\n", address + 2);
+        emit_goto(out, address + 2);
+        return 1;
+    case K_LD_DT:
+        fprintf(out, "    chip8_memory.delay_timer = V[0x%X];\n", x);
+        return 0;
+    case K_LD_ST:
+        fprintf(out, "    chip8_memory.sound_timer = V[0x%X];\n", x);
+        return 0;
+    case K_ADD_I:
+        fprintf(out, "    I += V[0x%X];\n", x);
+        return 0;
+    case K_LD_F:
+        fprintf(out, "    I = FONTSET_START_ADDRESS + (5 * V[0x%X]);\n", x);
+        return 0;
+    case K_BCD:
+    case K_STORE:
+        emit_checked_call(out, address, op, kind == K_BCD ? "OP_Fx33" : "OP_Fx55");
+        fprintf(out, "    aot_invalidate(I, %u);\n", kind == K_BCD ? 3u : x + 1);
+        fprintf(out, "    if (aot_dirty[%d])\n    {\n", block);
+        fprintf(out, "        PC = 0x%03X;\n        return cycles;\n    }\n", address + 2);
+        return 0;
+    case K_LOAD:
+        emit_checked_call(out, address, op, "OP_Fx65");
+        return 0;
+    default:
+        return 1;
+    }
+}
+
+static int block_length(unsigned start)
+{
+    int length = 0;
+    unsigned address = start;
+
+    for (;;)
+    {
+        length++;
+        if (is_terminator(decode(fetch(address))))
+            return length;
+
+        address += 2;
+        if (address >= rom_end || !reached[address] || leader[address])
+            return length;
+    }
+}
+
+static const char *separator(unsigned n)
+{
+    if (n == 0)
+        return "\n    ";
+    return (n % 8) ? ", " : ",\n    ";
+}
+
+static int translate(FILE *out, const char *rom_name)
+{
+    int blocks = 0;
+    int instructions = 0;
+    int indirect = 0;
+    unsigned code_start = RAM_SIZE;
+    unsigned code_end = 0;
+
+    for (unsigned a = START_ADDRESS; a < rom_end; a++)
+    {
+        block_id[a] = -1;
+        if (reached[a] && leader[a])
+            block_id[a] = blocks++;
+        if (code_byte[a])
+        {
+            if (a < code_start)
+                code_start = a;
+            code_end = a + 1;
+        }
+    }
+
+    fprintf(out,
+            "/*\n"
+            " * Generated by chip8-aot from %s. Do not edit.\n"
+            " */\n\n"
+            "#include <stdint.h>\n"
+            "#include \"chip8.h\"\n"
+            "#include \"opcode_table.h\"\n"
+            "#include \"instructions.h\"\n"
+            "#include \"aot.h\"\n\n"
+            "#define V chip8_memory.registers\n"
+            "#define I chip8_memory.index\n"
+            "#define PC chip8_memory.program_counter\n\n"
+            "#define AOT_BLOCK_COUNT %d\n"
+            "#define AOT_CODE_START 0x%03X\n"
+            "#define AOT_CODE_END 0x%03X\n\n",
+            rom_name, blocks > 0 ? blocks : 1, code_start, code_end);
+
+    fprintf(out, "const char aot_rom_name[] = \"");
+    for (const char *c = rom_name; *c; c++)
+    {
+        if (*c == '"' || *c == '\\')
+            fputc('\\', out);
+        fputc(*c, out);
+    }
+    fprintf(out, "\";\n\nstatic uint8_t aot_dirty[AOT_BLOCK_COUNT];\n\n");
+
+    fprintf(out, "static const uint16_t aot_block_start[AOT_BLOCK_COUNT] = {");
+    for (unsigned a = START_ADDRESS, n = 0; a < rom_end; a++)
+        if (block_id[a] >= 0)
+            fprintf(out, "%s0x%03X", separator(n++), a);
+    fprintf(out, "\n};\n\n");
+
+    fprintf(out, "static const uint16_t aot_block_end[AOT_BLOCK_COUNT] = {");
+    for (unsigned a = START_ADDRESS, n = 0; a < rom_end; a++)
+        if (block_id[a] >= 0)
+            fprintf(out, "%s0x%03X", separator(n++), a + 2 * block_length(a));
+    fprintf(out, "\n};\n\n");
+
+    fprintf(out,
+            "void aot_invalidate(uint16_t address, uint16_t length)\n"
+            "{\n"
+            "    unsigned end = (unsigned)address + length;\n\n"
+            "    if (end <= AOT_CODE_START || address >= AOT_CODE_END)\n"
+            "        return;\n\n"
+            "    for (int b = 0; b < AOT_BLOCK_COUNT; b++)\n"
+            "    {\n"
+            "        if (address < aot_block_end[b] && end > aot_block_start[b])\n"
+            "            aot_dirty[b] = 1;\n"
+            "    }\n"
+            "}\n\n");
+
+    fprintf(out,
+            "int aot_run(int budget)\n"
+            "{\n"
+            "    int cycles = 0;\n"
+            "    uint16_t sum;\n\n"
+            "    (void)sum;\n\n"
+            "dispatch:\n"
+            "    switch (PC)\n"
+            "    {\n");
+    for (unsigned start = START_ADDRESS; start < rom_end; start++)
+    {
+        if (block_id[start] < 0)
+            continue;
+
+        fprintf(out, "    case 0x%03X:\n        goto B_%03X;\n", start, start);
+
+        /* A budget exit can leave PC mid-block; resume there natively */
+        unsigned address = start + 2;
+        for (int i = 1; i < block_length(start); i++, address += 2)
+            fprintf(out, "    case 0x%03X:\n        if (aot_dirty[%d])\n            return cycles;\n"
+                         "        goto I_%03X;\n",
+                    address, block_id[start], address);
+    }
+    fprintf(out, "    default:\n        return cycles;\n    }\n");
+
+    for (unsigned start = START_ADDRESS; start < rom_end; start++)
+    {
+        if (block_id[start] < 0)
+            continue;
+
+        int length = block_length(start);
+        int id = block_id[start];
+
+        fprintf(out, "\nB_%03X:\n", start);
+        fprintf(out, "    if (aot_dirty[%d])\n        return cycles;\n", id);
+
+        unsigned address = start;
+        for (int i = 0; i < length; i++, address += 2)
+        {
+            Kind kind = decode(fetch(address));
+            if (kind == K_JP_V0)
+                indirect++;
+
+            if (emit_instruction(out, address, id))
+                break;
+
+            /* Fell through to a leader or to code that was not translated */
+            if (i == length - 1)
+                emit_goto(out, address + 2);
+        }
+
+        instructions += length;
+    }
+
+    fprintf(out, "}\n");
+
+    unsigned code_bytes = 0;
+    for (unsigned a = START_ADDRESS; a < rom_end; a++)
+        code_bytes += code_byte[a];
+
+    fprintf(stderr,
+            "chip8-aot: %s: %d instructions in %d blocks, %u code bytes, "
+            "%u data bytes, %d indirect jumps\n",
+            rom_name, instructions, blocks, code_bytes,
+            rom_end - START_ADDRESS - code_bytes, indirect);
+
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    const char *rom_path = NULL;
+    const char *output_path = NULL;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+            output_path = argv[++i];
+        else
+            rom_path = argv[i];
+    }
+
+    if (rom_path == NULL)
+    {
+        printf("Usage: %s <ROM file> [-o <output.c>]\n", argv[0]);
+        return 1;
+    }
+
+    FILE *fp = fopen(rom_path, "rb");
+    if (fp == NULL)
+    {
+        perror("Failed to open ROM file");
+        return 1;
+    }
+
+    size_t size = fread(image + START_ADDRESS, 1, RAM_SIZE - START_ADDRESS, fp);
+    if (!feof(fp))
+    {
+        fprintf(stderr, "ERROR: ROM is too large to fit into CHIP-8 memory.\n");
+        fclose(fp);
+        return 1;
+    }
+    fclose(fp);
+    rom_end = START_ADDRESS + (unsigned)size;
+
+    FILE *out = output_path ? fopen(output_path, "w") : stdout;
+    if (out == NULL)
+    {
+        perror("Failed to open output file");
+        return 1;
+    }
+
+    const char *rom_name = strrchr(rom_path, '/');
+    rom_name = rom_name ? rom_name + 1 : rom_path;
+
+    explore();
+    int status = translate(out, rom_name);
+
+    if (out != stdout)
+        fclose(out);
+
+    return status == 0 ? 0 : 1;
+}
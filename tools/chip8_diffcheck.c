@@ -0,0 +1,155 @@
+/*
+ * chip8-diffcheck — checks the optimized engines against the reference
+ * interpreter.
+ *
+ * Usage: chip8-diffcheck <ROM file> [-engine NAME] [-mode MODE] [-frames N]
+ *        chip8-diffcheck -opcodes [-engine NAME] [-states N] [-threads N] [-seed N]
+ *
+ * The first form runs the ROM for `-frames` frames (default 3600) on the
+ * engine and on the reference in lockstep, comparing them after every
+ * instruction, block or frame (`-mode`, default block), and reports the
+ * first diverging instruction. Engines that only run whole frames are
+ * compared by frame.
+ *
+ * The second form executes all 65536 opcodes on `-states` random machines
+ * each (default 8, at most 32) on `-threads` threads (default 4).
+ *
+ * `-engine` is run, frame, lockstep or all (the default). The
+ * exit status is 0 when every engine matched the reference.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "chip8.h"
+#include "diffcheck.h"
+
+typedef struct
+{
+    const char *rom;
+    const char *engine;
+    DiffcheckMode mode;
+    unsigned long frames;
+    int opcodes;
+    int states;
+    int threads;
+    uint32_t seed;
+} DiffcheckConfig;
+
+static int parse_mode(const char *text, DiffcheckMode *mode)
+{
+    if (strcmp(text, "instruction") == 0)
+        *mode = DIFFCHECK_INSTRUCTION;
+    else if (strcmp(text, "block") == 0)
+        *mode = DIFFCHECK_BLOCK;
+    else if (strcmp(text, "frame") == 0)
+        *mode = DIFFCHECK_FRAME;
+    else
+        return -1;
+    return 0;
+}
+
+/* Returns 0 if the engine matched, 1 if it did not, -1 on failure */
+static int check_engine(const DiffEngine *engine, const DiffcheckConfig *config, const MEMORY *initial)
+{
+    if (config->opcodes)
+    {
+        long mismatches = diffcheck_opcodes(engine, config->states, config->threads, config->seed, stdout);
+        if (mismatches < 0)
+            return -1;
+
+        printf("%-8s %ld of 65536 opcodes mismatch\n", engine->name, mismatches);
+        return mismatches > 0;
+    }
+
+    /* "all" compares the frame-only engines by frame rather than failing */
+    DiffcheckMode mode = engine->step || strcmp(config->engine, "all") != 0 ? config->mode : DIFFCHECK_FRAME;
+    int result = diffcheck_run(initial, engine, mode, config->frames, stdout);
+
+    if (result == 0)
+        printf("%-8s %lu frames match\n", engine->name, config->frames);
+    return result;
+}
+
+int main(int argc, char *argv[])
+{
+    DiffcheckConfig config = {
+        .engine = "all",
+        .mode = DIFFCHECK_BLOCK,
+        .frames = 3600,
+        .states = 8,
+        .threads = 4,
+        .seed = 1,
+    };
+
+    int i = 1;
+    if (argc > 1 && strcmp(argv[1], "-opcodes") == 0)
+        config.opcodes = 1;
+    else if (argc > 1)
+        config.rom = argv[1];
+    i++;
+
+    for (; i + 1 < argc; i += 2)
+    {
+        const char *value = argv[i + 1];
+
+        if (strcmp(argv[i], "-engine") == 0)
+            config.engine = value;
+        else if (strcmp(argv[i], "-mode") == 0 && parse_mode(value, &config.mode) == 0)
+            continue;
+        else if (strcmp(argv[i], "-frames") == 0)
+            config.frames = strtoul(value, NULL, 10);
+        else if (strcmp(argv[i], "-states") == 0)
+            config.states = atoi(value);
+        else if (strcmp(argv[i], "-threads") == 0)
+            config.threads = atoi(value);
+        else if (strcmp(argv[i], "-seed") == 0)
+            config.seed = (uint32_t)strtoul(value, NULL, 10);
+        else
+        {
+            fprintf(stderr, "Unknown option: %s %s\n", argv[i], value);
+            return 2;
+        }
+    }
+
+    if ((!config.opcodes && config.rom == NULL) || i < argc)
+    {
+        printf("Usage: %s <ROM file> [-engine %s|all] [-mode instruction|block|frame] [-frames N]\n"
+               "       %s -opcodes [-engine NAME] [-states N] [-threads N] [-seed N]\n",
+               argv[0], diffcheck_engine_names(), argv[0]);
+        return 2;
+    }
+
+    chip8_init();
+    chip8_seed(config.seed);
+    if (config.rom && chip8_load_ROM(config.rom) != 0)
+        return 2;
+
+    MEMORY initial = chip8_memory;
+    int failed = 0, diverged = 0;
+
+    if (strcmp(config.engine, "all") != 0)
+    {
+        const DiffEngine *engine = diffcheck_find_engine(config.engine);
+        if (engine == NULL)
+        {
+            fprintf(stderr, "ERROR: Unknown engine \"%s\" (%s).\n", config.engine, diffcheck_engine_names());
+            return 2;
+        }
+
+        int result = check_engine(engine, &config, &initial);
+        return result < 0 ? 2 : result;
+    }
+
+    char names[64];
+    snprintf(names, sizeof(names), "%s", diffcheck_engine_names());
+
+    for (char *name = strtok(names, "|"); name != NULL; name = strtok(NULL, "|"))
+    {
+        int result = check_engine(diffcheck_find_engine(name), &config, &initial);
+        failed |= result < 0;
+        diverged |= result > 0;
+    }
+
+    return failed ? 2 : diverged;
+}
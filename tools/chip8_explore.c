@@ -0,0 +1,122 @@
+/*
+ * chip8-explore — searches the input sequences of a ROM.
+ *
+ * Usage: chip8-explore <ROM file> [-k frames] [-depth N] [-states N]
+ *                      [-threads N] [-score ADDR] [-goal ADDR=VALUE]
+ *
+ * Each step holds one of the 16 single-key keypad states for `-k` frames
+ * (default 6). Without -score the search is breadth-first; -score ADDR
+ * makes it best-first on the 3-digit BCD counter at ADDR (as written by
+ * Fx33). -goal stops the search at the first state whose RAM byte at
+ * ADDR equals VALUE and prints the keys leading there. Addresses and
+ * values are hexadecimal.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "chip8.h"
+#include "explore.h"
+
+typedef struct
+{
+    uint16_t score_address;
+    uint16_t goal_address;
+    uint8_t goal_value;
+} ExploreTarget;
+
+static double bcd_score(const MEMORY *vm, void *user)
+{
+    const ExploreTarget *target = user;
+    const uint8_t *digits = vm->ram + target->score_address;
+    return digits[0] * 100 + digits[1] * 10 + digits[2];
+}
+
+static int byte_goal(const MEMORY *vm, void *user)
+{
+    const ExploreTarget *target = user;
+    return vm->ram[target->goal_address] == target->goal_value;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        printf("Usage: %s <ROM file> [-k frames] [-depth N] [-states N] [-threads N] "
+               "[-score ADDR] [-goal ADDR=VALUE]\n",
+               argv[0]);
+        return 1;
+    }
+
+    ExploreTarget target = {0};
+    ExploreConfig config = {
+        .strategy = EXPLORE_BREADTH_FIRST,
+        .frames_per_step = 6,
+        .max_states = 1000000,
+        .user = &target,
+    };
+
+    for (int i = 2; i + 1 < argc; i += 2)
+    {
+        const char *value = argv[i + 1];
+
+        if (strcmp(argv[i], "-k") == 0)
+            config.frames_per_step = atoi(value);
+        else if (strcmp(argv[i], "-depth") == 0)
+            config.max_depth = atoi(value);
+        else if (strcmp(argv[i], "-states") == 0)
+            config.max_states = strtoul(value, NULL, 10);
+        else if (strcmp(argv[i], "-threads") == 0)
+            config.num_threads = atoi(value);
+        else if (strcmp(argv[i], "-score") == 0)
+        {
+            target.score_address = (uint16_t)(strtoul(value, NULL, 16) & 0xFFFu);
+            if (target.score_address > 4096 - 3)
+                target.score_address = 4096 - 3;
+            config.strategy = EXPLORE_BEST_FIRST;
+            config.score = bcd_score;
+        }
+        else if (strcmp(argv[i], "-goal") == 0)
+        {
+            char *end;
+            target.goal_address = (uint16_t)(strtoul(value, &end, 16) & 0xFFFu);
+            target.goal_value = (uint8_t)(*end == '=' ? strtoul(end + 1, NULL, 16) : 0);
+            config.goal = byte_goal;
+        }
+        else
+        {
+            fprintf(stderr, "Unknown option: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    chip8_init();
+    chip8_seed(1);
+    if (chip8_load_ROM(argv[1]) != 0)
+        return 1;
+
+    Explorer *explorer = explore_create(&chip8_memory, &config);
+    if (explorer == NULL)
+        return 1;
+
+    int found = explore_run(explorer);
+    explore_report_stats(explorer, stdout);
+
+    if (found > 0)
+    {
+        uint16_t path[4096];
+        int length = explore_goal_path(explorer, path, 4096);
+
+        printf("Goal reached after %d steps:", length);
+        for (int i = 0; i < length; i++)
+            printf(" %X", __builtin_ctz(path[i]));
+        printf("\n");
+    }
+    else if (config.goal)
+    {
+        printf("Goal not reached.\n");
+    }
+
+    explore_destroy(explorer);
+    return found < 0 ? 1 : 0;
+}
@@ -0,0 +1,221 @@
+/*
+ * chip8-fuzz — in-process fuzz target for the CHIP-8 core.
+ *
+ * Input layout:
+ *
+ *   bytes 0–1   ROM length L (little-endian, clipped to what is available)
+ *   next L      ROM image, loaded at 0x200
+ *   rest        Keypad events, one per frame: bit 7 = pressed, bits 0–3 = key
+ *
+ * Every input starts from the same pristine machine, restored with a
+ * single memcpy, and runs for at most CHIP8_FUZZ_MAX_FRAMES frames. Program
+ * errors end the run as a Chip8Fault; anything the sanitizers catch is a
+ * bug in the core.
+ *
+ * Build modes:
+ *
+ *   - With -DCHIP8_FUZZ_LIBFUZZER and -fsanitize=fuzzer, only
+ *     LLVMFuzzerTestOneInput() is provided.
+ *   - Built with afl-clang-fast, main() runs the AFL++ persistent loop.
+ *   - Otherwise main() is a standalone driver:
+ *
+ *       chip8-fuzz [-runs N] [-seed S] [file ...]
+ *
+ *     Files are replayed one by one; without files, N random inputs are
+ *     generated. Execs/sec and a fault histogram are printed at the end.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include "chip8.h"
+#include "processor.h"
+
+#define CHIP8_FUZZ_MAX_FRAMES 1000
+#define CHIP8_FUZZ_MAX_ROM (4096 - START_ADDRESS)
+#define CHIP8_FUZZ_SEED 1
+
+static MEMORY pristine;
+static int initialized = 0;
+static unsigned long long fault_counts[CHIP8_FAULT_COUNT];
+static unsigned long long instructions;
+
+static void fuzz_init(void)
+{
+    chip8_init();
+    chip8_seed(CHIP8_FUZZ_SEED);
+    pristine = chip8_memory;
+    initialized = 1;
+}
+
+/* Runs one input; returns the fault it ended with */
+static uint8_t fuzz_run(const uint8_t *data, size_t size)
+{
+    if (!initialized)
+        fuzz_init();
+
+    memcpy(&chip8_memory, &pristine, sizeof(MEMORY));
+
+    if (size < 2)
+        return CHIP8_FAULT_NONE;
+
+    size_t rom_size = data[0] | (data[1] << 8);
+    data += 2;
+    size -= 2;
+
+    if (rom_size > size)
+        rom_size = size;
+    if (rom_size > CHIP8_FUZZ_MAX_ROM)
+        rom_size = CHIP8_FUZZ_MAX_ROM;
+
+    /* Byte by byte, so only the keys of the bytes copied change in ram_hash */
+    for (size_t i = 0; i < rom_size; i++)
+        chip8_write_ram((uint16_t)(START_ADDRESS + i), data[i]);
+
+    const uint8_t *events = data + rom_size;
+    size_t event_count = size - rom_size;
+    unsigned long long executed = processor_stats.cycles_executed;
+
+    for (size_t frame = 0; frame < CHIP8_FUZZ_MAX_FRAMES && !chip8_memory.fault;)
+    {
+        unsigned int ran;
+
+        if (frame < event_count)
+            chip8_set_key(events[frame] & 0xFu, events[frame] >> 7);
+        else if (chip8_memory.waiting_for_key && chip8_memory.delay_timer == 0 &&
+                 chip8_memory.sound_timer == 0)
+            break; /* Nothing left that could change the machine */
+
+        /* Past the last key event, idle frames are skipped in bulk */
+        processor_frames(frame < event_count ? 1 : (unsigned int)(CHIP8_FUZZ_MAX_FRAMES - frame), &ran, NULL);
+        frame += ran;
+    }
+
+    instructions += processor_stats.cycles_executed - executed;
+    fault_counts[chip8_memory.fault]++;
+    return chip8_memory.fault;
+}
+
+#ifdef CHIP8_FUZZ_LIBFUZZER
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    fuzz_run(data, size);
+    return 0;
+}
+
+#else
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static uint32_t random_next(uint32_t *state)
+{
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+static int replay_file(const char *path, uint8_t *buffer, size_t capacity)
+{
+    FILE *fp = fopen(path, "rb");
+    if (fp == NULL)
+    {
+        perror(path);
+        return -1;
+    }
+
+    size_t size = fread(buffer, 1, capacity, fp);
+    fclose(fp);
+
+    uint8_t fault = fuzz_run(buffer, size);
+    if (fault)
+        printf("%s: %s at 0x%03X\n", path, chip8_fault_name(fault), chip8_memory.program_counter);
+    else
+        printf("%s: ok\n", path);
+    return 0;
+}
+
+static void report(unsigned long long execs, double elapsed)
+{
+    fprintf(stderr, "%llu execs in %.2f s (%.0f execs/s), %llu instructions (%.1f M/s)\n",
+            execs, elapsed,
+            elapsed > 0 ? execs / elapsed : 0.0,
+            instructions,
+            elapsed > 0 ? instructions / elapsed / 1e6 : 0.0);
+
+    for (int i = 0; i < CHIP8_FAULT_COUNT; i++)
+    {
+        if (fault_counts[i])
+            fprintf(stderr, "  %-30s %llu\n", i ? chip8_fault_name(i) : "no fault", fault_counts[i]);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    static uint8_t buffer[2 + CHIP8_FUZZ_MAX_ROM + CHIP8_FUZZ_MAX_FRAMES];
+    unsigned long long runs = 100000;
+    uint32_t seed = (uint32_t)time(NULL);
+    int files = 0;
+
+    fuzz_init();
+
+#ifdef __AFL_FUZZ_TESTCASE_LEN
+    __AFL_FUZZ_INIT();
+    unsigned char *afl_buffer = __AFL_FUZZ_TESTCASE_BUF;
+    while (__AFL_LOOP(10000))
+        fuzz_run(afl_buffer, __AFL_FUZZ_TESTCASE_LEN);
+    return 0;
+#endif
+
+    double start = now_seconds();
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-runs") == 0 && i + 1 < argc)
+            runs = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "-seed") == 0 && i + 1 < argc)
+            seed = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (replay_file(argv[i], buffer, sizeof(buffer)) == 0)
+            files++;
+    }
+
+    if (files > 0)
+    {
+        report(files, now_seconds() - start);
+        return 0;
+    }
+
+    uint32_t state = seed ? seed : 1;
+    fprintf(stderr, "Fuzzing %llu random inputs (seed %u)\n", runs, seed);
+
+    for (unsigned long long run = 0; run < runs; run++)
+    {
+        size_t rom_size = 2 + random_next(&state) % 256;
+        size_t event_count = random_next(&state) % 64;
+        size_t size = 2 + rom_size + event_count;
+
+        buffer[0] = (uint8_t)rom_size;
+        buffer[1] = (uint8_t)(rom_size >> 8);
+        for (size_t i = 2; i < size; i += 4)
+        {
+            uint32_t r = random_next(&state);
+            memcpy(buffer + i, &r, size - i < 4 ? size - i : 4);
+        }
+
+        fuzz_run(buffer, size);
+    }
+
+    report(runs, now_seconds() - start);
+    return 0;
+}
+
+#endif
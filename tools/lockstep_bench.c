@@ -0,0 +1,133 @@
+/*
+ * chip8-lockstep-bench — compares lockstep_frame() against running the
+ * same machines one at a time.
+ *
+ * Usage: chip8-lockstep-bench <ROM file> [lanes] [frames]
+ *
+ * Every lane runs the ROM with its own random seed and its own keypad
+ * input. Both runs must end with identical machine states; the tool
+ * reports frames per second for each, the speedup and the lane
+ * utilisation of the lockstep run.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "chip8.h"
+#include "processor.h"
+#include "lockstep.h"
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Key held by `lane` during `frame`; changes every 16 frames */
+static uint8_t bench_key(int lane, long frame)
+{
+    return (uint8_t)((lane * 7 + frame / 16) & 0xFu);
+}
+
+static void bench_input(MEMORY *vm, int lane, long frame)
+{
+    chip8_vm = vm;
+    chip8_set_key(bench_key(lane, frame - 1), 0);
+    chip8_set_key(bench_key(lane, frame), 1);
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        printf("Usage: %s <ROM file> [lanes] [frames]\n", argv[0]);
+        return 1;
+    }
+
+    int lanes = argc > 2 ? atoi(argv[2]) : LOCKSTEP_MAX_LANES;
+    long frames = argc > 3 ? atol(argv[3]) : 10000;
+
+    if (lanes < 1 || lanes > LOCKSTEP_MAX_LANES)
+    {
+        fprintf(stderr, "ERROR: lanes must be between 1 and %d.\n", LOCKSTEP_MAX_LANES);
+        return 1;
+    }
+
+    MEMORY *caller_vm = chip8_vm;
+    MEMORY *scalar = calloc((size_t)lanes, sizeof(MEMORY));
+    MEMORY *result = malloc(sizeof(MEMORY));
+    LockstepGroup *group = lockstep_create(lanes);
+
+    if (scalar == NULL || result == NULL || group == NULL)
+    {
+        fprintf(stderr, "ERROR: Out of memory.\n");
+        return 1;
+    }
+
+    chip8_init();
+    if (chip8_load_ROM(argv[1]) != 0)
+        return 1;
+
+    for (int lane = 0; lane < lanes; lane++)
+    {
+        chip8_vm = &scalar[lane];
+        *chip8_vm = *caller_vm;
+        chip8_seed(0x9E3779B9u * (uint32_t)(lane + 1));
+        lockstep_load(group, lane, chip8_vm);
+    }
+
+    double start = now_seconds();
+    for (long frame = 0; frame < frames; frame++)
+    {
+        for (int lane = 0; lane < lanes; lane++)
+        {
+            bench_input(&scalar[lane], lane, frame);
+
+            /* processor_frame() without the idle-loop fast-forward */
+            for (int cycle = 0; cycle < CHIP8_CYCLES_PER_FRAME; cycle++)
+                processor_cycle();
+            processor_update_timers();
+        }
+    }
+    double scalar_time = now_seconds() - start;
+
+    start = now_seconds();
+    for (long frame = 0; frame < frames; frame++)
+    {
+        for (int lane = 0; lane < lanes; lane++)
+        {
+            lockstep_set_key(group, lane, bench_key(lane, frame - 1), 0);
+            lockstep_set_key(group, lane, bench_key(lane, frame), 1);
+        }
+        lockstep_frame(group);
+    }
+    double lockstep_time = now_seconds() - start;
+    chip8_vm = caller_vm;
+
+    int mismatches = 0;
+    for (int lane = 0; lane < lanes; lane++)
+    {
+        lockstep_store(group, lane, result);
+        if (memcmp(result, &scalar[lane], sizeof(MEMORY)) != 0)
+        {
+            fprintf(stderr, "Lane %d: state differs from the scalar run (PC 0x%03X vs 0x%03X)\n",
+                    lane, result->program_counter, scalar[lane].program_counter);
+            mismatches++;
+        }
+    }
+
+    double machine_frames = (double)frames * lanes;
+    printf("Scalar:   %.0f machine frames/s\n", scalar_time > 0 ? machine_frames / scalar_time : 0.0);
+    printf("Lockstep: %.0f machine frames/s (%.2fx)\n",
+           lockstep_time > 0 ? machine_frames / lockstep_time : 0.0,
+           lockstep_time > 0 ? scalar_time / lockstep_time : 0.0);
+    lockstep_report_stats(group, stdout);
+    printf("%s\n", mismatches ? "State check FAILED" : "State check passed");
+
+    lockstep_destroy(group);
+    free(result);
+    free(scalar);
+    return mismatches ? 1 : 0;
+}
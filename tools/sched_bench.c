@@ -0,0 +1,186 @@
+/*
+ * chip8-sched-bench — measures the cooperative scheduler against running
+ * every session every frame.
+ *
+ * Usage: chip8-sched-bench <ROM file> [sessions] [seconds] [presses per minute]
+ *
+ * Hosts `sessions` machines running the ROM (default 1000) for `seconds`
+ * of emulated time (default 60) on a virtual clock, so the numbers measure
+ * CPU work rather than sleeping. Each session gets a key press, held for
+ * one frame, about `presses per minute` times a minute (default 6), on a
+ * script derived from the session number.
+ *
+ * The same script is then replayed with every machine run every frame.
+ * Both runs must end in identical states; the tool prints the CPU time
+ * per emulated second of both and the scheduler's counters.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "libchip8.h"
+#include "processor.h"
+#include "scheduler.h"
+
+#define TICK_NS (1000000000LL / CHIP8_FRAME_RATE)
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Key pressed by `session` in frame `tick`, or -1 */
+static int script_key(int session, long tick, int per_minute)
+{
+    uint32_t x = (uint32_t)session * 0x9E3779B1u ^ (uint32_t)tick * 0x85EBCA6Bu;
+    x ^= x >> 15;
+    x *= 0x2C1B3C6Du;
+    x ^= x >> 12;
+
+    return (x % (60u * CHIP8_FRAME_RATE)) < (unsigned)per_minute ? (int)(x >> 24) & 0xF : -1;
+}
+
+typedef struct
+{
+    long tick;
+    int session;
+    uint8_t key;
+    uint8_t pressed;
+} KeyEvent;
+
+/* Presses and releases of the whole run, in tick order */
+static KeyEvent *script_events(int sessions, long ticks, int per_minute, long *count)
+{
+    size_t capacity = 1024;
+    KeyEvent *events = malloc(capacity * sizeof(KeyEvent));
+    *count = 0;
+
+    for (long tick = 0; events && tick < ticks; tick++)
+    {
+        for (int i = 0; i < sessions; i++)
+        {
+            int released = script_key(i, tick - 1, per_minute);
+            int pressed = script_key(i, tick, per_minute);
+
+            if ((size_t)*count + 2 > capacity)
+            {
+                capacity *= 2;
+                KeyEvent *grown = realloc(events, capacity * sizeof(KeyEvent));
+                if (grown == NULL)
+                {
+                    free(events);
+                    return NULL;
+                }
+                events = grown;
+            }
+
+            if (released >= 0)
+                events[(*count)++] = (KeyEvent){tick, i, (uint8_t)released, 0};
+            if (pressed >= 0)
+                events[(*count)++] = (KeyEvent){tick, i, (uint8_t)pressed, 1};
+        }
+    }
+    return events;
+}
+
+static Chip8Machine **create_machines(int count, const uint8_t *rom, size_t size)
+{
+    Chip8Machine **machines = calloc((size_t)count, sizeof(Chip8Machine *));
+
+    for (int i = 0; machines && i < count; i++)
+    {
+        machines[i] = libchip8_create((uint32_t)i + 1);
+        if (machines[i] == NULL || libchip8_load_rom(machines[i], rom, size) != 0)
+            return NULL;
+    }
+    return machines;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        printf("Usage: %s <ROM file> [sessions] [seconds] [presses per minute]\n", argv[0]);
+        return 1;
+    }
+
+    int sessions = argc > 2 ? atoi(argv[2]) : 1000;
+    long ticks = (argc > 3 ? atol(argv[3]) : 60) * CHIP8_FRAME_RATE;
+    int per_minute = argc > 4 ? atoi(argv[4]) : 6;
+
+    static uint8_t rom[4096];
+    FILE *fp = fopen(argv[1], "rb");
+    if (fp == NULL)
+    {
+        perror("Failed to open ROM file");
+        return 1;
+    }
+    size_t size = fread(rom, 1, sizeof(rom), fp);
+    fclose(fp);
+
+    Chip8Machine **scheduled = create_machines(sessions, rom, size);
+    Chip8Machine **spinning = create_machines(sessions, rom, size);
+    Scheduler *scheduler = scheduler_create(0, NULL, NULL);
+    long event_count;
+    KeyEvent *events = script_events(sessions, ticks, per_minute, &event_count);
+    if (scheduled == NULL || spinning == NULL || scheduler == NULL || events == NULL)
+    {
+        fprintf(stderr, "Failed to create %d sessions\n", sessions);
+        return 1;
+    }
+
+    for (int i = 0; i < sessions; i++)
+        scheduler_add(scheduler, scheduled[i]);
+
+    double started = now_seconds();
+    for (long tick = 0, e = 0; tick < ticks; tick++)
+    {
+        for (; e < event_count && events[e].tick == tick; e++)
+            scheduler_set_key(scheduler, events[e].session, events[e].key, events[e].pressed);
+        scheduler_run(scheduler, tick * TICK_NS + TICK_NS / 2);
+    }
+    double scheduled_seconds = now_seconds() - started;
+
+    started = now_seconds();
+    for (long tick = 0, e = 0; tick < ticks; tick++)
+    {
+        for (; e < event_count && events[e].tick == tick; e++)
+            libchip8_set_key(spinning[events[e].session], events[e].key, events[e].pressed);
+        for (int i = 0; i < sessions; i++)
+            libchip8_run_cycles(spinning[i], CHIP8_CYCLES_PER_FRAME);
+    }
+    double spinning_seconds = now_seconds() - started;
+
+    int mismatches = 0;
+    for (int i = 0; i < sessions; i++)
+    {
+        if (libchip8_hash(scheduler_machine(scheduler, i)) != libchip8_hash(spinning[i]))
+            mismatches++;
+    }
+
+    const SchedulerStats *stats = scheduler_stats(scheduler);
+    double emulated = (double)ticks / CHIP8_FRAME_RATE;
+
+    printf("%d sessions, %.0f s emulated, %d key presses per minute\n", sessions, emulated, per_minute);
+    printf("Every frame: %8.2f ms CPU per emulated second\n", 1e3 * spinning_seconds / emulated);
+    printf("Scheduler:   %8.2f ms CPU per emulated second (%.1fx)\n",
+           1e3 * scheduled_seconds / emulated,
+           scheduled_seconds > 0 ? spinning_seconds / scheduled_seconds : 0.0);
+    printf("Frames run %llu, skipped %llu; %d of %d sessions parked; wakeups: %llu key, %llu timer\n",
+           stats->frames_run, stats->frames_skipped, stats->parked, stats->sessions,
+           stats->key_wakeups, stats->timer_wakeups);
+    printf("Final states %s\n", mismatches ? "DIFFER" : "identical");
+
+    for (int i = 0; i < sessions; i++)
+    {
+        libchip8_destroy(scheduler_remove(scheduler, i));
+        libchip8_destroy(spinning[i]);
+    }
+    scheduler_destroy(scheduler);
+    free(events);
+    free(scheduled);
+    free(spinning);
+    return mismatches ? 1 : 0;
+}
@@ -0,0 +1,131 @@
+/*
+ * chip8-shm-reader — example reader of a --shm export, and a latency and
+ * consistency test for it.
+ *
+ * Usage: chip8-shm-reader <name> [frames] [poll µs]
+ *
+ * Maps the segment read-only and polls it every `poll µs` microseconds
+ * (default 100, 0 to spin) until `frames` new frames (default 600) were
+ * read. Each frame is read in place under the seqlock: the display is
+ * rehashed straight from the mapping and checked against the published
+ * display_hash, which catches any torn read that slipped past the lock.
+ * At the end it prints frames missed between polls, seqlock retries,
+ * hash mismatches and the publish-to-read latency with p50/p99/max.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "shm_export.h"
+#include "chip8.h"
+#include "frame_pacer.h"
+
+#define MAX_SAMPLES 100000
+#define IDLE_TIMEOUT_NS 2000000000LL
+
+static int64_t samples[MAX_SAMPLES];
+
+static int compare_ns(const void *a, const void *b)
+{
+    int64_t x = *(const int64_t *)a;
+    int64_t y = *(const int64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static uint64_t hash_display(const ShmExportSegment *segment, int *lit)
+{
+    uint64_t hash = 0;
+    *lit = 0;
+
+    for (int row = 0; row < CHIP8_HEIGHT; row++)
+        for (int col = 0; col < CHIP8_WIDTH; col++)
+            if (segment->display[row][col])
+            {
+                hash ^= chip8_pixel_key(row, col);
+                (*lit)++;
+            }
+
+    return hash;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "Usage: %s <name> [frames] [poll us]\n", argv[0]);
+        return 1;
+    }
+
+    unsigned long frames = argc > 2 ? strtoul(argv[2], NULL, 10) : 600;
+    int64_t poll_ns = (argc > 3 ? strtol(argv[3], NULL, 10) : 100) * 1000LL;
+
+    const ShmExportSegment *segment = shm_export_open(argv[1]);
+    if (segment == NULL)
+        return 1;
+
+    uint64_t last_sequence = shm_export_read_begin(segment);
+    uint64_t first_frame = 0, last_frame = 0;
+    unsigned long read = 0, missed = 0, retries = 0, mismatches = 0;
+    int count = 0, lit = 0;
+    int64_t last_change_ns = frame_pacer_now_ns();
+
+    while (read < frames)
+    {
+        uint64_t sequence = shm_export_read_begin(segment);
+        int64_t now = frame_pacer_now_ns();
+
+        if (sequence == last_sequence)
+        {
+            if (now - last_change_ns > IDLE_TIMEOUT_NS)
+            {
+                fprintf(stderr, "No new frame for %lld s; stopping.\n", IDLE_TIMEOUT_NS / 1000000000LL);
+                break;
+            }
+            if (poll_ns > 0)
+                frame_pacer_sleep_ns(poll_ns);
+            continue;
+        }
+
+        uint64_t frame = segment->frame;
+        int64_t published_ns = segment->published_ns;
+        uint64_t published_hash = segment->display_hash;
+        int frame_lit;
+        uint64_t hash = hash_display(segment, &frame_lit);
+
+        if (shm_export_read_retry(segment, sequence))
+        {
+            retries++;
+            continue;
+        }
+
+        if (hash != published_hash)
+            mismatches++;
+        if (read > 0 && frame > last_frame + 1)
+            missed += (unsigned long)(frame - last_frame - 1);
+        if (read == 0)
+            first_frame = frame;
+        if (count < MAX_SAMPLES)
+            samples[count++] = now - published_ns;
+
+        last_sequence = sequence;
+        last_change_ns = now;
+        last_frame = frame;
+        lit = frame_lit;
+        read++;
+    }
+
+    printf("Read %lu frames (%llu-%llu), %lu missed between polls, %d pixels lit\n",
+           read, (unsigned long long)first_frame, (unsigned long long)last_frame, missed, lit);
+    printf("Seqlock retries:  %lu, display hash mismatches: %lu\n", retries, mismatches);
+
+    if (count > 0)
+    {
+        qsort(samples, (size_t)count, sizeof(int64_t), compare_ns);
+        printf("Read latency:     p50 %.3f ms, p99 %.3f ms, max %.3f ms (%d samples)\n",
+               samples[count / 2] / 1e6, samples[(count - 1) * 99 / 100] / 1e6,
+               samples[count - 1] / 1e6, count);
+    }
+
+    shm_export_close(segment);
+    return read == frames && mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,223 @@
+/*
+ * chip8-stream-client — watches and drives a --stream session and
+ * measures it.
+ *
+ * Usage: chip8-stream-client <port|path> [frames] [key interval]
+ *
+ * Receives `frames` frame messages (default 600), applies each delta to
+ * a local copy of the display, and every `key interval` frames (default
+ * 30, 0 for never) presses or releases a key. At the end it prints the
+ * received bytes per frame, the frame delivery latency (frame finished
+ * on the server to frame received) and the end-to-end input latency (key
+ * event sent to the first frame that includes it), with p50/p99/max.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include "stream.h"
+#include "frame_pacer.h"
+
+#define MAX_SAMPLES 100000
+
+typedef struct
+{
+    int64_t samples[MAX_SAMPLES];
+    int count;
+} Latencies;
+
+static void record(Latencies *latencies, int64_t ns)
+{
+    if (latencies->count < MAX_SAMPLES)
+        latencies->samples[latencies->count++] = ns;
+}
+
+static int compare_ns(const void *a, const void *b)
+{
+    int64_t x = *(const int64_t *)a;
+    int64_t y = *(const int64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static void report(const char *name, Latencies *latencies)
+{
+    if (latencies->count == 0)
+    {
+        printf("%-17s no samples\n", name);
+        return;
+    }
+
+    qsort(latencies->samples, (size_t)latencies->count, sizeof(int64_t), compare_ns);
+    printf("%-17s p50 %.3f ms, p99 %.3f ms, max %.3f ms (%d samples)\n",
+           name,
+           latencies->samples[latencies->count / 2] / 1e6,
+           latencies->samples[(latencies->count - 1) * 99 / 100] / 1e6,
+           latencies->samples[latencies->count - 1] / 1e6,
+           latencies->count);
+}
+
+static int connect_endpoint(const char *endpoint)
+{
+    char *end;
+    long port = strtol(endpoint, &end, 10);
+    int fd;
+
+    if (*endpoint != '\0' && *end == '\0')
+    {
+        struct sockaddr_in address = {0};
+        address.sin_family = AF_INET;
+        address.sin_port = htons((uint16_t)port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0 || connect(fd, (struct sockaddr *)&address, sizeof(address)) != 0)
+            return -1;
+
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        return fd;
+    }
+
+    struct sockaddr_un address = {0};
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, endpoint, sizeof(address.sun_path) - 1);
+
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, (struct sockaddr *)&address, sizeof(address)) != 0)
+        return -1;
+    return fd;
+}
+
+static int read_exact(int fd, uint8_t *buffer, size_t length)
+{
+    while (length > 0)
+    {
+        ssize_t received = recv(fd, buffer, length, 0);
+        if (received < 0 && errno == EINTR)
+            continue;
+        if (received <= 0)
+            return -1;
+        buffer += received;
+        length -= (size_t)received;
+    }
+    return 0;
+}
+
+static uint64_t get_le(const uint8_t *in, int size)
+{
+    uint64_t value = 0;
+    for (int i = size - 1; i >= 0; i--)
+        value = (value << 8) | in[i];
+    return value;
+}
+
+static int send_key(int fd, uint8_t key, int pressed)
+{
+    uint8_t event[STREAM_KEY_EVENT_SIZE];
+    uint64_t now = (uint64_t)frame_pacer_now_ns();
+
+    event[0] = 'K';
+    event[1] = (uint8_t)((pressed ? 0x80 : 0) | (key & 0xFu));
+    for (int i = 0; i < 8; i++)
+        event[2 + i] = (uint8_t)(now >> (8 * i));
+
+    return send(fd, event, sizeof(event), MSG_NOSIGNAL) == (ssize_t)sizeof(event) ? 0 : -1;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        printf("Usage: %s <port|path> [frames] [key interval]\n", argv[0]);
+        return 1;
+    }
+
+    unsigned long frames = argc > 2 ? strtoul(argv[2], NULL, 10) : 600;
+    unsigned long key_interval = argc > 3 ? strtoul(argv[3], NULL, 10) : 30;
+
+    int fd = connect_endpoint(argv[1]);
+    if (fd < 0)
+    {
+        perror("Failed to connect to stream");
+        return 1;
+    }
+
+    static Latencies delivery, input;
+    static uint8_t bitmap[STREAM_BITMAP_BYTES];
+    uint8_t header[STREAM_HEADER_SIZE];
+    uint8_t payload[1 << 16];
+    unsigned long long bytes = 0;
+    unsigned long received = 0, key_frames = 0, first_frame = 0, last_frame = 0;
+    uint64_t last_input_ns = 0;
+    int pressed = 0;
+
+    while (received < frames)
+    {
+        if (read_exact(fd, header, sizeof(header)) != 0 || header[0] != 'F')
+        {
+            fprintf(stderr, "Stream ended or sent a malformed message.\n");
+            break;
+        }
+
+        size_t length = (size_t)get_le(header + 2, 2);
+        if (read_exact(fd, payload, length) != 0)
+            break;
+
+        int64_t now = frame_pacer_now_ns();
+        uint64_t produced_ns = get_le(header + 8, 8);
+        uint64_t input_ns = get_le(header + 16, 8);
+
+        if (header[1] & 0x01)
+        {
+            memset(bitmap, 0, sizeof(bitmap));
+            key_frames++;
+        }
+        if (stream_decode_delta(payload, length, bitmap) != 0)
+        {
+            fprintf(stderr, "Malformed frame payload.\n");
+            break;
+        }
+
+        record(&delivery, now - (int64_t)produced_ns);
+        if (input_ns != 0 && input_ns != last_input_ns)
+        {
+            record(&input, now - (int64_t)input_ns);
+            last_input_ns = input_ns;
+        }
+
+        last_frame = (unsigned long)get_le(header + 4, 4);
+        if (received == 0)
+            first_frame = last_frame;
+        received++;
+        bytes += sizeof(header) + length;
+
+        if (key_interval && received % key_interval == 0)
+        {
+            pressed = !pressed;
+            if (send_key(fd, (uint8_t)(received / key_interval / 2), pressed) != 0)
+                break;
+        }
+    }
+
+    close(fd);
+
+    int lit = 0;
+    for (int i = 0; i < STREAM_BITMAP_BYTES; i++)
+        lit += __builtin_popcount(bitmap[i]);
+
+    printf("Received %lu frames (%lu key frames) covering emulated frames %lu-%lu, %d pixels lit\n",
+           received, key_frames, first_frame, last_frame, lit);
+    printf("Bytes per frame:  %.1f (%llu total, raw bitmap %d)\n",
+           received ? (double)bytes / received : 0.0, bytes, STREAM_BITMAP_BYTES);
+    report("Delivery latency:", &delivery);
+    report("Input latency:", &input);
+    return received == frames ? 0 : 1;
+}